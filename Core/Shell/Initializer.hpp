@@ -9,6 +9,7 @@
 
 #include "Shell/Evaluator.hpp"
 #include "Shell/Settings.hpp"
+#include "Shell/ShellHelpers.hpp"
 #include <xcore/fs/utils.h>
 #include <atomic>
 #include <cassert>
@@ -34,7 +35,7 @@ public:
   template<typename T, typename... ARGs>
   void attach(ARGs... args)
   {
-    FsNode * const binEntryNode = fsOpenNode(fs(), env()["PATH"]);
+    FsNode * const binEntryNode = ShellHelpers::openNode(fs(), env()["PATH"]);
     assert(binEntryNode != nullptr);
 
     ScriptRunnerBase * const runner = new ScriptRunner<T, ARGs...>{args...};
@@ -0,0 +1,38 @@
+/*
+ * Core/Shell/Interfaces/CacheParameters.hpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#ifndef VFS_SHELL_CORE_SHELL_INTERFACES_CACHEPARAMETERS_HPP_
+#define VFS_SHELL_CORE_SHELL_INTERFACES_CACHEPARAMETERS_HPP_
+
+#include <xcore/interface.h>
+
+enum CacheParameter
+{
+  /** Write modified sectors to the underlying device. */
+  IF_CACHE_FLUSH = IF_PARAMETER_END,
+  /** Number of sectors read from the cache, parameter type is uint32_t. */
+  IF_CACHE_HITS,
+  /** Number of sectors read from the underlying device, parameter type is uint32_t. */
+  IF_CACHE_MISSES
+};
+
+template<CacheParameter ID>
+static constexpr const char *ifParamToName()
+{
+  switch (ID)
+  {
+    case IF_CACHE_FLUSH:
+      return "flush";
+    case IF_CACHE_HITS:
+      return "hits";
+    case IF_CACHE_MISSES:
+      return "misses";
+    default:
+      return "undefined";
+  }
+}
+
+#endif // VFS_SHELL_CORE_SHELL_INTERFACES_CACHEPARAMETERS_HPP_
@@ -0,0 +1,399 @@
+/*
+ * InterfaceCache.cpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "Shell/Interfaces/InterfaceCache.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+static const InterfaceClass cacheTable = {
+    sizeof(struct InterfaceCache), // size
+    InterfaceCache::init,          // init
+    InterfaceCache::deinit,        // deinit
+
+    nullptr,                       // setCallback
+    InterfaceCache::getParam,      // getParam
+    InterfaceCache::setParam,      // setParam
+    InterfaceCache::read,          // read
+    InterfaceCache::write          // write
+};
+
+const InterfaceClass * const InterfaceCache = &cacheTable;
+
+InterfaceCache::InterfaceCache(Interface *interface, size_t sectors, Policy policy) :
+  m_interface{interface},
+  m_lock{},
+  m_entries{nullptr},
+  m_arena{nullptr},
+  m_capacity{sectors},
+  m_position{0},
+  m_stamp{0},
+  m_hits{0},
+  m_misses{0},
+  m_policy{policy},
+  m_wide{true}
+{
+  // m_base should be left untouched
+}
+
+InterfaceCache::~InterfaceCache()
+{
+  if (m_entries != nullptr)
+  {
+    // Modified sectors are written before the device is released
+    flush();
+    ::deinit(m_interface);
+  }
+
+  free(m_arena);
+  free(m_entries);
+}
+
+bool InterfaceCache::allocate()
+{
+  m_entries = static_cast<Entry *>(malloc(m_capacity * sizeof(Entry)));
+  m_arena = static_cast<uint8_t *>(malloc(m_capacity * SECTOR_SIZE));
+
+  if (m_entries == nullptr || m_arena == nullptr)
+  {
+    // Ownership of the device stays with the caller
+    free(m_entries);
+    m_entries = nullptr;
+    return false;
+  }
+
+  std::fill(m_entries, m_entries + m_capacity, Entry{0, 0, false, false});
+  return true;
+}
+
+InterfaceCache::Entry *InterfaceCache::find(uint64_t sector)
+{
+  for (size_t index = 0; index < m_capacity; ++index)
+  {
+    if (m_entries[index].valid && m_entries[index].sector == sector)
+      return &m_entries[index];
+  }
+
+  return nullptr;
+}
+
+InterfaceCache::Entry *InterfaceCache::evict()
+{
+  Entry *victim = &m_entries[0];
+
+  for (size_t index = 0; index < m_capacity && victim->valid; ++index)
+  {
+    if (!m_entries[index].valid || m_entries[index].stamp < victim->stamp)
+      victim = &m_entries[index];
+  }
+
+  if (victim->valid && victim->dirty)
+  {
+    if (!store(victim->sector * SECTOR_SIZE, data(victim), SECTOR_SIZE))
+      return nullptr;
+  }
+
+  victim->valid = false;
+  victim->dirty = false;
+  return victim;
+}
+
+uint8_t *InterfaceCache::data(const Entry *entry)
+{
+  return m_arena + static_cast<size_t>(entry - m_entries) * SECTOR_SIZE;
+}
+
+Result InterfaceCache::flush()
+{
+  Result res = E_OK;
+
+  for (size_t index = 0; index < m_capacity; ++index)
+  {
+    Entry &entry = m_entries[index];
+
+    if (!entry.valid || !entry.dirty)
+      continue;
+
+    if (store(entry.sector * SECTOR_SIZE, data(&entry), SECTOR_SIZE))
+      entry.dirty = false;
+    else
+      res = E_INTERFACE;
+  }
+
+  return res;
+}
+
+Result InterfaceCache::flushRange(uint64_t position, size_t length)
+{
+  const uint64_t first = position / SECTOR_SIZE;
+  const uint64_t last = (position + length + SECTOR_SIZE - 1) / SECTOR_SIZE;
+
+  for (size_t index = 0; index < m_capacity; ++index)
+  {
+    Entry &entry = m_entries[index];
+
+    if (!entry.valid || !entry.dirty || entry.sector < first || entry.sector >= last)
+      continue;
+
+    if (!store(entry.sector * SECTOR_SIZE, data(&entry), SECTOR_SIZE))
+      return E_INTERFACE;
+    entry.dirty = false;
+  }
+
+  return E_OK;
+}
+
+void InterfaceCache::invalidateRange(uint64_t position, size_t length)
+{
+  const uint64_t first = position / SECTOR_SIZE;
+  const uint64_t last = (position + length + SECTOR_SIZE - 1) / SECTOR_SIZE;
+
+  for (size_t index = 0; index < m_capacity; ++index)
+  {
+    Entry &entry = m_entries[index];
+
+    if (entry.valid && entry.sector >= first && entry.sector < last)
+    {
+      entry.valid = false;
+      entry.dirty = false;
+    }
+  }
+}
+
+Result InterfaceCache::seek(uint64_t position)
+{
+  if (m_wide)
+    return ifSetParam(m_interface, IF_POSITION_64, &position);
+
+  if (position > std::numeric_limits<uint32_t>::max())
+    return E_ADDRESS;
+
+  const auto narrow = static_cast<uint32_t>(position);
+  return ifSetParam(m_interface, IF_POSITION, &narrow);
+}
+
+bool InterfaceCache::transfer(uint64_t position, void *buffer, size_t length)
+{
+  return seek(position) == E_OK && ifRead(m_interface, buffer, length) == length;
+}
+
+bool InterfaceCache::store(uint64_t position, const void *buffer, size_t length)
+{
+  return seek(position) == E_OK && ifWrite(m_interface, buffer, length) == length;
+}
+
+Result InterfaceCache::getParamImpl(int parameter, void *data)
+{
+  switch (parameter)
+  {
+    case IF_CACHE_HITS:
+    {
+      Os::MutexLocker locker{m_lock};
+
+      *static_cast<uint32_t *>(data) = m_hits;
+      return E_OK;
+    }
+
+    case IF_CACHE_MISSES:
+    {
+      Os::MutexLocker locker{m_lock};
+
+      *static_cast<uint32_t *>(data) = m_misses;
+      return E_OK;
+    }
+
+    case IF_POSITION:
+    {
+      Os::MutexLocker locker{m_lock};
+
+      if (m_position > std::numeric_limits<uint32_t>::max())
+        return E_VALUE;
+
+      *static_cast<uint32_t *>(data) = static_cast<uint32_t>(m_position);
+      return E_OK;
+    }
+
+    case IF_POSITION_64:
+    {
+      Os::MutexLocker locker{m_lock};
+
+      *static_cast<uint64_t *>(data) = m_position;
+      return E_OK;
+    }
+
+    default:
+      return ifGetParam(m_interface, parameter, data);
+  }
+}
+
+Result InterfaceCache::setParamImpl(int parameter, const void *data)
+{
+  switch (parameter)
+  {
+    case IF_CACHE_FLUSH:
+    {
+      Os::MutexLocker locker{m_lock};
+      return flush();
+    }
+
+    case IF_POSITION:
+    case IF_POSITION_64:
+    {
+      Os::MutexLocker locker{m_lock};
+
+      // Position is validated by the device, reads from the cache use the stored copy
+      const Result res = ifSetParam(m_interface, parameter, data);
+
+      if (res == E_OK)
+      {
+        m_wide = parameter == IF_POSITION_64;
+        m_position = m_wide ? *static_cast<const uint64_t *>(data) : *static_cast<const uint32_t *>(data);
+      }
+
+      return res;
+    }
+
+    default:
+      return ifSetParam(m_interface, parameter, data);
+  }
+}
+
+size_t InterfaceCache::readImpl(void *buffer, size_t length)
+{
+  Os::MutexLocker locker{m_lock};
+  const uint64_t position = m_position;
+
+  if (position % SECTOR_SIZE || length % SECTOR_SIZE)
+  {
+    // Partial sectors bypass the cache, modified sectors are written first
+    if (flushRange(position, length) != E_OK || !transfer(position, buffer, length))
+      return 0;
+
+    m_position = position + length;
+    return length;
+  }
+
+  // Long sequential transfers are not cached, otherwise they would evict file system metadata
+  const size_t limit = std::max<size_t>(m_capacity / 2, 1);
+  const uint64_t first = position / SECTOR_SIZE;
+  const size_t count = length / SECTOR_SIZE;
+  auto * const output = static_cast<uint8_t *>(buffer);
+  size_t index = 0;
+
+  while (index < count)
+  {
+    Entry * const entry = find(first + index);
+
+    if (entry != nullptr)
+    {
+      memcpy(output + index * SECTOR_SIZE, data(entry), SECTOR_SIZE);
+      entry->stamp = ++m_stamp;
+      ++m_hits;
+      ++index;
+      continue;
+    }
+
+    // Consecutive missing sectors are read with a single request
+    size_t run = 1;
+
+    while (index + run < count && find(first + index + run) == nullptr)
+      ++run;
+
+    if (!transfer((first + index) * SECTOR_SIZE, output + index * SECTOR_SIZE, run * SECTOR_SIZE))
+      break;
+    m_misses += static_cast<uint32_t>(run);
+
+    for (size_t offset = 0; run <= limit && offset < run; ++offset)
+    {
+      Entry * const slot = evict();
+
+      if (slot == nullptr)
+        break;
+
+      memcpy(data(slot), output + (index + offset) * SECTOR_SIZE, SECTOR_SIZE);
+      *slot = Entry{first + index + offset, ++m_stamp, true, false};
+    }
+
+    index += run;
+  }
+
+  m_position = position + index * SECTOR_SIZE;
+  return index * SECTOR_SIZE;
+}
+
+size_t InterfaceCache::writeImpl(const void *buffer, size_t length)
+{
+  Os::MutexLocker locker{m_lock};
+  const uint64_t position = m_position;
+
+  if (position % SECTOR_SIZE || length % SECTOR_SIZE)
+  {
+    // Cached copies of partially written sectors are dropped
+    if (flushRange(position, length) != E_OK)
+      return 0;
+    invalidateRange(position, length);
+
+    if (!store(position, buffer, length))
+      return 0;
+
+    m_position = position + length;
+    return length;
+  }
+
+  const size_t limit = std::max<size_t>(m_capacity / 2, 1);
+  const uint64_t first = position / SECTOR_SIZE;
+  const size_t count = length / SECTOR_SIZE;
+  const auto * const input = static_cast<const uint8_t *>(buffer);
+
+  if (m_policy == Policy::WRITE_THROUGH || count > limit)
+  {
+    if (!store(position, buffer, length))
+    {
+      invalidateRange(position, length);
+      return 0;
+    }
+
+    // Cached copies are updated, written sectors are not added to the cache
+    for (size_t index = 0; index < count; ++index)
+    {
+      Entry * const entry = find(first + index);
+
+      if (entry != nullptr)
+      {
+        memcpy(data(entry), input + index * SECTOR_SIZE, SECTOR_SIZE);
+        entry->dirty = false;
+      }
+    }
+
+    m_position = position + length;
+    return length;
+  }
+
+  size_t index = 0;
+
+  for (; index < count; ++index)
+  {
+    Entry *entry = find(first + index);
+
+    if (entry == nullptr)
+    {
+      // Victim is written to the device when it was modified
+      if ((entry = evict()) == nullptr)
+        break;
+
+      entry->sector = first + index;
+      entry->valid = true;
+    }
+
+    memcpy(data(entry), input + index * SECTOR_SIZE, SECTOR_SIZE);
+    entry->stamp = ++m_stamp;
+    entry->dirty = true;
+  }
+
+  m_position = position + index * SECTOR_SIZE;
+  return index * SECTOR_SIZE;
+}
@@ -0,0 +1,135 @@
+/*
+ * Core/Shell/Interfaces/InterfaceCache.hpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#ifndef VFS_SHELL_CORE_SHELL_INTERFACES_INTERFACECACHE_HPP_
+#define VFS_SHELL_CORE_SHELL_INTERFACES_INTERFACECACHE_HPP_
+
+#include "Shell/Interfaces/CacheParameters.hpp"
+#include "Wrappers/Mutex.hpp"
+#include <cstdint>
+#include <new>
+
+extern const InterfaceClass * const InterfaceCache;
+
+// Sector cache of a block device, sectors are replaced in least recently used order
+class InterfaceCache
+{
+public:
+  enum class Policy: uint8_t
+  {
+    // Writes are passed to the device immediately, cached copies are updated
+    WRITE_THROUGH,
+    // Written sectors are kept in the cache until eviction, flush or release
+    WRITE_BACK
+  };
+
+  struct Config
+  {
+    /** Mandatory: underlying block device, released together with the cache. */
+    Interface *pipe;
+    /** Mandatory: number of cached sectors. */
+    size_t sectors;
+    /** Optional: write policy. */
+    Policy policy;
+  };
+
+  static constexpr size_t SECTOR_SIZE{512};
+
+  InterfaceCache(const InterfaceCache &) = delete;
+  InterfaceCache &operator=(const InterfaceCache &) = delete;
+
+  static Result init(void *object, const void *configBase)
+  {
+    const Config * const config = static_cast<const Config *>(configBase);
+
+    // Arena of the cache should fit into the address space
+    if (config->pipe == nullptr || !config->sectors || config->sectors > SIZE_MAX / SECTOR_SIZE)
+      return E_VALUE;
+
+    auto * const cache = new (object) InterfaceCache{config->pipe, config->sectors, config->policy};
+
+    if (!cache->allocate())
+    {
+      cache->~InterfaceCache();
+      return E_MEMORY;
+    }
+
+    return E_OK;
+  }
+
+  static void deinit(void *object)
+  {
+    static_cast<InterfaceCache *>(object)->~InterfaceCache();
+  }
+
+  static Result getParam(void *object, int parameter, void *data)
+  {
+    return static_cast<InterfaceCache *>(object)->getParamImpl(parameter, data);
+  }
+
+  static Result setParam(void *object, int parameter, const void *data)
+  {
+    return static_cast<InterfaceCache *>(object)->setParamImpl(parameter, data);
+  }
+
+  static size_t read(void *object, void *buffer, size_t length)
+  {
+    return static_cast<InterfaceCache *>(object)->readImpl(buffer, length);
+  }
+
+  static size_t write(void *object, const void *buffer, size_t length)
+  {
+    return static_cast<InterfaceCache *>(object)->writeImpl(buffer, length);
+  }
+
+private:
+  struct Entry
+  {
+    uint64_t sector;
+    // Usage counter value of the last access, an entry with the lowest stamp is evicted first
+    uint32_t stamp;
+    bool valid;
+    bool dirty;
+  };
+
+  Interface m_base;
+  Interface * const m_interface;
+
+  Os::Mutex m_lock;
+  Entry *m_entries;
+  uint8_t *m_arena;
+  size_t m_capacity;
+  uint64_t m_position;
+  uint32_t m_stamp;
+  uint32_t m_hits;
+  uint32_t m_misses;
+  Policy m_policy;
+  // Position parameter used by the client is also used for the device
+  bool m_wide;
+
+  InterfaceCache(Interface *, size_t, Policy);
+  ~InterfaceCache();
+
+  bool allocate();
+
+  Entry *find(uint64_t);
+  Entry *evict();
+  uint8_t *data(const Entry *);
+
+  Result flush();
+  Result flushRange(uint64_t, size_t);
+  void invalidateRange(uint64_t, size_t);
+  Result seek(uint64_t);
+  bool transfer(uint64_t, void *, size_t);
+  bool store(uint64_t, const void *, size_t);
+
+  Result getParamImpl(int, void *);
+  Result setParamImpl(int, const void *);
+  size_t readImpl(void *, size_t);
+  size_t writeImpl(const void *, size_t);
+};
+
+#endif // VFS_SHELL_CORE_SHELL_INTERFACES_INTERFACECACHE_HPP_
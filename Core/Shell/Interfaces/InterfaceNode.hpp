@@ -13,10 +13,29 @@
 #include "Shell/TerminalHelpers.hpp"
 #include "Vfs/Vfs.hpp"
 #include "Vfs/VfsHandle.hpp"
+#include "Wrappers/Mutex.hpp"
+#include "Wrappers/Semaphore.hpp"
 #include <xcore/interface.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <memory>
+#include <new>
 #include <tuple>
 
+#ifndef CONFIG_SHELL_READ_AHEAD_LENGTH
+#  define CONFIG_SHELL_READ_AHEAD_LENGTH 4096
+#endif
+
+#ifndef CONFIG_SHELL_WRITE_BEHIND_LENGTH
+#  define CONFIG_SHELL_WRITE_BEHIND_LENGTH 2048
+#endif
+
+#ifndef CONFIG_SHELL_REQUEST_QUEUE_LENGTH
+#  define CONFIG_SHELL_REQUEST_QUEUE_LENGTH 4
+#endif
+
 template<typename T, typename... ARGs>
 class ParamBuilder
 {
@@ -166,7 +185,19 @@ public:
     VfsNode{timestamp, access},
     m_interface{interface}
   {
-    rename(name);
+    // Parameter names are string literals
+    setStaticName(name);
+  }
+
+  // Parameters are parts of the interface node, references are taken on the interface node
+  virtual bool acquire() override
+  {
+    return parent()->acquire();
+  }
+
+  virtual void release() override
+  {
+    parent()->release();
   }
 
   virtual Result length(FsFieldType type, FsLength *fieldLength) override
@@ -292,8 +323,8 @@ class InterfaceNode: public VfsNode
   {
     if (m_access & FS_ACCESS_READ)
     {
-      VfsHandle::Locker locker(*m_handle);
-      return m_handle->makeNodeProxy(&std::get<0>(m_parameters));
+      VfsHandle::SharedLocker locker{m_handle, this};
+      return VfsHandle::makeNodeProxy(m_handle, &std::get<0>(m_parameters));
     }
 
     return nullptr;
@@ -320,11 +351,53 @@ class InterfaceNode: public VfsNode
   }
 
 public:
+  // Sequential reads of block devices are extended up to this length, extra data is kept by the node
+  static constexpr size_t READ_AHEAD_LENGTH{CONFIG_SHELL_READ_AHEAD_LENGTH};
+  // Small writes to block devices are merged in a buffer of this length
+  static constexpr size_t WRITE_BEHIND_LENGTH{CONFIG_SHELL_WRITE_BEHIND_LENGTH};
+  // Buffered data is written in bursts aligned to sectors
+  static constexpr size_t SECTOR_SIZE{512};
+  static_assert(WRITE_BEHIND_LENGTH % SECTOR_SIZE == 0);
+  // Number of asynchronous requests submitted to a block device and not yet returned
+  static constexpr size_t REQUEST_QUEUE_LENGTH{CONFIG_SHELL_REQUEST_QUEUE_LENGTH};
+
+  struct WriteStats
+  {
+    // Bytes written to the buffer and not yet written to the device
+    size_t dirty;
+    // Bursts written to the device
+    size_t flushes;
+  };
+
   InterfaceNode(Interface *interface, time64_t timestamp = 0,
       FsAccess access = FS_ACCESS_READ | FS_ACCESS_WRITE) :
     VfsNode{timestamp, access},
     m_parameters{InterfaceParamNode<ARGs>{ARGs::name(), interface, timestamp, access}...},
-    m_interface{interface}
+    m_interface{interface},
+    m_lock{},
+    m_ahead{},
+    m_aheadPosition{0},
+    m_aheadLength{0},
+    m_next{NO_POSITION},
+    m_scale{1},
+    m_behind{},
+    m_behindPosition{0},
+    m_dirtyBegin{0},
+    m_dirtyEnd{0},
+    m_flushes{0},
+    m_writeBehind{false},
+    m_cursor{NO_POSITION},
+    m_seeks{0},
+    m_exported{false},
+    m_requests{},
+    m_submitted{0},
+    m_current{0},
+    m_active{false},
+    m_completions{0},
+    m_completeLock{},
+    m_consumed{0},
+    m_reaped{0},
+    m_zerocopy{false}
   {
     uint64_t tmp;
 
@@ -334,24 +407,171 @@ public:
     updateLinksImpl(nullptr, this);
   }
 
+  ~InterfaceNode() override
+  {
+    // Node stays attached while it is referenced by links and proxies
+    if (m_handle != nullptr && (size32 || size64))
+      m_handle->detach(this);
+
+    Os::MutexLocker locker{m_lock};
+    drain();
+    flushBlocks();
+  }
+
+  // Writes shorter than the buffer are merged, buffered data is written on overflow, on sync and on release
+  void setWriteBehind(bool enabled)
+  {
+    Os::MutexLocker locker{m_lock};
+
+    if (!enabled)
+      flushBlocks();
+
+    // Exported interface may be used behind the node, buffered data would become stale
+    m_writeBehind = enabled && !m_exported && (size32 || size64) && WRITE_BEHIND_LENGTH >= SECTOR_SIZE;
+  }
+
+  // Number of position changes requested from the interface
+  size_t seeks()
+  {
+    Os::MutexLocker locker{m_lock};
+    return m_seeks;
+  }
+
+  WriteStats writeStats()
+  {
+    Os::MutexLocker locker{m_lock};
+    return WriteStats{static_cast<size_t>(m_dirtyEnd - m_dirtyBegin), m_flushes};
+  }
+
+  virtual Result sync() override
+  {
+    Os::MutexLocker locker{m_lock};
+
+    drain();
+    return flushBlocks();
+  }
+
+  virtual Result submit(FsLength position, Request *request) override
+  {
+    if (!(size32 || size64))
+      return E_INVALID;
+    if (!(m_access & (request->write ? FS_ACCESS_WRITE : FS_ACCESS_READ)))
+      return E_ACCESS;
+
+    Os::MutexLocker locker{m_lock};
+    const size_t index = m_submitted.load(std::memory_order_relaxed);
+
+    if (index - m_reaped == REQUEST_QUEUE_LENGTH)
+      return E_BUSY;
+
+    if (index == m_current.load(std::memory_order_acquire))
+    {
+      // Buffered data is written and data read ahead is dropped before the device is used asynchronously
+      const Result res = flushBlocks();
+
+      if (res != E_OK)
+        return res;
+
+      m_aheadLength = 0;
+      m_next = NO_POSITION;
+      m_cursor = NO_POSITION;
+
+      if (!m_zerocopy)
+      {
+        // Interfaces without callbacks complete requests during submission
+        const auto * const type = reinterpret_cast<const InterfaceClass *>(m_interface->base.type);
+
+        if (type->setCallback != nullptr && ifSetParam(m_interface, IF_ZEROCOPY, nullptr) == E_OK)
+        {
+          ifSetCallback(m_interface, onTransferFinished, this);
+          m_zerocopy = true;
+        }
+      }
+    }
+
+    request->position = position;
+    request->status = E_BUSY;
+    request->count = 0;
+
+    m_requests[index % REQUEST_QUEUE_LENGTH] = request;
+    m_submitted.store(index + 1, std::memory_order_release);
+    resumeTransfers();
+
+    return E_OK;
+  }
+
+  virtual Result complete(Request **request) override
+  {
+    if (!(size32 || size64))
+      return E_INVALID;
+
+    // Requests are returned in submission order, only one caller waits for the device at a time
+    Os::MutexLocker completeLocker{m_completeLock};
+    size_t index;
+    bool finished;
+
+    {
+      Os::MutexLocker locker{m_lock};
+
+      index = m_reaped;
+      if (index == m_submitted.load(std::memory_order_relaxed))
+        return E_EMPTY;
+
+      // Each finished request posts the semaphore once, the post is claimed before waiting
+      finished = m_consumed != index;
+      if (!finished)
+      {
+        ++m_consumed;
+        resumeTransfers();
+      }
+    }
+
+    // Submissions and synchronous transfers proceed while the request is in progress
+    if (!finished)
+      m_completions.wait();
+
+    Os::MutexLocker locker{m_lock};
+
+    // Next request is started by the consumer, the interface callback only finishes transfers
+    resumeTransfers();
+
+    *request = m_requests[index % REQUEST_QUEUE_LENGTH];
+    m_reaped = index + 1;
+    return E_OK;
+  }
+
   virtual void *head() override
   {
     return headImpl<sizeof...(ARGs)>();
   }
 
-  virtual VfsNode *fetch(VfsNode *current) override
+  virtual VfsNode *fetch(VfsNode *current, Cursor * = nullptr) override
   {
     return fetchImpl<0>(current);
   }
 
   virtual void enter(VfsHandle *handle, VfsNode *node) override
   {
+    // Block devices may keep buffered writes, they are flushed with the handle
+    if ((size32 || size64) && m_handle != handle)
+    {
+      if (m_handle != nullptr)
+        m_handle->detach(this);
+      if (handle != nullptr)
+        handle->attach(this);
+    }
+
     VfsNode::enter(handle, node);
     updateLinksImpl(handle, this);
   }
 
   virtual void leave() override
   {
+    {
+      Os::MutexLocker locker{m_lock};
+      flushBlocks();
+    }
+
     VfsNode::leave();
     updateLinksImpl(nullptr, this);
   }
@@ -366,6 +586,18 @@ public:
         if (position || bufferLength != sizeof(m_interface))
           return E_VALUE;
 
+        {
+          // Position and data of the interface may be changed by other users from now on
+          Os::MutexLocker locker{m_lock};
+
+          drain();
+          flushBlocks();
+          m_aheadLength = 0;
+          m_next = NO_POSITION;
+          m_writeBehind = false;
+          m_exported = true;
+        }
+
         memcpy(buffer, &m_interface, sizeof(m_interface));
         if (bytesRead != nullptr)
           *bytesRead = sizeof(m_interface);
@@ -388,16 +620,20 @@ public:
           break;
         }
 
-        if (size64)
-          res = setInterfacePosition<uint64_t>(position);
-        else if (size32)
-          res = setInterfacePosition<uint32_t>(position);
+        size_t count;
+
+        if (size64 || size32)
+        {
+          res = readBlocks(position, buffer, bufferLength, &count);
+        }
+        else
+        {
+          count = ifRead(m_interface, buffer, bufferLength);
+        }
 
         if (res != E_OK)
           break;
 
-        const auto count = ifRead(m_interface, buffer, bufferLength);
-
         if (bytesRead != nullptr)
           *bytesRead = count;
 
@@ -428,15 +664,35 @@ public:
           break;
         }
 
-        if (size64)
-          res = setInterfacePosition<uint64_t>(position);
-        else if (size32)
-          res = setInterfacePosition<uint32_t>(position);
+        Os::MutexLocker locker{m_lock};
+
+        // Data read ahead may be overwritten
+        m_aheadLength = 0;
+        m_next = NO_POSITION;
+
+        if (m_writeBehind && bufferLength < WRITE_BEHIND_LENGTH)
+        {
+          res = bufferBlocks(position, buffer, bufferLength);
+
+          if (res == E_OK && bytesWritten != nullptr)
+            *bytesWritten = bufferLength;
+          break;
+        }
+
+        // Buffered data is written first to keep the order of writes
+        if (m_writeBehind)
+          res = flushBlocks();
 
         if (res != E_OK)
           break;
 
-        const auto count = ifWrite(m_interface, buffer, bufferLength);
+        if (size64 || size32)
+          res = seekInterface(position);
+
+        if (res != E_OK)
+          break;
+
+        const auto count = writeInterface(buffer, bufferLength);
 
         if (bytesWritten != nullptr)
           *bytesWritten = count;
@@ -454,11 +710,435 @@ public:
   }
 
 private:
+  static constexpr FsLength NO_POSITION{static_cast<FsLength>(-1)};
+
   std::tuple<InterfaceParamNode<ARGs>...> m_parameters;
   Interface *m_interface;
+
+  // Read-ahead state of block devices
+  Os::Mutex m_lock;
+  std::unique_ptr<uint8_t []> m_ahead;
+  FsLength m_aheadPosition;
+  size_t m_aheadLength;
+  // End of the previous read, a read from this position continues a sequential stream
+  FsLength m_next;
+  // Device requests are this many times longer than requests of the reader
+  size_t m_scale;
+
+  // Write-behind state of block devices, the buffer starts at a sector boundary
+  std::unique_ptr<uint8_t []> m_behind;
+  FsLength m_behindPosition;
+  // Range of buffered data, the buffer is empty when the range is empty
+  FsLength m_dirtyBegin;
+  FsLength m_dirtyEnd;
+  size_t m_flushes;
+  bool m_writeBehind;
+
+  // Expected position of the interface after the previous transfer
+  FsLength m_cursor;
+  size_t m_seeks;
+  // Interface was handed out and may be repositioned behind the node
+  bool m_exported;
+
+  // Ring of asynchronous requests: submitted, finished and returned requests are counted separately
+  std::array<Request *, REQUEST_QUEUE_LENGTH> m_requests;
+  std::atomic<size_t> m_submitted;
+  // Request in progress, also the number of finished requests
+  std::atomic<size_t> m_current;
+  // Requests are started by the owner of the flag under the node lock, a transfer in progress owns the flag
+  std::atomic<bool> m_active;
+  Os::Semaphore m_completions;
+  // Serializes callers waiting for finished requests
+  Os::Mutex m_completeLock;
+  // Posts of the semaphore claimed by waiters
+  size_t m_consumed;
+  size_t m_reaped;
+  // Interface works in non-blocking mode and reports finished transfers with the callback
+  bool m_zerocopy;
+
   bool size32;
   bool size64;
 
+  Result readBlocks(FsLength position, void *buffer, size_t length, size_t *bytesRead)
+  {
+    Os::MutexLocker locker{m_lock};
+    auto * const output = static_cast<uint8_t *>(buffer);
+    size_t count = 0;
+
+    if (m_aheadLength && position >= m_aheadPosition && position - m_aheadPosition < m_aheadLength)
+    {
+      const auto offset = static_cast<size_t>(position - m_aheadPosition);
+
+      count = std::min(length, m_aheadLength - offset);
+      memcpy(output, m_ahead.get() + offset, count);
+    }
+
+    if (count < length)
+    {
+      const FsLength start = position + count;
+      const size_t remaining = length - count;
+
+      // Window grows while reads are sequential, device requests stay multiples of reader requests
+      if (position == m_next && !m_exported)
+        m_scale = std::max<size_t>(std::min(m_scale * 2, READ_AHEAD_LENGTH / remaining), 1);
+      else
+        m_scale = 1;
+
+      if (m_scale > 1 && m_ahead == nullptr)
+      {
+        // Reads are not buffered while the buffer can not be allocated
+        m_ahead.reset(new (std::nothrow) uint8_t[READ_AHEAD_LENGTH]);
+
+        if (m_ahead == nullptr)
+          m_scale = 1;
+      }
+
+      const Result res = seekInterface(start);
+
+      if (res != E_OK)
+      {
+        m_next = NO_POSITION;
+        return res;
+      }
+
+      if (m_scale > 1)
+      {
+        m_aheadPosition = start;
+        m_aheadLength = readInterface(m_ahead.get(), remaining * m_scale);
+
+        const size_t chunk = std::min(remaining, m_aheadLength);
+
+        memcpy(output + count, m_ahead.get(), chunk);
+        count += chunk;
+      }
+      else
+      {
+        m_aheadLength = 0;
+        count += readInterface(output + count, remaining);
+      }
+    }
+
+    // Buffered writes are newer than device data
+    if (m_dirtyBegin < m_dirtyEnd && position < m_dirtyEnd && position + count > m_dirtyBegin)
+    {
+      const FsLength begin = std::max(position, m_dirtyBegin);
+      const FsLength end = std::min(position + count, m_dirtyEnd);
+
+      memcpy(output + (begin - position), m_behind.get() + (begin - m_behindPosition),
+          static_cast<size_t>(end - begin));
+    }
+
+    m_next = position + count;
+    *bytesRead = count;
+    return E_OK;
+  }
+
+  Result bufferBlocks(FsLength position, const void *buffer, size_t length)
+  {
+    const FsLength end = position + length;
+
+    if (m_dirtyBegin < m_dirtyEnd)
+    {
+      // Only adjacent and overlapping writes are merged
+      const bool adjacent = position <= m_dirtyEnd && end >= m_dirtyBegin;
+      const bool fits = position >= m_behindPosition && end <= m_behindPosition + WRITE_BEHIND_LENGTH;
+
+      if (!adjacent || !fits)
+      {
+        const Result res = flushBlocks();
+
+        if (res != E_OK)
+          return res;
+      }
+    }
+
+    if (m_dirtyBegin == m_dirtyEnd)
+    {
+      if (m_behind == nullptr)
+        m_behind.reset(new (std::nothrow) uint8_t[WRITE_BEHIND_LENGTH]);
+
+      m_behindPosition = position - position % SECTOR_SIZE;
+
+      if (m_behind == nullptr || end > m_behindPosition + WRITE_BEHIND_LENGTH)
+      {
+        // Unaligned write does not fit into the buffer or the buffer can not be allocated
+        const Result res = seekInterface(position);
+
+        if (res != E_OK)
+          return res;
+
+        return writeInterface(buffer, length) == length ? E_OK : E_FULL;
+      }
+
+      m_dirtyBegin = position;
+      m_dirtyEnd = end;
+    }
+    else
+    {
+      m_dirtyBegin = std::min(m_dirtyBegin, position);
+      m_dirtyEnd = std::max(m_dirtyEnd, end);
+    }
+
+    memcpy(m_behind.get() + (position - m_behindPosition), buffer, length);
+
+    // Full buffer is written at once
+    if (m_dirtyEnd == m_behindPosition + WRITE_BEHIND_LENGTH)
+      return flushBlocks();
+
+    return E_OK;
+  }
+
+  Result flushBlocks()
+  {
+    if (m_dirtyBegin == m_dirtyEnd)
+      return E_OK;
+
+    const FsLength begin = m_dirtyBegin - m_dirtyBegin % SECTOR_SIZE;
+    const FsLength tail = m_dirtyEnd - m_dirtyEnd % SECTOR_SIZE;
+    FsLength end = m_dirtyEnd % SECTOR_SIZE ? tail + SECTOR_SIZE : m_dirtyEnd;
+
+    // Last sector of the device may be incomplete
+    if (size64)
+    {
+      uint64_t size;
+
+      if (ifGetParam(m_interface, IF_SIZE_64, &size) == E_OK)
+        end = std::max(m_dirtyEnd, std::min<FsLength>(end, size));
+    }
+    else
+    {
+      uint32_t size;
+
+      if (ifGetParam(m_interface, IF_SIZE, &size) == E_OK)
+        end = std::max(m_dirtyEnd, std::min<FsLength>(end, size));
+    }
+
+    // Partial sectors at the edges are completed with device data
+    if (begin < m_dirtyBegin)
+    {
+      const Result res = fillSector(begin, end);
+
+      if (res != E_OK)
+        return res;
+    }
+    if (m_dirtyEnd < end && (tail != begin || begin == m_dirtyBegin))
+    {
+      const Result res = fillSector(tail, end);
+
+      if (res != E_OK)
+        return res;
+    }
+
+    Result res = seekInterface(begin);
+    const auto length = static_cast<size_t>(end - begin);
+
+    if (res == E_OK && writeInterface(m_behind.get() + (begin - m_behindPosition), length) != length)
+      res = E_FULL;
+
+    // Data is dropped after a failure, otherwise every following write would fail too
+    m_dirtyBegin = m_dirtyEnd = 0;
+    // Data read ahead before the flush may be outdated
+    m_aheadLength = 0;
+    ++m_flushes;
+
+    return res;
+  }
+
+  // Read a sector and copy device data outside of the buffered range
+  Result fillSector(FsLength sector, FsLength end)
+  {
+    uint8_t data[SECTOR_SIZE];
+    const auto length = static_cast<size_t>(std::min<FsLength>(end - sector, SECTOR_SIZE));
+    const Result res = seekInterface(sector);
+
+    if (res != E_OK)
+      return res;
+    if (readInterface(data, length) != length)
+      return E_INTERFACE;
+
+    uint8_t * const output = m_behind.get() + (sector - m_behindPosition);
+
+    for (size_t offset = 0; offset < length; ++offset)
+    {
+      const FsLength current = sector + offset;
+
+      if (current < m_dirtyBegin || current >= m_dirtyEnd)
+        output[offset] = data[offset];
+    }
+
+    return E_OK;
+  }
+
+  // Sequential transfers continue from the current position, drivers may keep multi-block commands open
+  Result seekInterface(FsLength position)
+  {
+    // Synchronous access waits for asynchronous requests
+    drain();
+
+    if (position == m_cursor)
+    {
+      if (!m_exported)
+        return E_OK;
+
+      // Interface is shared, the cursor is confirmed by the driver
+      const bool confirmed = size64 ?
+          getInterfacePosition<uint64_t>() == position : getInterfacePosition<uint32_t>() == position;
+
+      if (confirmed)
+        return E_OK;
+    }
+
+    const Result res = size64 ? setInterfacePosition<uint64_t>(position) : setInterfacePosition<uint32_t>(position);
+
+    m_cursor = res == E_OK ? position : NO_POSITION;
+    ++m_seeks;
+    return res;
+  }
+
+  // Wait until submitted requests are finished and return the interface to blocking mode
+  void drain()
+  {
+    const size_t submitted = m_submitted.load(std::memory_order_relaxed);
+
+    // Callback releases the queue before the post, the queue is idle after the last post
+    while (m_consumed != submitted)
+    {
+      resumeTransfers();
+      ++m_consumed;
+      m_completions.wait();
+    }
+
+    if (m_zerocopy)
+    {
+      ifSetParam(m_interface, IF_BLOCKING, nullptr);
+      ifSetCallback(m_interface, nullptr, nullptr);
+      m_zerocopy = false;
+    }
+  }
+
+  // Start queued requests unless a transfer is in progress, should be called with the node lock held
+  void resumeTransfers()
+  {
+    if (!m_active.exchange(true, std::memory_order_acq_rel))
+      startTransfers();
+  }
+
+  // Start queued requests, called by the owner of the active flag
+  void startTransfers()
+  {
+    while (true)
+    {
+      const size_t index = m_current.load(std::memory_order_relaxed);
+
+      if (index == m_submitted.load(std::memory_order_acquire))
+      {
+        m_active.store(false, std::memory_order_release);
+
+        // Request submitted after the check is started here or by the submitter
+        if (index == m_submitted.load(std::memory_order_acquire) || m_active.exchange(true, std::memory_order_acq_rel))
+          return;
+
+        continue;
+      }
+
+      Request * const request = m_requests[index % REQUEST_QUEUE_LENGTH];
+      const Result res = size64 ?
+          setInterfacePosition<uint64_t>(request->position) : setInterfacePosition<uint32_t>(request->position);
+
+      if (res != E_OK)
+      {
+        finishTransfer(res, 0);
+        continue;
+      }
+
+      const size_t count = request->write ?
+          ifWrite(m_interface, request->buffer, request->length) : ifRead(m_interface, request->buffer, request->length);
+
+      if (m_zerocopy)
+      {
+        // Transfer continues in background and is finished by the callback
+        if (count)
+          return;
+
+        finishTransfer(E_INTERFACE, 0);
+      }
+      else if (request->write)
+        finishTransfer(count == request->length ? E_OK : E_FULL, count);
+      else
+        finishTransfer(count || !request->length ? E_OK : E_EMPTY, count);
+    }
+  }
+
+  void finishTransfer(Result res, size_t count, bool release = false)
+  {
+    const size_t index = m_current.load(std::memory_order_relaxed);
+    Request * const request = m_requests[index % REQUEST_QUEUE_LENGTH];
+
+    request->status = res;
+    request->count = count;
+
+    m_current.store(index + 1, std::memory_order_release);
+
+    // Flag is released before the post, the woken waiter may start the next request
+    if (release)
+      m_active.store(false, std::memory_order_release);
+
+    m_completions.post();
+  }
+
+  // Called in the interrupt context, the node is not touched after the semaphore is posted
+  static void onTransferFinished(void *argument)
+  {
+    auto * const node = static_cast<InterfaceNode *>(argument);
+
+    if (!node->m_active.load(std::memory_order_acquire))
+      return;
+
+    // Interface reports E_BUSY while the transfer is in progress
+    const Result res = ifGetParam(node->m_interface, IF_STATUS, nullptr);
+
+    if (res == E_BUSY)
+      return;
+
+    const size_t index = node->m_current.load(std::memory_order_relaxed);
+
+    node->finishTransfer(res, res == E_OK ? node->m_requests[index % REQUEST_QUEUE_LENGTH]->length : 0, true);
+  }
+
+  size_t readInterface(void *buffer, size_t length)
+  {
+    const size_t count = ifRead(m_interface, buffer, length);
+
+    advanceCursor(count, length);
+    return count;
+  }
+
+  size_t writeInterface(const void *buffer, size_t length)
+  {
+    const size_t count = ifWrite(m_interface, buffer, length);
+
+    advanceCursor(count, length);
+    return count;
+  }
+
+  void advanceCursor(size_t count, size_t length)
+  {
+    // Position of the interface is unknown after an incomplete transfer
+    if (m_cursor != NO_POSITION && count == length)
+      m_cursor += count;
+    else
+      m_cursor = NO_POSITION;
+  }
+
+  template<typename T>
+  FsLength getInterfacePosition()
+  {
+    static constexpr IfParameter POSITION_PARAM = std::is_same_v<T, uint32_t> ? IF_POSITION : IF_POSITION_64;
+
+    T pos;
+    return ifGetParam(m_interface, POSITION_PARAM, &pos) == E_OK ? static_cast<FsLength>(pos) : NO_POSITION;
+  }
+
   template<typename T>
   Result setInterfacePosition(FsLength position)
   {
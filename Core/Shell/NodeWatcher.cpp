@@ -0,0 +1,66 @@
+/*
+ * NodeWatcher.cpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "Shell/NodeWatcher.hpp"
+#include "Vfs/VfsHandle.hpp"
+
+NodeWatcher::NodeWatcher(Script *script, FsNode *node, Os::Semaphore &semaphore) :
+  m_script{script},
+  m_semaphore{semaphore},
+  m_handle{nullptr},
+  m_watcher{}
+{
+  VfsNodeProxy * const proxy = VfsNodeProxy::cast(node);
+
+  if (proxy != nullptr && proxy->handle() != nullptr)
+  {
+    m_handle = proxy->handle();
+    m_watcher = std::make_unique<VfsWatcher>(proxy->get(), onNodeChanged, this);
+    m_handle->watch(m_watcher.get());
+  }
+}
+
+NodeWatcher::~NodeWatcher()
+{
+  if (m_watcher != nullptr)
+    m_handle->unwatch(m_watcher.get());
+}
+
+void NodeWatcher::dispatch()
+{
+  static const unsigned short CHANGES[] = {
+      NodeChangedEvent::CREATED,
+      NodeChangedEvent::REMOVED,
+      NodeChangedEvent::WRITTEN,
+      NodeChangedEvent::ATTRIBUTE_CHANGED,
+      NodeChangedEvent::OVERFLOW
+  };
+
+  if (m_watcher == nullptr)
+    return;
+
+  VfsWatcher::Event queued;
+
+  while (m_watcher->pop(&queued))
+  {
+    NodeChangedEvent event;
+
+    event.event = ScriptEvent::Event::NODE_CHANGED;
+    event.node = queued.node;
+    event.change = CHANGES[queued.type];
+
+    m_script->onEventReceived(&event);
+  }
+}
+
+void NodeWatcher::onNodeChanged(void *argument)
+{
+  NodeWatcher * const watcher = static_cast<NodeWatcher *>(argument);
+
+  // Single wake-up is enough, the script drains the whole queue
+  if (watcher->m_semaphore.value() <= 0)
+    watcher->m_semaphore.post();
+}
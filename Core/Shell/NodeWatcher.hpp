@@ -0,0 +1,46 @@
+/*
+ * Core/Shell/NodeWatcher.hpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#ifndef VFS_SHELL_CORE_SHELL_NODEWATCHER_HPP_
+#define VFS_SHELL_CORE_SHELL_NODEWATCHER_HPP_
+
+#include "Shell/Script.hpp"
+#include "Vfs/VfsWatcher.hpp"
+#include "Wrappers/Semaphore.hpp"
+#include <memory>
+
+class VfsHandle;
+
+// Delivers changes of an in-memory node and its descendants to a script as node change events
+class NodeWatcher
+{
+public:
+  // Semaphore of the script is posted by writers when new events are queued
+  NodeWatcher(Script *, FsNode *, Os::Semaphore &);
+  ~NodeWatcher();
+
+  NodeWatcher(const NodeWatcher &) = delete;
+  NodeWatcher &operator=(const NodeWatcher &) = delete;
+
+  // Queued events are passed to the script, should be called from the thread of the script
+  void dispatch();
+
+  // Nodes of other file systems can not be watched
+  bool isAttached() const
+  {
+    return m_watcher != nullptr;
+  }
+
+private:
+  Script * const m_script;
+  Os::Semaphore &m_semaphore;
+  VfsHandle *m_handle;
+  std::unique_ptr<VfsWatcher> m_watcher;
+
+  static void onNodeChanged(void *);
+};
+
+#endif // VFS_SHELL_CORE_SHELL_NODEWATCHER_HPP_
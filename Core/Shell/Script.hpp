@@ -22,6 +22,7 @@ struct ScriptEvent
   enum class Event
   {
     BUTTON_PRESSED,
+    NODE_CHANGED,
     POINTER_MOVED,
     SERIAL_INPUT,
     SIGNAL_RAISED
@@ -36,6 +37,21 @@ struct ButtonPressedEvent: public ScriptEvent
   bool state;
 };
 
+struct NodeChangedEvent: public ScriptEvent
+{
+  enum Change: unsigned short
+  {
+      CREATED,
+      REMOVED,
+      WRITTEN,
+      ATTRIBUTE_CHANGED,
+      OVERFLOW
+  };
+
+  FsIdentifier node;
+  unsigned short change;
+};
+
 struct PointerMovedEvent: public ScriptEvent
 {
   short x;
@@ -0,0 +1,56 @@
+/*
+ * AllocateNodeScript.cpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "Shell/Scripts/AllocateNodeScript.hpp"
+#include "Vfs/Vfs.hpp"
+
+const std::array<ArgParser::Descriptor, 3> AllocateNodeScript::descriptors{
+    {
+        {"--help", nullptr, "show this help message and exit", 0, Arguments::helpSetter},
+        {"-l", "LENGTH", "reserve LENGTH bytes of storage for each FILE", 1, Arguments::lengthSetter},
+        {nullptr, "FILE", "node to allocate", 0, Arguments::incrementNodeCount}
+    }
+};
+
+AllocateNodeScript::AllocateNodeScript(Script *parent, ArgumentIterator firstArgument,
+    ArgumentIterator lastArgument) :
+  NodeLengthScriptBase{parent, firstArgument, lastArgument},
+  m_arguments{ArgParser::parse<Arguments>(m_firstArgument, m_lastArgument,
+      descriptors.cbegin(), descriptors.cend())},
+  m_result{E_OK}
+{
+}
+
+Result AllocateNodeScript::run()
+{
+  if (m_arguments.help)
+  {
+    ArgParser::help(tty(), name(), std::cbegin(descriptors), std::cend(descriptors));
+    return E_OK;
+  }
+
+  const Result res = check(name(), m_arguments, "length");
+
+  if (res == E_OK)
+  {
+    ArgParser::invoke(m_firstArgument, m_lastArgument, descriptors.cbegin(), descriptors.cend(),
+        [this](const char *key){ allocateNode(key); });
+
+    return m_result;
+  }
+  else
+    return res;
+}
+
+void AllocateNodeScript::allocateNode(const char *positionalArgument)
+{
+  // Storage is reserved without changing the length of node data
+  if (m_result == E_OK)
+  {
+    m_result = writeLength(name(), positionalArgument, static_cast<FsFieldType>(VfsNode::VFS_NODE_CAPACITY),
+        m_arguments.length, "allocation");
+  }
+}
@@ -8,6 +8,8 @@
 #include "Shell/Scripts/ChangeDirectoryScript.hpp"
 #include "Shell/ShellHelpers.hpp"
 #include "Shell/Settings.hpp"
+#include "Shell/TerminalHelpers.hpp"
+#include "Vfs/Vfs.hpp"
 #include <xcore/fs/utils.h>
 #include <iterator>
 
@@ -48,7 +50,7 @@ Result ChangeDirectoryScript::changeDirectory(const char *relativePath)
   char path[Settings::PWD_LENGTH];
 
   fsJoinPaths(path, env()["PWD"], relativePath);
-  FsNode * const root = fsOpenNode(fs(), path);
+  FsNode * const root = ShellHelpers::openNode(fs(), env(), relativePath);
   if (root == nullptr)
   {
     tty() << name() << ": " << relativePath << ": node not found" << Terminal::EOL;
@@ -57,14 +59,23 @@ Result ChangeDirectoryScript::changeDirectory(const char *relativePath)
 
   FsAccess access;
   const Result res = fsNodeRead(root, FS_NODE_ACCESS, 0, &access, sizeof(access), nullptr);
-  fsNodeFree(root);
 
   if (res != E_OK || !(access & FS_ACCESS_READ))
   {
+    fsNodeFree(root);
     tty() << name() << ": " << relativePath << ": permission denied" << Terminal::EOL;
     return E_ACCESS;
   }
 
+  // Identifier is kept for resolution of relative paths, nodes of mounted file systems have no identifiers
+  char identifier[TerminalHelpers::serializedValueLength<FsIdentifier>()] = "";
+  FsIdentifier id;
+
+  if (VfsNodeProxy::cast(root) != nullptr && fsNodeRead(root, FS_NODE_ID, 0, &id, sizeof(id), nullptr) == E_OK)
+    TerminalHelpers::int2str(identifier, id);
+  fsNodeFree(root);
+
   env()["PWD"] = path;
+  env()["PWD_ID"] = identifier;
   return E_OK;
 }
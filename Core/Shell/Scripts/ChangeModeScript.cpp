@@ -5,8 +5,7 @@
  */
 
 #include "Shell/Scripts/ChangeModeScript.hpp"
-#include "Shell/Settings.hpp"
-#include <xcore/fs/utils.h>
+#include "Shell/ShellHelpers.hpp"
 
 const std::array<ArgParser::Descriptor, 4> ChangeModeScript::descriptors{
     {
@@ -51,10 +50,7 @@ void ChangeModeScript::changeEntryMode(const char *positionalArgument)
   if (m_result != E_OK)
     return;
 
-  char path[Settings::PWD_LENGTH];
-  fsJoinPaths(path, env()["PWD"], positionalArgument);
-
-  FsNode * const node = fsOpenNode(fs(), path);
+  FsNode * const node = ShellHelpers::openNode(fs(), env(), positionalArgument);
   if (node == nullptr)
   {
     tty() << name() << ": " << positionalArgument << ": node not found" << Terminal::EOL;
@@ -87,9 +87,37 @@ private:
 
     // TODO Check whether the destination is an existing directory
 
-    // Open the destination node
-    Result res;
-    FsNode * const dstNode = ShellHelpers::openSink(fs(), env(), time(), dst, true, &res);
+    // Destination is truncated before the source is read, a node is not copied onto itself
+    FsNode * const existingNode = ShellHelpers::openNode(fs(), env(), dst);
+    if (existingNode != nullptr)
+    {
+      const bool same = ShellHelpers::isSameNode(srcNode, existingNode);
+
+      fsNodeFree(existingNode);
+
+      if (same)
+      {
+        tty() << name() << ": " << src << " and " << dst << " are the same node" << Terminal::EOL;
+        fsNodeFree(srcNode);
+        return E_VALUE;
+      }
+    }
+
+    // Share data between in-memory nodes instead of copying
+    Result res = ShellHelpers::cloneNode(fs(), env(), time(), srcNode, dst);
+    if (res == E_OK)
+    {
+      fsNodeFree(srcNode);
+      return E_OK;
+    }
+
+    // Open the destination node, length of the source is used as a size hint
+    FsLength length;
+
+    if (fsNodeLength(srcNode, FS_NODE_DATA, &length) != E_OK)
+      length = 0;
+
+    FsNode * const dstNode = ShellHelpers::openSink(fs(), env(), time(), dst, true, &res, 0, length);
     if (dstNode == nullptr)
     {
       tty() << name() << ": " << dst << ": open failed" << Terminal::EOL;
@@ -97,12 +125,12 @@ private:
       return res;
     }
 
-    // Copy data
+    // Copy data, one half of the buffer is written while the other half is read from asynchronous sources
     uint8_t buffer[BUFFER_SIZE];
     FsLength pos = 0;
 
-    res = read(buffer, srcNode, BUFFER_SIZE, 0, 0,
-        [this, dstNode, &pos](const void *buf, size_t len){ return onDataRead(dstNode, &pos, buf, len); });
+    res = read(buffer, srcNode, BUFFER_SIZE / 2, 0, 0,
+        [this, dstNode, &pos](const void *buf, size_t len){ return onDataRead(dstNode, &pos, buf, len); }, 2);
 
     fsNodeFree(dstNode);
     fsNodeFree(srcNode);
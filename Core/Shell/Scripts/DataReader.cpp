@@ -5,6 +5,9 @@
  */
 
 #include "Shell/Scripts/DataReader.hpp"
+#include "Vfs/Vfs.hpp"
+#include <algorithm>
+#include <array>
 
 DataReader::DataReader(Script *parent, ArgumentIterator firstArgument, ArgumentIterator lastArgument) :
   ShellScript{parent, firstArgument, lastArgument},
@@ -51,15 +54,28 @@ bool DataReader::isTerminateRequested()
 }
 
 Result DataReader::read(void *buffer, FsNode *src, size_t blockSize, size_t blockCount, size_t skipBlocks,
-    std::function<Result (const void *, size_t)> callback)
+    std::function<Result (const void *, size_t)> callback, size_t bufferBlocks)
 {
+  if (bufferBlocks > 1)
+  {
+    const Result res = readQueued(buffer, src, blockSize, blockCount, skipBlocks, callback,
+        std::min(bufferBlocks, QUEUE_DEPTH));
+
+    // Source without asynchronous access is read block by block
+    if (res != E_INVALID)
+      return res;
+  }
+
   FsLength srcPosition = static_cast<FsLength>(blockSize) * skipBlocks;
   size_t blocks = 0;
+  bool mappable = true;
   Result res = E_OK;
 
   // Copy file content
   while (!blockCount || blocks++ < blockCount)
   {
+    VfsNode::Mapping mapping{nullptr, blockSize, nullptr, nullptr};
+    const void *data = buffer;
     size_t bytesRead;
 
     if (isTerminateRequested())
@@ -68,7 +84,33 @@ Result DataReader::read(void *buffer, FsNode *src, size_t blockSize, size_t bloc
       break;
     }
 
-    res = fsNodeRead(src, FS_NODE_DATA, srcPosition, buffer, blockSize, &bytesRead);
+    if (mappable)
+    {
+      // Data of in-memory nodes is passed to the callback without copying
+      res = fsNodeRead(src, static_cast<FsFieldType>(VfsNode::VFS_NODE_MAP), srcPosition, &mapping, sizeof(mapping),
+          nullptr);
+
+      if (res == E_OK && mapping.length < blockSize)
+      {
+        // Mapping is clamped to a fragment of the node, blocks are read into the buffer instead
+        mapping.unmap(mapping.token);
+        mapping.unmap = nullptr;
+        mappable = false;
+      }
+      else if (res == E_OK)
+      {
+        data = mapping.data;
+        bytesRead = mapping.length;
+      }
+      else if (res == E_INVALID || res == E_ADDRESS)
+      {
+        // Blocks of fragmented nodes are not retried, the rest of the node is read into the buffer
+        mappable = false;
+      }
+    }
+
+    if (mapping.unmap == nullptr)
+      res = fsNodeRead(src, FS_NODE_DATA, srcPosition, buffer, blockSize, &bytesRead);
 
     if (res == E_EMPTY || res == E_ADDRESS)
     {
@@ -77,14 +119,18 @@ Result DataReader::read(void *buffer, FsNode *src, size_t blockSize, size_t bloc
     }
     else if (res == E_OK)
     {
-      if (bytesRead > 0)
+      const bool finished = bytesRead == 0;
+
+      if (!finished)
       {
         srcPosition += bytesRead;
-
-        if ((res = callback(buffer, bytesRead)) != E_OK)
-          break;
+        res = callback(data, bytesRead);
       }
-      else
+
+      if (mapping.unmap != nullptr)
+        mapping.unmap(mapping.token);
+
+      if (finished || res != E_OK)
         break;
     }
     else
@@ -96,3 +142,102 @@ Result DataReader::read(void *buffer, FsNode *src, size_t blockSize, size_t bloc
 
   return res;
 }
+
+Result DataReader::readQueued(void *buffer, FsNode *src, size_t blockSize, size_t blockCount, size_t skipBlocks,
+    std::function<Result (const void *, size_t)> &callback, size_t depth)
+{
+  static constexpr auto REQUEST_FIELD = static_cast<FsFieldType>(VfsNode::VFS_NODE_REQUEST);
+
+  std::array<VfsNode::Request, QUEUE_DEPTH> requests;
+  FsLength srcPosition = static_cast<FsLength>(blockSize) * skipBlocks;
+  size_t submitted = 0;
+  size_t pending = 0;
+  bool finished = false;
+  Result res = E_OK;
+
+  const auto submit = [&](VfsNode::Request *request){
+    request->length = blockSize;
+    request->write = false;
+
+    const Result submitRes = fsNodeWrite(src, REQUEST_FIELD, srcPosition, &request, sizeof(request), nullptr);
+
+    if (submitRes == E_OK)
+    {
+      srcPosition += blockSize;
+      ++submitted;
+      ++pending;
+    }
+
+    return submitRes;
+  };
+
+  // Queue of the source may be shorter than the buffer
+  for (size_t i = 0; i < depth && (!blockCount || submitted < blockCount); ++i)
+  {
+    requests[i].buffer = static_cast<uint8_t *>(buffer) + i * blockSize;
+
+    const Result submitRes = submit(&requests[i]);
+
+    if (submitRes != E_OK)
+    {
+      if (!pending)
+        return submitRes;
+      break;
+    }
+  }
+
+  // Blocks are returned in order, every submitted request is collected before the buffer is released
+  while (pending)
+  {
+    VfsNode::Request *request;
+    const Result completeRes = fsNodeRead(src, REQUEST_FIELD, 0, &request, sizeof(request), nullptr);
+
+    if (completeRes != E_OK)
+    {
+      res = completeRes;
+      break;
+    }
+
+    --pending;
+
+    if (finished)
+      continue;
+
+    if (isTerminateRequested())
+    {
+      res = E_TIMEOUT;
+      finished = true;
+    }
+    else if (request->status == E_EMPTY || request->status == E_ADDRESS
+        || (request->status == E_OK && !request->count))
+    {
+      finished = true;
+    }
+    else if (request->status != E_OK)
+    {
+      tty() << "read error at " << request->position << Terminal::EOL;
+      res = request->status;
+      finished = true;
+    }
+    else
+    {
+      res = callback(request->buffer, request->count);
+
+      // Short block is the last one
+      if (res != E_OK || request->count < request->length)
+        finished = true;
+      else if (!blockCount || submitted < blockCount)
+      {
+        const Result submitRes = submit(request);
+
+        if (submitRes != E_OK)
+        {
+          res = submitRes;
+          finished = true;
+        }
+      }
+    }
+  }
+
+  return res;
+}
@@ -14,6 +14,9 @@
 class DataReader: public ShellScript
 {
 public:
+  // Maximum number of read requests kept in flight
+  static constexpr size_t QUEUE_DEPTH{8};
+
   DataReader(Script *, ArgumentIterator, ArgumentIterator);
   virtual Result onEventReceived(const ScriptEvent *) override;
 
@@ -21,7 +24,13 @@ protected:
   Os::Semaphore m_semaphore;
 
   bool isTerminateRequested();
-  Result read(void *, FsNode *, size_t, size_t, size_t, std::function<Result (const void *, size_t)>);
+  // Buffer holds the given number of blocks, sources with asynchronous access are read ahead of the callback
+  Result read(void *, FsNode *, size_t, size_t, size_t, std::function<Result (const void *, size_t)>,
+      size_t = 1);
+
+private:
+  Result readQueued(void *, FsNode *, size_t, size_t, size_t, std::function<Result (const void *, size_t)> &,
+      size_t);
 };
 
 #endif // VFS_SHELL_CORE_SHELL_SCRIPTS_DATAREADER_HPP_
@@ -10,6 +10,8 @@
 #include "Shell/ArgParser.hpp"
 #include "Shell/Scripts/DataReader.hpp"
 #include "Shell/ShellHelpers.hpp"
+#include "Vfs/VfsDataNode.hpp"
+#include <cstring>
 
 template<size_t BUFFER_SIZE>
 class DirectDataScript: public DataReader
@@ -28,6 +30,7 @@ public:
         {"--if", "FILE", "read from FILE", 1, Arguments::srcSetter},
         {"--of", "FILE", "write to FILE", 1, Arguments::dstSetter},
         {"--bs", "BYTES", "read and write up to BYTES at a time", 1, Arguments::bsSetter},
+        {"--conv", "CONV", "convert the file, CONV is sparse", 1, Arguments::convSetter},
         {"--count", "N", "copy only N input blocks", 1, Arguments::countSetter},
         {"--seek", "N", "skip N blocks at start of output", 1, Arguments::seekSetter},
         {"--skip", "N", "skip N blocks at start of input", 1, Arguments::skipSetter}
@@ -61,6 +64,13 @@ public:
       tty() << name() << ": block size is too big: " << arguments.bs << ", available " << BUFFER_SIZE << Terminal::EOL;
       return E_VALUE;
     }
+    else if (arguments.conv != nullptr && strcmp(arguments.conv, "sparse"))
+    {
+      tty() << name() << ": invalid conversion: " << arguments.conv << Terminal::EOL;
+      return E_VALUE;
+    }
+
+    const bool sparse = arguments.conv != nullptr;
 
     // Open the source node
     FsNode * const src = ShellHelpers::openSource(fs(), env(), arguments.src);
@@ -70,9 +80,28 @@ public:
       return E_ENTRY;
     }
 
-    // Open the destination node
+    FsLength pos = static_cast<FsLength>(arguments.seek) * arguments.bs;
+    FsLength end = pos;
+    FsLength hint = 0;
+
+    // Storage is not reserved for sparse output, zero blocks are skipped instead of being written
+    if (!sparse && arguments.count > 0)
+    {
+      // Hint ends with the written range, extent nodes do not allocate blocks before the seek position
+      hint = pos + static_cast<FsLength>(arguments.count) * arguments.bs;
+    }
+    else if (!sparse)
+    {
+      const FsLength skipped = static_cast<FsLength>(arguments.skip) * arguments.bs;
+      FsLength length;
+
+      if (fsNodeLength(src, FS_NODE_DATA, &length) == E_OK && length > skipped)
+        hint = pos + (length - skipped);
+    }
+
+    // Open the destination node, output data is allocated at once when the expected length is known
     Result res;
-    FsNode * const dst = ShellHelpers::openSink(fs(), env(), time(), arguments.dst, true, &res);
+    FsNode * const dst = ShellHelpers::openSink(fs(), env(), time(), arguments.dst, true, &res, pos, hint);
     if (dst == nullptr)
     {
       tty() << name() << ": " << arguments.dst << ": open failed" << Terminal::EOL;
@@ -80,12 +109,23 @@ public:
       return res;
     }
 
-    // Copy data
+    // Copy data, blocks smaller than the buffer are read from asynchronous sources while the output is written
     uint8_t buffer[BUFFER_SIZE];
-    FsLength pos = static_cast<FsLength>(arguments.seek) * arguments.bs;
 
     res = read(buffer, src, arguments.bs, arguments.count, arguments.skip, std::bind(&DirectDataScript::onDataRead,
-        this, dst, &pos, std::placeholders::_1, std::placeholders::_2));
+        this, dst, sparse, &pos, &end, std::placeholders::_1, std::placeholders::_2),
+        arguments.bs ? BUFFER_SIZE / arguments.bs : 1);
+
+    FsLength length;
+
+    if (res == E_OK && end < pos && fsNodeLength(dst, FS_NODE_DATA, &length) == E_OK && length < pos)
+    {
+      // Output ends with a skipped block, write the last byte to extend the node
+      static const uint8_t zero{0};
+      FsLength last = pos - 1;
+
+      res = onDataRead(dst, false, &last, &end, &zero, sizeof(zero));
+    }
 
     fsNodeFree(dst);
     fsNodeFree(src);
@@ -103,6 +143,7 @@ private:
   {
     const char *src{nullptr};
     const char *dst{nullptr};
+    const char *conv{nullptr};
     size_t bs{BUFFER_SIZE};
     size_t count{0};
     size_t seek{0};
@@ -124,6 +165,11 @@ private:
       static_cast<Arguments *>(object)->bs = static_cast<size_t>(atol(argument));
     }
 
+    static void convSetter(void *object, const char *argument)
+    {
+      static_cast<Arguments *>(object)->conv = argument;
+    }
+
     static void countSetter(void *object, const char *argument)
     {
       static_cast<Arguments *>(object)->count = static_cast<size_t>(atol(argument));
@@ -145,8 +191,16 @@ private:
     }
   };
 
-  Result onDataRead(FsNode *dst, FsLength *position, const void *buffer, size_t bytesRead)
+  Result onDataRead(FsNode *dst, bool sparse, FsLength *position, FsLength *end, const void *buffer,
+      size_t bytesRead)
   {
+    if (sparse && VfsDataNode::isZeroFilled(buffer, bytesRead))
+    {
+      // Seek over the block instead of writing it
+      *position += bytesRead;
+      return E_OK;
+    }
+
     size_t bytesWritten;
     Result res = fsNodeWrite(dst, FS_NODE_DATA, *position, buffer, bytesRead, &bytesWritten);
 
@@ -158,7 +212,10 @@ private:
         res = E_FULL;
     }
     else
+    {
       *position += bytesWritten;
+      *end = *position;
+    }
 
     return res;
   }
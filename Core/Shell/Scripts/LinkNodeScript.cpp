@@ -0,0 +1,71 @@
+/*
+ * LinkNodeScript.cpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "Shell/ArgParser.hpp"
+#include "Shell/Scripts/LinkNodeScript.hpp"
+#include "Shell/ShellHelpers.hpp"
+
+LinkNodeScript::LinkNodeScript(Script *parent, ArgumentIterator firstArgument, ArgumentIterator lastArgument) :
+  ShellScript{parent, firstArgument, lastArgument}
+{
+}
+
+Result LinkNodeScript::run()
+{
+  static const ArgParser::Descriptor descriptors[] = {
+      {"--help", nullptr, "show this help message and exit", 0, Arguments::helpSetter},
+      {nullptr, "SRC", "existing file", 1, Arguments::srcSetter},
+      {nullptr, "DST", "name of the new link", 1, Arguments::dstSetter}
+  };
+
+  bool argumentsParsed;
+  const Arguments arguments = ArgParser::parse<Arguments>(m_firstArgument, m_lastArgument,
+      std::cbegin(descriptors), std::cend(descriptors), &argumentsParsed);
+
+  if (arguments.help)
+  {
+    ArgParser::help(tty(), name(), std::cbegin(descriptors), std::cend(descriptors));
+    return E_OK;
+  }
+  else if (argumentsParsed && arguments.dst != nullptr)
+  {
+    return linkNode(arguments.src, arguments.dst);
+  }
+  else
+  {
+    tty() << name() << ": missing destination file operand" << Terminal::EOL;
+    return E_VALUE;
+  }
+}
+
+Result LinkNodeScript::linkNode(const char *src, const char *dst)
+{
+  FsNode * const srcNode = ShellHelpers::openNode(fs(), env(), src);
+  if (srcNode == nullptr)
+  {
+    tty() << name() << ": " << src << ": node not found" << Terminal::EOL;
+    return E_ENTRY;
+  }
+
+  Result res;
+
+  // Directories are attached with mount --bind
+  if (fsNodeLength(srcNode, FS_NODE_DATA, nullptr) != E_OK)
+  {
+    tty() << name() << ": " << src << ": hard link not allowed for directory" << Terminal::EOL;
+    res = E_VALUE;
+  }
+  else if ((res = ShellHelpers::linkNode(fs(), env(), time(), srcNode, dst)) != E_OK)
+  {
+    if (res == E_EXIST)
+      tty() << name() << ": " << dst << ": node already exists" << Terminal::EOL;
+    else
+      tty() << name() << ": " << dst << ": link creation failed" << Terminal::EOL;
+  }
+
+  fsNodeFree(srcNode);
+  return res;
+}
@@ -0,0 +1,49 @@
+/*
+ * Core/Shell/Scripts/LinkNodeScript.hpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#ifndef VFS_SHELL_CORE_SHELL_SCRIPTS_LINKNODESCRIPT_HPP_
+#define VFS_SHELL_CORE_SHELL_SCRIPTS_LINKNODESCRIPT_HPP_
+
+#include "Shell/ShellScript.hpp"
+
+class LinkNodeScript: public ShellScript
+{
+public:
+  LinkNodeScript(Script *, ArgumentIterator, ArgumentIterator);
+  virtual Result run() override;
+
+  static const char *name()
+  {
+    return "ln";
+  }
+
+private:
+  struct Arguments
+  {
+    const char *src{nullptr};
+    const char *dst{nullptr};
+    bool help{false};
+
+    static void dstSetter(void *object, const char *argument)
+    {
+      static_cast<Arguments *>(object)->dst = argument;
+    }
+
+    static void helpSetter(void *object, const char *)
+    {
+      static_cast<Arguments *>(object)->help = true;
+    }
+
+    static void srcSetter(void *object, const char *argument)
+    {
+      static_cast<Arguments *>(object)->src = argument;
+    }
+  };
+
+  Result linkNode(const char *, const char *);
+};
+
+#endif // VFS_SHELL_CORE_SHELL_SCRIPTS_LINKNODESCRIPT_HPP_
@@ -7,8 +7,8 @@
 #include "Shell/Scripts/ListNodesScript.hpp"
 #include "Shell/Settings.hpp"
 #include "Shell/ShellHelpers.hpp"
-#include <xcore/fs/utils.h>
 #include <xcore/realtime.h>
+#include <cstring>
 
 const std::array<ArgParser::Descriptor, 5> ListNodesScript::descriptors{
     {
@@ -121,6 +121,55 @@ Result ListNodesScript::run()
   }
 }
 
+bool ListNodesScript::printBatchedContent(FsNode *root, const char *positionalArgument)
+{
+  alignas(VfsNode::Record) uint8_t buffer[BATCH_LENGTH];
+  FsLength position = 0;
+  Result res;
+
+  while (true)
+  {
+    size_t count;
+
+    res = fsNodeRead(root, static_cast<FsFieldType>(VfsNode::VFS_NODE_ENTRIES), position,
+        buffer, sizeof(buffer), &count);
+    if (res != E_OK || !count)
+      break;
+
+    for (size_t offset = 0; offset < count; ++position)
+    {
+      VfsNode::Record record;
+
+      memcpy(&record, buffer + offset, sizeof(record));
+      printNode(record, reinterpret_cast<const char *>(buffer + offset + sizeof(record)));
+      offset += record.size;
+    }
+  }
+
+  if (res == E_OK)
+  {
+    if (!position)
+      tty() << name() << ": " << positionalArgument << ": node has no descendants" << Terminal::EOL;
+  }
+  else if (res == E_VALUE)
+  {
+    // Name of the next node does not fit into the buffer
+    tty() << name() << ": " << positionalArgument << ": error reading name attribute" << Terminal::EOL;
+    m_result = E_ERROR;
+  }
+  else if (position)
+  {
+    m_result = res;
+  }
+  else
+  {
+    // Batched listing is not supported by the node
+    return false;
+  }
+
+  return true;
+}
+
 void ListNodesScript::printDirectoryContent(const char *positionalArgument)
 {
   if (m_result != E_OK)
@@ -129,10 +178,7 @@ void ListNodesScript::printDirectoryContent(const char *positionalArgument)
   if (m_arguments.nodeCount > 1)
     tty() << positionalArgument << ":" << Terminal::EOL;
 
-  char path[Settings::PWD_LENGTH];
-
-  fsJoinPaths(path, env()["PWD"], positionalArgument);
-  FsNode * const root = fsOpenNode(fs(), path);
+  FsNode * const root = ShellHelpers::openNode(fs(), env(), positionalArgument);
   if (root == nullptr)
   {
     tty() << name() << ": " << positionalArgument << ": node not found" << Terminal::EOL;
@@ -140,20 +186,27 @@ void ListNodesScript::printDirectoryContent(const char *positionalArgument)
     return;
   }
 
-  FsNode * const child = static_cast<FsNode *>(fsNodeHead(root));
-  fsNodeFree(root);
-  if (child == nullptr)
+  if (!printBatchedContent(root, positionalArgument))
   {
-    tty() << name() << ": " << positionalArgument << ": node has no descendants" << Terminal::EOL;
-    return;
+    FsNode * const child = static_cast<FsNode *>(fsNodeHead(root));
+
+    if (child != nullptr)
+      printIteratedContent(child, positionalArgument);
+    else
+      tty() << name() << ": " << positionalArgument << ": node has no descendants" << Terminal::EOL;
   }
 
+  fsNodeFree(root);
+}
+
+void ListNodesScript::printIteratedContent(FsNode *child, const char *positionalArgument)
+{
   Result res;
 
   do
   {
     char nodeName[Settings::ENTRY_NAME_LENGTH];
-    FsAccess nodeAccess;
+    VfsNode::Record record{};
 
     if ((res = fsNodeRead(child, FS_NODE_NAME, 0, nodeName, sizeof(nodeName), nullptr)) != E_OK)
     {
@@ -162,67 +215,27 @@ void ListNodesScript::printDirectoryContent(const char *positionalArgument)
       break;
     }
 
-    if ((res = fsNodeRead(child, FS_NODE_ACCESS, 0, &nodeAccess, sizeof(nodeAccess), nullptr)) != E_OK)
+    if ((res = fsNodeRead(child, FS_NODE_ACCESS, 0, &record.access, sizeof(record.access), nullptr)) != E_OK)
     {
       tty() << name() << ": " << nodeName << ": error reading access attribute" << Terminal::EOL;
       res = E_ERROR;
       break;
     }
 
-    FsIdentifier nodeId = 0;
-    fsNodeRead(child, FS_NODE_ID, 0, &nodeId, sizeof(nodeId), nullptr);
-
-    FsLength nodeDataLength = 0;
-    fsNodeLength(child, FS_NODE_DATA, &nodeDataLength);
-
-    time64_t nodeTime = 0;
-    fsNodeRead(child, FS_NODE_TIME, 0, &nodeTime, sizeof(nodeTime), nullptr);
+    fsNodeRead(child, FS_NODE_ID, 0, &record.id, sizeof(record.id), nullptr);
+    fsNodeLength(child, FS_NODE_DATA, &record.length);
+    fsNodeRead(child, FS_NODE_TIME, 0, &record.time, sizeof(record.time), nullptr);
 
     // Get information about child nodes
     FsNode * const firstDescendant = static_cast<FsNode *>(fsNodeHead(child));
-    bool hasDescendants = false;
 
     if (firstDescendant)
     {
-      hasDescendants = true;
+      record.directory = true;
       fsNodeFree(firstDescendant);
     }
 
-    if (m_arguments.longListing)
-    {
-      const auto format = tty().format();
-      const auto width = tty().width();
-
-      // Print inode value
-      if (m_arguments.showInodes)
-        tty() << Terminal::Width{16} << Terminal::Format::HEX << nodeId << Terminal::Width{1} << Terminal::Format::DEC;
-
-      // Print access flags
-      tty() << " " << HumanReadableAccess{nodeAccess, hasDescendants};
-
-      // Print node size
-      tty() << " ";
-      if (m_arguments.humanReadable)
-        tty() << Terminal::Width{8} << HumanReadableLength{nodeDataLength} << Terminal::Width{1};
-      else
-        tty() << Terminal::Width{10} << nodeDataLength << Terminal::Width{1};
-
-      // Date and time
-      tty() << " " << HumanReadableTime{nodeTime};
-
-      tty() << " ";
-      if (hasDescendants)
-        tty() << Terminal::BOLD << Terminal::Color::BLUE << nodeName << Terminal::RESET;
-      else
-        tty() << nodeName;
-
-      tty() << Terminal::EOL;
-      tty() << format << width;
-    }
-    else
-    {
-      tty() << nodeName << Terminal::EOL;
-    }
+    printNode(record, nodeName);
   }
   while ((res = fsNodeNext(child)) == E_OK);
 
@@ -231,3 +244,42 @@ void ListNodesScript::printDirectoryContent(const char *positionalArgument)
   if (res != E_ENTRY)
     m_result = res;
 }
+
+void ListNodesScript::printNode(const VfsNode::Record &record, const char *nodeName)
+{
+  if (m_arguments.longListing)
+  {
+    const auto format = tty().format();
+    const auto width = tty().width();
+
+    // Print inode value
+    if (m_arguments.showInodes)
+      tty() << Terminal::Width{16} << Terminal::Format::HEX << record.id << Terminal::Width{1} << Terminal::Format::DEC;
+
+    // Print access flags
+    tty() << " " << HumanReadableAccess{record.access, record.directory};
+
+    // Print node size
+    tty() << " ";
+    if (m_arguments.humanReadable)
+      tty() << Terminal::Width{8} << HumanReadableLength{record.length} << Terminal::Width{1};
+    else
+      tty() << Terminal::Width{10} << record.length << Terminal::Width{1};
+
+    // Date and time
+    tty() << " " << HumanReadableTime{record.time};
+
+    tty() << " ";
+    if (record.directory)
+      tty() << Terminal::BOLD << Terminal::Color::BLUE << nodeName << Terminal::RESET;
+    else
+      tty() << nodeName;
+
+    tty() << Terminal::EOL;
+    tty() << format << width;
+  }
+  else
+  {
+    tty() << nodeName << Terminal::EOL;
+  }
+}
@@ -9,6 +9,7 @@
 
 #include "Shell/ArgParser.hpp"
 #include "Shell/ShellScript.hpp"
+#include "Vfs/Vfs.hpp"
 #include <array>
 
 class ListNodesScript: public ShellScript
@@ -77,10 +78,16 @@ private:
     }
   };
 
+  // Buffer for a batch of node attributes
+  static constexpr size_t BATCH_LENGTH{512};
+
   const Arguments m_arguments;
   Result m_result;
 
+  bool printBatchedContent(FsNode *, const char *);
   void printDirectoryContent(const char *);
+  void printIteratedContent(FsNode *, const char *);
+  void printNode(const VfsNode::Record &, const char *);
 
   static const std::array<ArgParser::Descriptor, 5> descriptors;
 };
@@ -0,0 +1,96 @@
+/*
+ * LoadImageScript.cpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "Shell/Scripts/LoadImageScript.hpp"
+#include "Shell/ShellHelpers.hpp"
+#include "Vfs/VfsImage.hpp"
+
+const std::array<ArgParser::Descriptor, 3> LoadImageScript::descriptors{
+    {
+        {"--help", nullptr, "show this help message and exit", 0, Arguments::helpSetter},
+        {nullptr, "IMAGE", "image file to load", 1, Arguments::imageSetter},
+        {nullptr, "DIR", "directory for restored nodes", 1, Arguments::directorySetter}
+    }
+};
+
+LoadImageScript::LoadImageScript(Script *parent, ArgumentIterator firstArgument, ArgumentIterator lastArgument) :
+  ShellScript{parent, firstArgument, lastArgument}
+{
+}
+
+Result LoadImageScript::run()
+{
+  bool argumentsParsed;
+  const Arguments arguments = ArgParser::parse<Arguments>(m_firstArgument, m_lastArgument,
+      descriptors.cbegin(), descriptors.cend(), &argumentsParsed);
+
+  if (arguments.help)
+  {
+    ArgParser::help(tty(), name(), descriptors.cbegin(), descriptors.cend());
+    return E_OK;
+  }
+  else if (argumentsParsed)
+  {
+    return loadImage(arguments.image, arguments.directory);
+  }
+  else
+  {
+    tty() << name() << ": missing directory operand" << Terminal::EOL;
+    return E_VALUE;
+  }
+}
+
+Result LoadImageScript::loadImage(const char *path, const char *directory)
+{
+  FsNode * const source = ShellHelpers::openSource(fs(), env(), path);
+  if (source == nullptr)
+  {
+    tty() << name() << ": " << path << ": node not found" << Terminal::EOL;
+    return E_ENTRY;
+  }
+
+  // Image is read into memory once, restored data nodes share that memory
+  VfsImage * const image = VfsImage::load(source);
+  fsNodeFree(source);
+
+  if (image == nullptr)
+  {
+    tty() << name() << ": " << path << ": read failed" << Terminal::EOL;
+    return E_MEMORY;
+  }
+
+  FsNode * const destination = ShellHelpers::openNode(fs(), env(), directory);
+  Result res = E_ENTRY;
+
+  if (destination != nullptr)
+  {
+    res = image->restore(destination);
+    fsNodeFree(destination);
+
+    if (res != E_OK)
+      tty() << name() << ": " << path << ": restore failed" << Terminal::EOL;
+  }
+  else
+    tty() << name() << ": " << directory << ": node not found" << Terminal::EOL;
+
+  image->release();
+  return res;
+}
+
+void LoadImageScript::Arguments::directorySetter(void *object, const char *argument)
+{
+  static_cast<Arguments *>(object)->directory = argument;
+}
+
+void LoadImageScript::Arguments::helpSetter(void *object, const char *)
+{
+  static_cast<Arguments *>(object)->help = true;
+}
+
+void LoadImageScript::Arguments::imageSetter(void *object, const char *argument)
+{
+  static_cast<Arguments *>(object)->image = argument;
+}
@@ -0,0 +1,42 @@
+/*
+ * Core/Shell/Scripts/LoadImageScript.hpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#ifndef VFS_SHELL_CORE_SHELL_SCRIPTS_LOADIMAGESCRIPT_HPP_
+#define VFS_SHELL_CORE_SHELL_SCRIPTS_LOADIMAGESCRIPT_HPP_
+
+#include "Shell/ArgParser.hpp"
+#include "Shell/ShellScript.hpp"
+#include <array>
+
+class LoadImageScript: public ShellScript
+{
+public:
+  LoadImageScript(Script *, ArgumentIterator, ArgumentIterator);
+  virtual Result run() override;
+
+  static const char *name()
+  {
+    return "load";
+  }
+
+private:
+  struct Arguments
+  {
+    const char *image{nullptr};
+    const char *directory{nullptr};
+    bool help{false};
+
+    static void directorySetter(void *, const char *);
+    static void helpSetter(void *, const char *);
+    static void imageSetter(void *, const char *);
+  };
+
+  Result loadImage(const char *, const char *);
+
+  static const std::array<ArgParser::Descriptor, 3> descriptors;
+};
+
+#endif // VFS_SHELL_CORE_SHELL_SCRIPTS_LOADIMAGESCRIPT_HPP_
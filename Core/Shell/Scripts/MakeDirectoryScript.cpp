@@ -49,10 +49,10 @@ Result MakeDirectoryScript::makeDirectory(const char *positionalArgument)
   char absolutePath[Settings::PWD_LENGTH];
   fsJoinPaths(absolutePath, env()["PWD"], positionalArgument);
 
-  FsNode * const root = fsOpenBaseNode(fs(), absolutePath);
+  FsNode * const root = ShellHelpers::openBaseNode(fs(), absolutePath);
   if (root != nullptr)
   {
-    FsNode * const node = fsOpenNode(fs(), absolutePath);
+    FsNode * const node = ShellHelpers::openNode(fs(), absolutePath);
     if (node == nullptr)
     {
       const char * const nodeName = fsExtractName(positionalArgument);
@@ -10,7 +10,11 @@
 #include "Shell/ArgParser.hpp"
 #include "Shell/Interfaces/InterfaceProxy.hpp"
 #include "Shell/Scripts/MountScriptBase.hpp"
+#include "Shell/ShellHelpers.hpp"
+#include "Shell/TerminalHelpers.hpp"
 #include "Vfs/Vfs.hpp"
+#include <cctype>
+#include <cstring>
 
 class MockMountInterfaceBuilder
 {
@@ -40,6 +44,10 @@ public:
   {
     static const ArgParser::Descriptor descriptors[] = {
         {"--help", nullptr, "show this help message and exit", 0, Arguments::helpSetter},
+        {"--bind", nullptr, "attach the directory DEVICE at another place", 0, Arguments::bindSetter},
+        {"--cache", "SECTORS", "number of cached device sectors, 0 disables the cache", 1, Arguments::cacheSetter},
+        {"--write-back", nullptr, "keep written sectors in the cache until sync or unmount", 0,
+            Arguments::writeBackSetter},
         {nullptr, "DEVICE", "search the device for a filesystem", 1, Arguments::deviceSetter},
         {nullptr, "DIR", "attach a filesystem at the specified directory", 1, Arguments::directorySetter}
     };
@@ -57,11 +65,20 @@ public:
     {
       return E_VALUE;
     }
+    else if (arguments.invalid)
+    {
+      tty() << name() << ": invalid cache size" << Terminal::EOL;
+      return E_VALUE;
+    }
+    else if (arguments.bind)
+    {
+      return bind(arguments.device, arguments.directory);
+    }
 
     char path[Settings::PWD_LENGTH];
     fsJoinPaths(path, env()["PWD"], arguments.device);
 
-    FsNode * const device = fsOpenNode(fs(), path);
+    FsNode * const device = ShellHelpers::openNode(fs(), path);
     if (device == nullptr)
     {
       tty() << name() << ": " << arguments.device << ": node not found" << Terminal::EOL;
@@ -85,7 +102,7 @@ public:
     Interface * const interface = T::build(base);
 
     if (interface != nullptr)
-      res = mount(arguments.directory, interface);
+      res = mount(arguments.directory, interface, arguments.sectors, arguments.writeBack);
     else
       res = E_INTERFACE;
 
@@ -102,7 +119,27 @@ private:
   {
     const char *device{nullptr};
     const char *directory{nullptr};
+    size_t sectors{CACHE_SECTORS};
+    bool bind{false};
     bool help{false};
+    bool invalid{false};
+    bool writeBack{false};
+
+    static void bindSetter(void *object, const char *)
+    {
+      static_cast<Arguments *>(object)->bind = true;
+    }
+
+    static void cacheSetter(void *object, const char *argument)
+    {
+      auto args = static_cast<Arguments *>(object);
+      const size_t length = strlen(argument);
+      size_t converted = 0;
+
+      args->sectors = TerminalHelpers::str2int<size_t>(argument, length, &converted);
+      // Signs, spaces and trailing characters are rejected
+      args->invalid = !length || !isdigit(static_cast<unsigned char>(argument[0])) || converted != length;
+    }
 
     static void deviceSetter(void *object, const char *argument)
     {
@@ -118,6 +155,11 @@ private:
     {
       static_cast<Arguments *>(object)->help = true;
     }
+
+    static void writeBackSetter(void *object, const char *)
+    {
+      static_cast<Arguments *>(object)->writeBack = true;
+    }
   };
 };
 
@@ -5,36 +5,82 @@
  */
 
 #include "Shell/Scripts/MountScriptBase.hpp"
+#include "Shell/Interfaces/InterfaceCache.hpp"
 #include "Shell/Settings.hpp"
 #include "Shell/ShellHelpers.hpp"
 #include "Vfs/VfsMountpoint.hpp"
 #include <xcore/fs/utils.h>
 #include <yaf/fat32.h>
-#include <new>
 
 MountScriptBase::MountScriptBase(Script *parent, ArgumentIterator firstArgument, ArgumentIterator lastArgument) :
   ShellScript{parent, firstArgument, lastArgument}
 {
 }
 
-Result MountScriptBase::mount(const char *dst, Interface *interface)
+Result MountScriptBase::bind(const char *src, const char *dst)
+{
+  FsNode * const source = ShellHelpers::openNode(fs(), env(), src);
+  if (source == nullptr)
+  {
+    tty() << name() << ": " << src << ": node not found" << Terminal::EOL;
+    return E_ENTRY;
+  }
+
+  Result res;
+
+  // Data nodes are shared with ln
+  if (fsNodeLength(source, FS_NODE_DATA, nullptr) == E_OK)
+  {
+    tty() << name() << ": " << src << ": not a directory" << Terminal::EOL;
+    res = E_VALUE;
+  }
+  else if ((res = ShellHelpers::linkNode(fs(), env(), time(), source, dst)) != E_OK)
+  {
+    tty() << name() << ": mount failed" << Terminal::EOL;
+  }
+
+  fsNodeFree(source);
+  return res;
+}
+
+Result MountScriptBase::mount(const char *dst, Interface *interface, size_t sectors, bool writeBack)
 {
   char path[Settings::PWD_LENGTH];
   fsJoinPaths(path, env()["PWD"], dst);
 
-  // Create FAT32 handle
-  const Fat32Config config{interface, 4, 2};
+  if (sectors)
+  {
+    const InterfaceCache::Config cacheConfig{
+        interface,
+        sectors,
+        writeBack ? InterfaceCache::Policy::WRITE_BACK : InterfaceCache::Policy::WRITE_THROUGH
+    };
+    Interface * const cache = static_cast<Interface *>(init(InterfaceCache, &cacheConfig));
+
+    if (cache == nullptr)
+    {
+      tty() << name() << ": cache allocation failed" << Terminal::EOL;
+
+      deinit(interface);
+      return E_MEMORY;
+    }
+
+    // Device is released together with the cache
+    interface = cache;
+  }
+
+  // Create FAT32 handle, node pool also covers nodes kept open by the mountpoint
+  const Fat32Config config{interface, 4 + VfsMountpoint::RESERVED_NODES, 2};
   FsHandle * const partition = static_cast<FsHandle *>(init(FatHandle, &config));
 
   if (partition != nullptr)
   {
     // Create VFS node
-    const auto mountpoint = static_cast<VfsMountpoint *>(malloc(sizeof(VfsMountpoint)));
+    const auto mountpoint = new VfsMountpoint{partition, interface, time().getTime()};
     Result res;
 
     if (mountpoint != nullptr)
     {
-      new (mountpoint) VfsMountpoint{partition, interface, time().getTime()};
       res = ShellHelpers::injectNode(fs(), mountpoint, path);
 
       if (res != E_OK)
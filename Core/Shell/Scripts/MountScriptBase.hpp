@@ -21,7 +21,13 @@ public:
   }
 
 protected:
-  Result mount(const char *, Interface *);
+  // Default number of cached sectors of a mounted device
+  static constexpr size_t CACHE_SECTORS{16};
+
+  // Directory is shared at another place, contents are not copied
+  Result bind(const char *, const char *);
+  // Sector cache is placed between the file system and the device when the number of sectors is not zero
+  Result mount(const char *, Interface *, size_t = 0, bool = false);
 };
 
 #endif // VFS_SHELL_CORE_SHELL_SCRIPTS_MOUNTSCRIPTBASE_HPP_
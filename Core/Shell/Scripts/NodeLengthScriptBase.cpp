@@ -0,0 +1,76 @@
+/*
+ * NodeLengthScriptBase.cpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "Shell/Scripts/NodeLengthScriptBase.hpp"
+#include "Shell/ShellHelpers.hpp"
+#include "Shell/TerminalHelpers.hpp"
+#include <cctype>
+#include <cstring>
+
+NodeLengthScriptBase::NodeLengthScriptBase(Script *parent, ArgumentIterator firstArgument,
+    ArgumentIterator lastArgument) :
+  ShellScript{parent, firstArgument, lastArgument}
+{
+}
+
+Result NodeLengthScriptBase::check(const char *script, const Arguments &arguments, const char *operand)
+{
+  if (!arguments.parsed)
+  {
+    tty() << script << ": missing " << operand << " operand" << Terminal::EOL;
+    return E_VALUE;
+  }
+  else if (arguments.invalid)
+  {
+    tty() << script << ": invalid " << operand << " operand" << Terminal::EOL;
+    return E_VALUE;
+  }
+  else if (!arguments.count)
+    return E_VALUE;
+  else
+    return E_OK;
+}
+
+Result NodeLengthScriptBase::writeLength(const char *script, const char *path, FsFieldType type,
+    FsLength length, const char *operation)
+{
+  FsNode * const node = ShellHelpers::openNode(fs(), env(), path);
+  if (node == nullptr)
+  {
+    tty() << script << ": " << path << ": node not found" << Terminal::EOL;
+    return E_ENTRY;
+  }
+
+  const Result res = fsNodeWrite(node, type, 0, &length, sizeof(length), nullptr);
+  fsNodeFree(node);
+
+  if (res != E_OK)
+    tty() << script << ": " << path << ": " << operation << " failed" << Terminal::EOL;
+
+  return res;
+}
+
+void NodeLengthScriptBase::Arguments::helpSetter(void *object, const char *)
+{
+  static_cast<Arguments *>(object)->help = true;
+}
+
+void NodeLengthScriptBase::Arguments::incrementNodeCount(void *object, const char *)
+{
+  ++static_cast<Arguments *>(object)->count;
+}
+
+void NodeLengthScriptBase::Arguments::lengthSetter(void *object, const char *argument)
+{
+  auto args = static_cast<Arguments *>(object);
+  const size_t length = strlen(argument);
+  size_t converted = 0;
+
+  args->length = TerminalHelpers::str2int<FsLength>(argument, length, &converted);
+  // Signs, spaces and trailing characters are rejected
+  args->invalid = !length || !isdigit(static_cast<unsigned char>(argument[0])) || converted != length;
+  args->parsed = true;
+}
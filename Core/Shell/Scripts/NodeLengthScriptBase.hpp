@@ -0,0 +1,37 @@
+/*
+ * Core/Shell/Scripts/NodeLengthScriptBase.hpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#ifndef VFS_SHELL_CORE_SHELL_SCRIPTS_NODELENGTHSCRIPTBASE_HPP_
+#define VFS_SHELL_CORE_SHELL_SCRIPTS_NODELENGTHSCRIPTBASE_HPP_
+
+#include "Shell/ShellScript.hpp"
+
+class NodeLengthScriptBase: public ShellScript
+{
+public:
+  NodeLengthScriptBase(Script *, ArgumentIterator, ArgumentIterator);
+
+protected:
+  struct Arguments
+  {
+    size_t count{0};
+    FsLength length{0};
+    bool help{false};
+    bool invalid{false};
+    bool parsed{false};
+
+    static void helpSetter(void *, const char *);
+    static void incrementNodeCount(void *, const char *);
+    static void lengthSetter(void *, const char *);
+  };
+
+  // Length operand should be present and contain only digits of a number
+  Result check(const char *, const Arguments &, const char *);
+  // Length field of the node is written, errors are reported with the description of the operation
+  Result writeLength(const char *, const char *, FsFieldType, FsLength, const char *);
+};
+
+#endif // VFS_SHELL_CORE_SHELL_SCRIPTS_NODELENGTHSCRIPTBASE_HPP_
@@ -0,0 +1,123 @@
+/*
+ * QuotaScript.cpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "Shell/Scripts/QuotaScript.hpp"
+#include "Shell/ShellHelpers.hpp"
+#include "Vfs/Vfs.hpp"
+#include <cstdlib>
+
+const std::array<ArgParser::Descriptor, 4> QuotaScript::descriptors{
+    {
+        {"--help", nullptr, "show this help message and exit", 0, Arguments::helpSetter},
+        {"--size", "BYTES", "limit memory used by the directory, 0 removes the limit", 1, Arguments::bytesSetter},
+        {"--nodes", "N", "limit number of nodes in the directory, 0 removes the limit", 1, Arguments::nodesSetter},
+        {nullptr, "DIR", "show usage and limits of DIR", 0, Arguments::incrementNodeCount}
+    }
+};
+
+QuotaScript::QuotaScript(Script *parent, ArgumentIterator firstArgument, ArgumentIterator lastArgument) :
+  ShellScript{parent, firstArgument, lastArgument},
+  m_arguments{ArgParser::parse<Arguments>(m_firstArgument, m_lastArgument,
+      descriptors.cbegin(), descriptors.cend())},
+  m_result{E_OK}
+{
+}
+
+Result QuotaScript::run()
+{
+  if (m_arguments.help)
+  {
+    ArgParser::help(tty(), name(), std::cbegin(descriptors), std::cend(descriptors));
+    return E_OK;
+  }
+  else if (m_arguments.count)
+  {
+    ArgParser::invoke(m_firstArgument, m_lastArgument, descriptors.cbegin(), descriptors.cend(),
+        [this](const char *key){ processEntry(key); });
+
+    return m_result;
+  }
+  else
+    return E_VALUE;
+}
+
+void QuotaScript::processEntry(const char *positionalArgument)
+{
+  static constexpr auto LIMIT_FIELD = static_cast<FsFieldType>(VfsNode::VFS_NODE_LIMIT);
+  static constexpr auto USAGE_FIELD = static_cast<FsFieldType>(VfsNode::VFS_NODE_USAGE);
+
+  if (m_result != E_OK)
+    return;
+
+  FsNode * const node = ShellHelpers::openNode(fs(), env(), positionalArgument);
+  if (node == nullptr)
+  {
+    tty() << name() << ": " << positionalArgument << ": node not found" << Terminal::EOL;
+    m_result = E_ENTRY;
+    return;
+  }
+
+  VfsNode::Usage limit{0, 0};
+  VfsNode::Usage usage{0, 0};
+  Result res;
+
+  // Limits are supported by in-memory directories only
+  res = fsNodeRead(node, LIMIT_FIELD, 0, &limit, sizeof(limit), nullptr);
+  if (res == E_OK && (m_arguments.setBytes || m_arguments.setNodes))
+  {
+    if (m_arguments.setBytes)
+      limit.bytes = m_arguments.bytes;
+    if (m_arguments.setNodes)
+      limit.nodes = m_arguments.nodes;
+
+    res = fsNodeWrite(node, LIMIT_FIELD, 0, &limit, sizeof(limit), nullptr);
+  }
+  if (res == E_OK)
+    res = fsNodeRead(node, USAGE_FIELD, 0, &usage, sizeof(usage), nullptr);
+
+  fsNodeFree(node);
+
+  if (res != E_OK)
+  {
+    tty() << name() << ": " << positionalArgument << ": quota is not supported" << Terminal::EOL;
+    m_result = res;
+    return;
+  }
+
+  tty() << positionalArgument << ": " << usage.bytes << " bytes";
+  if (limit.bytes)
+    tty() << " of " << limit.bytes;
+  tty() << ", " << usage.nodes << " nodes";
+  if (limit.nodes)
+    tty() << " of " << limit.nodes;
+  tty() << Terminal::EOL;
+}
+
+void QuotaScript::Arguments::bytesSetter(void *object, const char *argument)
+{
+  auto args = static_cast<Arguments *>(object);
+
+  args->bytes = static_cast<size_t>(atol(argument));
+  args->setBytes = true;
+}
+
+void QuotaScript::Arguments::helpSetter(void *object, const char *)
+{
+  static_cast<Arguments *>(object)->help = true;
+}
+
+void QuotaScript::Arguments::incrementNodeCount(void *object, const char *)
+{
+  ++static_cast<Arguments *>(object)->count;
+}
+
+void QuotaScript::Arguments::nodesSetter(void *object, const char *argument)
+{
+  auto args = static_cast<Arguments *>(object);
+
+  args->nodes = static_cast<size_t>(atol(argument));
+  args->setNodes = true;
+}
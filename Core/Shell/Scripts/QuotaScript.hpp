@@ -0,0 +1,49 @@
+/*
+ * Core/Shell/Scripts/QuotaScript.hpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#ifndef VFS_SHELL_CORE_SHELL_SCRIPTS_QUOTASCRIPT_HPP_
+#define VFS_SHELL_CORE_SHELL_SCRIPTS_QUOTASCRIPT_HPP_
+
+#include "Shell/ArgParser.hpp"
+#include "Shell/ShellScript.hpp"
+#include <array>
+
+class QuotaScript: public ShellScript
+{
+public:
+  QuotaScript(Script *, ArgumentIterator, ArgumentIterator);
+  virtual Result run() override;
+
+  static const char *name()
+  {
+    return "quota";
+  }
+
+private:
+  struct Arguments
+  {
+    size_t count{0};
+    size_t bytes{0};
+    size_t nodes{0};
+    bool help{false};
+    bool setBytes{false};
+    bool setNodes{false};
+
+    static void bytesSetter(void *, const char *);
+    static void helpSetter(void *, const char *);
+    static void incrementNodeCount(void *, const char *);
+    static void nodesSetter(void *, const char *);
+  };
+
+  const Arguments m_arguments;
+  Result m_result;
+
+  void processEntry(const char *);
+
+  static const std::array<ArgParser::Descriptor, 4> descriptors;
+};
+
+#endif // VFS_SHELL_CORE_SHELL_SCRIPTS_QUOTASCRIPT_HPP_
@@ -48,13 +48,13 @@ void RemoveNodesScript::removeNode(const char *positionalArgument, bool recursiv
   char absolutePath[Settings::PWD_LENGTH];
   fsJoinPaths(absolutePath, env()["PWD"], positionalArgument);
 
-  FsNode * const node = fsOpenNode(fs(), absolutePath);
+  FsNode * const node = ShellHelpers::openNode(fs(), absolutePath);
   if (node != nullptr)
   {
     // TODO Remove directories recursively
     if (recursive || fsNodeLength(node, FS_NODE_DATA, nullptr) == E_OK)
     {
-      FsNode * const root = fsOpenBaseNode(fs(), absolutePath);
+      FsNode * const root = ShellHelpers::openBaseNode(fs(), absolutePath);
       if (root != nullptr)
       {
         m_result = fsNodeRemove(root, node);
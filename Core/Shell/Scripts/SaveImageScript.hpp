@@ -0,0 +1,114 @@
+/*
+ * Core/Shell/Scripts/SaveImageScript.hpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#ifndef VFS_SHELL_CORE_SHELL_SCRIPTS_SAVEIMAGESCRIPT_HPP_
+#define VFS_SHELL_CORE_SHELL_SCRIPTS_SAVEIMAGESCRIPT_HPP_
+
+#include "Shell/ArgParser.hpp"
+#include "Shell/ShellHelpers.hpp"
+#include "Shell/ShellScript.hpp"
+#include "Vfs/VfsImage.hpp"
+
+template<size_t BUFFER_SIZE>
+class SaveImageScript: public ShellScript
+{
+public:
+  SaveImageScript(Script *parent, ArgumentIterator firstArgument, ArgumentIterator lastArgument) :
+    ShellScript{parent, firstArgument, lastArgument}
+  {
+  }
+
+  virtual Result run() override
+  {
+    static const ArgParser::Descriptor descriptors[] = {
+        {"--help", nullptr, "show this help message and exit", 0, Arguments::helpSetter},
+        {nullptr, "DIR", "directory to save", 1, Arguments::directorySetter},
+        {nullptr, "IMAGE", "destination image file", 1, Arguments::imageSetter}
+    };
+
+    bool argumentsParsed;
+    const Arguments arguments = ArgParser::parse<Arguments>(m_firstArgument, m_lastArgument,
+        std::cbegin(descriptors), std::cend(descriptors), &argumentsParsed);
+
+    if (arguments.help)
+    {
+      ArgParser::help(tty(), name(), std::cbegin(descriptors), std::cend(descriptors));
+      return E_OK;
+    }
+    else if (argumentsParsed)
+    {
+      return saveImage(arguments.directory, arguments.image);
+    }
+    else
+    {
+      tty() << name() << ": missing image operand" << Terminal::EOL;
+      return E_VALUE;
+    }
+  }
+
+  static const char *name()
+  {
+    return "save";
+  }
+
+private:
+  struct Arguments
+  {
+    const char *directory{nullptr};
+    const char *image{nullptr};
+    bool help{false};
+
+    static void directorySetter(void *object, const char *argument)
+    {
+      static_cast<Arguments *>(object)->directory = argument;
+    }
+
+    static void imageSetter(void *object, const char *argument)
+    {
+      static_cast<Arguments *>(object)->image = argument;
+    }
+
+    static void helpSetter(void *object, const char *)
+    {
+      static_cast<Arguments *>(object)->help = true;
+    }
+  };
+
+  Result saveImage(const char *directory, const char *image)
+  {
+    FsNode * const source = ShellHelpers::openNode(fs(), env(), directory);
+    if (source == nullptr)
+    {
+      tty() << name() << ": " << directory << ": node not found" << Terminal::EOL;
+      return E_ENTRY;
+    }
+
+    Result res;
+
+    FsNode * const sink = ShellHelpers::openSink(fs(), env(), time(), image, true, &res);
+    if (sink == nullptr)
+    {
+      tty() << name() << ": " << image << ": open failed" << Terminal::EOL;
+      fsNodeFree(source);
+      return res;
+    }
+
+    // Image is written sequentially, node data is copied through the buffer
+    uint8_t buffer[BUFFER_SIZE];
+
+    res = VfsImage::save(source, sink, buffer, sizeof(buffer));
+
+    fsNodeFree(sink);
+    fsNodeFree(source);
+
+    if (res != E_OK)
+      tty() << name() << ": " << image << ": write failed" << Terminal::EOL;
+
+    return res;
+  }
+};
+
+#endif // VFS_SHELL_CORE_SHELL_SCRIPTS_SAVEIMAGESCRIPT_HPP_
@@ -8,6 +8,7 @@
 #define VFS_SHELL_CORE_SHELL_SCRIPTS_SETENVSCRIPT_HPP_
 
 #include "Shell/ShellScript.hpp"
+#include <cstring>
 
 class SetEnvScript: public ShellScript
 {
@@ -23,6 +24,10 @@ public:
     {
       auto &variable = env()[*m_firstArgument];
       variable = *(m_firstArgument + 1);
+
+      // Identifier of the current directory is set by cd together with the path
+      if (!strcmp(*m_firstArgument, "PWD"))
+        env().purge("PWD_ID");
     }
 
     return E_OK;
@@ -0,0 +1,23 @@
+/*
+ * SyncScript.cpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "Shell/Scripts/SyncScript.hpp"
+
+SyncScript::SyncScript(Script *parent, ArgumentIterator firstArgument, ArgumentIterator lastArgument) :
+  ShellScript{parent, firstArgument, lastArgument}
+{
+}
+
+Result SyncScript::run()
+{
+  // Mounted file systems and their sector caches are flushed
+  const Result res = fsHandleSync(fs());
+
+  if (res != E_OK)
+    tty() << name() << ": synchronization failed" << Terminal::EOL;
+
+  return res;
+}
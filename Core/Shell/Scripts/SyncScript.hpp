@@ -0,0 +1,24 @@
+/*
+ * Core/Shell/Scripts/SyncScript.hpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#ifndef VFS_SHELL_CORE_SHELL_SCRIPTS_SYNCSCRIPT_HPP_
+#define VFS_SHELL_CORE_SHELL_SCRIPTS_SYNCSCRIPT_HPP_
+
+#include "Shell/ShellScript.hpp"
+
+class SyncScript: public ShellScript
+{
+public:
+  SyncScript(Script *, ArgumentIterator, ArgumentIterator);
+  virtual Result run() override;
+
+  static const char *name()
+  {
+    return "sync";
+  }
+};
+
+#endif // VFS_SHELL_CORE_SHELL_SCRIPTS_SYNCSCRIPT_HPP_
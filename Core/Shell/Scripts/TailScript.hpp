@@ -0,0 +1,274 @@
+/*
+ * Core/Shell/Scripts/TailScript.hpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#ifndef VFS_SHELL_CORE_SHELL_SCRIPTS_TAILSCRIPT_HPP_
+#define VFS_SHELL_CORE_SHELL_SCRIPTS_TAILSCRIPT_HPP_
+
+#include "Shell/ArgParser.hpp"
+#include "Shell/NodeWatcher.hpp"
+#include "Shell/Scripts/DataReader.hpp"
+#include "Shell/ShellHelpers.hpp"
+#include <cstdlib>
+
+template<size_t BUFFER_SIZE>
+class TailScript: public DataReader
+{
+public:
+  TailScript(Script *parent, ArgumentIterator firstArgument, ArgumentIterator lastArgument) :
+    DataReader{parent, firstArgument, lastArgument},
+    m_id{0},
+    m_changed{false},
+    m_removed{false}
+  {
+  }
+
+  virtual Result onEventReceived(const ScriptEvent *event) override
+  {
+    if (event->event != ScriptEvent::Event::NODE_CHANGED)
+      return DataReader::onEventReceived(event);
+
+    const auto * const change = static_cast<const NodeChangedEvent *>(event);
+
+    switch (change->change)
+    {
+      case NodeChangedEvent::REMOVED:
+        if (!m_id || change->node == m_id)
+          m_removed = true;
+        break;
+
+      case NodeChangedEvent::WRITTEN:
+      case NodeChangedEvent::OVERFLOW:
+        m_changed = true;
+        break;
+
+      default:
+        break;
+    }
+
+    return E_OK;
+  }
+
+  virtual Result run() override
+  {
+    static const ArgParser::Descriptor descriptors[] = {
+        {"--help", nullptr, "show this help message and exit", 0, Arguments::helpSetter},
+        {"-f", nullptr, "output appended data as the file grows", 0, Arguments::followSetter},
+        {"-n", "LINES", "output the last LINES lines, 10 by default", 1, Arguments::linesSetter},
+        {nullptr, "FILE", "file to be shown", 1, Arguments::fileSetter}
+    };
+
+    bool argumentsParsed;
+    const Arguments arguments = ArgParser::parse<Arguments>(m_firstArgument, m_lastArgument,
+        std::cbegin(descriptors), std::cend(descriptors), &argumentsParsed);
+
+    if (arguments.help)
+    {
+      ArgParser::help(tty(), name(), std::cbegin(descriptors), std::cend(descriptors));
+      return E_OK;
+    }
+    else if (!argumentsParsed)
+    {
+      return E_VALUE;
+    }
+    else if (arguments.file == nullptr)
+    {
+      tty() << name() << ": missing file operand" << Terminal::EOL;
+      return E_VALUE;
+    }
+
+    FsNode * const src = ShellHelpers::openSource(fs(), env(), arguments.file);
+    if (src == nullptr)
+    {
+      tty() << name() << ": " << arguments.file << ": node not found" << Terminal::EOL;
+      return E_ENTRY;
+    }
+
+    Result res;
+
+    {
+      // Subscription is made before the length is read, so appended data is not missed
+      NodeWatcher watcher{this, src, m_semaphore};
+      uint8_t buffer[BUFFER_SIZE];
+      FsLength position;
+
+      if (fsNodeRead(src, FS_NODE_ID, 0, &m_id, sizeof(m_id), nullptr) != E_OK)
+        m_id = 0;
+
+      position = findTail(src, buffer, arguments.lines);
+      res = printData(src, buffer, &position);
+
+      if (res == E_OK && arguments.follow)
+      {
+        if (watcher.isAttached())
+        {
+          res = followData(src, buffer, &position, watcher, arguments.file);
+        }
+        else
+        {
+          tty() << name() << ": " << arguments.file << ": changes can not be watched" << Terminal::EOL;
+          res = E_INVALID;
+        }
+      }
+    }
+
+    fsNodeFree(src);
+    return res;
+  }
+
+  static const char *name()
+  {
+    return "tail";
+  }
+
+private:
+  static constexpr size_t DEFAULT_LINES{10};
+
+  struct Arguments
+  {
+    const char *file{nullptr};
+    size_t lines{DEFAULT_LINES};
+    bool follow{false};
+    bool help{false};
+
+    static void fileSetter(void *object, const char *argument)
+    {
+      static_cast<Arguments *>(object)->file = argument;
+    }
+
+    static void followSetter(void *object, const char *)
+    {
+      static_cast<Arguments *>(object)->follow = true;
+    }
+
+    static void linesSetter(void *object, const char *argument)
+    {
+      static_cast<Arguments *>(object)->lines = static_cast<size_t>(atol(argument));
+    }
+
+    static void helpSetter(void *object, const char *)
+    {
+      static_cast<Arguments *>(object)->help = true;
+    }
+  };
+
+  // Identifier of the shown node, removal events of other nodes are ignored
+  FsIdentifier m_id;
+  bool m_changed;
+  bool m_removed;
+
+  Result followData(FsNode *src, uint8_t *buffer, FsLength *position, NodeWatcher &watcher, const char *path)
+  {
+    while (true)
+    {
+      // Events queued before the semaphore is drained are delivered by the following dispatch
+      if (isTerminateRequested())
+        return E_OK;
+
+      m_changed = false;
+      watcher.dispatch();
+
+      if (m_removed)
+      {
+        tty() << name() << ": " << path << ": node removed" << Terminal::EOL;
+        return E_OK;
+      }
+
+      if (!m_changed)
+      {
+        // Semaphore is posted by writers and by the terminal, it is posted again for the next drain
+        m_semaphore.wait();
+        m_semaphore.post();
+        continue;
+      }
+
+      FsLength length;
+
+      if (fsNodeLength(src, FS_NODE_DATA, &length) == E_OK && length < *position)
+      {
+        tty() << name() << ": " << path << ": file truncated" << Terminal::EOL;
+        *position = 0;
+      }
+
+      const Result res = printData(src, buffer, position);
+
+      if (res != E_OK)
+        return res == E_TIMEOUT ? E_OK : res;
+    }
+  }
+
+  Result printData(FsNode *src, uint8_t *buffer, FsLength *position)
+  {
+    while (true)
+    {
+      size_t bytesRead;
+      Result res;
+
+      if (isTerminateRequested())
+        return E_TIMEOUT;
+
+      res = fsNodeRead(src, FS_NODE_DATA, *position, buffer, BUFFER_SIZE, &bytesRead);
+
+      if (res == E_EMPTY || res == E_ADDRESS || (res == E_OK && !bytesRead))
+        return E_OK;
+
+      if (res != E_OK)
+      {
+        tty() << "read error at " << *position << Terminal::EOL;
+        return res;
+      }
+
+      const char *data = reinterpret_cast<const char *>(buffer);
+      size_t bytesLeft = bytesRead;
+
+      while (bytesLeft)
+      {
+        const size_t bytesWritten = tty().write(data, bytesLeft);
+        bytesLeft -= bytesWritten;
+        data += bytesWritten;
+      }
+
+      *position += static_cast<FsLength>(bytesRead);
+    }
+  }
+
+  static FsLength findTail(FsNode *src, uint8_t *buffer, size_t lines)
+  {
+    FsLength length;
+
+    if (fsNodeLength(src, FS_NODE_DATA, &length) != E_OK)
+      return 0;
+    if (!lines)
+      return length;
+
+    FsLength end = length;
+    size_t found = 0;
+
+    // Data is scanned backwards, the newline at the end of the file does not start a new line
+    while (end > 0)
+    {
+      const size_t chunk = end < static_cast<FsLength>(BUFFER_SIZE) ? static_cast<size_t>(end) : BUFFER_SIZE;
+      const FsLength start = end - static_cast<FsLength>(chunk);
+      size_t bytesRead;
+
+      if (fsNodeRead(src, FS_NODE_DATA, start, buffer, chunk, &bytesRead) != E_OK || bytesRead != chunk)
+        return 0;
+
+      for (size_t i = chunk; i > 0; --i)
+      {
+        const FsLength next = start + static_cast<FsLength>(i);
+
+        if (buffer[i - 1] == '\n' && next != length && ++found == lines)
+          return next;
+      }
+
+      end = start;
+    }
+
+    return 0;
+  }
+};
+
+#endif // VFS_SHELL_CORE_SHELL_SCRIPTS_TAILSCRIPT_HPP_
@@ -0,0 +1,56 @@
+/*
+ * TruncateNodeScript.cpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "Shell/Scripts/TruncateNodeScript.hpp"
+#include "Vfs/Vfs.hpp"
+
+const std::array<ArgParser::Descriptor, 3> TruncateNodeScript::descriptors{
+    {
+        {"--help", nullptr, "show this help message and exit", 0, Arguments::helpSetter},
+        {"-s", "SIZE", "set the length of each FILE to SIZE bytes", 1, Arguments::lengthSetter},
+        {nullptr, "FILE", "node to truncate", 0, Arguments::incrementNodeCount}
+    }
+};
+
+TruncateNodeScript::TruncateNodeScript(Script *parent, ArgumentIterator firstArgument,
+    ArgumentIterator lastArgument) :
+  NodeLengthScriptBase{parent, firstArgument, lastArgument},
+  m_arguments{ArgParser::parse<Arguments>(m_firstArgument, m_lastArgument,
+      descriptors.cbegin(), descriptors.cend())},
+  m_result{E_OK}
+{
+}
+
+Result TruncateNodeScript::run()
+{
+  if (m_arguments.help)
+  {
+    ArgParser::help(tty(), name(), std::cbegin(descriptors), std::cend(descriptors));
+    return E_OK;
+  }
+
+  const Result res = check(name(), m_arguments, "size");
+
+  if (res == E_OK)
+  {
+    ArgParser::invoke(m_firstArgument, m_lastArgument, descriptors.cbegin(), descriptors.cend(),
+        [this](const char *key){ truncateNode(key); });
+
+    return m_result;
+  }
+  else
+    return res;
+}
+
+void TruncateNodeScript::truncateNode(const char *positionalArgument)
+{
+  // Data beyond the new length is discarded, the gap is filled with zeros on extension
+  if (m_result == E_OK)
+  {
+    m_result = writeLength(name(), positionalArgument, static_cast<FsFieldType>(VfsNode::VFS_NODE_LENGTH),
+        m_arguments.length, "truncation");
+  }
+}
@@ -0,0 +1,34 @@
+/*
+ * Core/Shell/Scripts/TruncateNodeScript.hpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#ifndef VFS_SHELL_CORE_SHELL_SCRIPTS_TRUNCATENODESCRIPT_HPP_
+#define VFS_SHELL_CORE_SHELL_SCRIPTS_TRUNCATENODESCRIPT_HPP_
+
+#include "Shell/ArgParser.hpp"
+#include "Shell/Scripts/NodeLengthScriptBase.hpp"
+#include <array>
+
+class TruncateNodeScript: public NodeLengthScriptBase
+{
+public:
+  TruncateNodeScript(Script *, ArgumentIterator, ArgumentIterator);
+  virtual Result run() override;
+
+  static const char *name()
+  {
+    return "truncate";
+  }
+
+private:
+  const Arguments m_arguments;
+  Result m_result;
+
+  void truncateNode(const char *);
+
+  static const std::array<ArgParser::Descriptor, 3> descriptors;
+};
+
+#endif // VFS_SHELL_CORE_SHELL_SCRIPTS_TRUNCATENODESCRIPT_HPP_
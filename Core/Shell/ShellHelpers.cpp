@@ -6,8 +6,9 @@
 
 #include "Shell/Settings.hpp"
 #include "Shell/ShellHelpers.hpp"
-#include "Vfs/Vfs.hpp"
+#include "Vfs/VfsHandle.hpp"
 #include <xcore/fs/utils.h>
+#include <cstdlib>
 
 Terminal &operator<<(Terminal &output, ShellHelpers::ResultSerializer container)
 {
@@ -38,6 +39,78 @@ Terminal &operator<<(Terminal &output, ShellHelpers::ResultSerializer container)
   return output;
 }
 
+static Result createFromNode(FsHandle *fs, Environment &env, TimeProvider &time, FsNode *source,
+    const char *path, VfsNode::VfsFieldType type)
+{
+  // Only in-memory nodes are able to share their data
+  VfsNodeProxy * const proxy = VfsNodeProxy::cast(source);
+
+  if (proxy == nullptr)
+    return E_INVALID;
+
+  char absolutePath[Settings::PWD_LENGTH];
+
+  fsJoinPaths(absolutePath, env["PWD"], path);
+
+  // Check node existence, existing nodes are not replaced
+  FsNode * const existingNode = ShellHelpers::openNode(fs, absolutePath);
+  if (existingNode != nullptr)
+  {
+    fsNodeFree(existingNode);
+    return E_EXIST;
+  }
+
+  // Open directory
+  FsNode * const root = ShellHelpers::openBaseNode(fs, absolutePath);
+  if (root == nullptr)
+    return E_ENTRY;
+
+  VfsNodeProxy * const directory = VfsNodeProxy::cast(root);
+
+  // Links reference nodes of the same handle only
+  if (directory == nullptr || (type == VfsNode::VFS_NODE_LINK && directory->handle() != proxy->handle()))
+  {
+    fsNodeFree(root);
+    return E_INVALID;
+  }
+
+  // Create new node
+  const char * const nodeName = fsExtractName(absolutePath);
+  const auto nodeTime = time.getTime();
+  VfsNode * const node = proxy->get();
+  const FsFieldDescriptor fields[] = {
+      // Name descriptor
+      {
+          nodeName,
+          strlen(nodeName) + 1,
+          FS_NODE_NAME
+      },
+      // Access time descriptor
+      {
+          &nodeTime,
+          sizeof(nodeTime),
+          FS_NODE_TIME
+      },
+      // Source node descriptor
+      {
+          &node,
+          sizeof(node),
+          static_cast<FsFieldType>(type)
+      }
+  };
+
+  const Result res = fsNodeCreate(root, fields, ARRAY_SIZE(fields));
+  fsNodeFree(root);
+
+  return res;
+}
+
+Result ShellHelpers::cloneNode(FsHandle *fs, Environment &env, TimeProvider &time, FsNode *source,
+    const char *path)
+{
+  return createFromNode(fs, env, time, source, path, VfsNode::VFS_NODE_CLONE);
+}
+
 Result ShellHelpers::injectNode(FsHandle *handle, VfsNode *node, const char *path)
 {
   if (node == nullptr)
@@ -52,7 +125,7 @@ Result ShellHelpers::injectNode(FsHandle *handle, VfsNode *node, const char *pat
     return E_MEMORY;
 
   // Open base node
-  FsNode * const parent = fsOpenBaseNode(handle, path);
+  FsNode * const parent = openBaseNode(handle, path);
 
   if (!parent)
     return E_ENTRY;
@@ -68,6 +141,63 @@ Result ShellHelpers::injectNode(FsHandle *handle, VfsNode *node, const char *pat
   return res;
 }
 
+bool ShellHelpers::isSameNode(FsNode *first, FsNode *second)
+{
+  VfsNodeProxy * const firstProxy = VfsNodeProxy::cast(first);
+  VfsNodeProxy * const secondProxy = VfsNodeProxy::cast(second);
+
+  if (firstProxy != nullptr || secondProxy != nullptr)
+    return firstProxy != nullptr && secondProxy != nullptr && firstProxy->get() == secondProxy->get();
+
+  FsIdentifier firstId;
+  FsIdentifier secondId;
+
+  if (fsNodeRead(first, FS_NODE_ID, 0, &firstId, sizeof(firstId), nullptr) != E_OK)
+    return false;
+  if (fsNodeRead(second, FS_NODE_ID, 0, &secondId, sizeof(secondId), nullptr) != E_OK)
+    return false;
+
+  return firstId == secondId;
+}
+
+Result ShellHelpers::linkNode(FsHandle *fs, Environment &env, TimeProvider &time, FsNode *source,
+    const char *path)
+{
+  return createFromNode(fs, env, time, source, path, VfsNode::VFS_NODE_LINK);
+}
+
+FsNode *ShellHelpers::openBaseNode(FsHandle *handle, const char *path)
+{
+  return VfsHandle::openBaseNode(handle, path);
+}
+
+FsNode *ShellHelpers::openNode(FsHandle *handle, const char *path)
+{
+  return VfsHandle::openNode(handle, path);
+}
+
+FsNode *ShellHelpers::openNode(FsHandle *handle, Environment &env, const char *path)
+{
+  if (*path != '/')
+  {
+    const char * const directory = env["PWD_ID"];
+
+    // Current directory is opened by the identifier without a walk from the root
+    if (*directory != '\0')
+    {
+      FsNode * const node = VfsHandle::openNodeAt(handle, strtoull(directory, nullptr, 10), path);
+
+      if (node != nullptr)
+        return node;
+    }
+  }
+
+  char absolutePath[Settings::PWD_LENGTH];
+
+  fsJoinPaths(absolutePath, env["PWD"], path);
+  return openNode(handle, absolutePath);
+}
+
 FsNode *ShellHelpers::openScript(FsHandle *handle, Environment &env, const char *path)
 {
   char absolutePath[Settings::PWD_LENGTH];
@@ -75,19 +205,19 @@ FsNode *ShellHelpers::openScript(FsHandle *handle, Environment &env, const char
 
   // Search node in the PATH
   fsJoinPaths(absolutePath, env["PATH"], path);
-  if ((node = fsOpenNode(handle, absolutePath)) != nullptr)
+  if ((node = openNode(handle, absolutePath)) != nullptr)
     return node;
 
   // Search node in the current directory
   fsJoinPaths(absolutePath, env["PWD"], path);
-  if ((node = fsOpenNode(handle, absolutePath)) != nullptr)
+  if ((node = openNode(handle, absolutePath)) != nullptr)
     return node;
 
   return nullptr;
 }
 
 FsNode *ShellHelpers::openSink(FsHandle *fs, Environment &env, TimeProvider &time, const char *path, bool overwrite,
-    Result *invocationResult)
+    Result *invocationResult, FsLength offset, FsLength hint)
 {
   char absolutePath[Settings::PWD_LENGTH];
   FsNode *node = nullptr;
@@ -96,12 +226,33 @@ FsNode *ShellHelpers::openSink(FsHandle *fs, Environment &env, TimeProvider &tim
   fsJoinPaths(absolutePath, env["PWD"], path);
 
   // Check node existence
-  FsNode * const existingNode = fsOpenNode(fs, absolutePath);
+  FsNode * const existingNode = openNode(fs, absolutePath);
   if (existingNode != nullptr)
   {
     if (overwrite)
     {
-      node = existingNode;
+      FsLength length;
+
+      // Only in-memory nodes support truncation and preallocation
+      if (VfsNodeProxy::cast(existingNode) != nullptr)
+      {
+        if (fsNodeLength(existingNode, FS_NODE_DATA, &length) == E_OK && length > offset)
+        {
+          res = fsNodeWrite(existingNode, static_cast<FsFieldType>(VfsNode::VFS_NODE_LENGTH), 0,
+              &offset, sizeof(offset), nullptr);
+        }
+
+        if (res == E_OK && hint > 0)
+        {
+          fsNodeWrite(existingNode, static_cast<FsFieldType>(VfsNode::VFS_NODE_CAPACITY), 0,
+              &hint, sizeof(hint), nullptr);
+        }
+      }
+
+      if (res == E_OK)
+        node = existingNode;
+      else
+        fsNodeFree(existingNode);
     }
     else
     {
@@ -114,7 +265,7 @@ FsNode *ShellHelpers::openSink(FsHandle *fs, Environment &env, TimeProvider &tim
     FsNode *root = nullptr;
 
     // Open directory
-    if ((root = fsOpenBaseNode(fs, absolutePath)) == nullptr)
+    if ((root = openBaseNode(fs, absolutePath)) == nullptr)
       res = E_ENTRY;
 
     // Create new node
@@ -140,10 +291,18 @@ FsNode *ShellHelpers::openSink(FsHandle *fs, Environment &env, TimeProvider &tim
               nullptr,
               0,
               FS_NODE_DATA
+          },
+          // Size hint descriptor
+          {
+              &hint,
+              sizeof(hint),
+              static_cast<FsFieldType>(VfsNode::VFS_NODE_CAPACITY)
           }
       };
+      // Size hint is passed to in-memory directories only
+      const bool hinted = hint > 0 && VfsNodeProxy::cast(root) != nullptr;
 
-      res = fsNodeCreate(root, fields, ARRAY_SIZE(fields));
+      res = fsNodeCreate(root, fields, hinted ? ARRAY_SIZE(fields) : ARRAY_SIZE(fields) - 1);
       fsNodeFree(root);
     }
   }
@@ -151,7 +310,7 @@ FsNode *ShellHelpers::openSink(FsHandle *fs, Environment &env, TimeProvider &tim
   // Open created node
   if (res == E_OK && node == nullptr)
   {
-    if ((node = fsOpenNode(fs, absolutePath)) == nullptr)
+    if ((node = openNode(fs, absolutePath)) == nullptr)
       res = E_ENTRY;
   }
 
@@ -162,8 +321,5 @@ FsNode *ShellHelpers::openSink(FsHandle *fs, Environment &env, TimeProvider &tim
 
 FsNode *ShellHelpers::openSource(FsHandle *fs, Environment &env, const char *path)
 {
-  char absolutePath[Settings::PWD_LENGTH];
-
-  fsJoinPaths(absolutePath, env["PWD"], path);
-  return fsOpenNode(fs, absolutePath);
+  return openNode(fs, env, path);
 }
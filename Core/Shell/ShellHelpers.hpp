@@ -11,6 +11,7 @@
 #include "Shell/ScriptHeaders.hpp"
 #include <xcore/fs/fs.h>
 #include <cctype>
+#include <limits>
 
 class Terminal;
 class VfsNode;
@@ -22,13 +23,27 @@ struct ShellHelpers
     Result m_result;
   };
 
+  // Sink offset that keeps all data of an existing node
+  static constexpr FsLength APPEND_OFFSET{std::numeric_limits<FsLength>::max()};
+
   ShellHelpers() = delete;
   ShellHelpers(const ShellHelpers &) = delete;
   ShellHelpers &operator=(const ShellHelpers &) = delete;
 
+  static Result cloneNode(FsHandle *, Environment &, TimeProvider &, FsNode *, const char *);
   static Result injectNode(FsHandle *, VfsNode *, const char *);
+  // In-memory nodes are compared by objects, other nodes are compared by identifiers
+  static bool isSameNode(FsNode *, FsNode *);
+  // Node of the same in-memory handle is shared under another name
+  static Result linkNode(FsHandle *, Environment &, TimeProvider &, FsNode *, const char *);
+  static FsNode *openBaseNode(FsHandle *, const char *);
+  static FsNode *openNode(FsHandle *, const char *);
+  // Relative paths are resolved from the current directory
+  static FsNode *openNode(FsHandle *, Environment &, const char *);
   static FsNode *openScript(FsHandle *, Environment &, const char *);
-  static FsNode *openSink(FsHandle *, Environment &, TimeProvider &, const char *, bool, Result *);
+  // Existing node is truncated to the offset when overwriting is allowed, the hint is the expected length
+  static FsNode *openSink(FsHandle *, Environment &, TimeProvider &, const char *, bool, Result *,
+      FsLength = 0, FsLength = 0);
   static FsNode *openSource(FsHandle *, Environment &, const char *);
 
   template<typename T>
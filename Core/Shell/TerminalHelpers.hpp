@@ -8,8 +8,9 @@
 #define VFS_SHELL_CORE_SHELL_TERMINALHELPERS_HPP_
 
 #include <algorithm>
-#include <cstring>
 #include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <limits>
 #include <type_traits>
 
@@ -98,7 +99,13 @@ public:
     memcpy(nullTerminatedBuffer, buffer, chunkLength);
 
     char *lastConvertedCharacter;
-    const T value = static_cast<T>(strtol(nullTerminatedBuffer, &lastConvertedCharacter, 0));
+    T value;
+
+    // Wide unsigned values do not fit into long on 32-bit targets
+    if constexpr (std::is_signed_v<T>)
+      value = static_cast<T>(strtoll(nullTerminatedBuffer, &lastConvertedCharacter, 0));
+    else
+      value = static_cast<T>(strtoull(nullTerminatedBuffer, &lastConvertedCharacter, 0));
 
     if (converted != nullptr)
       *converted = lastConvertedCharacter - nullTerminatedBuffer;
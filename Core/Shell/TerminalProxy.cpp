@@ -30,7 +30,8 @@ TerminalProxy::TerminalProxy(Script *parent, Terminal &terminal, const char *inp
     m_output.enabled = true;
 
     m_output.node = {
-        ShellHelpers::openSink(m_parent->fs(), m_parent->env(), m_parent->time(), outputPath, true, nullptr),
+        ShellHelpers::openSink(m_parent->fs(), m_parent->env(), m_parent->time(), outputPath, true, nullptr,
+            append ? ShellHelpers::APPEND_OFFSET : 0),
         freeNode
     };
 
@@ -6,8 +6,9 @@
 
 #include "Vfs/Vfs.hpp"
 #include "Vfs/VfsHandle.hpp"
-#include <cstring>
+#include "Vfs/VfsSlab.hpp"
 #include <cstdlib>
+#include <cstring>
 
 const FsNodeClass VfsNodeProxy::table{
     sizeof(VfsNodeProxy), // size
@@ -28,10 +29,34 @@ const FsNodeClass * const VfsNodeProxyClass = &VfsNodeProxy::table;
 VfsNode::VfsNode(time64_t timestamp, FsAccess access) :
   m_handle{nullptr},
   m_parent{nullptr},
-  m_name{nullptr, [](char pointer[]){ free(pointer); }},
   m_timestamp{timestamp},
-  m_access{access}
+  m_name{nullptr},
+  m_access{access},
+  m_links{0},
+  m_nameStorage{NAME_STATIC}
+{
+}
+
+VfsNode::VfsNode(VfsNode &&other) :
+  m_handle{other.m_handle},
+  m_parent{other.parent()},
+  m_timestamp{other.m_timestamp},
+  m_name{other.m_name},
+  m_access{other.m_access},
+  m_links{0},
+  m_nameStorage{other.m_nameStorage}
 {
+  // Allocated name is moved to the new node
+  other.m_name.pointer = nullptr;
+  other.m_nameStorage = NAME_STATIC;
+}
+
+VfsNode::~VfsNode()
+{
+  if (m_handle != nullptr)
+    m_handle->release(this);
+
+  releaseName();
 }
 
 Result VfsNode::create(const FsFieldDescriptor *, size_t)
@@ -39,7 +64,7 @@ Result VfsNode::create(const FsFieldDescriptor *, size_t)
   return E_INVALID;
 }
 
-VfsNode *VfsNode::fetch(VfsNode *)
+VfsNode *VfsNode::fetch(VfsNode *, Cursor *)
 {
   return nullptr;
 }
@@ -49,6 +74,11 @@ void *VfsNode::head()
   return nullptr;
 }
 
+FsIdentifier VfsNode::identify(VfsNode *)
+{
+  return 0;
+}
+
 Result VfsNode::length(FsFieldType type, FsLength *fieldLength)
 {
   size_t len = 0;
@@ -60,12 +90,17 @@ Result VfsNode::length(FsFieldType type, FsLength *fieldLength)
       break;
 
     case FS_NODE_ID:
-      len = sizeof(void *);
+      len = sizeof(FsIdentifier);
       break;
 
     case FS_NODE_NAME:
-      len = strlen(m_name.get()) + 1;
+    {
+      // Name may be replaced concurrently under the lock of the parent node
+      VfsHandle::SharedLocker locker{m_handle, parent()};
+
+      len = strlen(name()) + 1;
       break;
+    }
 
     case FS_NODE_TIME:
       len = sizeof(time64_t);
@@ -80,9 +115,49 @@ Result VfsNode::length(FsFieldType type, FsLength *fieldLength)
   return E_OK;
 }
 
-VfsNode *VfsNode::next()
+Result VfsNode::list(Cursor *, FsLength, void *, size_t, size_t *)
+{
+  // Batched listing is not supported, iterate over descendants instead
+  return E_INVALID;
+}
+
+VfsNode *VfsNode::locate(FsIdentifier)
+{
+  return nullptr;
+}
+
+Result VfsNode::lookup(std::string_view, VfsNode **)
+{
+  // Name index is not supported, iterate over descendants instead
+  return E_INVALID;
+}
+
+Result VfsNode::map(FsLength, Mapping *)
 {
-  return m_parent != nullptr ? m_parent->fetch(this) : nullptr;
+  // Data is not kept in memory, read it into a buffer instead
+  return E_INVALID;
+}
+
+Result VfsNode::open(std::string_view, FsNode **)
+{
+  // Path is not resolved by the node, iterate over descendants instead
+  return E_INVALID;
+}
+
+VfsNode *VfsNode::next(Cursor *cursor)
+{
+  VfsNode *node = parent();
+
+  // Removed node has no parent, iteration continues in the node that owns the cursor
+  if (node == nullptr && cursor != nullptr && cursor->owner != this)
+    node = cursor->owner;
+
+  return node != nullptr ? node->fetch(this, cursor) : nullptr;
+}
+
+bool VfsNode::reaches(const VfsNode *node)
+{
+  return node == this;
 }
 
 Result VfsNode::read(FsFieldType type, FsLength position, void *buffer, size_t bufferLength, size_t *bytesRead)
@@ -103,23 +178,30 @@ Result VfsNode::read(FsFieldType type, FsLength position, void *buffer, size_t b
 
     case FS_NODE_ID:
     {
-      if (position || bufferLength != sizeof(void *))
+      if (position || bufferLength != sizeof(FsIdentifier))
         return E_VALUE;
 
-      void * const pointer = reinterpret_cast<void *>(this);
-      memcpy(buffer, &pointer, sizeof(pointer));
-      count = sizeof(pointer);
+      // Nodes outside of a handle are identified by their address
+      const FsIdentifier id = m_handle != nullptr ?
+          m_handle->identify(this) : static_cast<FsIdentifier>(reinterpret_cast<uintptr_t>(this));
+
+      if (!id)
+        return E_ENTRY;
+
+      memcpy(buffer, &id, sizeof(id));
+      count = sizeof(id);
       break;
     }
 
     case FS_NODE_NAME:
     {
-      const size_t nameLength = strlen(m_name.get()) + 1;
+      VfsHandle::SharedLocker locker{m_handle, parent()};
+      const size_t nameLength = strlen(name()) + 1;
 
       if (position || bufferLength < nameLength)
         return E_VALUE;
 
-      strcpy(static_cast<char *>(buffer), m_name.get());
+      strcpy(static_cast<char *>(buffer), name());
       count = nameLength;
       break;
     }
@@ -135,7 +217,51 @@ Result VfsNode::read(FsFieldType type, FsLength position, void *buffer, size_t b
     }
 
     default:
-      return E_INVALID;
+      if (static_cast<VfsFieldType>(type) == VFS_NODE_MAP)
+      {
+        if (bufferLength != sizeof(Mapping))
+          return E_VALUE;
+
+        const Result res = map(position, static_cast<Mapping *>(buffer));
+
+        if (res != E_OK)
+          return res;
+
+        count = sizeof(Mapping);
+        break;
+      }
+      else if (static_cast<VfsFieldType>(type) == VFS_NODE_USAGE)
+      {
+        if (position || bufferLength != sizeof(Usage))
+          return E_VALUE;
+
+        // Counters are maintained during modification, the subtree is not traversed
+        const Usage nodeUsage = usage();
+
+        memcpy(buffer, &nodeUsage, sizeof(nodeUsage));
+        count = sizeof(nodeUsage);
+        break;
+      }
+      else if (static_cast<VfsFieldType>(type) == VFS_NODE_ENTRIES)
+      {
+        // Listing without a cursor starts from the first descendant
+        return list(nullptr, position, buffer, bufferLength, bytesRead);
+      }
+      else if (static_cast<VfsFieldType>(type) == VFS_NODE_REQUEST)
+      {
+        if (position || bufferLength != sizeof(Request *))
+          return E_VALUE;
+
+        const Result res = complete(static_cast<Request **>(buffer));
+
+        if (res != E_OK)
+          return res;
+
+        count = sizeof(Request *);
+        break;
+      }
+      else
+        return E_INVALID;
   }
 
   if (bytesRead != nullptr)
@@ -148,6 +274,23 @@ Result VfsNode::remove(FsNode *)
   return E_INVALID;
 }
 
+Result VfsNode::submit(FsLength, Request *)
+{
+  // Data is transferred synchronously
+  return E_INVALID;
+}
+
+Result VfsNode::complete(Request **)
+{
+  return E_INVALID;
+}
+
+Result VfsNode::sync()
+{
+  // Nodes kept in memory have nothing to write
+  return E_OK;
+}
+
 Result VfsNode::write(FsFieldType type, FsLength position, const void *buffer, size_t bufferLength,
     size_t *bytesWritten)
 {
@@ -160,6 +303,10 @@ Result VfsNode::write(FsFieldType type, FsLength position, const void *buffer, s
       if (position || bufferLength != sizeof(m_access))
         return E_VALUE;
 
+      // Access rights are checked during path resolution
+      if (m_handle != nullptr)
+        m_handle->invalidate(this);
+
       memcpy(&m_access, buffer, sizeof(m_access));
       count = sizeof(m_access);
       break;
@@ -176,9 +323,28 @@ Result VfsNode::write(FsFieldType type, FsLength position, const void *buffer, s
     }
 
     default:
-      return E_INVALID;
+      if (static_cast<VfsFieldType>(type) == VFS_NODE_REQUEST)
+      {
+        if (bufferLength != sizeof(Request *))
+          return E_VALUE;
+
+        // Request is not an attribute, watchers are not notified
+        Request *request;
+
+        memcpy(&request, buffer, sizeof(request));
+
+        const Result res = submit(position, request);
+
+        if (res == E_OK && bytesWritten != nullptr)
+          *bytesWritten = sizeof(Request *);
+        return res;
+      }
+      else
+        return E_INVALID;
   }
 
+  notify(VfsWatcher::EVENT_ATTRIBUTE);
+
   if (bytesWritten != nullptr)
     *bytesWritten = count;
   return E_OK;
@@ -186,47 +352,224 @@ Result VfsNode::write(FsFieldType type, FsLength position, const void *buffer, s
 
 void VfsNode::enter(VfsHandle *handle, VfsNode *node)
 {
+  // Identifier issued by the previous handle is no longer valid
+  if (m_handle != nullptr && m_handle != handle)
+    m_handle->release(this);
+
   m_handle = handle;
   m_parent = node;
 }
 
 void VfsNode::leave()
 {
-  m_handle = nullptr;
-  m_parent = nullptr;
+  // Handle is kept until the node is destroyed, identifiers and watchers stay valid while it is referenced
+  m_parent.store(nullptr, std::memory_order_release);
 }
 
-bool VfsNode::rename(const char *name)
+bool VfsNode::empty()
 {
-  if (name != nullptr)
+  FsNode * const child = static_cast<FsNode *>(head());
+
+  if (child != nullptr)
   {
-    const auto reallocatedNameBuffer = static_cast<char *>(malloc(strlen(name) + 1));
+    fsNodeFree(child);
+    return false;
+  }
+  else
+    return true;
+}
 
-    if (reallocatedNameBuffer != nullptr)
-    {
-      strcpy(reallocatedNameBuffer, name);
-      m_name.reset(reallocatedNameBuffer);
+bool VfsNode::attachable() const
+{
+  return false;
+}
 
-      return true;
-    }
-    else
+bool VfsNode::mounted() const
+{
+  return false;
+}
+
+VfsNode::Usage VfsNode::detach()
+{
+  return usage();
+}
+
+VfsNode::Usage VfsNode::usage() const
+{
+  return Usage{0, 1};
+}
+
+void *VfsNode::unindex(VfsNode *)
+{
+  return nullptr;
+}
+
+void VfsNode::reindex(VfsNode *, void *)
+{
+}
+
+void VfsNode::destroy()
+{
+  delete this;
+}
+
+bool VfsNode::charge(size_t bytes, size_t nodes, bool limited)
+{
+  // Parent is not released until the section is left even when the node is removed concurrently
+  VfsHandle::Section section{m_handle};
+  VfsNode * const node = parent();
+
+  return node == nullptr || node->charge(bytes, nodes, limited);
+}
+
+void VfsNode::uncharge(size_t bytes, size_t nodes)
+{
+  VfsHandle::Section section{m_handle};
+  VfsNode * const node = parent();
+
+  if (node != nullptr)
+    node->uncharge(bytes, nodes);
+}
+
+bool VfsNode::acquire()
+{
+  uint16_t links = m_links.load(std::memory_order_relaxed);
+
+  // Counter of a destroyed node wraps around, such a node is never referenced again
+  do
+  {
+    if (links == UINT16_MAX)
       return false;
   }
+  while (!m_links.compare_exchange_weak(links, static_cast<uint16_t>(links + 1), std::memory_order_relaxed));
+
+  return true;
+}
+
+void VfsNode::release()
+{
+  if (m_links.fetch_sub(1, std::memory_order_acq_rel) == 0)
+    destroy();
+}
+
+bool VfsNode::rename(const char *name)
+{
+  if (name == nullptr)
+  {
+    updateName(nullptr, NAME_STATIC);
+  }
+  else if (strlen(name) < NAME_LOCAL_LENGTH)
+  {
+    updateName(name, NAME_LOCAL);
+  }
   else
   {
-    m_name.reset(nullptr);
-    return true;
+    const size_t length = strlen(name) + 1;
+    const bool cached = length <= VfsSlab::NAME_LENGTH;
+    const auto buffer = static_cast<char *>(cached ? VfsSlab::nameCache().allocate(length) : malloc(length));
+
+    if (buffer == nullptr)
+      return false;
+
+    strcpy(buffer, name);
+    updateName(buffer, cached ? NAME_CACHED : NAME_ALLOCATED);
   }
+
+  return true;
+}
+
+void VfsNode::notify(VfsWatcher::Type type)
+{
+  if (m_handle != nullptr)
+    m_handle->notify(this, type);
+}
+
+void VfsNode::setStaticName(const char *name)
+{
+  updateName(name, NAME_STATIC);
+}
+
+void VfsNode::releaseName()
+{
+  if (m_nameStorage == NAME_CACHED)
+    VfsSlab::nameCache().deallocate(const_cast<char *>(m_name.pointer));
+  else if (m_nameStorage == NAME_ALLOCATED)
+    free(const_cast<char *>(m_name.pointer));
+}
+
+void VfsNode::updateName(const char *name, NameStorage storage)
+{
+  // Cached paths of the node and its descendants become invalid
+  if (m_handle != nullptr)
+    m_handle->invalidate(this);
+
+  // Parent node may keep an index with a pointer to the previous name
+  VfsHandle::Section section{m_handle};
+  VfsNode * const node = parent();
+  VfsHandle::Locker locker{m_handle, node};
+  void * const position = node != nullptr ? node->unindex(this) : nullptr;
+
+  releaseName();
+
+  if (storage == NAME_LOCAL)
+    strcpy(m_name.local, name);
+  else
+    m_name.pointer = name;
+  m_nameStorage = storage;
+
+  if (position != nullptr)
+    node->reindex(this, position);
+}
+
+void *VfsNode::operator new(size_t size) noexcept
+{
+  return VfsSlab::allocateHeap(size);
 }
 
 void VfsNode::operator delete(void *pointer)
 {
-  free(pointer);
+  VfsSlab::release(pointer);
 }
 
-VfsNodeProxy::VfsNodeProxy(VfsNode *node) :
+VfsNodeProxy::VfsNodeProxy(VfsHandle *handle, VfsNode *node, const VfsNode::Cursor *cursor) :
+  m_handle{handle},
   m_node{node}
 {
+  // Node is referenced by the caller, the owner of the cursor is referenced here
+  if (cursor != nullptr)
+  {
+    m_cursor = *cursor;
+    updateOwner(nullptr);
+  }
+}
+
+VfsNodeProxy::~VfsNodeProxy()
+{
+  if (m_cursor.owner != nullptr)
+    m_cursor.owner->release();
+
+  m_node->release();
+}
+
+void VfsNodeProxy::updateOwner(VfsNode *previous)
+{
+  // Cursor without a referenced owner is ignored by nodes, iteration falls back to a search
+  if (m_cursor.owner != previous)
+  {
+    if (m_cursor.owner != nullptr && !m_cursor.owner->acquire())
+      m_cursor.owner = nullptr;
+
+    if (previous != nullptr)
+      previous->release();
+  }
+}
+
+VfsNodeProxy *VfsNodeProxy::cast(FsNode *node)
+{
+  if (node != nullptr && static_cast<const void *>(node->base.type) == VfsNodeProxyClass)
+    return reinterpret_cast<VfsNodeProxy *>(node);
+  else
+    return nullptr;
 }
 
 Result VfsNodeProxy::createImpl(const struct FsFieldDescriptor *descriptors, size_t number)
@@ -236,11 +579,14 @@ Result VfsNodeProxy::createImpl(const struct FsFieldDescriptor *descriptors, siz
 
 void VfsNodeProxy::freeImpl()
 {
-  return m_node->m_handle->freeNodeProxy(this);
+  // Node may be already removed, use the handle stored in the proxy
+  VfsHandle::freeNodeProxy(m_handle, this);
 }
 
 void *VfsNodeProxy::headImpl()
 {
+  // First descendant is reached without locks, the new proxy references it before the section is left
+  VfsHandle::Section section{m_handle};
   return m_node->head();
 }
 
@@ -251,21 +597,38 @@ Result VfsNodeProxy::lengthImpl(FsFieldType type, FsLength *length)
 
 Result VfsNodeProxy::nextImpl()
 {
-  VfsNode * const nextNode = m_node->next();
+  // Next node is reached without locks, it is referenced before the section is left
+  VfsHandle::Section section{m_handle};
+  VfsNode * const owner = m_cursor.owner;
+  VfsNode * const nextNode = m_node->next(&m_cursor);
 
-  if (nextNode != nullptr)
-  {
-    m_node = nextNode;
-    return E_OK;
-  }
-  else
+  updateOwner(owner);
+
+  if (nextNode == nullptr)
     return E_ENTRY;
+  if (!nextNode->acquire())
+    return E_FULL;
+
+  m_node->release();
+  m_node = nextNode;
+  return E_OK;
 }
 
 Result VfsNodeProxy::readImpl(FsFieldType type, FsLength position, void *buffer, size_t bufferLength,
     size_t *bytesRead)
 {
-  return m_node->read(type, position, buffer, bufferLength, bytesRead);
+  // Consecutive listing calls continue from the cursor instead of skipping records again
+  if (static_cast<VfsNode::VfsFieldType>(type) == VfsNode::VFS_NODE_ENTRIES)
+  {
+    VfsHandle::Section section{m_handle};
+    VfsNode * const owner = m_cursor.owner;
+    const Result res = m_node->list(&m_cursor, position, buffer, bufferLength, bytesRead);
+
+    updateOwner(owner);
+    return res;
+  }
+  else
+    return m_node->read(type, position, buffer, bufferLength, bytesRead);
 }
 
 Result VfsNodeProxy::removeImpl(void *node)
@@ -7,11 +7,15 @@
 #ifndef VFS_SHELL_CORE_VFS_VFS_HPP_
 #define VFS_SHELL_CORE_VFS_VFS_HPP_
 
+#include "Vfs/VfsWatcher.hpp"
 #include <xcore/fs/fs.h>
 #include <xcore/realtime.h>
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <new>
+#include <string_view>
 
 extern const FsNodeClass * const VfsNodeProxyClass;
 
@@ -26,35 +30,199 @@ public:
   enum VfsFieldType
   {
     VFS_NODE_OBJECT = FS_TYPE_END,
-    VFS_NODE_INTERFACE
+    VFS_NODE_INTERFACE,
+    // Data node whose contents are shared with a newly created node, reading takes a reference of the node
+    VFS_NODE_CLONE,
+    // Read-only view of node data, buffer contains a Mapping structure
+    VFS_NODE_MAP,
+    // Length of node data, written value truncates or extends the data
+    VFS_NODE_LENGTH,
+    // Storage reserved for node data, also used as a size hint during creation
+    VFS_NODE_CAPACITY,
+    // Resources used by the node and its descendants, buffer contains a Usage structure
+    VFS_NODE_USAGE,
+    // Limits of resources used by the node and its descendants, zero values in the Usage structure disable limits
+    VFS_NODE_LIMIT,
+    // Attributes of descendant nodes packed into Record structures, position is a number of records to skip
+    VFS_NODE_ENTRIES,
+    // Node referenced by a newly created link, links to links reference the same node
+    VFS_NODE_LINK,
+    // Asynchronous transfer of node data, buffer contains a pointer to a Request structure:
+    // written pointer submits a request, read pointer is the oldest finished request
+    VFS_NODE_REQUEST
+  };
+
+  // Memory and node counters of a subtree
+  struct Usage
+  {
+    size_t bytes;
+    size_t nodes;
+  };
+
+  // Attributes of a descendant node, null-terminated name follows the structure
+  struct Record
+  {
+    FsIdentifier id;
+    FsLength length;
+    time64_t time;
+    FsAccess access;
+    // Length of the record with the name, aligned to the alignment of the structure
+    uint16_t size;
+    // Node has descendants
+    bool directory;
+  };
+
+  // Data mapped in place, stays valid and unchanged until unmapped
+  struct Mapping
+  {
+    const void *data;
+    // Requested length on input, length of the mapped data on output
+    size_t length;
+    void *token;
+    void (*unmap)(void *);
+  };
+
+  // Asynchronous transfer, owned by the node from submission until it is returned as finished
+  struct Request
+  {
+    void *buffer;
+    size_t length;
+    // Data is written to the node instead of being read
+    bool write;
+    // Filled by the node: position of node data, result and number of transferred bytes
+    FsLength position;
+    Result status;
+    size_t count;
+  };
+
+  // Iteration state kept by a node proxy, contents are defined by the owner node referenced by the proxy
+  struct Cursor
+  {
+    VfsNode *owner{nullptr};
+    alignas(void *) uint8_t position[3 * sizeof(uint64_t)];
   };
 
   VfsNode(time64_t, FsAccess);
-  VfsNode(VfsNode &&) = default;
-  virtual ~VfsNode() = default;
+  VfsNode(VfsNode &&);
+  virtual ~VfsNode();
 
   virtual Result create(const FsFieldDescriptor *, size_t);
-  virtual VfsNode *fetch(VfsNode *);
+  virtual VfsNode *fetch(VfsNode *, Cursor * = nullptr);
   virtual void *head();
+  // Identifier of a descendant derived from its entry, zero when the node is not a descendant
+  virtual FsIdentifier identify(VfsNode *);
   virtual Result length(FsFieldType, FsLength *);
-  virtual VfsNode *next();
+  virtual Result list(Cursor *, FsLength, void *, size_t, size_t *);
+  // Search the subtree for a node with the identifier, links are not followed
+  virtual VfsNode *locate(FsIdentifier);
+  virtual Result lookup(std::string_view, VfsNode **);
+  // Nodes that intercept data reads should not provide mappings, mapped data bypasses read
+  virtual Result map(FsLength, Mapping *);
+  virtual VfsNode *next(Cursor * = nullptr);
+  // Open a descendant of a node without a name index by a relative path
+  virtual Result open(std::string_view, FsNode **);
+  // Check whether the node is reachable through descendants and links, caller is in an epoch section
+  virtual bool reaches(const VfsNode *);
   virtual Result read(FsFieldType, FsLength, void *, size_t, size_t *);
   virtual Result remove(FsNode *);
+  // Queue an asynchronous transfer, nodes without asynchronous access return E_INVALID
+  virtual Result submit(FsLength, Request *);
+  // Wait for the oldest submitted request, E_EMPTY is returned when nothing is submitted
+  virtual Result complete(Request **);
+  // Write buffered data of the node to the backing storage
+  virtual Result sync();
   virtual Result write(FsFieldType, FsLength, const void *, size_t, size_t *);
 
   virtual void enter(VfsHandle *, VfsNode *);
   virtual void leave();
 
+  // Check for descendants without making a proxy
+  virtual bool empty();
+  // In-memory directories accept detached nodes of the VFS_NODE_OBJECT type
+  virtual bool attachable() const;
+  // Descendants belong to another file system
+  virtual bool mounted() const;
+
+  // Called by the parent during removal, usage of the node is no longer charged to ancestors
+  virtual Usage detach();
+  virtual Usage usage() const;
+
+  const char *name() const
+  {
+    return m_nameStorage == NAME_LOCAL ? m_name.local : m_name.pointer;
+  }
+
+  VfsNode *parent() const
+  {
+    return m_parent.load(std::memory_order_acquire);
+  }
+
   bool rename(const char *);
+
+  // Take a reference for a link or a proxy, fails when the counter is exhausted
+  virtual bool acquire();
+  // Drop a reference of a link, a proxy or the parent, the node is destroyed with the last reference
+  virtual void release();
+
+  void *operator new(size_t) noexcept;
   void operator delete(void *);
 
 protected:
-  VfsHandle *m_handle;
-  VfsNode *m_parent;
+  // Name index maintenance, called for a descendant node during renaming with the node locked,
+  // an index position returned by unindex is passed back to reindex after the name is changed
+  virtual void *unindex(VfsNode *);
+  virtual void reindex(VfsNode *, void *);
+
+  // Called with the last reference, nodes reachable by readers without references defer deletion
+  virtual void destroy();
 
-  std::unique_ptr<char [], std::function<void (char [])>> m_name;
+  // Usage of the subtree has grown, limits of ancestors are checked when requested
+  virtual bool charge(size_t, size_t, bool);
+  // Usage of the subtree has decreased
+  virtual void uncharge(size_t, size_t);
+
+  // Use a string with static storage duration as a name without copying it
+  void setStaticName(const char *);
+  // Report a change to watchers, should be called without node locks
+  void notify(VfsWatcher::Type);
+
+  VfsHandle *m_handle;
+  // Cleared concurrently with readers that reach the node through links and proxies
+  std::atomic<VfsNode *> m_parent;
   time64_t m_timestamp;
+
+private:
+  enum NameStorage: uint8_t
+  {
+    // Short name is stored inside the node
+    NAME_LOCAL,
+    // Name of medium length is allocated from the name cache
+    NAME_CACHED,
+    // Long name is allocated from the heap
+    NAME_ALLOCATED,
+    // Name is not owned by the node
+    NAME_STATIC
+  };
+
+  static constexpr size_t NAME_LOCAL_LENGTH{16};
+
+  union
+  {
+    const char *pointer;
+    char local[NAME_LOCAL_LENGTH];
+  } m_name;
+
+protected:
+  // Small fields are placed last, tail padding of the node is reused by derived classes
   FsAccess m_access;
+
+private:
+  // References held by links and proxies, the reference of the parent is not counted
+  std::atomic<uint16_t> m_links;
+  NameStorage m_nameStorage;
+
+  void releaseName();
+  void updateName(const char *, NameStorage);
 };
 
 class VfsNodeProxy
@@ -62,17 +230,22 @@ class VfsNodeProxy
 public:
   struct Config
   {
+    VfsHandle *handle;
     VfsNode *node;
+    const VfsNode::Cursor *cursor;
   };
 
   static const FsNodeClass table;
 
   VfsNodeProxy(const VfsNodeProxy &) = delete;
   VfsNodeProxy &operator=(const VfsNodeProxy &) = delete;
+  ~VfsNodeProxy();
 
   static Result init(void *object, const void *config)
   {
-    new (object) VfsNodeProxy{static_cast<const Config *>(config)->node};
+    const Config * const proxyConfig = static_cast<const Config *>(config);
+
+    new (object) VfsNodeProxy{proxyConfig->handle, proxyConfig->node, proxyConfig->cursor};
     return E_OK;
   }
 
@@ -123,16 +296,28 @@ public:
     return static_cast<VfsNodeProxy *>(object)->writeImpl(type, position, buffer, bufferLength, bytesWritten);
   }
 
+  static VfsNodeProxy *cast(FsNode *);
+
   VfsNode *get()
   {
     return m_node;
   }
 
+  VfsHandle *handle()
+  {
+    return m_handle;
+  }
+
 protected:
   FsNode m_base;
+  VfsHandle *m_handle;
+  // Node and the owner of the cursor are referenced by the proxy
   VfsNode *m_node;
+  VfsNode::Cursor m_cursor;
+
+  VfsNodeProxy(VfsHandle *, VfsNode *, const VfsNode::Cursor *);
 
-  VfsNodeProxy(VfsNode *);
+  void updateOwner(VfsNode *);
 
   Result createImpl(const struct FsFieldDescriptor *, size_t);
   void freeImpl();
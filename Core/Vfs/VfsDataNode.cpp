@@ -5,16 +5,68 @@
  */
 
 #include "Vfs/VfsDataNode.hpp"
-#include <cstdlib>
+#include "Vfs/VfsHandle.hpp"
+#include "Vfs/VfsSlab.hpp"
+#include <algorithm>
+#include <atomic>
 #include <cstring>
 
+struct alignas(std::max_align_t) VfsDataNode::Block
+{
+  std::atomic<size_t> references;
+  size_t capacity;
+
+  uint8_t *data()
+  {
+    return reinterpret_cast<uint8_t *>(this + 1);
+  }
+};
+
+struct alignas(std::max_align_t) VfsDataNode::External
+{
+  Release release;
+  void *argument;
+};
+
+struct VfsDataNode::ExtentLeaf
+{
+  std::atomic<size_t> references;
+  // Number of entries that are not holes
+  size_t used;
+  Block *entries[LEAF_EXTENTS];
+};
+
+struct VfsDataNode::ExtentTable
+{
+  std::atomic<size_t> references;
+  // Number of leaf slots, missing leaves are holes
+  size_t count;
+  // Number of extents that are not holes
+  size_t used;
+  // Number of allocated leaves
+  size_t populated;
+
+  ExtentLeaf **leaves()
+  {
+    return reinterpret_cast<ExtentLeaf **>(this + 1);
+  }
+};
+
+VfsDataNode::Storage VfsDataNode::s_defaultStorage{STORAGE_AUTO};
+
 VfsDataNode::VfsDataNode(time64_t timestamp, FsAccess access) :
   VfsNode{timestamp, access},
-  m_dataCapacity{0},
+  m_storage{s_defaultStorage},
   m_dataLength{0},
-  m_dataBuffer{nullptr, [](uint8_t pointer[]){ free(pointer); }}
+  m_buffer{nullptr},
+  m_extents{nullptr},
+  m_charged{0}
 {
-  // TODO Locks in read/write operations
+}
+
+VfsDataNode::~VfsDataNode()
+{
+  releaseData();
 }
 
 Result VfsDataNode::length(FsFieldType type, FsLength *fieldLength)
@@ -23,7 +75,10 @@ Result VfsDataNode::length(FsFieldType type, FsLength *fieldLength)
   {
     case FS_NODE_DATA:
       if (fieldLength != nullptr)
+      {
+        VfsHandle::SharedLocker locker{m_handle, this};
         *fieldLength = static_cast<FsLength>(m_dataLength);
+      }
       return E_OK;
 
     default:
@@ -31,6 +86,55 @@ Result VfsDataNode::length(FsFieldType type, FsLength *fieldLength)
   }
 }
 
+Result VfsDataNode::map(FsLength position, Mapping *mapping)
+{
+  if (!(m_access & FS_ACCESS_READ))
+    return E_ACCESS;
+
+  VfsHandle::SharedLocker locker{m_handle, this};
+
+  if (position > static_cast<FsLength>(m_dataLength))
+    return E_VALUE;
+
+  const size_t offset = static_cast<size_t>(position);
+  size_t chunk = MIN(m_dataLength - offset, mapping->length);
+  Block *block = nullptr;
+  const uint8_t *data = nullptr;
+
+  if (chunk > 0)
+  {
+    if (m_extents != nullptr)
+    {
+      // Holes are mapped to a shared block of zeros
+      static const uint8_t zeros[EXTENT_SIZE]{};
+
+      // Mapped range is clamped to the end of the extent
+      chunk = MIN(chunk, EXTENT_SIZE - offset % EXTENT_SIZE);
+
+      if ((block = extentAt(offset / EXTENT_SIZE)) != nullptr)
+        data = block->data() + offset % EXTENT_SIZE;
+      else
+        data = zeros + offset % EXTENT_SIZE;
+    }
+    else
+    {
+      block = m_buffer;
+      data = block->data() + offset;
+    }
+
+    // Block is copied on the next modification of the node while the mapping exists
+    if (block != nullptr)
+      block->references.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  mapping->data = data;
+  mapping->length = chunk;
+  mapping->token = block;
+  mapping->unmap = unmapBlock;
+
+  return E_OK;
+}
+
 Result VfsDataNode::read(FsFieldType type, FsLength position, void *buffer, size_t length, size_t *read)
 {
   switch (type)
@@ -39,18 +143,63 @@ Result VfsDataNode::read(FsFieldType type, FsLength position, void *buffer, size
     {
       if (!(m_access & FS_ACCESS_READ))
         return E_ACCESS;
+
+      VfsHandle::SharedLocker locker{m_handle, this};
+
       if (position > static_cast<FsLength>(m_dataLength))
         return E_VALUE;
 
       const size_t remaining = static_cast<size_t>(static_cast<FsLength>(m_dataLength) - position);
       const size_t chunk = MIN(remaining, length);
 
-      memcpy(buffer, m_dataBuffer.get() + position, chunk);
+      if (m_extents != nullptr)
+        readExtents(static_cast<size_t>(position), buffer, chunk);
+      else if (chunk > 0)
+        memcpy(buffer, m_buffer->data() + position, chunk);
+
       if (read)
         *read = chunk;
       return E_OK;
     }
 
+    default:
+      break;
+  }
+
+  switch (static_cast<VfsFieldType>(type))
+  {
+    case VFS_NODE_CLONE:
+    {
+      if (!(m_access & FS_ACCESS_READ))
+        return E_ACCESS;
+      if (position || length != sizeof(VfsDataNode *))
+        return E_VALUE;
+
+      // Node object is used as a source of shared data, the caller releases the reference
+      if (!acquire())
+        return E_FULL;
+
+      VfsDataNode * const pointer = this;
+      memcpy(buffer, &pointer, sizeof(pointer));
+
+      if (read)
+        *read = sizeof(pointer);
+      return E_OK;
+    }
+
+    case VFS_NODE_CAPACITY:
+    {
+      if (position || length != sizeof(FsLength))
+        return E_VALUE;
+
+      const auto capacity = static_cast<FsLength>(allocated());
+      memcpy(buffer, &capacity, sizeof(capacity));
+
+      if (read)
+        *read = sizeof(capacity);
+      return E_OK;
+    }
+
     default:
       return VfsNode::read(type, position, buffer, length, read);
   }
@@ -61,34 +210,567 @@ Result VfsDataNode::write(FsFieldType type, FsLength position, const void *buffe
   switch (type)
   {
     case FS_NODE_DATA:
+    {
+      if (!(m_access & FS_ACCESS_WRITE))
+        return E_ACCESS;
+
+      Result res;
+
+      {
+        VfsHandle::Locker locker{m_handle, this};
+        const auto end = static_cast<size_t>(position + static_cast<FsLength>(length));
+
+        // Writes over the limit of an ancestor fail before any memory is allocated
+        if (!account(required(static_cast<size_t>(position), end, true)))
+          return E_FULL;
+
+        res = writeDataBuffer(position, buffer, length, written);
+
+        if (!settle() && res == E_OK)
+          res = E_FULL;
+      }
+
+      if (res == E_OK)
+        notify(VfsWatcher::EVENT_WRITE);
+      return res;
+    }
+
+    default:
+      break;
+  }
+
+  switch (static_cast<VfsFieldType>(type))
+  {
+    case VFS_NODE_CAPACITY:
+    case VFS_NODE_LENGTH:
+    {
       if (!(m_access & FS_ACCESS_WRITE))
         return E_ACCESS;
+      if (position || length != sizeof(FsLength))
+        return E_VALUE;
+
+      FsLength value;
+      memcpy(&value, buffer, sizeof(value));
+
+      if (static_cast<FsLength>(static_cast<size_t>(value)) != value)
+        return E_VALUE;
 
-      return writeDataBuffer(position, buffer, length, written);
+      const auto size = static_cast<size_t>(value);
+      const Result res = static_cast<VfsFieldType>(type) == VFS_NODE_LENGTH ? truncate(size) : preallocate(size);
+
+      if (res != E_OK)
+        return res;
+
+      // Storage reservation does not change the data
+      if (static_cast<VfsFieldType>(type) == VFS_NODE_LENGTH)
+        notify(VfsWatcher::EVENT_WRITE);
+
+      if (written)
+        *written = sizeof(value);
+      return E_OK;
+    }
 
     default:
       return VfsNode::write(type, position, buffer, length, written);
   }
 }
 
-bool VfsDataNode::reallocateDataBuffer(size_t length)
+VfsNode::Usage VfsDataNode::detach()
+{
+  VfsHandle::Locker locker{m_handle, this};
+
+  // Memory is charged under the lock, later changes are not propagated to former ancestors
+  m_parent.store(nullptr, std::memory_order_release);
+  return Usage{m_charged, 1};
+}
+
+VfsNode::Usage VfsDataNode::usage() const
+{
+  VfsHandle::SharedLocker locker{m_handle, this};
+  return Usage{m_charged, 1};
+}
+
+bool VfsDataNode::clone(const VfsDataNode &source)
+{
+  if (&source == this)
+    return true;
+
+  Block *buffer;
+  ExtentTable *extents;
+  size_t length;
+  Storage storage;
+
+  {
+    // Nodes are locked one after another to avoid nested locks
+    VfsHandle::SharedLocker locker{source.m_handle, &source};
+
+    storage = source.m_storage;
+    buffer = source.m_buffer;
+    extents = source.m_extents;
+    length = source.m_dataLength;
+
+    if (buffer != nullptr)
+      buffer->references.fetch_add(1, std::memory_order_relaxed);
+    if (extents != nullptr)
+      extents->references.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  VfsHandle::Locker locker{m_handle, this};
+
+  releaseData();
+
+  // Representation of shared data is kept, new data is stored the same way
+  m_storage = storage;
+  m_buffer = buffer;
+  m_extents = extents;
+  m_dataLength = length;
+
+  // Shared data is charged to each node, data is dropped when ancestors are over the limit
+  return settleShared();
+}
+
+bool VfsDataNode::share(void *header, size_t length, Release callback, void *argument)
+{
+  static_assert(sizeof(External) + sizeof(Block) == EXTERNAL_HEADER_SIZE, "Incorrect external header size");
+
+  // Biased counter keeps the block shared, so it is copied before any modification
+  const auto external = new (header) External{callback, argument};
+  const auto block = new (external + 1) Block{{EXTERNAL_BIAS + 1}, length};
+
+  VfsHandle::Locker locker{m_handle, this};
+
+  releaseData();
+
+  m_buffer = block;
+  m_dataLength = length;
+
+  return settleShared();
+}
+
+bool VfsDataNode::reserve(size_t length, char fill)
+{
+  VfsHandle::Locker locker{m_handle, this};
+
+  releaseData();
+  settle();
+
+  if (length == 0)
+    return true;
+  if (!account(required(0, length, fill != '\0')))
+    return false;
+
+  bool ok;
+
+  if (useExtents(length))
+  {
+    // Zero-filled node consists of holes only
+    ok = fill != '\0' ? allocateExtents(0, length, nullptr) : reserveExtentTable(length);
+
+    if (ok && fill != '\0')
+    {
+      for (size_t offset = 0; offset < length; offset += EXTENT_SIZE)
+        memset(extentAt(offset / EXTENT_SIZE)->data(), fill, MIN(EXTENT_SIZE, length - offset));
+    }
+  }
+  else
+  {
+    if ((ok = reallocateDataBuffer(length)))
+      memset(m_buffer->data(), fill, length);
+  }
+
+  if (ok)
+    m_dataLength = length;
+  else
+    releaseData();
+
+  return settle() && ok;
+}
+
+bool VfsDataNode::reserve(const void *data, size_t length)
+{
+  VfsHandle::Locker locker{m_handle, this};
+
+  releaseData();
+  settle();
+
+  if (length == 0)
+    return true;
+  if (!account(required(0, length, true)))
+    return false;
+
+  const bool ok = writeDataBuffer(0, data, length, nullptr) == E_OK;
+
+  if (!ok)
+    releaseData();
+
+  return settle() && ok;
+}
+
+bool VfsDataNode::reserve(const char *text)
+{
+  return reserve(text, text != nullptr ? strlen(text) : 0);
+}
+
+Result VfsDataNode::truncate(size_t length)
+{
+  VfsHandle::Locker locker{m_handle, this};
+  bool ok = true;
+
+  if (length == 0)
+  {
+    // Storage of an empty node is released
+    releaseData();
+  }
+  else if (length < m_dataLength)
+  {
+    ok = shrinkData(length);
+  }
+  else if (length > m_dataLength)
+  {
+    if (!account(required(m_dataLength, length, false)))
+      return E_FULL;
+
+    ok = extendData(length);
+  }
+
+  if (!settle())
+    return E_FULL;
+  return ok ? E_OK : E_MEMORY;
+}
+
+Result VfsDataNode::preallocate(size_t length)
+{
+  VfsHandle::Locker locker{m_handle, this};
+  bool ok = true;
+
+  if (m_extents != nullptr || useExtents(length))
+  {
+    if (!account(extentsRequired(0, length, false)))
+      return E_FULL;
+
+    if (m_extents == nullptr)
+      ok = convertToExtents();
+
+    // Only the extent table is reserved, holes stay unallocated until written
+    if (ok)
+      ok = reserveExtentTable(length);
+  }
+  else
+  {
+    const size_t capacity = m_buffer != nullptr ? m_buffer->capacity : 0;
+
+    length = std::max(length, m_dataLength);
+
+    if (m_buffer == nullptr || length > capacity || m_buffer->references.load(std::memory_order_acquire) > 1)
+    {
+      if (!account(length > capacity ? length - capacity : 0))
+        return E_FULL;
+
+      // Buffer is allocated once with the requested capacity
+      ok = reallocateDataBuffer(length, true);
+    }
+  }
+
+  if (!settle())
+    return E_FULL;
+  return ok ? E_OK : E_MEMORY;
+}
+
+bool VfsDataNode::setStorage(Storage storage)
+{
+  VfsHandle::Locker locker{m_handle, this};
+  bool ok = true;
+
+  // New storage is allocated before the old one is released, both are charged during conversion
+  if (storage == STORAGE_CONTIGUOUS && m_extents != nullptr)
+  {
+    if (!account(m_dataLength))
+      return false;
+
+    ok = convertToBuffer();
+  }
+  else if (storage == STORAGE_EXTENTS && m_extents == nullptr && m_dataLength > 0)
+  {
+    if (!account(extentsRequired(0, m_dataLength, true)))
+      return false;
+
+    ok = convertToExtents();
+  }
+
+  if (ok)
+    m_storage = storage;
+
+  return settle() && ok;
+}
+
+size_t VfsDataNode::allocated() const
+{
+  VfsHandle::SharedLocker locker{m_handle, this};
+  return storage();
+}
+
+bool VfsDataNode::isZeroFilled(const void *buffer, size_t length)
+{
+  const auto data = static_cast<const uint8_t *>(buffer);
+  return length == 0 || (data[0] == 0 && !memcmp(data, data + 1, length - 1));
+}
+
+void *VfsDataNode::operator new(size_t size) noexcept
+{
+  return VfsSlab::dataCache().allocate(size);
+}
+
+bool VfsDataNode::account(size_t bytes)
+{
+  if (bytes > 0 && !VfsNode::charge(bytes, 0, true))
+    return false;
+
+  m_charged += bytes;
+  return true;
+}
+
+bool VfsDataNode::settle()
+{
+  // Charged memory is an upper estimate, it is replaced with the size of the allocated storage
+  const size_t used = footprint();
+
+  if (used > m_charged)
+  {
+    // Growth beyond the estimate is limited as well, the uncharged part is retried on the next operation
+    if (!VfsNode::charge(used - m_charged, 0, true))
+      return false;
+  }
+  else if (used < m_charged)
+    VfsNode::uncharge(m_charged - used, 0);
+
+  m_charged = used;
+  return true;
+}
+
+bool VfsDataNode::settleShared()
+{
+  if (settle())
+    return true;
+
+  releaseData();
+  settle();
+  return false;
+}
+
+size_t VfsDataNode::footprint() const
+{
+  // Extent table and allocated leaves are charged together with the extents
+  if (m_extents != nullptr)
+    return storage() + tableSize(m_extents->count) + m_extents->populated * sizeof(ExtentLeaf);
+  else
+    return storage();
+}
+
+size_t VfsDataNode::storage() const
+{
+  if (m_extents != nullptr)
+    return m_extents->used * EXTENT_SIZE;
+  else
+    return m_buffer != nullptr ? m_buffer->capacity : 0;
+}
+
+size_t VfsDataNode::required(size_t position, size_t end, bool fill) const
+{
+  if (m_extents != nullptr || useExtents(end))
+    return extentsRequired(position, end, fill);
+
+  const size_t capacity = m_buffer != nullptr ? m_buffer->capacity : 0;
+
+  // Buffer shared with a clone is copied before modification
+  if (m_buffer != nullptr && m_buffer->references.load(std::memory_order_acquire) > 1)
+    return bufferCapacity(end);
+  else
+    return end > capacity ? bufferCapacity(end) - capacity : 0;
+}
+
+size_t VfsDataNode::extentsRequired(size_t position, size_t end, bool fill) const
+{
+  const size_t first = position / EXTENT_SIZE;
+  const size_t last = fill && end > position ? (end + EXTENT_SIZE - 1) / EXTENT_SIZE : first;
+  size_t count = 0;
+  size_t leaves = 0;
+  size_t slots = 0;
+
+  if (m_extents == nullptr)
+  {
+    // Existing data is moved into extents, only the range beyond it may contain new extents
+    const size_t converted = (m_dataLength + EXTENT_SIZE - 1) / EXTENT_SIZE;
+    const size_t start = std::max(first, converted);
+
+    count = converted + (last > start ? last - start : 0);
+    leaves = (converted + LEAF_EXTENTS - 1) / LEAF_EXTENTS;
+
+    if (last > start)
+    {
+      const size_t tail = (last + LEAF_EXTENTS - 1) / LEAF_EXTENTS;
+      leaves += tail - std::min(std::max(start / LEAF_EXTENTS, leaves), tail);
+    }
+
+    slots = tableSlots(INITIAL_LEAVES, std::max(end, m_dataLength));
+  }
+  else
+  {
+    const bool shared = m_extents->references.load(std::memory_order_acquire) > 1;
+    const size_t grown = tableSlots(m_extents->count, end);
+
+    // Shared table is copied before modification, a longer table is reallocated
+    if (shared || grown != m_extents->count)
+      slots = grown;
+
+    for (size_t index = first; index < last; ++index)
+    {
+      const size_t slot = index / LEAF_EXTENTS;
+      const ExtentLeaf * const leaf = slot < m_extents->count ? m_extents->leaves()[slot] : nullptr;
+      const bool copied = leaf != nullptr && (shared || leaf->references.load(std::memory_order_acquire) > 1);
+
+      // Missing and shared leaves are allocated once per leaf
+      if ((leaf == nullptr || copied) && (index == first || index % LEAF_EXTENTS == 0))
+        ++leaves;
+
+      // Shared extents are copied before modification
+      const Block * const block = leaf != nullptr ? leaf->entries[index % LEAF_EXTENTS] : nullptr;
+
+      if (block == nullptr || copied || block->references.load(std::memory_order_acquire) > 1)
+        ++count;
+    }
+  }
+
+  return count * EXTENT_SIZE + leaves * sizeof(ExtentLeaf) + (slots ? tableSize(slots) : 0);
+}
+
+size_t VfsDataNode::bufferCapacity(size_t length) const
+{
+  // Capacity is doubled to reduce the number of reallocations during appends
+  size_t capacity = m_buffer != nullptr ? m_buffer->capacity : 0;
+
+  if (!capacity)
+    capacity = INITIAL_LENGTH;
+  while (capacity < length)
+    capacity *= 2;
+
+  return capacity;
+}
+
+bool VfsDataNode::allocateExtents(size_t position, size_t length, const void *data)
+{
+  if (!length)
+    return true;
+  if (!reserveExtentTable(position + length))
+    return false;
+
+  auto input = static_cast<const uint8_t *>(data);
+
+  while (length)
+  {
+    const size_t offset = position % EXTENT_SIZE;
+    const size_t chunk = MIN(EXTENT_SIZE - offset, length);
+    const size_t index = position / EXTENT_SIZE;
+
+    // Holes are kept when the data written to them consists of zeros
+    if (extentAt(index) != nullptr || input == nullptr || !isZeroFilled(input, chunk))
+    {
+      ExtentLeaf * const leaf = privateLeaf(index);
+
+      if (leaf == nullptr)
+        return false;
+
+      Block ** const extent = leaf->entries + index % LEAF_EXTENTS;
+
+      if (*extent != nullptr && (*extent)->references.load(std::memory_order_acquire) > 1)
+      {
+        // Extent is shared with a clone, make a private copy before modification
+        Block * const copy = makeExtent();
+
+        if (copy == nullptr)
+          return false;
+
+        memcpy(copy->data(), (*extent)->data(), EXTENT_SIZE);
+
+        releaseBlock(*extent);
+        *extent = copy;
+      }
+      else if (*extent == nullptr)
+      {
+        Block * const block = makeExtent();
+
+        if (block == nullptr)
+          return false;
+
+        // Unwritten parts of the extent should be read as zeros
+        memset(block->data(), 0, EXTENT_SIZE);
+
+        *extent = block;
+        ++leaf->used;
+        ++m_extents->used;
+      }
+    }
+
+    if (input != nullptr)
+      input += chunk;
+    position += chunk;
+    length -= chunk;
+  }
+
+  return true;
+}
+
+bool VfsDataNode::convertToBuffer()
+{
+  Block *buffer = nullptr;
+
+  if (m_dataLength > 0)
+  {
+    if ((buffer = makeBlock(m_dataLength)) == nullptr)
+      return false;
+
+    readExtents(0, buffer->data(), m_dataLength);
+  }
+
+  releaseExtentTable(m_extents);
+  m_extents = nullptr;
+  m_buffer = buffer;
+
+  return true;
+}
+
+bool VfsDataNode::convertToExtents()
 {
-  auto dataCapacity = m_dataCapacity;
+  const uint8_t * const data = m_buffer != nullptr ? m_buffer->data() : nullptr;
 
-  if (!dataCapacity)
-    dataCapacity = INITIAL_LENGTH;
-  while (dataCapacity < length)
-    dataCapacity *= 2;
+  if (!reserveExtentTable(m_dataLength))
+    return false;
 
-  const auto reallocatedDataBuffer = static_cast<uint8_t *>(malloc(dataCapacity));
+  if (!allocateExtents(0, m_dataLength, data))
+  {
+    releaseExtentTable(m_extents);
+    m_extents = nullptr;
+    return false;
+  }
+
+  writeExtents(0, data, m_dataLength);
+  releaseBlock(m_buffer);
+  m_buffer = nullptr;
+
+  return true;
+}
+
+bool VfsDataNode::reallocateDataBuffer(size_t length, bool exact)
+{
+  const size_t dataCapacity = exact ? length : bufferCapacity(length);
+  Block * const reallocatedDataBuffer = makeBlock(dataCapacity);
 
   if (reallocatedDataBuffer != nullptr)
   {
     if (m_dataLength > 0)
-      memcpy(reallocatedDataBuffer, m_dataBuffer.get(), m_dataLength);
+      memcpy(reallocatedDataBuffer->data(), m_buffer->data(), m_dataLength);
 
-    m_dataBuffer.reset(reallocatedDataBuffer);
-    m_dataCapacity = dataCapacity;
+    releaseBlock(m_buffer);
+    m_buffer = reallocatedDataBuffer;
 
     return true;
   }
@@ -96,18 +778,290 @@ bool VfsDataNode::reallocateDataBuffer(size_t length)
     return false;
 }
 
+void VfsDataNode::releaseData()
+{
+  releaseExtentTable(m_extents);
+  releaseBlock(m_buffer);
+
+  m_dataLength = 0;
+  m_buffer = nullptr;
+  m_extents = nullptr;
+}
+
+bool VfsDataNode::extendData(size_t length)
+{
+  if (m_extents == nullptr && useExtents(length))
+  {
+    if (!convertToExtents())
+      return false;
+  }
+
+  if (m_extents != nullptr)
+  {
+    // Appended range consists of holes
+    if (!reserveExtentTable(length))
+      return false;
+  }
+  else
+  {
+    if (m_buffer == nullptr || length > m_buffer->capacity
+        || m_buffer->references.load(std::memory_order_acquire) > 1)
+    {
+      if (!reallocateDataBuffer(length))
+        return false;
+    }
+
+    memset(m_buffer->data() + m_dataLength, 0, length - m_dataLength);
+  }
+
+  m_dataLength = length;
+  return true;
+}
+
+bool VfsDataNode::shrinkData(size_t length)
+{
+  if (m_extents != nullptr)
+  {
+    const size_t offset = length % EXTENT_SIZE;
+
+    // Extent table shared with a clone is copied before modification
+    if (!reserveExtentTable(length))
+      return false;
+
+    if (offset != 0 && extentAt(length / EXTENT_SIZE) != nullptr)
+    {
+      // Tail of the last extent is cleared, data beyond the end of the node is read as zeros after growth
+      if (!allocateExtents(length, EXTENT_SIZE - offset, nullptr))
+        return false;
+
+      memset(extentAt(length / EXTENT_SIZE)->data() + offset, 0, EXTENT_SIZE - offset);
+    }
+
+    const size_t first = (length + EXTENT_SIZE - 1) / EXTENT_SIZE;
+    ExtentLeaf ** const leaves = m_extents->leaves();
+
+    for (size_t slot = first / LEAF_EXTENTS; slot < m_extents->count; ++slot)
+    {
+      if (leaves[slot] == nullptr)
+        continue;
+
+      if (slot * LEAF_EXTENTS >= first)
+      {
+        // Leaves beyond the end are dropped without copying
+        m_extents->used -= leaves[slot]->used;
+        --m_extents->populated;
+        releaseExtentLeaf(leaves[slot]);
+        leaves[slot] = nullptr;
+        continue;
+      }
+
+      const auto tail = std::find_if(leaves[slot]->entries + first % LEAF_EXTENTS,
+          leaves[slot]->entries + LEAF_EXTENTS, [](const Block *block){ return block != nullptr; });
+
+      if (tail != leaves[slot]->entries + LEAF_EXTENTS)
+      {
+        // Leaf is partially beyond the end and may be shared with a clone
+        ExtentLeaf * const leaf = privateLeaf(first);
+
+        if (leaf == nullptr)
+          return false;
+
+        for (size_t index = first % LEAF_EXTENTS; index < LEAF_EXTENTS; ++index)
+        {
+          if (leaf->entries[index] != nullptr)
+          {
+            releaseBlock(leaf->entries[index]);
+            leaf->entries[index] = nullptr;
+            --leaf->used;
+            --m_extents->used;
+          }
+        }
+      }
+    }
+  }
+
+  // Contiguous buffer is not reallocated, the gap is cleared on the next growth
+  m_dataLength = length;
+  return true;
+}
+
+bool VfsDataNode::reserveExtentTable(size_t length)
+{
+  const size_t count = tableSlots(m_extents != nullptr ? m_extents->count : INITIAL_LEAVES, length);
+  const bool shared = m_extents != nullptr && m_extents->references.load(std::memory_order_acquire) > 1;
+
+  if (m_extents != nullptr && !shared && count == m_extents->count)
+    return true;
+
+  ExtentTable * const table = makeExtentTable(count);
+
+  if (table == nullptr)
+    return false;
+
+  if (m_extents != nullptr)
+  {
+    ExtentLeaf ** const leaves = m_extents->leaves();
+
+    std::copy(leaves, leaves + m_extents->count, table->leaves());
+    table->used = m_extents->used;
+    table->populated = m_extents->populated;
+
+    if (shared)
+    {
+      // Leaves are referenced by both tables until modified
+      for (size_t slot = 0; slot < m_extents->count; ++slot)
+      {
+        if (leaves[slot] != nullptr)
+          leaves[slot]->references.fetch_add(1, std::memory_order_relaxed);
+      }
+
+      releaseExtentTable(m_extents);
+    }
+    else
+    {
+      // Leaves are moved to the new table
+      VfsSlab::release(m_extents);
+    }
+  }
+
+  m_extents = table;
+  return true;
+}
+
+VfsDataNode::Block *VfsDataNode::extentAt(size_t index) const
+{
+  const size_t slot = index / LEAF_EXTENTS;
+
+  if (slot >= m_extents->count)
+    return nullptr;
+
+  const ExtentLeaf * const leaf = m_extents->leaves()[slot];
+  return leaf != nullptr ? leaf->entries[index % LEAF_EXTENTS] : nullptr;
+}
+
+VfsDataNode::ExtentLeaf *VfsDataNode::privateLeaf(size_t index)
+{
+  // Table should be private and should cover the index
+  ExtentLeaf ** const leaf = m_extents->leaves() + index / LEAF_EXTENTS;
+
+  if (*leaf == nullptr)
+  {
+    if ((*leaf = makeExtentLeaf()) != nullptr)
+      ++m_extents->populated;
+  }
+  else if ((*leaf)->references.load(std::memory_order_acquire) > 1)
+  {
+    ExtentLeaf * const copy = makeExtentLeaf();
+
+    if (copy == nullptr)
+      return nullptr;
+
+    // Extents are referenced by both leaves until modified
+    for (size_t entry = 0; entry < LEAF_EXTENTS; ++entry)
+    {
+      if ((copy->entries[entry] = (*leaf)->entries[entry]) != nullptr)
+        copy->entries[entry]->references.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    copy->used = (*leaf)->used;
+    releaseExtentLeaf(*leaf);
+    *leaf = copy;
+  }
+
+  return *leaf;
+}
+
+void VfsDataNode::readExtents(size_t position, void *buffer, size_t length) const
+{
+  auto output = static_cast<uint8_t *>(buffer);
+
+  while (length)
+  {
+    const size_t offset = position % EXTENT_SIZE;
+    const size_t chunk = MIN(EXTENT_SIZE - offset, length);
+    Block * const extent = extentAt(position / EXTENT_SIZE);
+
+    if (extent != nullptr)
+      memcpy(output, extent->data() + offset, chunk);
+    else
+      memset(output, 0, chunk);
+
+    output += chunk;
+    position += chunk;
+    length -= chunk;
+  }
+}
+
+bool VfsDataNode::useExtents(size_t length) const
+{
+  switch (m_storage)
+  {
+    case STORAGE_CONTIGUOUS:
+      return false;
+
+    case STORAGE_EXTENTS:
+      return true;
+
+    default:
+      return length > EXTENT_THRESHOLD;
+  }
+}
+
+void VfsDataNode::writeExtents(size_t position, const void *buffer, size_t length)
+{
+  auto input = static_cast<const uint8_t *>(buffer);
+
+  while (length)
+  {
+    const size_t offset = position % EXTENT_SIZE;
+    const size_t chunk = MIN(EXTENT_SIZE - offset, length);
+    Block * const extent = extentAt(position / EXTENT_SIZE);
+
+    // Zeros are not written into holes
+    if (extent != nullptr)
+      memcpy(extent->data() + offset, input, chunk);
+
+    input += chunk;
+    position += chunk;
+    length -= chunk;
+  }
+}
+
 Result VfsDataNode::writeDataBuffer(FsLength position, const void *buffer, size_t length, size_t *written)
 {
-  auto * const bufferPosition = static_cast<const uint8_t *>(buffer);
   const auto end = static_cast<size_t>(position + static_cast<FsLength>(length));
 
-  if (end > m_dataCapacity)
+  if (m_extents == nullptr && useExtents(end))
   {
-    if (!reallocateDataBuffer(end))
+    if (!convertToExtents())
       return E_MEMORY;
   }
 
-  memcpy(m_dataBuffer.get() + static_cast<size_t>(position), bufferPosition, length);
+  if (m_extents != nullptr)
+  {
+    // Existing data is never moved in extent mode
+    if (!allocateExtents(static_cast<size_t>(position), length, buffer))
+      return E_MEMORY;
+
+    writeExtents(static_cast<size_t>(position), buffer, length);
+  }
+  else
+  {
+    // Buffer shared with a clone is copied before modification
+    if (m_buffer == nullptr || end > m_buffer->capacity
+        || m_buffer->references.load(std::memory_order_acquire) > 1)
+    {
+      if (!reallocateDataBuffer(end))
+        return E_MEMORY;
+    }
+
+    // Gap between the end of data and the write position is filled with zeros
+    if (static_cast<size_t>(position) > m_dataLength)
+      memset(m_buffer->data() + m_dataLength, 0, static_cast<size_t>(position) - m_dataLength);
+
+    memcpy(m_buffer->data() + static_cast<size_t>(position), buffer, length);
+  }
+
   if (end > m_dataLength)
     m_dataLength = end;
 
@@ -117,49 +1071,103 @@ Result VfsDataNode::writeDataBuffer(FsLength position, const void *buffer, size_
   return E_OK;
 }
 
-bool VfsDataNode::reserve(size_t length, char fill)
+VfsDataNode::Block *VfsDataNode::makeBlock(size_t capacity)
 {
-  if (length > 0)
+  void * const memory = VfsSlab::allocateHeap(sizeof(Block) + capacity);
+  return memory != nullptr ? new (memory) Block{{1}, capacity} : nullptr;
+}
+
+VfsDataNode::Block *VfsDataNode::makeExtent()
+{
+  // Extent cache reserves space for the block header in front of the extent data
+  static_assert(sizeof(Block) == alignof(std::max_align_t), "Incorrect block header size");
+
+  void * const memory = VfsSlab::extentCache().allocate(sizeof(Block) + EXTENT_SIZE);
+  return memory != nullptr ? new (memory) Block{{1}, EXTENT_SIZE} : nullptr;
+}
+
+VfsDataNode::ExtentLeaf *VfsDataNode::makeExtentLeaf()
+{
+  void * const memory = VfsSlab::allocateHeap(sizeof(ExtentLeaf));
+  return memory != nullptr ? new (memory) ExtentLeaf{{1}, 0, {}} : nullptr;
+}
+
+VfsDataNode::ExtentTable *VfsDataNode::makeExtentTable(size_t count)
+{
+  void * const memory = VfsSlab::allocateHeap(tableSize(count));
+
+  if (memory != nullptr)
   {
-    if (!reallocateDataBuffer(length))
-      return false;
+    const auto table = new (memory) ExtentTable{{1}, count, 0, 0};
 
-    memset(m_dataBuffer.get(), fill, length);
-    m_dataLength = length;
+    std::fill(table->leaves(), table->leaves() + count, nullptr);
+    return table;
   }
   else
-  {
-    m_dataCapacity = 0;
-    m_dataLength = 0;
-    m_dataBuffer.reset();
-  }
+    return nullptr;
+}
 
-  return true;
+size_t VfsDataNode::tableSize(size_t count)
+{
+  return sizeof(ExtentTable) + count * sizeof(ExtentLeaf *);
 }
 
-bool VfsDataNode::reserve(const void *data, size_t length)
+size_t VfsDataNode::tableSlots(size_t count, size_t length)
 {
-  if (length > 0)
-  {
-    auto * const position = static_cast<const uint8_t *>(data);
+  const size_t extents = (length + EXTENT_SIZE - 1) / EXTENT_SIZE;
+  const size_t required = (extents + LEAF_EXTENTS - 1) / LEAF_EXTENTS;
 
-    if (!reallocateDataBuffer(length))
-      return false;
+  // Table is grown by doubling the number of leaf slots
+  while (count < required)
+    count *= 2;
 
-    memcpy(m_dataBuffer.get(), position, length);
-    m_dataLength = length;
+  return count;
+}
+
+void VfsDataNode::releaseBlock(Block *block)
+{
+  if (block == nullptr)
+    return;
+
+  const size_t references = block->references.fetch_sub(1, std::memory_order_acq_rel);
+
+  if (references == 1)
+  {
+    VfsSlab::release(block);
   }
-  else
+  else if (references == EXTERNAL_BIAS + 1)
   {
-    m_dataCapacity = 0;
-    m_dataLength = 0;
-    m_dataBuffer.reset();
+    // Last user of external data is gone, memory is returned to the owner
+    const External * const external = reinterpret_cast<const External *>(block) - 1;
+    external->release(external->argument);
   }
+}
 
-  return true;
+void VfsDataNode::unmapBlock(void *token)
+{
+  releaseBlock(static_cast<Block *>(token));
 }
 
-bool VfsDataNode::reserve(const char *text)
+void VfsDataNode::releaseExtentLeaf(ExtentLeaf *leaf)
 {
-  return reserve(text, text != nullptr ? strlen(text) : 0);
+  if (leaf != nullptr && leaf->references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+  {
+    for (const auto block : leaf->entries)
+      releaseBlock(block);
+
+    VfsSlab::release(leaf);
+  }
+}
+
+void VfsDataNode::releaseExtentTable(ExtentTable *table)
+{
+  if (table != nullptr && table->references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+  {
+    ExtentLeaf ** const leaves = table->leaves();
+
+    for (size_t slot = 0; slot < table->count; ++slot)
+      releaseExtentLeaf(leaves[slot]);
+
+    VfsSlab::release(table);
+  }
 }
@@ -8,30 +8,146 @@
 #define VFS_SHELL_CORE_VFS_VFSDATANODE_HPP_
 
 #include "Vfs/Vfs.hpp"
-#include <memory>
+#include <cstddef>
+
+#ifndef CONFIG_VFS_EXTENT_SIZE
+#  define CONFIG_VFS_EXTENT_SIZE 256
+#endif
+
+#ifndef CONFIG_VFS_EXTENT_THRESHOLD
+#  define CONFIG_VFS_EXTENT_THRESHOLD (CONFIG_VFS_EXTENT_SIZE * 8)
+#endif
 
 class VfsDataNode: public VfsNode
 {
 public:
+  enum Storage: uint8_t
+  {
+    // Contiguous buffer for small files and extents for large files
+    STORAGE_AUTO,
+    // Single buffer reallocated on growth
+    STORAGE_CONTIGUOUS,
+    // List of fixed-size extents, data is never moved on growth, holes take no memory
+    STORAGE_EXTENTS
+  };
+
+  // Callback invoked when external data is no longer used by nodes
+  using Release = void (*)(void *);
+
+  static constexpr size_t EXTENT_SIZE{CONFIG_VFS_EXTENT_SIZE};
+  // Nodes with automatic storage switch to extents when data grows beyond the threshold
+  static constexpr size_t EXTENT_THRESHOLD{CONFIG_VFS_EXTENT_THRESHOLD};
+  // Space reserved in front of external data for the block header
+  static constexpr size_t EXTERNAL_HEADER_SIZE{2 * alignof(std::max_align_t)};
+
   VfsDataNode(time64_t = 0, FsAccess = FS_ACCESS_READ | FS_ACCESS_WRITE);
+  ~VfsDataNode() override;
 
   virtual Result length(FsFieldType, FsLength *) override;
+  virtual Result map(FsLength, Mapping *) override;
   virtual Result read(FsFieldType, FsLength, void *, size_t, size_t *) override;
   virtual Result write(FsFieldType, FsLength, const void *, size_t, size_t *) override;
 
+  virtual Usage detach() override;
+  virtual Usage usage() const override;
+
+  // Share data with another node, data is copied on the first modification
+  bool clone(const VfsDataNode &);
+  // Use external data placed after a reserved header, data is copied on the first modification
+  bool share(void *, size_t, Release, void *);
+
   bool reserve(size_t, char);
   bool reserve(const void *, size_t);
   bool reserve(const char *);
 
+  // Change length of data, appended range is read as zeros
+  Result truncate(size_t);
+  // Allocate storage for data of the specified length without changing the data length, extent nodes reserve the table only
+  Result preallocate(size_t);
+
+  bool setStorage(Storage);
+  size_t allocated() const;
+
+  bool extents() const
+  {
+    return m_extents != nullptr;
+  }
+
+  static void setDefaultStorage(Storage storage)
+  {
+    s_defaultStorage = storage;
+  }
+
+  // Data consisting of zeros is not stored, holes are read as zeros
+  static bool isZeroFilled(const void *, size_t);
+
+  void *operator new(size_t) noexcept;
+
 private:
+  // Reference-counted memory block shared between cloned nodes
+  struct Block;
+  // Fixed-size group of extents, shared between extent tables of cloned nodes
+  struct ExtentLeaf;
+  struct ExtentTable;
+  // Owner of an external block, placed in front of the block header
+  struct External;
+
+  // Counter bias of external blocks, such blocks are never released to the heap
+  static constexpr size_t EXTERNAL_BIAS{static_cast<size_t>(1) << (sizeof(size_t) * 8 - 2)};
+
   static constexpr size_t INITIAL_LENGTH{16};
+  static constexpr size_t INITIAL_LEAVES{1};
+  // Leaves are allocated only for ranges with data, long holes take one pointer per leaf
+  static constexpr size_t LEAF_EXTENTS{64};
+
+  static Storage s_defaultStorage;
+
+  // Small fields are placed first to fill the tail padding of the base node
+  Storage m_storage;
 
-  size_t m_dataCapacity;
   size_t m_dataLength;
-  std::unique_ptr<uint8_t [], std::function<void (uint8_t [])>> m_dataBuffer;
+  Block *m_buffer;
+
+  // Extent table replaces the contiguous buffer when allocated
+  ExtentTable *m_extents;
+
+  // Memory charged to ancestors, equals the footprint between operations unless a limit is reached
+  size_t m_charged;
 
-  bool reallocateDataBuffer(size_t);
+  bool account(size_t);
+  bool settle();
+  bool settleShared();
+  size_t footprint() const;
+  size_t storage() const;
+  size_t required(size_t, size_t, bool) const;
+  size_t extentsRequired(size_t, size_t, bool) const;
+  size_t bufferCapacity(size_t) const;
+
+  bool allocateExtents(size_t, size_t, const void *);
+  bool convertToBuffer();
+  bool convertToExtents();
+  bool reallocateDataBuffer(size_t, bool = false);
+  void releaseData();
+  bool extendData(size_t);
+  bool shrinkData(size_t);
+  bool reserveExtentTable(size_t);
+  Block *extentAt(size_t) const;
+  ExtentLeaf *privateLeaf(size_t);
+  void readExtents(size_t, void *, size_t) const;
+  bool useExtents(size_t) const;
+  void writeExtents(size_t, const void *, size_t);
   Result writeDataBuffer(FsLength, const void *, size_t, size_t *);
+
+  static Block *makeBlock(size_t);
+  static Block *makeExtent();
+  static ExtentLeaf *makeExtentLeaf();
+  static ExtentTable *makeExtentTable(size_t);
+  static size_t tableSize(size_t);
+  static size_t tableSlots(size_t, size_t);
+  static void releaseBlock(Block *);
+  static void releaseExtentLeaf(ExtentLeaf *);
+  static void releaseExtentTable(ExtentTable *);
+  static void unmapBlock(void *);
 };
 
 #endif // VFS_SHELL_CORE_VFS_VFSDATANODE_HPP_
@@ -7,27 +7,106 @@
 #include "Vfs/VfsDataNode.hpp"
 #include "Vfs/VfsDirectory.hpp"
 #include "Vfs/VfsHandle.hpp"
-#include <algorithm>
+#include "Vfs/VfsLink.hpp"
+#include "Vfs/VfsSlab.hpp"
 #include <cstring>
-#include <new>
+
+// Counters of a removed directory are marked, changes of them are not propagated to ancestors
+static constexpr size_t DETACHED{~(~size_t{0} >> 1)};
+
+// Source of entry stamps, stamps of entries grow in order of creation and identify the nodes
+static std::atomic<uint64_t> entryStamps{VfsDirectory::ROOT_IDENTIFIER};
+// Positions of listing are marked, they refer to the entry of the last returned record
+static constexpr uint64_t LISTING{~(~uint64_t{0} >> 1)};
+
+static std::string_view nameToKey(const char *name)
+{
+  return name != nullptr ? std::string_view{name} : std::string_view{};
+}
+
+static bool increaseCounter(std::atomic<size_t> &counter, size_t amount, bool limited, size_t limit,
+    bool *attached)
+{
+  size_t value = counter.load(std::memory_order_relaxed);
+
+  do
+  {
+    const size_t used = value & ~DETACHED;
+
+    if (limited && amount && (used > limit || amount > limit - used))
+      return false;
+  }
+  while (!counter.compare_exchange_weak(value, value + amount, std::memory_order_relaxed));
+
+  *attached = !(value & DETACHED);
+  return true;
+}
+
+static size_t makeRecord(VfsNode *node, FsIdentifier id, uint8_t *buffer, size_t length)
+{
+  using Record = VfsNode::Record;
+
+  if (length <= sizeof(Record))
+    return 0;
+
+  // Name is copied first, the record is not added when the name does not fit into the buffer
+  size_t nameLength;
+
+  if (node->read(FS_NODE_NAME, 0, buffer + sizeof(Record), length - sizeof(Record), &nameLength) != E_OK)
+    return 0;
+
+  const size_t size = (sizeof(Record) + nameLength + alignof(Record) - 1) & ~(alignof(Record) - 1);
+
+  if (size > length || size > UINT16_MAX)
+    return 0;
+
+  Record record{};
+
+  record.id = id;
+  node->read(FS_NODE_ACCESS, 0, &record.access, sizeof(record.access), nullptr);
+  node->read(FS_NODE_TIME, 0, &record.time, sizeof(record.time), nullptr);
+  node->length(FS_NODE_DATA, &record.length);
+
+  record.size = static_cast<uint16_t>(size);
+  record.directory = !node->empty();
+
+  memcpy(buffer, &record, sizeof(record));
+  return size;
+}
+
+static bool decreaseCounter(std::atomic<size_t> &counter, size_t amount)
+{
+  return !(counter.fetch_sub(amount, std::memory_order_relaxed) & DETACHED);
+}
 
 VfsDirectory::VfsDirectory(time64_t timestamp, FsAccess access) :
-  VfsNode{timestamp, access}
+  VfsNode{timestamp, access},
+  m_head{nullptr},
+  m_tail{nullptr},
+  m_bytes{0},
+  m_nodes{0},
+  m_byteLimit{0},
+  m_nodeLimit{0},
+  m_removals{0}
 {
 }
 
 VfsDirectory::~VfsDirectory()
 {
-  VfsHandle::Locker locker(*m_handle);
+  // Directory is destroyed when no readers are left, descendants are released immediately
+  Entry *entry = m_head.load(std::memory_order_relaxed);
 
-  for (auto iter = m_nodes.begin(); iter != m_nodes.end();)
+  while (entry != nullptr)
   {
-    VfsNode * const node = *iter;
+    Entry * const next = entry->next.load(std::memory_order_relaxed);
+    VfsNode * const node = entry->node;
 
-    iter = m_nodes.erase(iter);
+    entry->~Entry();
+    VfsSlab::release(entry);
 
     node->leave();
-    delete node;
+    node->release();
+    entry = next;
   }
 }
 
@@ -41,10 +120,15 @@ Result VfsDirectory::create(const FsFieldDescriptor *descriptors, size_t number)
 
   const struct FsFieldDescriptor *dataDesc = 0;
   const struct FsFieldDescriptor *nameDesc = 0;
+  VfsNode *origin = nullptr;
+  VfsNode *target = nullptr;
   VfsNode *node = nullptr;
+  FsLength capacity = 0;
   time64_t nodeTime = 0;
   FsAccess nodeAccess = FS_ACCESS_READ | FS_ACCESS_WRITE;
   bool create = false;
+  // Cycle check and insertion of a link are atomic with respect to other links
+  VfsHandle::LinkLocker linkLocker{m_handle};
 
   for (size_t index = 0; index < number; ++index)
   {
@@ -102,6 +186,51 @@ Result VfsDirectory::create(const FsFieldDescriptor *descriptors, size_t number)
         else
           return E_VALUE;
 
+      case VFS_NODE_CLONE:
+        if (desc->length == sizeof(VfsNode *))
+        {
+          origin = *static_cast<VfsNode * const *>(desc->data);
+          create = true;
+          break;
+        }
+        else
+          return E_VALUE;
+
+      case VFS_NODE_LINK:
+        if (desc->length == sizeof(VfsNode *))
+        {
+          target = *static_cast<VfsNode * const *>(desc->data);
+          linkLocker.lock();
+
+          // Links to links reference the same node
+          target->read(static_cast<FsFieldType>(VFS_NODE_LINK), 0, &target, sizeof(target), nullptr);
+
+          // Directory bound into a subtree reachable from it makes a cycle, links of the subtree are followed
+          VfsHandle::Section section{m_handle};
+
+          if (target->reaches(this))
+            return E_INVALID;
+
+          create = true;
+          break;
+        }
+        else
+          return E_VALUE;
+
+      case VFS_NODE_CAPACITY:
+        if (desc->length == sizeof(capacity))
+        {
+          memcpy(&capacity, desc->data, sizeof(capacity));
+
+          if (static_cast<FsLength>(static_cast<size_t>(capacity)) != capacity)
+            return E_VALUE;
+
+          create = true;
+          break;
+        }
+        else
+          return E_VALUE;
+
       default:
         break;
     }
@@ -113,30 +242,66 @@ Result VfsDirectory::create(const FsFieldDescriptor *descriptors, size_t number)
     return E_INVALID;
   }
 
+  // Attached nodes are owned by the caller until the operation succeeds
+  const bool attached = node != nullptr;
+
   if (node == nullptr)
   {
     if (nameDesc == nullptr)
       return E_VALUE;
 
-    if (dataDesc == nullptr)
+    if (target != nullptr)
     {
-      // Create directory node
-      node = static_cast<VfsDirectory *>(malloc(sizeof(VfsDirectory)));
+      // Create link holding a reference of the target
+      if (!target->acquire())
+        return E_FULL;
+
+      node = new VfsLink{target, nodeTime};
 
-      if (node != nullptr)
-        new (node) VfsDirectory{nodeTime, nodeAccess};
+      if (node == nullptr)
+        target->release();
+    }
+    else if (origin != nullptr)
+    {
+      VfsDataNode *source;
+
+      // Only data nodes are able to share their contents, the source is referenced during cloning
+      if (origin->read(static_cast<FsFieldType>(VFS_NODE_CLONE), 0, &source, sizeof(source), nullptr) != E_OK)
+        return E_INVALID;
+
+      // Create data node with contents shared with the source node
+      const auto entry = new VfsDataNode{nodeTime, nodeAccess};
+
+      if (entry != nullptr)
+      {
+        entry->clone(*source);
+        node = entry;
+      }
+
+      source->release();
+    }
+    else if (dataDesc == nullptr && capacity == 0)
+    {
+      // Create directory node
+      node = new VfsDirectory{nodeTime, nodeAccess};
     }
     else
     {
       // Create data node
-      const auto entry = static_cast<VfsDataNode *>(malloc(sizeof(VfsDataNode)));
+      const auto entry = new VfsDataNode{nodeTime, nodeAccess};
 
       if (entry != nullptr)
       {
-        new (entry) VfsDataNode{nodeTime, nodeAccess};
+        if (dataDesc == nullptr || entry->reserve(dataDesc->data, dataDesc->length))
+        {
+          // Capacity is a hint, the node is created even when the storage is not allocated
+          if (capacity > 0)
+            entry->preallocate(static_cast<size_t>(capacity));
 
-        if (entry->reserve(dataDesc->data, dataDesc->length))
           node = entry;
+        }
+        else
+          delete entry;
       }
     }
 
@@ -148,46 +313,254 @@ Result VfsDirectory::create(const FsFieldDescriptor *descriptors, size_t number)
     }
   }
 
-  if (node != nullptr)
-  {
-    VfsHandle::Locker locker(*m_handle);
+  if (node == nullptr)
+    return E_MEMORY;
 
-    node->enter(m_handle, this);
-    m_nodes.push_back(node);
+  // Resources of the node are charged before attachment, limits of ancestors are checked
+  const Usage nodeUsage = node->usage();
 
-    return E_OK;
+  if (!charge(nodeUsage.bytes, nodeUsage.nodes, true))
+  {
+    if (!attached)
+      delete node;
+
+    return E_FULL;
   }
-  else
+
+  Entry * const entry = makeEntry(node);
+
+  if (entry == nullptr)
+  {
+    uncharge(nodeUsage.bytes, nodeUsage.nodes);
+
+    if (!attached)
+      delete node;
+
     return E_MEMORY;
+  }
+
+  {
+    VfsHandle::Locker locker{m_handle, this};
+
+    node->enter(m_handle, this);
+    append(entry);
+    m_index.emplace(nameToKey(node->name()), entry);
+  }
+
+  if (m_handle != nullptr)
+    m_handle->notify(node, VfsWatcher::EVENT_CREATE);
+  return E_OK;
 }
 
 void *VfsDirectory::head()
 {
   if (m_access & FS_ACCESS_READ)
   {
-    VfsHandle::Locker locker(*m_handle);
+    // Caller is in an epoch section, entries are not released until the proxy references the node
+    const uint32_t removals = m_removals.load();
+    Entry * const entry = m_head.load(std::memory_order_acquire);
 
-    if (!m_nodes.empty())
-      return m_handle->makeNodeProxy(m_nodes.front());
+    if (entry != nullptr)
+    {
+      Cursor cursor;
+
+      storePosition(&cursor, Position{entry, entry->stamp, removals, 0});
+      return VfsHandle::makeNodeProxy(m_handle, entry->node, &cursor);
+    }
   }
 
   return nullptr;
 }
 
-VfsNode *VfsDirectory::fetch(VfsNode *current)
+VfsNode *VfsDirectory::fetch(VfsNode *current, Cursor *cursor)
 {
-  if (m_access & FS_ACCESS_READ)
+  if (!(m_access & FS_ACCESS_READ))
+    return nullptr;
+
+  // Caller is in an epoch section, the counter is loaded before entries are reached
+  const uint32_t removals = m_removals.load();
+  Position position;
+  const bool positioned = cursor != nullptr && loadPosition(cursor, &position) && position.stamp
+      && !(position.stamp & LISTING);
+  Entry *next;
+
+  if (positioned && position.removals == removals && position.entry->node == current)
+  {
+    // Entries were not removed since the position was stored, the entry is still linked
+    next = position.entry->next.load(std::memory_order_acquire);
+  }
+  else if (positioned && current->parent() != this)
+  {
+    // Current node is removed, iteration continues with entries created after it
+    next = m_head.load(std::memory_order_acquire);
+
+    while (next != nullptr && next->stamp <= position.stamp)
+      next = next->next.load(std::memory_order_acquire);
+  }
+  else
+  {
+    // Position is unknown, search for the current node by name
+    VfsHandle::SharedLocker locker{m_handle, this};
+    const auto iter = find(current);
+
+    if (iter == m_index.end())
+      return nullptr;
+
+    next = iter->second->next.load(std::memory_order_acquire);
+  }
+
+  if (next != nullptr)
+  {
+    if (cursor != nullptr)
+      storePosition(cursor, Position{next, next->stamp, removals, 0});
+
+    return next->node;
+  }
+  else
+    return nullptr;
+}
+
+FsIdentifier VfsDirectory::identify(VfsNode *node)
+{
+  VfsHandle::SharedLocker locker{m_handle, this};
+  const auto entry = find(node);
+
+  return entry != m_index.end() ? entry->second->stamp : 0;
+}
+
+Result VfsDirectory::list(Cursor *cursor, FsLength position, void *buffer, size_t length, size_t *read)
+{
+  if (!(m_access & FS_ACCESS_READ))
+    return E_ACCESS;
+
+  // Entries are traversed without locks, the caller is in an epoch section
+  const uint32_t removals = m_removals.load();
+  Position saved;
+  // Entry of the last returned record
+  Entry *last = nullptr;
+  Entry *entry;
+
+  if (cursor != nullptr && loadPosition(cursor, &saved) && (saved.stamp & LISTING) && saved.index == position)
+  {
+    if (saved.removals == removals)
+    {
+      // Entries were not removed since the position was stored, the last entry is still linked
+      last = saved.entry;
+      entry = last != nullptr ? last->next.load(std::memory_order_acquire) : m_head.load(std::memory_order_acquire);
+    }
+    else
+    {
+      // Returned records may be removed, listing continues with entries created after them
+      entry = m_head.load(std::memory_order_acquire);
+
+      while (entry != nullptr && entry->stamp <= (saved.stamp & ~LISTING))
+      {
+        last = entry;
+        entry = entry->next.load(std::memory_order_acquire);
+      }
+    }
+  }
+  else
+  {
+    entry = m_head.load(std::memory_order_acquire);
+
+    for (FsLength index = 0; entry != nullptr && index < position; ++index)
+    {
+      last = entry;
+      entry = entry->next.load(std::memory_order_acquire);
+    }
+  }
+
+  uint8_t * const records = static_cast<uint8_t *>(buffer);
+  size_t count = 0;
+  size_t offset = 0;
+
+  while (entry != nullptr)
+  {
+    const size_t size = makeRecord(entry->node, entry->stamp, records + offset, length - offset);
+
+    if (!size)
+      break;
+
+    offset += size;
+    ++count;
+    last = entry;
+    entry = entry->next.load(std::memory_order_acquire);
+  }
+
+  // Buffer is too small for a single record
+  if (entry != nullptr && !count)
+    return E_VALUE;
+
+  if (cursor != nullptr)
   {
-    VfsHandle::Locker locker(*m_handle);
-    auto iter = std::find(m_nodes.begin(), m_nodes.end(), current);
+    const uint64_t stamp = last != nullptr ? last->stamp : 0;
+    storePosition(cursor, Position{last, stamp | LISTING, removals, static_cast<uint32_t>(position + count)});
+  }
+
+  if (read != nullptr)
+    *read = offset;
+  return E_OK;
+}
 
-    if (iter != m_nodes.end() && ++iter != m_nodes.end())
-      return *iter;
+VfsNode *VfsDirectory::locate(FsIdentifier id)
+{
+  if (!(m_access & FS_ACCESS_READ))
+    return nullptr;
+
+  // Caller is in an epoch section, entries are traversed without locks
+  for (Entry *entry = m_head.load(std::memory_order_acquire); entry != nullptr;
+      entry = entry->next.load(std::memory_order_acquire))
+  {
+    if (entry->stamp == id)
+      return entry->node;
+  }
+
+  for (Entry *entry = m_head.load(std::memory_order_acquire); entry != nullptr;
+      entry = entry->next.load(std::memory_order_acquire))
+  {
+    VfsNode * const node = entry->node->locate(id);
+
+    if (node != nullptr)
+      return node;
   }
 
   return nullptr;
 }
 
+bool VfsDirectory::reaches(const VfsNode *node)
+{
+  if (node == this)
+    return true;
+
+  // Caller is in an epoch section, entries are traversed without locks
+  for (Entry *entry = m_head.load(std::memory_order_acquire); entry != nullptr;
+      entry = entry->next.load(std::memory_order_acquire))
+  {
+    if (entry->node->reaches(node))
+      return true;
+  }
+
+  return false;
+}
+
+Result VfsDirectory::lookup(std::string_view name, VfsNode **node)
+{
+  if (!(m_access & FS_ACCESS_READ))
+    return E_ACCESS;
+
+  VfsHandle::SharedLocker locker{m_handle, this};
+  const auto entry = m_index.lower_bound(name);
+
+  if (entry != m_index.end() && entry->first == name)
+  {
+    *node = entry->second->node;
+    return E_OK;
+  }
+  else
+    return E_ENTRY;
+}
+
 Result VfsDirectory::remove(FsNode *proxy)
 {
   if (!(m_access & FS_ACCESS_WRITE))
@@ -202,20 +575,58 @@ Result VfsDirectory::remove(FsNode *proxy)
   {
     if (access & FS_ACCESS_WRITE)
     {
-      VfsHandle::Locker locker(*m_handle);
-      auto iter = std::find(m_nodes.begin(), m_nodes.end(), node);
+      // Removed entry references the directory, readers may still follow the parent link of the node
+      if (!acquire())
+        return E_FULL;
+
+      Entry *removed = nullptr;
 
-      if (iter != m_nodes.end())
       {
-        m_nodes.erase(iter);
+        VfsHandle::Locker locker{m_handle, this};
+        const auto entry = find(node);
 
+        if (entry != m_index.end())
+        {
+          if (m_handle != nullptr)
+            m_handle->invalidate(node);
+
+          removed = entry->second;
+          m_removals.fetch_add(1);
+          m_index.erase(entry);
+          unlink(removed);
+        }
+      }
+
+      if (removed != nullptr)
+      {
+        // Entry is no longer indexed, watchers receive the identifier from the entry
+        if (m_handle != nullptr)
+          m_handle->notify(node, VfsWatcher::EVENT_REMOVE, removed->stamp);
+
+        // Resources of the removed subtree are returned at once, later changes are not charged
+        const Usage nodeUsage = node->detach();
+        uncharge(nodeUsage.bytes, nodeUsage.nodes);
+
+        // Nodes of the subtree can not be opened by identifiers
+        if (m_handle != nullptr)
+          m_handle->unlink(node);
+
+        // Proxies of the node continue iteration through their cursors
         node->leave();
-        delete node;
+        removed->owner = this;
+
+        if (m_handle != nullptr)
+          m_handle->epoch().retire(removed);
+        else
+          releaseEntry(removed);
 
         res = E_OK;
       }
       else
+      {
+        release();
         res = E_ENTRY;
+      }
     }
     else
       res = E_ACCESS;
@@ -223,3 +634,282 @@ Result VfsDirectory::remove(FsNode *proxy)
 
   return res;
 }
+
+Result VfsDirectory::read(FsFieldType type, FsLength position, void *buffer, size_t length, size_t *read)
+{
+  if (static_cast<VfsFieldType>(type) == VFS_NODE_LIMIT)
+  {
+    if (position || length != sizeof(Usage))
+      return E_VALUE;
+
+    const Usage limit{m_byteLimit.load(std::memory_order_relaxed), m_nodeLimit.load(std::memory_order_relaxed)};
+    memcpy(buffer, &limit, sizeof(limit));
+
+    if (read != nullptr)
+      *read = sizeof(limit);
+    return E_OK;
+  }
+  else
+    return VfsNode::read(type, position, buffer, length, read);
+}
+
+Result VfsDirectory::write(FsFieldType type, FsLength position, const void *buffer, size_t length,
+    size_t *written)
+{
+  if (static_cast<VfsFieldType>(type) == VFS_NODE_LIMIT)
+  {
+    if (!(m_access & FS_ACCESS_WRITE))
+      return E_ACCESS;
+    if (position || length != sizeof(Usage))
+      return E_VALUE;
+
+    Usage limit;
+    memcpy(&limit, buffer, sizeof(limit));
+
+    if (limit.nodes > UINT32_MAX)
+      return E_VALUE;
+
+    // Resources used above the new limits are kept, further growth fails
+    m_byteLimit.store(limit.bytes, std::memory_order_relaxed);
+    m_nodeLimit.store(static_cast<uint32_t>(limit.nodes), std::memory_order_relaxed);
+
+    if (written != nullptr)
+      *written = sizeof(limit);
+    return E_OK;
+  }
+  else
+    return VfsNode::write(type, position, buffer, length, written);
+}
+
+bool VfsDirectory::empty()
+{
+  return !(m_access & FS_ACCESS_READ) || m_head.load(std::memory_order_acquire) == nullptr;
+}
+
+bool VfsDirectory::attachable() const
+{
+  return true;
+}
+
+VfsNode::Usage VfsDirectory::detach()
+{
+  const size_t bytes = m_bytes.fetch_or(DETACHED, std::memory_order_relaxed);
+  const size_t nodes = m_nodes.fetch_or(DETACHED, std::memory_order_relaxed);
+
+  // Changes made before marking are either included here or already propagated
+  return Usage{bytes & ~DETACHED, (nodes & ~DETACHED) + 1};
+}
+
+VfsNode::Usage VfsDirectory::usage() const
+{
+  return Usage{
+      m_bytes.load(std::memory_order_relaxed) & ~DETACHED,
+      (m_nodes.load(std::memory_order_relaxed) & ~DETACHED) + 1
+  };
+}
+
+void VfsDirectory::destroy()
+{
+  Entry * const head = m_head.load(std::memory_order_relaxed);
+
+  // Empty directory is reachable only through parent links of removed nodes, their entries reference it
+  if (m_handle == nullptr || head == nullptr)
+  {
+    delete this;
+    return;
+  }
+
+  // Readers may follow parent links of descendants concurrently, deletion waits for the grace period
+  for (Entry *entry = head; entry != nullptr; entry = entry->next.load(std::memory_order_relaxed))
+    entry->node->leave();
+
+  head->owner = this;
+  head->release = releaseDirectory;
+  m_handle->epoch().retire(head);
+}
+
+bool VfsDirectory::charge(size_t bytes, size_t nodes, bool limited)
+{
+  const size_t byteLimit = m_byteLimit.load(std::memory_order_relaxed);
+  const size_t nodeLimit = m_nodeLimit.load(std::memory_order_relaxed);
+  bool bytesAttached;
+  bool nodesAttached;
+
+  if (!increaseCounter(m_bytes, bytes, limited && byteLimit, byteLimit, &bytesAttached))
+    return false;
+
+  // Node limit includes the directory itself
+  if (!increaseCounter(m_nodes, nodes, limited && nodeLimit, nodeLimit - 1, &nodesAttached))
+  {
+    decreaseCounter(m_bytes, bytes);
+    return false;
+  }
+
+  const size_t forwardedBytes = bytesAttached ? bytes : 0;
+  const size_t forwardedNodes = nodesAttached ? nodes : 0;
+
+  if ((forwardedBytes || forwardedNodes) && !VfsNode::charge(forwardedBytes, forwardedNodes, limited))
+  {
+    // Directory may be detached concurrently, its usage is subtracted from ancestors with the rejected part
+    const size_t restoredBytes = decreaseCounter(m_bytes, bytes) ? 0 : forwardedBytes;
+    const size_t restoredNodes = decreaseCounter(m_nodes, nodes) ? 0 : forwardedNodes;
+
+    if (restoredBytes || restoredNodes)
+      VfsNode::charge(restoredBytes, restoredNodes, false);
+
+    return false;
+  }
+
+  return true;
+}
+
+void VfsDirectory::uncharge(size_t bytes, size_t nodes)
+{
+  const size_t forwardedBytes = decreaseCounter(m_bytes, bytes) ? bytes : 0;
+  const size_t forwardedNodes = decreaseCounter(m_nodes, nodes) ? nodes : 0;
+
+  if (forwardedBytes || forwardedNodes)
+    VfsNode::uncharge(forwardedBytes, forwardedNodes);
+}
+
+void *VfsDirectory::unindex(VfsNode *node)
+{
+  const auto iter = find(node);
+
+  // Removed nodes are not indexed and are not indexed again
+  if (iter == m_index.end())
+    return nullptr;
+
+  Entry * const entry = iter->second;
+
+  m_index.erase(iter);
+  return entry;
+}
+
+void VfsDirectory::reindex(VfsNode *node, void *position)
+{
+  m_index.emplace(nameToKey(node->name()), static_cast<Entry *>(position));
+}
+
+void *VfsDirectory::operator new(size_t size) noexcept
+{
+  return VfsSlab::directoryCache().allocate(size);
+}
+
+void VfsDirectory::append(Entry *entry)
+{
+  // Stamps are issued under the exclusive lock, so they grow along the list
+  entry->stamp = entryStamps.fetch_add(1, std::memory_order_relaxed) + 1;
+  entry->next.store(nullptr, std::memory_order_relaxed);
+  entry->prev = m_tail;
+
+  // Entry is published to readers after initialization
+  if (m_tail != nullptr)
+    m_tail->next.store(entry, std::memory_order_release);
+  else
+    m_head.store(entry, std::memory_order_release);
+
+  m_tail = entry;
+}
+
+void VfsDirectory::unlink(Entry *entry)
+{
+  Entry * const next = entry->next.load(std::memory_order_relaxed);
+
+  // Link of the removed entry is kept, readers positioned on it proceed to the next entry
+  if (entry->prev != nullptr)
+    entry->prev->next.store(next, std::memory_order_release);
+  else
+    m_head.store(next, std::memory_order_release);
+
+  if (next != nullptr)
+    next->prev = entry->prev;
+  else
+    m_tail = entry->prev;
+}
+
+VfsDirectory::NodeIndex::iterator VfsDirectory::find(VfsNode *node)
+{
+  const auto range = m_index.equal_range(nameToKey(node->name()));
+
+  for (auto entry = range.first; entry != range.second; ++entry)
+  {
+    if (entry->second->node == node)
+      return entry;
+  }
+
+  return m_index.end();
+}
+
+bool VfsDirectory::loadPosition(const Cursor *cursor, Position *position) const
+{
+  if (cursor->owner == this)
+  {
+    memcpy(position, cursor->position, sizeof(Position));
+    return true;
+  }
+  else
+    return false;
+}
+
+void VfsDirectory::storePosition(Cursor *cursor, const Position &position)
+{
+  static_assert(sizeof(Position) <= sizeof(cursor->position));
+
+  cursor->owner = this;
+  memcpy(cursor->position, &position, sizeof(Position));
+}
+
+VfsDirectory::Entry *VfsDirectory::makeEntry(VfsNode *node)
+{
+  void * const memory = VfsSlab::entryCache().allocate(sizeof(Entry));
+
+  if (memory != nullptr)
+  {
+    const auto entry = new (memory) Entry{};
+
+    entry->release = releaseEntry;
+    entry->node = node;
+    return entry;
+  }
+  else
+    return nullptr;
+}
+
+void VfsDirectory::releaseDirectory(VfsEpoch::Retired *object)
+{
+  Entry *entry = static_cast<Entry *>(object);
+  VfsDirectory * const directory = entry->owner;
+
+  // Descendants already left the directory, their references are dropped with the entries
+  directory->m_head.store(nullptr, std::memory_order_relaxed);
+  directory->m_tail = nullptr;
+
+  while (entry != nullptr)
+  {
+    Entry * const next = entry->next.load(std::memory_order_relaxed);
+    VfsNode * const node = entry->node;
+
+    entry->~Entry();
+    VfsSlab::release(entry);
+
+    node->release();
+    entry = next;
+  }
+
+  delete directory;
+}
+
+void VfsDirectory::releaseEntry(VfsEpoch::Retired *object)
+{
+  const auto entry = static_cast<Entry *>(object);
+  VfsDirectory * const owner = entry->owner;
+  VfsNode * const node = entry->node;
+
+  entry->~Entry();
+  VfsSlab::release(entry);
+
+  // Node is deleted unless links or proxies to it are left
+  node->release();
+  owner->release();
+}
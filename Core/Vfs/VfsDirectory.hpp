@@ -8,24 +8,111 @@
 #define VFS_SHELL_CORE_VFS_VFSDIRECTORY_HPP_
 
 #include "Vfs/Vfs.hpp"
-#include <list>
+#include "Vfs/VfsEpoch.hpp"
+#include <atomic>
+#include <map>
 
 class VfsHandle;
 
 class VfsDirectory: public VfsNode
 {
 public:
+  // Root directories have no entries, identifiers of other nodes are stamps of their entries
+  static constexpr FsIdentifier ROOT_IDENTIFIER{1};
+
   VfsDirectory(time64_t = 0, FsAccess = FS_ACCESS_READ | FS_ACCESS_WRITE);
   ~VfsDirectory() override;
 
   virtual Result create(const FsFieldDescriptor *, size_t) override;
-  virtual VfsNode *fetch(VfsNode *current) override;
+  virtual VfsNode *fetch(VfsNode *, Cursor * = nullptr) override;
   virtual void *head() override;
+  virtual FsIdentifier identify(VfsNode *) override;
+  virtual Result list(Cursor *, FsLength, void *, size_t, size_t *) override;
+  virtual VfsNode *locate(FsIdentifier) override;
+  virtual Result lookup(std::string_view, VfsNode **) override;
+  virtual bool reaches(const VfsNode *) override;
+  virtual Result read(FsFieldType, FsLength, void *, size_t, size_t *) override;
   virtual Result remove(FsNode *) override;
+  virtual Result write(FsFieldType, FsLength, const void *, size_t, size_t *) override;
+
+  virtual bool empty() override;
+  virtual bool attachable() const override;
+
+  virtual Usage detach() override;
+  virtual Usage usage() const override;
+
+  void *operator new(size_t) noexcept;
+
+protected:
+  virtual void *unindex(VfsNode *) override;
+  virtual void reindex(VfsNode *, void *) override;
+
+  virtual void destroy() override;
+
+  virtual bool charge(size_t, size_t, bool) override;
+  virtual void uncharge(size_t, size_t) override;
 
 private:
-  // List of descendant nodes
-  std::list<VfsNode *> m_nodes;
+  friend class VfsSlab;
+
+  // Directory entry, released after the end of the grace period when removed
+  struct Entry: VfsEpoch::Retired
+  {
+    // Link followed by readers without locks, kept unchanged after removal of the entry
+    std::atomic<Entry *> next;
+
+    union
+    {
+      // Link used by writers only
+      Entry *prev;
+      // Directory referenced by a removed entry, readers may still follow the parent link of the node
+      VfsDirectory *owner;
+    };
+
+    VfsNode *node;
+    // Creation order of entries, iteration continues after a removed node with newer entries,
+    // stamps are never reused and serve as identifiers of the nodes
+    uint64_t stamp;
+  };
+
+  // Iteration state stored in a cursor of a proxy
+  struct Position
+  {
+    // Entry is valid while the removal counter of the directory is unchanged
+    Entry *entry;
+    // Stamp of the entry, iteration continues with newer entries when the entry is removed
+    uint64_t stamp;
+    uint32_t removals;
+    // Number of records returned by listing
+    uint32_t index;
+  };
+
+  using NodeIndex = std::multimap<std::string_view, Entry *>;
+
+  // List of descendant nodes in order of creation, modified under the exclusive lock
+  std::atomic<Entry *> m_head;
+  Entry *m_tail;
+  // Descendant nodes sorted by name, names are owned by the nodes
+  NodeIndex m_index;
+
+  // Resources used by descendants, changed without locks
+  std::atomic<size_t> m_bytes;
+  std::atomic<size_t> m_nodes;
+  // Limits of resources used by the directory and its descendants, zero when unlimited
+  std::atomic<size_t> m_byteLimit;
+  std::atomic<uint32_t> m_nodeLimit;
+  // Incremented before each removal, positions stored in cursors are trusted while it is unchanged
+  std::atomic<uint32_t> m_removals;
+
+  void append(Entry *);
+  void unlink(Entry *);
+  NodeIndex::iterator find(VfsNode *);
+  bool loadPosition(const Cursor *, Position *) const;
+  void storePosition(Cursor *, const Position &);
+
+  static Entry *makeEntry(VfsNode *);
+  static void releaseDirectory(VfsEpoch::Retired *);
+  static void releaseEntry(VfsEpoch::Retired *);
 };
 
 #endif // VFS_SHELL_CORE_VFS_VFSDIRECTORY_HPP_
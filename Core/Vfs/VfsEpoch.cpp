@@ -0,0 +1,141 @@
+/*
+ * VfsEpoch.cpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "Vfs/VfsEpoch.hpp"
+#include "Wrappers/Semaphore.hpp"
+
+VfsEpoch::VfsEpoch() :
+  m_epoch{0},
+  m_readers{},
+  m_pending{0},
+  m_requested{false},
+  m_current{nullptr},
+  m_previous{nullptr}
+{
+}
+
+VfsEpoch::~VfsEpoch()
+{
+  // Readers are gone when the handle is destroyed
+  release(m_previous);
+  release(m_current);
+}
+
+uint32_t VfsEpoch::enter()
+{
+  while (true)
+  {
+    const uint32_t epoch = m_epoch.load();
+    const uint32_t slot = epoch & 1;
+
+    m_readers[slot].fetch_add(1);
+
+    // Epoch was advanced after the load, the slot may belong to the readers of an older epoch
+    if (m_epoch.load() == epoch)
+      return slot;
+
+    m_readers[slot].fetch_sub(1);
+  }
+}
+
+void VfsEpoch::leave(uint32_t slot)
+{
+  // The last reader of the slot may finish the grace period of pending objects
+  if (m_readers[slot].fetch_sub(1) == 1 && m_pending.load() != 0)
+    reclaim();
+}
+
+void VfsEpoch::retire(Retired *object)
+{
+  m_pending.fetch_add(1);
+
+  {
+    Os::MutexLocker locker{m_lock};
+
+    object->next = m_current;
+    m_current = object;
+  }
+
+  reclaim();
+}
+
+void VfsEpoch::synchronize()
+{
+  // Barrier is released together with objects retired before it
+  struct Barrier: Retired
+  {
+    Os::Semaphore semaphore{0};
+  } barrier;
+
+  barrier.release = [](Retired *object){ static_cast<Barrier *>(object)->semaphore.post(); };
+  retire(&barrier);
+  barrier.semaphore.wait();
+}
+
+void VfsEpoch::reclaim()
+{
+  // Readers never wait for the lock, the request is served by the current owner of the lock
+  m_requested.store(true);
+
+  while (m_requested.load() && m_lock.tryLock())
+  {
+    m_requested.store(false);
+
+    Retired * const released = collect();
+    m_lock.unlock();
+
+    // Objects are released without the lock, release of a large subtree may take a while
+    release(released);
+  }
+}
+
+VfsEpoch::Retired *VfsEpoch::collect()
+{
+  // Epoch is changed only with the lock held
+  const uint32_t slot = m_epoch.load(std::memory_order_relaxed) & 1;
+  Retired *released = nullptr;
+
+  // Objects of the previous epoch are unreachable when its readers are gone
+  if (m_previous != nullptr && m_readers[slot ^ 1].load() == 0)
+  {
+    released = m_previous;
+    m_previous = nullptr;
+  }
+
+  // Slot of the previous epoch is reused by the next epoch, so it should be empty
+  if (m_previous == nullptr && m_current != nullptr && m_readers[slot ^ 1].load() == 0)
+  {
+    m_epoch.store(m_epoch.load(std::memory_order_relaxed) + 1);
+    m_previous = m_current;
+    m_current = nullptr;
+
+    if (m_readers[slot].load() == 0)
+    {
+      Retired *tail = m_previous;
+
+      while (tail->next != nullptr)
+        tail = tail->next;
+
+      tail->next = released;
+      released = m_previous;
+      m_previous = nullptr;
+    }
+  }
+
+  return released;
+}
+
+void VfsEpoch::release(Retired *object)
+{
+  while (object != nullptr)
+  {
+    Retired * const next = object->next;
+
+    object->release(object);
+    m_pending.fetch_sub(1);
+    object = next;
+  }
+}
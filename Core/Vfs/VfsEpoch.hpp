@@ -0,0 +1,89 @@
+/*
+ * Core/Vfs/VfsEpoch.hpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#ifndef VFS_SHELL_CORE_VFS_VFSEPOCH_HPP_
+#define VFS_SHELL_CORE_VFS_VFSEPOCH_HPP_
+
+#include "Wrappers/Mutex.hpp"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Epoch-based reclamation: objects unlinked by writers are released after all readers
+// that could still reach them have left their read-side sections
+class VfsEpoch
+{
+public:
+  // Intrusive hook of an object waiting for reclamation
+  struct Retired
+  {
+    Retired *next;
+    void (*release)(Retired *);
+  };
+
+  // Read-side section, objects reachable inside the section are not released until it is left
+  class Guard
+  {
+  public:
+    Guard(const Guard &) = delete;
+    Guard &operator=(const Guard &) = delete;
+
+    Guard(VfsEpoch &epoch) :
+      m_epoch{epoch},
+      m_slot{epoch.enter()}
+    {
+    }
+
+    ~Guard()
+    {
+      m_epoch.leave(m_slot);
+    }
+
+  private:
+    VfsEpoch &m_epoch;
+    uint32_t m_slot;
+  };
+
+  VfsEpoch();
+  ~VfsEpoch();
+
+  VfsEpoch(const VfsEpoch &) = delete;
+  VfsEpoch &operator=(const VfsEpoch &) = delete;
+
+  // Never blocks, returns a reader slot that should be passed to leave
+  uint32_t enter();
+  void leave(uint32_t);
+  void retire(Retired *);
+  // Blocks until readers that entered before the call are gone, should be called outside of sections
+  void synchronize();
+
+  size_t pending() const
+  {
+    return m_pending.load(std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic<uint32_t> m_epoch;
+  // Active readers of even and odd epochs
+  std::array<std::atomic<uint32_t>, 2> m_readers;
+  // Number of retired objects that are not released yet
+  std::atomic<size_t> m_pending;
+  // Collection was requested while the lock was busy
+  std::atomic<bool> m_requested;
+
+  Os::Mutex m_lock;
+  // Objects retired during the current epoch
+  Retired *m_current;
+  // Objects retired during the previous epoch
+  Retired *m_previous;
+
+  Retired *collect();
+  void reclaim();
+  void release(Retired *);
+};
+
+#endif // VFS_SHELL_CORE_VFS_VFSEPOCH_HPP_
@@ -5,6 +5,10 @@
  */
 
 #include "Vfs/VfsHandle.hpp"
+#include <xcore/fs/utils.h>
+#include <algorithm>
+#include <cstring>
+#include <functional>
 
 const FsHandleClass VfsHandle::table{
     sizeof(VfsHandle), // size
@@ -15,3 +19,468 @@ const FsHandleClass VfsHandle::table{
     VfsHandle::sync    // sync
 };
 const FsHandleClass * const VfsHandleClass = &VfsHandle::table;
+
+static constexpr size_t NAME_BUFFER_LENGTH{256};
+
+static std::string_view followPath(std::string_view *path)
+{
+  const size_t begin = path->find_first_not_of('/');
+
+  if (begin == std::string_view::npos)
+  {
+    *path = std::string_view{};
+    return *path;
+  }
+
+  path->remove_prefix(begin);
+
+  const size_t end = std::min(path->find('/'), path->size());
+  const auto name = path->substr(0, end);
+
+  path->remove_prefix(end);
+  return name;
+}
+
+static std::string_view extractBasePath(std::string_view path)
+{
+  const size_t last = path.find_last_not_of('/');
+
+  if (last == std::string_view::npos)
+  {
+    // Path has no name part
+    return std::string_view{};
+  }
+
+  return path.substr(0, path.find_last_of('/', last) + 1);
+}
+
+static FsNode *followChild(FsNode *node, std::string_view name)
+{
+  // Iterate over descendants of a node without a name index
+  FsNode *child = static_cast<FsNode *>(fsNodeHead(node));
+
+  fsNodeFree(node);
+
+  while (child != nullptr)
+  {
+    char buffer[NAME_BUFFER_LENGTH];
+    FsLength length;
+
+    if (fsNodeLength(child, FS_NODE_NAME, &length) == E_OK && length == name.size() + 1 && length <= sizeof(buffer))
+    {
+      if (fsNodeRead(child, FS_NODE_NAME, 0, buffer, sizeof(buffer), nullptr) == E_OK && name == buffer)
+        break;
+    }
+
+    if (fsNodeNext(child) != E_OK)
+    {
+      fsNodeFree(child);
+      child = nullptr;
+    }
+  }
+
+  return child;
+}
+
+VfsHandle *VfsHandle::cast(FsHandle *handle)
+{
+  if (handle != nullptr && static_cast<const void *>(handle->base.type) == VfsHandleClass)
+    return reinterpret_cast<VfsHandle *>(handle);
+  else
+    return nullptr;
+}
+
+void VfsHandle::freeNodeProxy(VfsHandle *handle, VfsNodeProxy *proxy)
+{
+  if (handle != nullptr && handle->m_proxies.owns(proxy))
+  {
+    VfsNodeProxy::deinit(proxy);
+    handle->m_proxies.release(proxy);
+  }
+  else
+    ::deinit(proxy);
+}
+
+VfsNodeProxy *VfsHandle::makeNodeProxy(VfsHandle *handle, VfsNode *node, const VfsNode::Cursor *cursor)
+{
+  // Node is reached by the caller inside an epoch section or through a reference
+  if (!node->acquire())
+    return nullptr;
+
+  const VfsNodeProxy::Config config{handle, node, cursor};
+  void * const object = handle != nullptr ? handle->m_proxies.allocate() : nullptr;
+
+  if (object != nullptr)
+  {
+    // Mimic the generic object initialization for preallocated memory
+    VfsNodeProxy::init(object, &config);
+    static_cast<Entity *>(object)->type = reinterpret_cast<const EntityClass *>(VfsNodeProxyClass);
+
+    return static_cast<VfsNodeProxy *>(object);
+  }
+
+  // Pool is exhausted or the node is detached, fall back to the heap
+  const auto proxy = static_cast<VfsNodeProxy *>(::init(VfsNodeProxyClass, &config));
+
+  if (proxy == nullptr)
+    node->release();
+
+  return proxy;
+}
+
+void VfsHandle::watch(VfsWatcher *watcher)
+{
+  const WatcherList::Entry entry{watcher->node(), watcher};
+  WatcherList * const list = new WatcherList{};
+  WatcherList *previous;
+
+  {
+    Os::MutexLocker locker{m_watchLock};
+
+    previous = m_watchers.load(std::memory_order_relaxed);
+    if (previous != nullptr)
+      list->entries = previous->entries;
+
+    const auto position = std::upper_bound(list->entries.begin(), list->entries.end(), entry,
+        WatcherList::compare);
+
+    list->entries.insert(position, entry);
+    m_watchers.store(list, std::memory_order_release);
+  }
+
+  // Writers may still iterate the previous list
+  if (previous != nullptr)
+    m_epoch.retire(previous);
+}
+
+void VfsHandle::unwatch(VfsWatcher *watcher)
+{
+  WatcherList *previous;
+
+  {
+    Os::MutexLocker locker{m_watchLock};
+
+    previous = m_watchers.load(std::memory_order_relaxed);
+    if (previous == nullptr)
+      return;
+
+    // Watched node of the watcher may be detached already, entries are compared by watchers
+    const auto position = std::find_if(previous->entries.begin(), previous->entries.end(),
+        [watcher](const WatcherList::Entry &entry){ return entry.watcher == watcher; });
+
+    if (position == previous->entries.end())
+      return;
+
+    WatcherList *list = nullptr;
+
+    if (previous->entries.size() > 1)
+    {
+      list = new WatcherList{};
+      list->entries = previous->entries;
+      list->entries.erase(list->entries.begin() + (position - previous->entries.begin()));
+    }
+
+    m_watchers.store(list, std::memory_order_release);
+  }
+
+  m_epoch.retire(previous);
+  // Writers that reached the watcher through the previous list are gone after the grace period
+  m_epoch.synchronize();
+}
+
+void VfsHandle::attach(VfsNode *node)
+{
+  Os::MutexLocker locker{m_syncLock};
+  m_buffered.push_back(node);
+}
+
+void VfsHandle::detach(VfsNode *node)
+{
+  Os::MutexLocker locker{m_syncLock};
+  const auto iter = std::find(m_buffered.begin(), m_buffered.end(), node);
+
+  if (iter != m_buffered.end())
+    m_buffered.erase(iter);
+}
+
+void VfsHandle::detachWatchers(const VfsNode *node)
+{
+  Section section{this};
+  const WatcherList * const list = m_watchers.load(std::memory_order_acquire);
+
+  if (list == nullptr)
+    return;
+
+  const auto range = list->find(node);
+
+  for (auto entry = range.first; entry != range.second; ++entry)
+    entry->watcher->detach();
+}
+
+void VfsHandle::dispatch(VfsNode *node, VfsWatcher::Type type, FsIdentifier id)
+{
+  // List is not released until the section is left, writers never wait for subscribers
+  Section section{this};
+  const WatcherList * const list = m_watchers.load(std::memory_order_acquire);
+
+  if (list == nullptr)
+    return;
+
+  const VfsNode * const watched[] = {node, node->parent()};
+  bool identified = id != 0;
+
+  for (const VfsNode *target : watched)
+  {
+    if (target == nullptr)
+      continue;
+
+    // Only watchers of the node and its parent are visited
+    const auto range = list->find(target);
+
+    for (auto entry = range.first; entry != range.second; ++entry)
+    {
+      // Watcher is detached when its node is released, another node may reuse the address
+      if (entry->watcher->node() != target)
+        continue;
+
+      // Identifier is issued once for all watchers of the node
+      if (!identified)
+      {
+        id = identify(node);
+        identified = true;
+      }
+
+      entry->watcher->push(type, id);
+    }
+  }
+}
+
+std::pair<const VfsHandle::WatcherList::Entry *, const VfsHandle::WatcherList::Entry *>
+    VfsHandle::WatcherList::find(const VfsNode *node) const
+{
+  const Entry * const first = entries.data();
+  const Entry * const last = first + entries.size();
+
+  return std::equal_range(first, last, Entry{node, nullptr}, compare);
+}
+
+bool VfsHandle::WatcherList::compare(const Entry &a, const Entry &b)
+{
+  return std::less<const VfsNode *>{}(a.node, b.node);
+}
+
+Result VfsHandle::syncImpl()
+{
+  // Nodes are not released while the list is locked
+  Os::MutexLocker locker{m_syncLock};
+  Result res = E_OK;
+
+  for (VfsNode *node : m_buffered)
+  {
+    const Result nodeRes = node->sync();
+
+    if (res == E_OK)
+      res = nodeRes;
+  }
+
+  return res;
+}
+
+Os::SharedMutex &VfsHandle::mutex(const VfsNode *node)
+{
+  const auto address = reinterpret_cast<uintptr_t>(node);
+  return m_locks[((address >> 4) ^ (address >> 12)) % LOCK_SHARDS];
+}
+
+VfsHandle::CacheShard &VfsHandle::cache(std::string_view path)
+{
+  return m_caches[VfsPathCache::makeHash(path) % LOCK_SHARDS];
+}
+
+VfsPathCache::Stats VfsHandle::cacheStats() const
+{
+  VfsPathCache::Stats total{0, 0, 0};
+
+  for (const auto &shard : m_caches)
+  {
+    Os::MutexLocker locker{shard.lock};
+    const auto stats = shard.cache.stats();
+
+    total.hits += stats.hits;
+    total.misses += stats.misses;
+    total.entries += stats.entries;
+  }
+
+  return total;
+}
+
+void VfsHandle::invalidate(const VfsNode *node)
+{
+  // Descendants of the node may be cached in any shard
+  for (auto &shard : m_caches)
+  {
+    Os::MutexLocker locker{shard.lock};
+    shard.cache.invalidate(node);
+  }
+}
+
+FsNode *VfsHandle::openNode(FsHandle *handle, const char *path)
+{
+  VfsHandle * const vfs = cast(handle);
+  return vfs != nullptr ? vfs->openImpl(path, false) : fsOpenNode(handle, path);
+}
+
+FsNode *VfsHandle::openBaseNode(FsHandle *handle, const char *path)
+{
+  VfsHandle * const vfs = cast(handle);
+  return vfs != nullptr ? vfs->openImpl(path, true) : fsOpenBaseNode(handle, path);
+}
+
+FsNode *VfsHandle::openNodeAt(FsHandle *handle, FsIdentifier id, const char *path)
+{
+  VfsHandle * const vfs = cast(handle);
+  return vfs != nullptr ? vfs->openImpl(id, path) : nullptr;
+}
+
+FsNode *VfsHandle::openImpl(const char *path, bool base)
+{
+  FsHandle * const handle = reinterpret_cast<FsHandle *>(this);
+
+  if (path == nullptr || *path != '/' || strstr(path, "..") != nullptr)
+  {
+    // Relative paths and paths with parent references are resolved by the generic code
+    return base ? fsOpenBaseNode(handle, path) : fsOpenNode(handle, path);
+  }
+
+  const std::string_view requested = base ? extractBasePath(path) : std::string_view{path};
+
+  if (requested.empty())
+    return nullptr;
+
+  // Different spellings of the same path should share a cache entry
+  char buffer[VfsPathCache::PATH_LENGTH];
+  const std::string_view target = VfsPathCache::normalize(requested, buffer);
+
+  // Nodes found in the cache or during the walk are not released until proxies reference them
+  VfsEpoch::Guard guard{m_epoch};
+  CacheShard &shard = cache(target);
+  VfsNode *node;
+  uint32_t generation;
+
+  {
+    Os::MutexLocker locker{shard.lock};
+
+    node = shard.cache.find(target);
+    generation = shard.cache.generation();
+  }
+
+  if (node != nullptr)
+    return reinterpret_cast<FsNode *>(makeNodeProxy(this, node));
+
+  FsNode *foreign = nullptr;
+  bool linked = false;
+
+  if ((node = resolve(&m_root, target, &foreign, &linked)) == nullptr)
+  {
+    // Nodes of mounted file systems are not cached
+    return foreign;
+  }
+
+  // Paths through links are resolved every time
+  if (!linked)
+  {
+    Os::MutexLocker locker{shard.lock};
+
+    // Node may be removed by another thread during path resolution
+    if (shard.cache.generation() == generation)
+      shard.cache.insert(target, node);
+  }
+
+  return reinterpret_cast<FsNode *>(makeNodeProxy(this, node));
+}
+
+FsNode *VfsHandle::openImpl(FsIdentifier id, const char *path)
+{
+  const std::string_view target = path != nullptr ? std::string_view{path} : std::string_view{};
+
+  if (target.find("..") != std::string_view::npos)
+    return nullptr;
+
+  if (!id)
+    return nullptr;
+
+  // Node found in the table is not released until a proxy references it
+  VfsEpoch::Guard guard{m_epoch};
+  VfsNode *node;
+
+  {
+    Os::MutexLocker locker{m_inodeLock};
+    node = m_inodes.find(id);
+  }
+
+  if (node == nullptr)
+  {
+    // Tree is searched on the first open by the identifier, the node is remembered afterwards
+    node = id == VfsDirectory::ROOT_IDENTIFIER ? &m_root : m_root.locate(id);
+
+    if (node == nullptr)
+      return nullptr;
+
+    Os::MutexLocker locker{m_inodeLock};
+
+    if (!m_inodes.insert(id, node))
+      return nullptr;
+  }
+
+  FsNode *foreign = nullptr;
+
+  if ((node = resolve(node, target, &foreign)) == nullptr)
+    return foreign;
+
+  return reinterpret_cast<FsNode *>(makeNodeProxy(this, node));
+}
+
+VfsNode *VfsHandle::resolve(VfsNode *node, std::string_view path, FsNode **foreign, bool *linked)
+{
+  std::string_view remaining = path;
+  std::string_view name;
+
+  while (!(name = followPath(&remaining)).empty())
+  {
+    if (name == ".")
+      continue;
+
+    if (*foreign == nullptr)
+    {
+      VfsNode *child;
+      const Result res = node->lookup(name, &child);
+
+      if (res == E_OK)
+      {
+        // Descendants of a link belong to its target, removal of the link does not invalidate them
+        if (linked != nullptr && child->parent() != node)
+          *linked = true;
+
+        node = child;
+        continue;
+      }
+      else if (res != E_INVALID)
+        return nullptr;
+
+      // Mounted file systems resolve the rest of the path themselves
+      const std::string_view rest{name.data(), path.size() - static_cast<size_t>(name.data() - path.data())};
+
+      if (node->open(rest, foreign) != E_INVALID)
+        return nullptr;
+
+      // Node has no name index, switch to iteration over proxies
+      if ((*foreign = reinterpret_cast<FsNode *>(makeNodeProxy(this, node))) == nullptr)
+        return nullptr;
+    }
+
+    if ((*foreign = followChild(*foreign, name)) == nullptr)
+      return nullptr;
+  }
+
+  return *foreign == nullptr ? node : nullptr;
+}
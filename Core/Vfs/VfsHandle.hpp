@@ -8,33 +8,133 @@
 #define VFS_SHELL_CORE_VFS_VFSHANDLE_HPP_
 
 #include "Vfs/VfsDirectory.hpp"
+#include "Vfs/VfsEpoch.hpp"
+#include "Vfs/VfsInodeTable.hpp"
+#include "Vfs/VfsPathCache.hpp"
+#include "Vfs/VfsProxyPool.hpp"
+#include "Vfs/VfsWatcher.hpp"
+#include "Wrappers/SharedMutex.hpp"
+#include <array>
+#include <atomic>
+#include <utility>
+#include <vector>
+
+#ifndef CONFIG_VFS_LOCK_SHARDS
+#  define CONFIG_VFS_LOCK_SHARDS 4
+#endif
 
 extern const FsHandleClass * const VfsHandleClass;
 
 class VfsHandle
 {
 public:
+  // Exclusive lock of a node, should not be nested with other node locks
   class Locker
   {
   public:
     Locker(const Locker &) = delete;
     Locker &operator=(const Locker &) = delete;
 
-    Locker(VfsHandle &handle) :
-      m_handle{handle}
+    Locker(VfsHandle *handle, const VfsNode *node) :
+      m_mutex{handle != nullptr ? &handle->mutex(node) : nullptr}
     {
-      m_handle.lock();
+      if (m_mutex != nullptr)
+        m_mutex->lock();
     }
 
     ~Locker()
     {
-      m_handle.unlock();
+      if (m_mutex != nullptr)
+        m_mutex->unlock();
+    }
+
+  private:
+    Os::SharedMutex *m_mutex;
+  };
+
+  // Shared lock of a node, should not be nested with other node locks
+  class SharedLocker
+  {
+  public:
+    SharedLocker(const SharedLocker &) = delete;
+    SharedLocker &operator=(const SharedLocker &) = delete;
+
+    SharedLocker(VfsHandle *handle, const VfsNode *node) :
+      m_mutex{handle != nullptr ? &handle->mutex(node) : nullptr}
+    {
+      if (m_mutex != nullptr)
+        m_mutex->lockShared();
+    }
+
+    ~SharedLocker()
+    {
+      if (m_mutex != nullptr)
+        m_mutex->unlockShared();
+    }
+
+  private:
+    Os::SharedMutex *m_mutex;
+  };
+
+  // Lock of link creation acquired on demand, taken before node locks and held until the link is inserted
+  class LinkLocker
+  {
+  public:
+    LinkLocker(const LinkLocker &) = delete;
+    LinkLocker &operator=(const LinkLocker &) = delete;
+
+    LinkLocker(VfsHandle *handle) :
+      m_mutex{handle != nullptr ? &handle->m_linkLock : nullptr},
+      m_locked{false}
+    {
+    }
+
+    ~LinkLocker()
+    {
+      if (m_locked)
+        m_mutex->unlock();
+    }
+
+    void lock()
+    {
+      if (m_mutex != nullptr && !m_locked)
+      {
+        m_mutex->lock();
+        m_locked = true;
+      }
+    }
+
+  private:
+    Os::Mutex *m_mutex;
+    bool m_locked;
+  };
+
+  // Read-side epoch section, nodes reached without locks are not released until the section is left
+  class Section
+  {
+  public:
+    Section(const Section &) = delete;
+    Section &operator=(const Section &) = delete;
+
+    Section(VfsHandle *handle) :
+      m_epoch{handle != nullptr ? &handle->m_epoch : nullptr},
+      m_slot{m_epoch != nullptr ? m_epoch->enter() : 0}
+    {
+    }
+
+    ~Section()
+    {
+      if (m_epoch != nullptr)
+        m_epoch->leave(m_slot);
     }
 
   private:
-    VfsHandle &m_handle;
+    VfsEpoch *m_epoch;
+    uint32_t m_slot;
   };
 
+  static constexpr size_t LOCK_SHARDS{CONFIG_VFS_LOCK_SHARDS};
+
   static const FsHandleClass table;
 
   VfsHandle(const VfsHandle &) = delete;
@@ -61,47 +161,167 @@ public:
     return static_cast<VfsHandle *>(object)->syncImpl();
   }
 
-  void freeNodeProxy(VfsNodeProxy *proxy)
+  static VfsHandle *cast(FsHandle *);
+  static FsNode *openNode(FsHandle *, const char *);
+  static FsNode *openBaseNode(FsHandle *, const char *);
+  // Open a node by a path relative to the node with the identifier, empty path opens the node itself
+  static FsNode *openNodeAt(FsHandle *, FsIdentifier, const char *);
+
+  VfsPathCache::Stats cacheStats() const;
+
+  // Should be called before the tree structure changes
+  void invalidate(const VfsNode *node);
+
+  // Identifier of a node derived from its directory entry, zero for removed nodes
+  FsIdentifier identify(VfsNode *node)
   {
-    ::deinit(proxy);
+    if (node == &m_root)
+      return VfsDirectory::ROOT_IDENTIFIER;
+
+    // Parent is not released until the section is left even when the node is removed concurrently
+    Section section{this};
+    VfsNode * const parent = node->parent();
+
+    return parent != nullptr ? parent->identify(node) : 0;
   }
 
-  VfsNodeProxy *makeNodeProxy(VfsNode *node)
+  // Should be called when the node is removed from the tree
+  void unlink(const VfsNode *node)
   {
-    const VfsNodeProxy::Config config{node};
-    return static_cast<VfsNodeProxy *>(::init(VfsNodeProxyClass, &config));
+    Os::MutexLocker locker{m_inodeLock};
+    m_inodes.unlink(node);
   }
 
-  void lock()
+  // Should be called before the node is destroyed or leaves the handle
+  void release(const VfsNode *node)
   {
-    // TODO Mutex
+    {
+      Os::MutexLocker locker{m_inodeLock};
+      m_inodes.release(node);
+    }
+
+    if (m_watchers.load(std::memory_order_acquire) != nullptr)
+      detachWatchers(node);
   }
 
-  void unlock()
+  size_t inodes() const
+  {
+    Os::MutexLocker locker{m_inodeLock};
+    return m_inodes.size();
+  }
+
+  // Report a change of the node to watchers of the node and its parent, should be called without node locks,
+  // the identifier is passed for nodes that already left the directory
+  void notify(VfsNode *node, VfsWatcher::Type type, FsIdentifier id = 0)
+  {
+    // Writers do not touch the list of watchers when nobody is watching
+    if (m_watchers.load(std::memory_order_acquire) != nullptr)
+      dispatch(node, type, id);
+  }
+
+  void watch(VfsWatcher *);
+  // Watcher is not used by writers after the call, should be called outside of epoch sections
+  void unwatch(VfsWatcher *);
+
+  // Nodes with buffered data, such as mountpoints, are flushed during synchronization of the handle
+  void attach(VfsNode *);
+  void detach(VfsNode *);
+
+  // Removed entries are released when readers that may reach them without references are gone
+  VfsEpoch &epoch()
   {
-    // TODO Mutex
+    return m_epoch;
   }
 
+  // Proxies of nodes without a handle are allocated on the heap
+  static void freeNodeProxy(VfsHandle *, VfsNodeProxy *);
+  // Proxy references the node, null is returned when the reference counter of the node is exhausted
+  static VfsNodeProxy *makeNodeProxy(VfsHandle *, VfsNode *, const VfsNode::Cursor * = nullptr);
+
+  // Lock shared by all nodes with the same address hash
+  Os::SharedMutex &mutex(const VfsNode *);
+
 protected:
+  // Paths are distributed between shards of the cache, lookups of different paths do not contend
+  struct CacheShard
+  {
+    mutable Os::Mutex lock;
+    VfsPathCache cache;
+  };
+
+  // Immutable list of watchers sorted by watched nodes, subscribers replace the whole list
+  struct WatcherList: VfsEpoch::Retired
+  {
+    struct Entry
+    {
+      const VfsNode *node;
+      VfsWatcher *watcher;
+    };
+
+    std::vector<Entry> entries;
+
+    WatcherList() :
+      VfsEpoch::Retired{nullptr, [](VfsEpoch::Retired *object){ delete static_cast<WatcherList *>(object); }},
+      entries{}
+    {
+    }
+
+    // Range of watchers subscribed to the node
+    std::pair<const Entry *, const Entry *> find(const VfsNode *) const;
+
+    static bool compare(const Entry &, const Entry &);
+  };
+
   FsHandle m_base;
+  // Node locks are destroyed after the root node
+  std::array<Os::SharedMutex, LOCK_SHARDS> m_locks;
+  mutable Os::Mutex m_inodeLock;
+  // Serializes subscribers, writers read the list of watchers inside epoch sections
+  Os::Mutex m_watchLock;
+  // List is empty when nobody is watching
+  std::atomic<WatcherList *> m_watchers;
+  Os::Mutex m_syncLock;
+  // Serializes creation of links, checks for cycles and insertions of concurrent links are not interleaved
+  Os::Mutex m_linkLock;
+  std::vector<VfsNode *> m_buffered;
+  // Nodes opened by identifiers, they leave the table during release of the root node and retired nodes
+  VfsInodeTable m_inodes;
+  // Retired nodes are released after the root node and before the locks
+  VfsEpoch m_epoch;
   VfsDirectory m_root;
+  std::array<CacheShard, LOCK_SHARDS> m_caches;
+  VfsProxyPool m_proxies;
 
   VfsHandle() :
-    m_root{}
+    m_locks{},
+    m_inodeLock{},
+    m_watchLock{},
+    m_watchers{nullptr},
+    m_syncLock{},
+    m_linkLock{},
+    m_buffered{},
+    m_inodes{&m_root},
+    m_epoch{},
+    m_root{},
+    m_caches{},
+    m_proxies{}
   {
     m_root.enter(this, nullptr);
   }
 
+  CacheShard &cache(std::string_view);
+  void detachWatchers(const VfsNode *);
+  void dispatch(VfsNode *, VfsWatcher::Type, FsIdentifier);
+  FsNode *openImpl(const char *, bool);
+  FsNode *openImpl(FsIdentifier, const char *);
+  VfsNode *resolve(VfsNode *, std::string_view, FsNode **, bool * = nullptr);
+
   void *rootImpl()
   {
-    return makeNodeProxy(&m_root);
+    return makeNodeProxy(this, &m_root);
   }
 
-  Result syncImpl()
-  {
-    // TODO
-    return E_OK;
-  }
+  Result syncImpl();
 };
 
 #endif // VFS_SHELL_CORE_VFS_VFSHANDLE_HPP_
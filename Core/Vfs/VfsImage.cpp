@@ -0,0 +1,519 @@
+/*
+ * VfsImage.cpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "Vfs/VfsDataNode.hpp"
+#include "Vfs/VfsDirectory.hpp"
+#include "Vfs/VfsHandle.hpp"
+#include "Vfs/VfsImage.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+struct VfsImage::Header
+{
+  uint32_t magic;
+  uint16_t version;
+  uint16_t reserved;
+  // Number of node records
+  uint32_t count;
+  // Length of the name table placed after the records
+  uint32_t names;
+  // Offset of the record table
+  uint64_t records;
+  // Length of the whole image
+  uint64_t length;
+};
+
+struct VfsImage::Record
+{
+  // Offset of node data, zero for directories and empty data nodes
+  uint64_t data;
+  uint64_t length;
+  int64_t time;
+  // Index of the parent record, parents are placed before their descendants
+  uint32_t parent;
+  // Offset of the name in the name table
+  uint32_t name;
+  uint32_t access;
+  uint8_t directory;
+  uint8_t reserved[3];
+};
+
+// Image writer, data of nodes is written during the traversal and tables are written at the end
+class VfsImage::Writer
+{
+public:
+  Writer(FsNode *sink, void *buffer, size_t length) :
+    m_sink{sink},
+    m_buffer{static_cast<uint8_t *>(buffer)},
+    m_bufferLength{length},
+    m_position{sizeof(Header)}
+  {
+    // Sink node is skipped when it belongs to the saved subtree
+    m_identified = fsNodeRead(sink, FS_NODE_ID, 0, &m_sinkId, sizeof(m_sinkId), nullptr) == E_OK;
+  }
+
+  Result finish();
+  Result walk(FsNode *, uint32_t);
+
+private:
+  FsNode * const m_sink;
+  uint8_t * const m_buffer;
+  const size_t m_bufferLength;
+
+  FsIdentifier m_sinkId;
+  bool m_identified;
+
+  uint64_t m_position;
+  std::vector<Record> m_records;
+  std::string m_names;
+
+  Result align(size_t);
+  Result append(const void *, size_t);
+  Result appendData(FsNode *, FsLength, Record *);
+  Result appendNode(FsNode *, uint32_t, bool *);
+  bool skipped(FsNode *) const;
+};
+
+static uint64_t alignOffset(uint64_t offset, size_t alignment)
+{
+  return (offset + alignment - 1) & ~static_cast<uint64_t>(alignment - 1);
+}
+
+VfsImage::VfsImage(void *data, size_t length, Release callback) :
+  m_data{static_cast<uint8_t *>(data)},
+  m_length{length},
+  m_release{callback},
+  m_references{1},
+  m_restored{false}
+{
+}
+
+void VfsImage::release()
+{
+  releaseData(this);
+}
+
+Result VfsImage::restore(FsNode *directory)
+{
+  static_assert(VfsDataNode::EXTERNAL_HEADER_SIZE <= GAP, "Incorrect data gap");
+  static_assert(alignof(std::max_align_t) <= ALIGNMENT, "Incorrect data alignment");
+
+  VfsNodeProxy * const proxy = VfsNodeProxy::cast(directory);
+
+  // Only in-memory directories are able to attach restored nodes
+  if (proxy == nullptr || !proxy->get()->attachable())
+    return E_INVALID;
+
+  // Block headers are constructed in place, so the image can be restored only once
+  if (m_restored.exchange(true))
+    return E_BUSY;
+
+  const auto header = reinterpret_cast<const Header *>(m_data);
+
+  if (!validate(header))
+    return E_VALUE;
+
+  const auto records = reinterpret_cast<const Record *>(m_data + header->records);
+  const auto names = reinterpret_cast<const char *>(records + header->count);
+  std::vector<VfsNode *> nodes(header->count, nullptr);
+  std::vector<bool> created(header->count, false);
+  Result res = E_OK;
+
+  // Restored nodes are not referenced, they stay valid inside the section even when removed concurrently
+  VfsHandle::Section section{proxy->handle()};
+
+  for (uint32_t index = 0; index < header->count && res == E_OK; ++index)
+  {
+    const Record * const record = records + index;
+    VfsNode * const parent = record->parent != ROOT ? nodes[record->parent] : proxy->get();
+    bool attached = false;
+
+    res = restoreNode(parent, record, names + record->name, &nodes[index], &attached);
+    created[index] = attached;
+  }
+
+  // Directories are created writable, their access is restored after creation of descendants
+  for (uint32_t index = 0; index < header->count; ++index)
+  {
+    if (created[index] && records[index].directory)
+    {
+      const auto access = static_cast<FsAccess>(records[index].access);
+      nodes[index]->write(FS_NODE_ACCESS, 0, &access, sizeof(access), nullptr);
+    }
+  }
+
+  return res;
+}
+
+Result VfsImage::save(FsNode *directory, FsNode *sink, void *buffer, size_t length)
+{
+  Writer writer{sink, buffer, length};
+  const Result res = writer.walk(directory, ROOT);
+
+  return res == E_OK ? writer.finish() : res;
+}
+
+VfsImage *VfsImage::load(FsNode *node)
+{
+  FsLength length;
+
+  if (fsNodeLength(node, FS_NODE_DATA, &length) != E_OK)
+    return nullptr;
+  if (length < sizeof(Header) || static_cast<FsLength>(static_cast<size_t>(length)) != length)
+    return nullptr;
+
+  const auto size = static_cast<size_t>(length);
+  const auto memory = static_cast<uint8_t *>(malloc(size));
+
+  if (memory == nullptr)
+    return nullptr;
+
+  size_t position = 0;
+
+  while (position < size)
+  {
+    size_t count;
+    const Result res = fsNodeRead(node, FS_NODE_DATA, static_cast<FsLength>(position),
+        memory + position, size - position, &count);
+
+    if (res != E_OK || count == 0)
+    {
+      free(memory);
+      return nullptr;
+    }
+
+    position += count;
+  }
+
+  const auto image = new (std::nothrow) VfsImage{memory, size, freeHeap};
+
+  if (image == nullptr)
+    free(memory);
+
+  return image;
+}
+
+bool VfsImage::validate(const Header *header) const
+{
+  static_assert(sizeof(Header) == 32, "Incorrect image header size");
+  static_assert(sizeof(Record) == 40, "Incorrect image record size");
+
+  if (m_length < sizeof(Header) || header->magic != MAGIC || header->version != VERSION)
+    return false;
+  if (header->length > m_length || header->records % alignof(Record) != 0 || header->records < sizeof(Header))
+    return false;
+  if (header->records > header->length)
+    return false;
+
+  const uint64_t tables = static_cast<uint64_t>(header->count) * sizeof(Record) + header->names;
+
+  if (tables > header->length - header->records)
+    return false;
+
+  const auto records = reinterpret_cast<const Record *>(m_data + header->records);
+  const auto names = reinterpret_cast<const char *>(records + header->count);
+
+  // Name table should end with a terminating character
+  if (header->names == 0 || names[header->names - 1] != '\0')
+    return false;
+
+  // Data ranges follow each other in the order of records, each range is prepended with a gap
+  uint64_t end = sizeof(Header);
+
+  for (uint32_t index = 0; index < header->count; ++index)
+  {
+    const Record * const record = records + index;
+
+    if (record->name >= header->names)
+      return false;
+
+    if (record->parent != ROOT && (record->parent >= index || !records[record->parent].directory))
+      return false;
+
+    if (record->directory || record->length == 0)
+      continue;
+
+    if (record->data % ALIGNMENT != 0 || record->data < end + GAP || record->data > header->records)
+      return false;
+    if (record->length > header->records - record->data)
+      return false;
+
+    end = record->data + record->length;
+  }
+
+  return true;
+}
+
+Result VfsImage::restoreNode(VfsNode *parent, const Record *record, const char *name, VfsNode **result,
+    bool *attached)
+{
+  const auto access = static_cast<FsAccess>(record->access);
+  const auto timestamp = static_cast<time64_t>(record->time);
+  VfsNode *node;
+
+  if (parent->lookup(name, &node) == E_OK)
+  {
+    // Existing in-memory directories are merged with restored ones
+    if (!record->directory || !node->attachable())
+      return E_EXIST;
+
+    *result = node;
+    return E_OK;
+  }
+
+  if (record->directory)
+  {
+    node = new VfsDirectory{timestamp, static_cast<FsAccess>(access | FS_ACCESS_WRITE)};
+  }
+  else
+  {
+    const auto data = new VfsDataNode{timestamp, access};
+
+    if (data != nullptr && record->length > 0)
+    {
+      // Header of the data block is placed into the gap in front of the data
+      uint8_t * const header = m_data + record->data - VfsDataNode::EXTERNAL_HEADER_SIZE;
+
+      m_references.fetch_add(1, std::memory_order_relaxed);
+      data->share(header, static_cast<size_t>(record->length), releaseData, this);
+    }
+
+    node = data;
+  }
+
+  if (node == nullptr)
+    return E_MEMORY;
+
+  if (!node->rename(name))
+  {
+    delete node;
+    return E_MEMORY;
+  }
+
+  const FsFieldDescriptor descriptor = {
+      &node, sizeof(node), static_cast<FsFieldType>(VfsNode::VFS_NODE_OBJECT)
+  };
+  const Result res = parent->create(&descriptor, 1);
+
+  if (res != E_OK)
+  {
+    // Attached node is owned by the caller until the operation succeeds
+    delete node;
+    return res;
+  }
+
+  *result = node;
+  *attached = true;
+  return E_OK;
+}
+
+void VfsImage::releaseData(void *argument)
+{
+  const auto image = static_cast<VfsImage *>(argument);
+
+  if (image->m_references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+  {
+    image->m_release(image->m_data, image->m_length);
+    delete image;
+  }
+}
+
+void VfsImage::freeHeap(void *data, size_t)
+{
+  free(data);
+}
+
+Result VfsImage::Writer::finish()
+{
+  Result res;
+
+  // Record table is aligned, so records can be accessed in place
+  if ((res = align(alignof(Record))) != E_OK)
+    return res;
+
+  const uint64_t offset = m_position;
+  const size_t count = m_records.size();
+
+  // Name table is never empty, so an image without nodes is still valid
+  if (m_names.empty())
+    m_names.push_back('\0');
+
+  if ((res = append(m_records.data(), count * sizeof(Record))) != E_OK)
+    return res;
+  if ((res = append(m_names.data(), m_names.size())) != E_OK)
+    return res;
+
+  const Header header{MAGIC, VERSION, 0, static_cast<uint32_t>(count), static_cast<uint32_t>(m_names.size()),
+      offset, m_position};
+  size_t written;
+
+  res = fsNodeWrite(m_sink, FS_NODE_DATA, 0, &header, sizeof(header), &written);
+  if (res == E_OK && written != sizeof(header))
+    res = E_FULL;
+
+  return res;
+}
+
+Result VfsImage::Writer::walk(FsNode *directory, uint32_t parent)
+{
+  FsNode * const child = static_cast<FsNode *>(fsNodeHead(directory));
+
+  if (child == nullptr)
+    return E_OK;
+
+  Result res = E_OK;
+
+  do
+  {
+    bool directoryNode;
+
+    if (skipped(child))
+      continue;
+
+    if ((res = appendNode(child, parent, &directoryNode)) != E_OK)
+      break;
+
+    if (directoryNode && (res = walk(child, static_cast<uint32_t>(m_records.size() - 1))) != E_OK)
+      break;
+  }
+  while (fsNodeNext(child) == E_OK);
+
+  fsNodeFree(child);
+  return res;
+}
+
+Result VfsImage::Writer::align(size_t alignment)
+{
+  static const uint8_t zeros[GAP] = {0};
+  const auto padding = static_cast<size_t>(alignOffset(m_position, alignment) - m_position);
+
+  return padding > 0 ? append(zeros, padding) : E_OK;
+}
+
+Result VfsImage::Writer::append(const void *buffer, size_t length)
+{
+  size_t written;
+  Result res = fsNodeWrite(m_sink, FS_NODE_DATA, static_cast<FsLength>(m_position), buffer, length, &written);
+
+  if (res == E_OK && written != length)
+    res = E_FULL;
+  if (res == E_OK)
+    m_position += length;
+
+  return res;
+}
+
+Result VfsImage::Writer::appendData(FsNode *node, FsLength length, Record *record)
+{
+  static const uint8_t zeros[GAP] = {0};
+  Result res;
+
+  // Gap for the block header is placed in front of the aligned data
+  if ((res = align(ALIGNMENT)) != E_OK)
+    return res;
+  if ((res = append(zeros, GAP)) != E_OK)
+    return res;
+
+  const uint64_t offset = m_position;
+  FsLength position = 0;
+
+  while (position < length)
+  {
+    const auto chunk = static_cast<size_t>(MIN(length - position, static_cast<FsLength>(m_bufferLength)));
+    size_t count;
+
+    if ((res = fsNodeRead(node, FS_NODE_DATA, position, m_buffer, chunk, &count)) != E_OK)
+      return res;
+
+    // Data was truncated during the traversal
+    if (count == 0)
+      break;
+
+    if ((res = append(m_buffer, count)) != E_OK)
+      return res;
+
+    position += static_cast<FsLength>(count);
+  }
+
+  record->data = position > 0 ? offset : 0;
+  record->length = static_cast<uint64_t>(position);
+  return E_OK;
+}
+
+Result VfsImage::Writer::appendNode(FsNode *node, uint32_t parent, bool *directory)
+{
+  FsLength nameLength;
+  Result res;
+
+  if ((res = fsNodeLength(node, FS_NODE_NAME, &nameLength)) != E_OK)
+    return res;
+
+  Record record{};
+  FsAccess access = 0;
+  time64_t timestamp = 0;
+  FsLength length;
+
+  fsNodeRead(node, FS_NODE_ACCESS, 0, &access, sizeof(access), nullptr);
+  fsNodeRead(node, FS_NODE_TIME, 0, &timestamp, sizeof(timestamp), nullptr);
+
+  record.parent = parent;
+  record.name = static_cast<uint32_t>(m_names.size());
+  record.access = static_cast<uint32_t>(access);
+  record.time = static_cast<int64_t>(timestamp);
+
+  m_names.resize(m_names.size() + static_cast<size_t>(nameLength));
+
+  if ((res = fsNodeRead(node, FS_NODE_NAME, 0, &m_names[record.name], static_cast<size_t>(nameLength),
+      nullptr)) != E_OK)
+  {
+    return res;
+  }
+
+  // Nodes without data are stored as directories
+  *directory = fsNodeLength(node, FS_NODE_DATA, &length) != E_OK;
+
+  if (*directory)
+    record.directory = 1;
+  else if (length > 0 && (res = appendData(node, length, &record)) != E_OK)
+    return res;
+
+  m_records.push_back(record);
+  return E_OK;
+}
+
+bool VfsImage::Writer::skipped(FsNode *node) const
+{
+  // Contents of mounted file systems are stored by these file systems
+  VfsNodeProxy * const proxy = VfsNodeProxy::cast(node);
+
+  if (proxy != nullptr && proxy->get()->mounted())
+    return true;
+
+  // Device nodes are rebuilt during startup
+  void *interface;
+
+  if (fsNodeRead(node, static_cast<FsFieldType>(VfsNode::VFS_NODE_INTERFACE), 0, &interface, sizeof(interface),
+      nullptr) == E_OK)
+  {
+    return true;
+  }
+
+  // Bound directories are saved at their own place, hard links to data are saved as copies
+  VfsNode *target;
+
+  if (fsNodeRead(node, static_cast<FsFieldType>(VfsNode::VFS_NODE_LINK), 0, &target, sizeof(target),
+      nullptr) == E_OK && fsNodeLength(node, FS_NODE_DATA, nullptr) != E_OK)
+  {
+    return true;
+  }
+
+  FsIdentifier id;
+
+  return m_identified && fsNodeRead(node, FS_NODE_ID, 0, &id, sizeof(id), nullptr) == E_OK && id == m_sinkId;
+}
@@ -0,0 +1,75 @@
+/*
+ * Core/Vfs/VfsImage.hpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#ifndef VFS_SHELL_CORE_VFS_VFSIMAGE_HPP_
+#define VFS_SHELL_CORE_VFS_VFSIMAGE_HPP_
+
+#include <xcore/fs/fs.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+class VfsNode;
+
+// Flat image of a subtree: header, aligned data of nodes, node records and a name table.
+// All offsets are relative to the beginning of the image, so the image may be placed at any address.
+class VfsImage
+{
+public:
+  // Callback that frees memory of the image
+  using Release = void (*)(void *, size_t);
+
+  // Memory should be writable and aligned, block headers of data nodes are constructed in place
+  VfsImage(void *, size_t, Release);
+
+  VfsImage(const VfsImage &) = delete;
+  VfsImage &operator=(const VfsImage &) = delete;
+
+  // Drop the reference of the creator, memory is freed when restored nodes no longer use it
+  void release();
+
+  // Attach nodes of the image to an in-memory directory, existing directories are merged with restored ones,
+  // data nodes reference the image memory without copying
+  Result restore(FsNode *);
+
+  // Write a subtree to a sink node, the buffer is used for data transfer
+  static Result save(FsNode *, FsNode *, void *, size_t);
+
+  // Read an image from a node into heap memory
+  static VfsImage *load(FsNode *);
+
+private:
+  struct Header;
+  struct Record;
+  class Writer;
+
+  static constexpr uint32_t MAGIC{0x49534656};
+  static constexpr uint16_t VERSION{1};
+  // Alignment of data and tables, equals or exceeds the alignment of block headers on all platforms
+  static constexpr size_t ALIGNMENT{16};
+  // Space in front of each data range, used for the block header after restoration
+  static constexpr size_t GAP{32};
+  // Parent index of top-level nodes
+  static constexpr uint32_t ROOT{UINT32_MAX};
+
+  uint8_t *m_data;
+  size_t m_length;
+  Release m_release;
+  // Reference of the creator and references of data blocks used by nodes
+  std::atomic<size_t> m_references;
+  // Block headers are constructed in the image memory during restoration
+  std::atomic<bool> m_restored;
+
+  ~VfsImage() = default;
+
+  bool validate(const Header *) const;
+  Result restoreNode(VfsNode *, const Record *, const char *, VfsNode **, bool *);
+
+  static void releaseData(void *);
+  static void freeHeap(void *, size_t);
+};
+
+#endif // VFS_SHELL_CORE_VFS_VFSIMAGE_HPP_
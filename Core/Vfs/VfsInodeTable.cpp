@@ -0,0 +1,66 @@
+/*
+ * VfsInodeTable.cpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "Vfs/Vfs.hpp"
+#include "Vfs/VfsInodeTable.hpp"
+
+VfsInodeTable::VfsInodeTable(const VfsNode *root) :
+  m_root{root}
+{
+}
+
+bool VfsInodeTable::insert(FsIdentifier id, VfsNode *node)
+{
+  // Removed nodes can not be opened by identifier
+  if (!reachable(node))
+    return false;
+
+  m_identifiers.emplace(node, id);
+  m_nodes.emplace(id, node);
+  return true;
+}
+
+VfsNode *VfsInodeTable::find(FsIdentifier id) const
+{
+  const auto iter = m_nodes.find(id);
+
+  if (iter != m_nodes.end() && reachable(iter->second))
+    return iter->second;
+  else
+    return nullptr;
+}
+
+void VfsInodeTable::unlink(const VfsNode *node)
+{
+  m_unlinked.insert(node);
+}
+
+void VfsInodeTable::release(const VfsNode *node)
+{
+  const auto iter = m_identifiers.find(node);
+
+  if (iter != m_identifiers.end())
+  {
+    m_nodes.erase(iter->second);
+    m_identifiers.erase(iter);
+  }
+
+  m_unlinked.erase(node);
+}
+
+bool VfsInodeTable::reachable(const VfsNode *node) const
+{
+  // Parent links are cleared before ancestors are released, the caller is in an epoch section
+  while (node != m_root)
+  {
+    if (node == nullptr || m_unlinked.find(node) != m_unlinked.end())
+      return false;
+
+    node = node->parent();
+  }
+
+  return true;
+}
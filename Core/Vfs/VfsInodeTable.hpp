@@ -0,0 +1,48 @@
+/*
+ * Core/Vfs/VfsInodeTable.hpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#ifndef VFS_SHELL_CORE_VFS_VFSINODETABLE_HPP_
+#define VFS_SHELL_CORE_VFS_VFSINODETABLE_HPP_
+
+#include <xcore/fs/fs.h>
+#include <unordered_map>
+#include <unordered_set>
+
+class VfsNode;
+
+// Nodes opened by identifiers, entries are added on the first open and removed together with the nodes
+class VfsInodeTable
+{
+public:
+  VfsInodeTable(const VfsNode *);
+  VfsInodeTable(const VfsInodeTable &) = delete;
+  VfsInodeTable &operator=(const VfsInodeTable &) = delete;
+
+  // Returns false for nodes that are not reachable from the root
+  bool insert(FsIdentifier, VfsNode *);
+  // Returns null when the node was removed or released
+  VfsNode *find(FsIdentifier) const;
+  // Node and its descendants are removed from the tree but may still be in use
+  void unlink(const VfsNode *);
+  // Node is destroyed or leaves the tree, its identifier becomes invalid
+  void release(const VfsNode *);
+
+  size_t size() const
+  {
+    return m_nodes.size();
+  }
+
+private:
+  const VfsNode * const m_root;
+  std::unordered_map<FsIdentifier, VfsNode *> m_nodes;
+  std::unordered_map<const VfsNode *, FsIdentifier> m_identifiers;
+  // Roots of removed subtrees that are not released yet
+  std::unordered_set<const VfsNode *> m_unlinked;
+
+  bool reachable(const VfsNode *) const;
+};
+
+#endif // VFS_SHELL_CORE_VFS_VFSINODETABLE_HPP_
@@ -0,0 +1,121 @@
+/*
+ * VfsLink.cpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "Vfs/VfsLink.hpp"
+#include <cstring>
+
+VfsLink::VfsLink(VfsNode *target, time64_t timestamp) :
+  VfsNode{timestamp, FS_ACCESS_READ | FS_ACCESS_WRITE},
+  m_target{target}
+{
+}
+
+VfsLink::~VfsLink()
+{
+  m_target->release();
+}
+
+Result VfsLink::create(const FsFieldDescriptor *descriptors, size_t number)
+{
+  return m_target->create(descriptors, number);
+}
+
+void *VfsLink::head()
+{
+  // Descendants belong to the target, proxies of them iterate over the target
+  return m_target->head();
+}
+
+Result VfsLink::length(FsFieldType type, FsLength *fieldLength)
+{
+  if (type == FS_NODE_ID || type == FS_NODE_NAME)
+    return VfsNode::length(type, fieldLength);
+  else
+    return m_target->length(type, fieldLength);
+}
+
+Result VfsLink::list(Cursor *cursor, FsLength position, void *buffer, size_t bufferLength, size_t *bytesRead)
+{
+  return m_target->list(cursor, position, buffer, bufferLength, bytesRead);
+}
+
+Result VfsLink::lookup(std::string_view name, VfsNode **node)
+{
+  return m_target->lookup(name, node);
+}
+
+Result VfsLink::map(FsLength position, Mapping *mapping)
+{
+  return m_target->map(position, mapping);
+}
+
+Result VfsLink::open(std::string_view path, FsNode **node)
+{
+  return m_target->open(path, node);
+}
+
+bool VfsLink::reaches(const VfsNode *node)
+{
+  return node == this || m_target->reaches(node);
+}
+
+Result VfsLink::read(FsFieldType type, FsLength position, void *buffer, size_t bufferLength, size_t *bytesRead)
+{
+  if (type == FS_NODE_ID || type == FS_NODE_NAME)
+    return VfsNode::read(type, position, buffer, bufferLength, bytesRead);
+
+  if (static_cast<VfsFieldType>(type) == VFS_NODE_LINK)
+  {
+    if (position || bufferLength != sizeof(VfsNode *))
+      return E_VALUE;
+
+    // Links to links reference the final target
+    memcpy(buffer, &m_target, sizeof(VfsNode *));
+
+    if (bytesRead != nullptr)
+      *bytesRead = sizeof(VfsNode *);
+    return E_OK;
+  }
+
+  return m_target->read(type, position, buffer, bufferLength, bytesRead);
+}
+
+Result VfsLink::remove(FsNode *node)
+{
+  return m_target->remove(node);
+}
+
+Result VfsLink::sync()
+{
+  return m_target->sync();
+}
+
+Result VfsLink::write(FsFieldType type, FsLength position, const void *buffer, size_t bufferLength,
+    size_t *bytesWritten)
+{
+  const Result res = m_target->write(type, position, buffer, bufferLength, bytesWritten);
+
+  // Target notifies its own watchers, watchers of the link directory are notified here
+  if (res == E_OK)
+  {
+    if (type == FS_NODE_DATA || static_cast<VfsFieldType>(type) == VFS_NODE_LENGTH)
+      notify(VfsWatcher::EVENT_WRITE);
+    else if (type == FS_NODE_ACCESS || type == FS_NODE_TIME)
+      notify(VfsWatcher::EVENT_ATTRIBUTE);
+  }
+
+  return res;
+}
+
+bool VfsLink::empty()
+{
+  return m_target->empty();
+}
+
+bool VfsLink::attachable() const
+{
+  return m_target->attachable();
+}
@@ -0,0 +1,47 @@
+/*
+ * Core/Vfs/VfsLink.hpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#ifndef VFS_SHELL_CORE_VFS_VFSLINK_HPP_
+#define VFS_SHELL_CORE_VFS_VFSLINK_HPP_
+
+#include "Vfs/Vfs.hpp"
+
+// Named reference to another node of the same handle. Links to data nodes act as hard links,
+// links to directories act as bind mounts. Everything except the name and the identifier is forwarded
+// to the target, the target is kept alive while the link exists.
+class VfsLink: public VfsNode
+{
+public:
+  // Link adopts a reference of the target acquired by the caller
+  VfsLink(VfsNode *, time64_t = 0);
+  ~VfsLink() override;
+
+  virtual Result create(const FsFieldDescriptor *, size_t) override;
+  virtual void *head() override;
+  virtual Result length(FsFieldType, FsLength *) override;
+  virtual Result list(Cursor *, FsLength, void *, size_t, size_t *) override;
+  virtual Result lookup(std::string_view, VfsNode **) override;
+  virtual Result map(FsLength, Mapping *) override;
+  virtual Result open(std::string_view, FsNode **) override;
+  virtual bool reaches(const VfsNode *) override;
+  virtual Result read(FsFieldType, FsLength, void *, size_t, size_t *) override;
+  virtual Result remove(FsNode *) override;
+  virtual Result sync() override;
+  virtual Result write(FsFieldType, FsLength, const void *, size_t, size_t *) override;
+
+  virtual bool empty() override;
+  virtual bool attachable() const override;
+
+  VfsNode *target() const
+  {
+    return m_target;
+  }
+
+private:
+  VfsNode * const m_target;
+};
+
+#endif // VFS_SHELL_CORE_VFS_VFSLINK_HPP_
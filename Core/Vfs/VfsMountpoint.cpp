@@ -5,53 +5,396 @@
  */
 
 #include "Vfs/VfsMountpoint.hpp"
+#include "Shell/Interfaces/CacheParameters.hpp"
+#include "Vfs/VfsHandle.hpp"
+#include <algorithm>
+#include <cstring>
+
+static constexpr size_t NAME_BUFFER_LENGTH{256};
+
+struct VfsMountpoint::Proxy
+{
+  struct Config
+  {
+    VfsMountpoint *owner;
+    FsNode *node;
+  };
+
+  FsNode base;
+  VfsMountpoint *owner;
+  FsNode *node;
+
+  static const FsNodeClass table;
+
+  static FsNode *wrap(VfsMountpoint *owner, FsNode *node)
+  {
+    if (node == nullptr)
+      return nullptr;
+
+    // Mounted file system is released with the mountpoint, so proxies reference the mountpoint
+    FsNode *proxy = nullptr;
+
+    if (owner->acquire())
+    {
+      const Config config{owner, node};
+
+      if ((proxy = static_cast<FsNode *>(::init(&table, &config))) == nullptr)
+        owner->release();
+    }
+
+    if (proxy == nullptr)
+      fsNodeFree(node);
+
+    return proxy;
+  }
+
+  static FsNode *unwrap(void *node)
+  {
+    if (static_cast<const void *>(static_cast<FsNode *>(node)->base.type) == &table)
+      return static_cast<Proxy *>(node)->node;
+    else
+      return static_cast<FsNode *>(node);
+  }
+
+  static Result init(void *object, const void *config)
+  {
+    const Config * const proxyConfig = static_cast<const Config *>(config);
+    Proxy * const proxy = static_cast<Proxy *>(object);
+
+    proxy->owner = proxyConfig->owner;
+    proxy->node = proxyConfig->node;
+    return E_OK;
+  }
+
+  static void deinit(void *object)
+  {
+    Proxy * const proxy = static_cast<Proxy *>(object);
+
+    fsNodeFree(proxy->node);
+    proxy->owner->release();
+  }
+
+  static Result create(void *object, const FsFieldDescriptor *descriptors, size_t number)
+  {
+    return fsNodeCreate(static_cast<Proxy *>(object)->node, descriptors, number);
+  }
+
+  static void *head(void *object)
+  {
+    Proxy * const proxy = static_cast<Proxy *>(object);
+    return wrap(proxy->owner, static_cast<FsNode *>(fsNodeHead(proxy->node)));
+  }
+
+  static void free(void *object)
+  {
+    ::deinit(object);
+  }
+
+  static Result length(void *object, FsFieldType type, FsLength *fieldLength)
+  {
+    return fsNodeLength(static_cast<Proxy *>(object)->node, type, fieldLength);
+  }
+
+  static Result next(void *object)
+  {
+    return fsNodeNext(static_cast<Proxy *>(object)->node);
+  }
+
+  static Result read(void *object, FsFieldType type, FsLength position, void *buffer, size_t bufferLength,
+      size_t *bytesRead)
+  {
+    return fsNodeRead(static_cast<Proxy *>(object)->node, type, position, buffer, bufferLength, bytesRead);
+  }
+
+  static Result remove(void *object, void *node)
+  {
+    Proxy * const proxy = static_cast<Proxy *>(object);
+    FsNode * const target = unwrap(node);
+
+    // Directories are not cached again until the removal is finished
+    Os::MutexLocker locker{proxy->owner->m_lock};
+
+    proxy->owner->invalidate(target);
+    return fsNodeRemove(proxy->node, target);
+  }
+
+  static Result write(void *object, FsFieldType type, FsLength position, const void *buffer, size_t bufferLength,
+      size_t *bytesWritten)
+  {
+    return fsNodeWrite(static_cast<Proxy *>(object)->node, type, position, buffer, bufferLength, bytesWritten);
+  }
+};
+
+const FsNodeClass VfsMountpoint::Proxy::table{
+    sizeof(Proxy),  // size
+    Proxy::init,    // init
+    Proxy::deinit,  // deinit
+
+    Proxy::create,  // create
+    Proxy::head,    // head
+    Proxy::free,    // free
+    Proxy::length,  // length
+    Proxy::next,    // next
+    Proxy::read,    // read
+    Proxy::remove,  // remove
+    Proxy::write    // write
+};
+
+static std::string_view followPath(std::string_view *path)
+{
+  std::string_view name;
+
+  // Empty parts and references to the current directory are skipped
+  while (name.empty() || name == ".")
+  {
+    const size_t begin = path->find_first_not_of('/');
+
+    if (begin == std::string_view::npos)
+      return std::string_view{};
+
+    path->remove_prefix(begin);
+
+    const size_t end = std::min(path->find('/'), path->size());
+
+    name = path->substr(0, end);
+    path->remove_prefix(end);
+  }
+
+  return name;
+}
+
+static FsNode *findChild(FsNode *node, std::string_view name)
+{
+  // Directory node stays open, only the descendant is returned
+  FsNode *child = static_cast<FsNode *>(fsNodeHead(node));
+
+  while (child != nullptr)
+  {
+    char buffer[NAME_BUFFER_LENGTH];
+    FsLength length;
+
+    if (fsNodeLength(child, FS_NODE_NAME, &length) == E_OK && length == name.size() + 1 && length <= sizeof(buffer))
+    {
+      if (fsNodeRead(child, FS_NODE_NAME, 0, buffer, sizeof(buffer), nullptr) == E_OK && name == buffer)
+        break;
+    }
+
+    if (fsNodeNext(child) != E_OK)
+    {
+      fsNodeFree(child);
+      child = nullptr;
+    }
+  }
+
+  return child;
+}
 
 VfsMountpoint::VfsMountpoint(FsHandle *targetHandle, Interface *targetInterface,
     time64_t timestamp, FsAccess access) :
   VfsNode{timestamp, access},
+  m_targetInterface{targetInterface, [](Interface *pointer){ deinit(pointer); }},
   m_targetHandle{targetHandle, [](FsHandle *pointer){ deinit(pointer); }},
-  m_targetInterface{targetInterface, [](Interface *pointer){ deinit(pointer); }}
+  m_lock{},
+  m_root{nullptr},
+  m_directories{},
+  m_stamp{0}
 {
 }
 
+VfsMountpoint::~VfsMountpoint()
+{
+  // Mountpoint stays attached while it is referenced by links and proxies
+  if (m_handle != nullptr)
+    m_handle->detach(this);
+
+  // Nodes are released before the handle of the mounted file system
+  invalidate(nullptr);
+
+  if (m_root != nullptr)
+    fsNodeFree(m_root);
+}
+
 Result VfsMountpoint::create(const FsFieldDescriptor *descriptors, size_t number)
 {
-  FsNode * const root = static_cast<FsNode *>(fsHandleRoot(m_targetHandle.get()));
-  Result res = E_ERROR;
+  Os::MutexLocker locker{m_lock};
+  FsNode * const directory = root();
+
+  return directory != nullptr ? fsNodeCreate(directory, descriptors, number) : E_ERROR;
+}
+
+void *VfsMountpoint::head()
+{
+  FsNode *child = nullptr;
 
-  if (root != nullptr)
   {
-    res = fsNodeCreate(root, descriptors, number);
-    fsNodeFree(root);
+    Os::MutexLocker locker{m_lock};
+    FsNode * const directory = root();
+
+    if (directory != nullptr)
+      child = static_cast<FsNode *>(fsNodeHead(directory));
   }
 
-  return res;
+  return Proxy::wrap(this, child);
 }
 
-void *VfsMountpoint::head()
+Result VfsMountpoint::open(std::string_view path, FsNode **node)
 {
-  FsNode * const root = static_cast<FsNode *>(fsHandleRoot(m_targetHandle.get()));
+  // Path is split into the parent directory and the name of the node
+  char directory[PATH_LENGTH];
+  size_t length = 0;
+  std::string_view remaining = path;
+  std::string_view name;
+  std::string_view part;
+
+  while (!(part = followPath(&remaining)).empty())
+  {
+    if (!name.empty())
+    {
+      // Long paths are resolved by iteration
+      if (length + name.size() + 1 >= sizeof(directory))
+        return E_INVALID;
+
+      if (length)
+        directory[length++] = '/';
+      memcpy(directory + length, name.data(), name.size());
+      length += name.size();
+    }
+
+    name = part;
+  }
+
+  if (name.empty())
+    return E_INVALID;
+
   FsNode *child = nullptr;
 
-  if (root != nullptr)
   {
-    child = static_cast<FsNode *>(fsNodeHead(root));
-    fsNodeFree(root);
+    Os::MutexLocker locker{m_lock};
+    FsNode * const parent = openDirectory(std::string_view{directory, length});
+
+    if (parent != nullptr)
+      child = findChild(parent, name);
   }
 
-  return child;
+  if (child == nullptr)
+    return E_ENTRY;
+
+  *node = Proxy::wrap(this, child);
+  return *node != nullptr ? E_OK : E_MEMORY;
 }
 
 Result VfsMountpoint::remove(FsNode *node)
 {
-  FsNode * const root = static_cast<FsNode *>(fsHandleRoot(m_targetHandle.get()));
-  Result res = E_ERROR;
+  Os::MutexLocker locker{m_lock};
+  FsNode * const directory = root();
+
+  if (directory == nullptr)
+    return E_ERROR;
+
+  FsNode * const target = Proxy::unwrap(node);
+
+  invalidate(target);
+  return fsNodeRemove(directory, target);
+}
+
+Result VfsMountpoint::sync()
+{
+  Os::MutexLocker locker{m_lock};
+  const Result res = fsHandleSync(m_targetHandle.get());
 
-  if (root != nullptr)
+  if (res != E_OK || m_targetInterface == nullptr)
+    return res;
+
+  // Interfaces without a sector cache have nothing to flush
+  const Result flushRes = ifSetParam(m_targetInterface.get(), IF_CACHE_FLUSH, nullptr);
+  return flushRes != E_INVALID ? flushRes : E_OK;
+}
+
+void VfsMountpoint::enter(VfsHandle *handle, VfsNode *node)
+{
+  if (m_handle != handle)
+  {
+    if (m_handle != nullptr)
+      m_handle->detach(this);
+    if (handle != nullptr)
+      handle->attach(this);
+  }
+
+  VfsNode::enter(handle, node);
+}
+
+bool VfsMountpoint::mounted() const
+{
+  return true;
+}
+
+FsNode *VfsMountpoint::root()
+{
+  if (m_root == nullptr)
+    m_root = static_cast<FsNode *>(fsHandleRoot(m_targetHandle.get()));
+
+  return m_root;
+}
+
+FsNode *VfsMountpoint::openDirectory(std::string_view path)
+{
+  if (path.empty())
+    return root();
+
+  Directory *victim = &m_directories[0];
+
+  for (auto &entry : m_directories)
   {
-    res = fsNodeRemove(root, node);
-    fsNodeFree(root);
+    if (entry.node != nullptr && path == entry.path)
+    {
+      entry.stamp = ++m_stamp;
+      return entry.node;
+    }
+
+    if (entry.node == nullptr || (victim->node != nullptr && entry.stamp < victim->stamp))
+      victim = &entry;
   }
 
-  return res;
+  // Directory is opened by a walk from the root, intermediate nodes are released
+  FsNode *node = root();
+  std::string_view remaining = path;
+  std::string_view name;
+
+  while (node != nullptr && !(name = followPath(&remaining)).empty())
+  {
+    FsNode * const child = findChild(node, name);
+
+    if (node != m_root)
+      fsNodeFree(node);
+    node = child;
+  }
+
+  if (node == nullptr)
+    return nullptr;
+
+  if (victim->node != nullptr)
+    fsNodeFree(victim->node);
+
+  victim->node = node;
+  victim->stamp = ++m_stamp;
+  memcpy(victim->path, path.data(), path.size());
+  victim->path[path.size()] = '\0';
+
+  return node;
+}
+
+void VfsMountpoint::invalidate(FsNode *node)
+{
+  // Removal of a data node does not affect cached directories
+  if (node != nullptr && fsNodeLength(node, FS_NODE_DATA, nullptr) == E_OK)
+    return;
+
+  for (auto &entry : m_directories)
+  {
+    if (entry.node != nullptr)
+    {
+      fsNodeFree(entry.node);
+      entry.node = nullptr;
+    }
+  }
 }
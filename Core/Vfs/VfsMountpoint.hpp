@@ -8,22 +8,64 @@
 #define VFS_SHELL_CORE_VFS_VFSMOUNTPOINT_HPP_
 
 #include "Vfs/Vfs.hpp"
+#include "Wrappers/Mutex.hpp"
 #include <xcore/interface.h>
+#include <array>
 #include <functional>
 #include <memory>
 
+#ifndef CONFIG_VFS_MOUNT_DIRECTORIES
+#  define CONFIG_VFS_MOUNT_DIRECTORIES 4
+#endif
+
 class VfsMountpoint: public VfsNode
 {
 public:
+  // Number of cached directory nodes of the mounted file system
+  static constexpr size_t DIRECTORIES{CONFIG_VFS_MOUNT_DIRECTORIES};
+  // Nodes of the mounted file system kept open by the mountpoint: the root node and cached directories
+  static constexpr size_t RESERVED_NODES{DIRECTORIES + 1};
+  static constexpr size_t PATH_LENGTH{64};
+
   VfsMountpoint(FsHandle *, Interface *, time64_t = 0, FsAccess = FS_ACCESS_READ | FS_ACCESS_WRITE);
+  ~VfsMountpoint() override;
 
   virtual Result create(const FsFieldDescriptor *descriptors, size_t number) override;
   virtual void *head() override;
+  virtual Result open(std::string_view, FsNode **) override;
   virtual Result remove(FsNode *node) override;
+  virtual Result sync() override;
+
+  virtual void enter(VfsHandle *, VfsNode *) override;
+
+  virtual bool mounted() const override;
 
 private:
-  std::unique_ptr<FsHandle, std::function<void (FsHandle *)>> m_targetHandle;
+  // Node of the mounted file system, removals are reported to the mountpoint
+  struct Proxy;
+
+  struct Directory
+  {
+    FsNode *node;
+    uint32_t stamp;
+    char path[PATH_LENGTH];
+  };
+
+  // Handle of the mounted file system is released before the interface
   std::unique_ptr<Interface, std::function<void (Interface *)>> m_targetInterface;
+  std::unique_ptr<FsHandle, std::function<void (FsHandle *)>> m_targetHandle;
+
+  Os::Mutex m_lock;
+  // Root node of the mounted file system, opened on first use and kept until unmounting
+  FsNode *m_root;
+  std::array<Directory, DIRECTORIES> m_directories;
+  // Usage counter, a directory with the lowest stamp is evicted first
+  uint32_t m_stamp;
+
+  FsNode *root();
+  FsNode *openDirectory(std::string_view);
+  // Release cached directories before removal of a node, null node releases them unconditionally
+  void invalidate(FsNode *);
 };
 
 #endif // VFS_SHELL_CORE_VFS_VFSMOUNTPOINT_HPP_
@@ -0,0 +1,157 @@
+/*
+ * VfsPathCache.cpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "Vfs/Vfs.hpp"
+#include "Vfs/VfsPathCache.hpp"
+#include <algorithm>
+#include <cstring>
+
+VfsPathCache::VfsPathCache() :
+  m_stamp{0},
+  m_generation{0},
+  m_hits{0},
+  m_misses{0}
+{
+  clear();
+}
+
+VfsNode *VfsPathCache::find(std::string_view path)
+{
+  if (path.size() < PATH_LENGTH)
+  {
+    const uint32_t hash = makeHash(path);
+
+    for (auto &entry : m_entries)
+    {
+      if (entry.node != nullptr && entry.hash == hash && path == entry.path)
+      {
+        entry.stamp = ++m_stamp;
+        ++m_hits;
+        return entry.node;
+      }
+    }
+  }
+
+  ++m_misses;
+  return nullptr;
+}
+
+void VfsPathCache::insert(std::string_view path, VfsNode *node)
+{
+  if (path.size() >= PATH_LENGTH)
+  {
+    // Long paths are not cached
+    return;
+  }
+
+  Entry *victim = &m_entries[0];
+
+  for (auto &entry : m_entries)
+  {
+    if (entry.node == nullptr)
+    {
+      victim = &entry;
+      break;
+    }
+    if (entry.stamp < victim->stamp)
+      victim = &entry;
+  }
+
+  victim->node = node;
+  victim->hash = makeHash(path);
+  victim->stamp = ++m_stamp;
+  memcpy(victim->path, path.data(), path.size());
+  victim->path[path.size()] = '\0';
+}
+
+void VfsPathCache::invalidate(const VfsNode *node)
+{
+  ++m_generation;
+
+  // Drop entries for the node and for all its descendants
+  for (auto &entry : m_entries)
+  {
+    for (const VfsNode *current = entry.node; current != nullptr; current = current->parent())
+    {
+      if (current == node)
+      {
+        entry.node = nullptr;
+        break;
+      }
+    }
+  }
+}
+
+void VfsPathCache::clear()
+{
+  ++m_generation;
+
+  for (auto &entry : m_entries)
+  {
+    entry.node = nullptr;
+    entry.stamp = 0;
+  }
+}
+
+VfsPathCache::Stats VfsPathCache::stats() const
+{
+  size_t entries = 0;
+
+  for (const auto &entry : m_entries)
+  {
+    if (entry.node != nullptr)
+      ++entries;
+  }
+
+  return Stats{m_hits, m_misses, entries};
+}
+
+std::string_view VfsPathCache::normalize(std::string_view path, char *buffer)
+{
+  size_t length = 0;
+  size_t position = 0;
+
+  // Repeated separators, trailing separators and references to the current directory are dropped
+  while ((position = path.find_first_not_of('/', position)) != std::string_view::npos)
+  {
+    const size_t end = std::min(path.find('/', position), path.size());
+    const auto name = path.substr(position, end - position);
+
+    position = end;
+
+    if (name == ".")
+      continue;
+
+    if (length + name.size() + 1 >= PATH_LENGTH)
+    {
+      // Long paths are not cached, they are resolved unchanged
+      return path;
+    }
+
+    buffer[length++] = '/';
+    memcpy(buffer + length, name.data(), name.size());
+    length += name.size();
+  }
+
+  if (length == 0)
+    buffer[length++] = '/';
+
+  return std::string_view{buffer, length};
+}
+
+uint32_t VfsPathCache::makeHash(std::string_view path)
+{
+  // FNV-1a hash
+  uint32_t hash = 2166136261UL;
+
+  for (const char c : path)
+  {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 16777619UL;
+  }
+
+  return hash;
+}
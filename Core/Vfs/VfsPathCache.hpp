@@ -0,0 +1,68 @@
+/*
+ * Core/Vfs/VfsPathCache.hpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#ifndef VFS_SHELL_CORE_VFS_VFSPATHCACHE_HPP_
+#define VFS_SHELL_CORE_VFS_VFSPATHCACHE_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+class VfsNode;
+
+class VfsPathCache
+{
+public:
+  static constexpr size_t CAPACITY{16};
+  static constexpr size_t PATH_LENGTH{64};
+
+  struct Stats
+  {
+    size_t hits;
+    size_t misses;
+    size_t entries;
+  };
+
+  VfsPathCache();
+  VfsPathCache(const VfsPathCache &) = delete;
+  VfsPathCache &operator=(const VfsPathCache &) = delete;
+
+  VfsNode *find(std::string_view);
+  void insert(std::string_view, VfsNode *);
+  void invalidate(const VfsNode *);
+  void clear();
+  Stats stats() const;
+
+  // Equivalent spellings of an absolute path are reduced to one key in a buffer of PATH_LENGTH bytes
+  static std::string_view normalize(std::string_view, char *);
+
+  static uint32_t makeHash(std::string_view);
+
+  // Invalidation counter, lookups started before an invalidation should not be inserted
+  uint32_t generation() const
+  {
+    return m_generation;
+  }
+
+private:
+  struct Entry
+  {
+    VfsNode *node;
+    uint32_t hash;
+    uint32_t stamp;
+    char path[PATH_LENGTH];
+  };
+
+  std::array<Entry, CAPACITY> m_entries;
+  // Usage counter, an entry with the lowest stamp is evicted first
+  uint32_t m_stamp;
+  uint32_t m_generation;
+  size_t m_hits;
+  size_t m_misses;
+};
+
+#endif // VFS_SHELL_CORE_VFS_VFSPATHCACHE_HPP_
@@ -0,0 +1,50 @@
+/*
+ * VfsProxyPool.cpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "Vfs/VfsProxyPool.hpp"
+
+VfsProxyPool::VfsProxyPool() :
+  m_head{0}
+{
+  for (size_t index = 0; index < CAPACITY; ++index)
+  {
+    const uint16_t next = index + 1 < CAPACITY ? static_cast<uint16_t>(index + 1) : END_OF_LIST;
+    m_links[index].store(next, std::memory_order_relaxed);
+  }
+}
+
+void *VfsProxyPool::allocate()
+{
+  uint32_t head = m_head.load(std::memory_order_acquire);
+
+  while ((head & INDEX_MASK) != END_OF_LIST)
+  {
+    const uint32_t index = head & INDEX_MASK;
+    const uint32_t next = m_links[index].load(std::memory_order_relaxed);
+    const uint32_t tag = (head & ~INDEX_MASK) + TAG_STEP;
+
+    // Tag protects against reuse of the same slot between load and exchange
+    if (m_head.compare_exchange_weak(head, tag | next, std::memory_order_acquire, std::memory_order_acquire))
+      return m_slots[index].data;
+  }
+
+  // Pool is exhausted
+  return nullptr;
+}
+
+void VfsProxyPool::release(void *pointer)
+{
+  const auto index = static_cast<uint16_t>(static_cast<Slot *>(pointer) - m_slots.data());
+  uint32_t head = m_head.load(std::memory_order_relaxed);
+  uint32_t tag;
+
+  do
+  {
+    m_links[index].store(static_cast<uint16_t>(head & INDEX_MASK), std::memory_order_relaxed);
+    tag = (head & ~INDEX_MASK) + TAG_STEP;
+  }
+  while (!m_head.compare_exchange_weak(head, tag | index, std::memory_order_release, std::memory_order_relaxed));
+}
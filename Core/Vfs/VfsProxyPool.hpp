@@ -0,0 +1,56 @@
+/*
+ * Core/Vfs/VfsProxyPool.hpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#ifndef VFS_SHELL_CORE_VFS_VFSPROXYPOOL_HPP_
+#define VFS_SHELL_CORE_VFS_VFSPROXYPOOL_HPP_
+
+#include "Vfs/Vfs.hpp"
+#include <array>
+#include <atomic>
+
+#ifndef CONFIG_VFS_PROXY_POOL_SIZE
+#  define CONFIG_VFS_PROXY_POOL_SIZE 16
+#endif
+
+class VfsProxyPool
+{
+public:
+  static constexpr size_t CAPACITY{CONFIG_VFS_PROXY_POOL_SIZE};
+
+  VfsProxyPool();
+  VfsProxyPool(const VfsProxyPool &) = delete;
+  VfsProxyPool &operator=(const VfsProxyPool &) = delete;
+
+  void *allocate();
+  void release(void *);
+
+  bool owns(const void *pointer) const
+  {
+    const auto address = static_cast<const uint8_t *>(pointer);
+    const auto begin = reinterpret_cast<const uint8_t *>(m_slots.data());
+
+    return address >= begin && address < begin + sizeof(m_slots);
+  }
+
+private:
+  // Head of the free list: slot index in low half-word, modification tag in high half-word
+  static constexpr uint32_t INDEX_MASK{0xFFFF};
+  static constexpr uint32_t TAG_STEP{INDEX_MASK + 1};
+  static constexpr uint16_t END_OF_LIST{INDEX_MASK};
+
+  static_assert(CAPACITY > 0 && CAPACITY < END_OF_LIST, "Incorrect proxy pool size");
+
+  struct alignas(VfsNodeProxy) Slot
+  {
+    uint8_t data[sizeof(VfsNodeProxy)];
+  };
+
+  std::array<Slot, CAPACITY> m_slots;
+  std::array<std::atomic<uint16_t>, CAPACITY> m_links;
+  std::atomic<uint32_t> m_head;
+};
+
+#endif // VFS_SHELL_CORE_VFS_VFSPROXYPOOL_HPP_
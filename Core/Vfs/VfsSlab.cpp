@@ -0,0 +1,260 @@
+/*
+ * VfsSlab.cpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "Vfs/VfsDataNode.hpp"
+#include "Vfs/VfsDirectory.hpp"
+#include "Vfs/VfsSlab.hpp"
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+struct VfsSlab::Chunk
+{
+  union
+  {
+    // Owning page of an allocated chunk or null for heap allocations
+    Page *page;
+    // Next free chunk of the page
+    Chunk *next;
+  };
+};
+
+struct VfsSlab::Page
+{
+  VfsSlab *owner;
+  Page *prev;
+  Page *next;
+  Chunk *free;
+  size_t used;
+};
+
+static constexpr size_t ENTRIES_PER_PAGE{32};
+static constexpr size_t EXTENTS_PER_PAGE{8};
+static constexpr size_t NODES_PER_PAGE{16};
+static constexpr size_t NAMES_PER_PAGE{32};
+
+static constexpr size_t alignSize(size_t size, size_t alignment)
+{
+  return (size + alignment - 1) & ~(alignment - 1);
+}
+
+static constexpr size_t alignPower(size_t size)
+{
+  size_t power = 1;
+
+  while (power < size)
+    power <<= 1;
+  return power;
+}
+
+VfsSlab::VfsSlab(size_t objectSize, size_t chunksPerPage, bool compact) :
+  m_lock{},
+  m_partial{nullptr},
+  m_spare{nullptr},
+  m_objectSize{objectSize},
+  m_headerSize{compact ? 0 : HEADER_SIZE},
+  m_chunkSize{compact ? alignSize(objectSize, alignof(Chunk)) : HEADER_SIZE + alignSize(objectSize, ALIGNMENT)},
+  m_pageSize{0},
+  m_chunksPerPage{chunksPerPage},
+  m_pages{0},
+  m_used{0}
+{
+  if (compact)
+  {
+    // Space left by rounding of the page size is filled with chunks
+    const size_t headerSize = alignSize(sizeof(Page), alignof(Chunk));
+
+    m_pageSize = alignPower(headerSize + m_chunkSize * chunksPerPage);
+    m_chunksPerPage = (m_pageSize - headerSize) / m_chunkSize;
+  }
+}
+
+void *VfsSlab::allocate(size_t size)
+{
+  if (size > m_objectSize)
+  {
+    // Object does not fit into the chunk, objects of compact caches can not be taken from the heap
+    return m_pageSize ? nullptr : allocateHeap(size);
+  }
+
+  Os::MutexLocker locker{m_lock};
+  Page *page = m_partial;
+
+  if (page == nullptr)
+  {
+    if (m_spare != nullptr)
+    {
+      page = m_spare;
+      m_spare = nullptr;
+    }
+    else if ((page = makePage()) == nullptr)
+      return nullptr;
+
+    link(page);
+  }
+
+  Chunk * const chunk = page->free;
+
+  page->free = chunk->next;
+  ++page->used;
+  ++m_used;
+
+  if (page->free == nullptr)
+    unlink(page);
+
+  if (m_headerSize)
+    chunk->page = page;
+  return reinterpret_cast<uint8_t *>(chunk) + m_headerSize;
+}
+
+void VfsSlab::deallocate(void *pointer)
+{
+  if (pointer == nullptr)
+    return;
+
+  const auto address = reinterpret_cast<uintptr_t>(pointer);
+  free(reinterpret_cast<Page *>(address & ~(m_pageSize - 1)), pointer);
+}
+
+VfsSlab::Stats VfsSlab::stats() const
+{
+  Os::MutexLocker locker{m_lock};
+  return Stats{m_objectSize, m_chunkSize, m_pages, m_used, m_pages * m_chunksPerPage};
+}
+
+void *VfsSlab::allocateHeap(size_t size)
+{
+  const auto chunk = static_cast<Chunk *>(malloc(HEADER_SIZE + size));
+
+  if (chunk != nullptr)
+  {
+    chunk->page = nullptr;
+    return reinterpret_cast<uint8_t *>(chunk) + HEADER_SIZE;
+  }
+  else
+    return nullptr;
+}
+
+void VfsSlab::release(void *pointer)
+{
+  if (pointer == nullptr)
+    return;
+
+  const auto chunk = reinterpret_cast<Chunk *>(static_cast<uint8_t *>(pointer) - HEADER_SIZE);
+  Page * const page = chunk->page;
+
+  if (page != nullptr)
+    page->owner->free(page, chunk);
+  else
+    ::free(chunk);
+}
+
+VfsSlab &VfsSlab::directoryCache()
+{
+  static VfsSlab cache{sizeof(VfsDirectory), NODES_PER_PAGE};
+  return cache;
+}
+
+VfsSlab &VfsSlab::dataCache()
+{
+  static VfsSlab cache{sizeof(VfsDataNode), NODES_PER_PAGE};
+  return cache;
+}
+
+VfsSlab &VfsSlab::entryCache()
+{
+  static VfsSlab cache{sizeof(VfsDirectory::Entry), ENTRIES_PER_PAGE};
+  return cache;
+}
+
+VfsSlab &VfsSlab::extentCache()
+{
+  // Each extent is prepended with a reference counter
+  static VfsSlab cache{VfsDataNode::EXTENT_SIZE + alignof(std::max_align_t), EXTENTS_PER_PAGE};
+  return cache;
+}
+
+VfsSlab &VfsSlab::nameCache()
+{
+  // Names need no alignment, a chunk header would cost more than the name itself
+  static VfsSlab cache{NAME_LENGTH, NAMES_PER_PAGE, true};
+  return cache;
+}
+
+VfsSlab::Page *VfsSlab::makePage()
+{
+  const size_t headerSize = alignSize(sizeof(Page), m_headerSize ? ALIGNMENT : alignof(Chunk));
+  const auto memory = static_cast<uint8_t *>(m_pageSize ?
+      aligned_alloc(m_pageSize, m_pageSize) : malloc(headerSize + m_chunkSize * m_chunksPerPage));
+
+  if (memory == nullptr)
+    return nullptr;
+
+  const auto page = new (memory) Page{this, nullptr, nullptr, nullptr, 0};
+
+  for (size_t index = m_chunksPerPage; index > 0; --index)
+  {
+    const auto chunk = reinterpret_cast<Chunk *>(memory + headerSize + (index - 1) * m_chunkSize);
+
+    chunk->next = page->free;
+    page->free = chunk;
+  }
+
+  ++m_pages;
+  return page;
+}
+
+void VfsSlab::free(Page *page, void *pointer)
+{
+  Os::MutexLocker locker{m_lock};
+  const auto chunk = static_cast<Chunk *>(pointer);
+  const bool full = page->free == nullptr;
+
+  chunk->next = page->free;
+  page->free = chunk;
+  --page->used;
+  --m_used;
+
+  if (full)
+    link(page);
+
+  if (page->used == 0)
+  {
+    unlink(page);
+
+    if (m_spare == nullptr)
+      m_spare = page;
+    else
+    {
+      ::free(page);
+      --m_pages;
+    }
+  }
+}
+
+void VfsSlab::link(Page *page)
+{
+  page->prev = nullptr;
+  page->next = m_partial;
+
+  if (m_partial != nullptr)
+    m_partial->prev = page;
+  m_partial = page;
+}
+
+void VfsSlab::unlink(Page *page)
+{
+  if (page->prev != nullptr)
+    page->prev->next = page->next;
+  else
+    m_partial = page->next;
+
+  if (page->next != nullptr)
+    page->next->prev = page->prev;
+
+  page->prev = nullptr;
+  page->next = nullptr;
+}
@@ -0,0 +1,79 @@
+/*
+ * Core/Vfs/VfsSlab.hpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#ifndef VFS_SHELL_CORE_VFS_VFSSLAB_HPP_
+#define VFS_SHELL_CORE_VFS_VFSSLAB_HPP_
+
+#include "Wrappers/Mutex.hpp"
+#include <cstddef>
+#include <cstdint>
+
+class VfsSlab
+{
+public:
+  // Names shorter than this limit are allocated from the name cache
+  static constexpr size_t NAME_LENGTH{24};
+
+  struct Stats
+  {
+    size_t objectSize;
+    // Memory taken by each object including the chunk header
+    size_t chunkSize;
+    size_t slabs;
+    size_t used;
+    size_t capacity;
+  };
+
+  // Chunks of compact caches have no headers, their objects are returned with deallocate
+  VfsSlab(size_t, size_t, bool = false);
+  VfsSlab(const VfsSlab &) = delete;
+  VfsSlab &operator=(const VfsSlab &) = delete;
+
+  void *allocate(size_t);
+  void deallocate(void *);
+  Stats stats() const;
+
+  static void *allocateHeap(size_t);
+  static void release(void *);
+
+  static VfsSlab &directoryCache();
+  static VfsSlab &dataCache();
+  static VfsSlab &entryCache();
+  static VfsSlab &extentCache();
+  static VfsSlab &nameCache();
+
+private:
+  struct Chunk;
+  struct Page;
+
+  // Chunk header is padded to keep objects aligned
+  static constexpr size_t ALIGNMENT{alignof(std::max_align_t)};
+  static constexpr size_t HEADER_SIZE{(sizeof(Page *) + ALIGNMENT - 1) & ~(ALIGNMENT - 1)};
+
+  // Nodes of different directories are created and released concurrently
+  mutable Os::Mutex m_lock;
+
+  // Pages with at least one free chunk
+  Page *m_partial;
+  // Single empty page kept to avoid allocation bounce on create-remove sequences
+  Page *m_spare;
+
+  size_t m_objectSize;
+  size_t m_headerSize;
+  size_t m_chunkSize;
+  // Pages of compact caches are aligned to their size, the page of a chunk is found by its address
+  size_t m_pageSize;
+  size_t m_chunksPerPage;
+  size_t m_pages;
+  size_t m_used;
+
+  Page *makePage();
+  void free(Page *, void *);
+  void link(Page *);
+  void unlink(Page *);
+};
+
+#endif // VFS_SHELL_CORE_VFS_VFSSLAB_HPP_
@@ -0,0 +1,101 @@
+/*
+ * VfsWatcher.cpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "Vfs/VfsWatcher.hpp"
+
+VfsWatcher::VfsWatcher(const VfsNode *node, Callback callback, void *argument) :
+  m_node{node},
+  m_callback{callback},
+  m_argument{argument},
+  m_head{0},
+  m_tail{0},
+  m_written{0},
+  m_overflow{false}
+{
+  for (size_t index = 0; index < DEPTH; ++index)
+    m_cells[index].sequence.store(index, std::memory_order_relaxed);
+}
+
+void VfsWatcher::push(Type type, FsIdentifier node)
+{
+  // Write event of the same node is already waiting for the consumer
+  if (type == EVENT_WRITE && node != 0 && m_written.exchange(node, std::memory_order_acq_rel) == node)
+    return;
+
+  if (!enqueue(Event{node, type}))
+  {
+    if (type == EVENT_WRITE && node != 0)
+    {
+      FsIdentifier expected = node;
+      m_written.compare_exchange_strong(expected, 0, std::memory_order_relaxed);
+    }
+
+    m_overflow.store(true, std::memory_order_release);
+  }
+
+  if (m_callback != nullptr)
+    m_callback(m_argument);
+}
+
+bool VfsWatcher::pop(Event *event)
+{
+  Cell * const cell = &m_cells[m_tail & (DEPTH - 1)];
+
+  if (cell->sequence.load(std::memory_order_acquire) != m_tail + 1)
+  {
+    // Dropped events are reported after all queued events
+    if (m_overflow.exchange(false, std::memory_order_acquire))
+    {
+      *event = Event{0, EVENT_OVERFLOW};
+      return true;
+    }
+    else
+      return false;
+  }
+
+  *event = cell->event;
+  cell->sequence.store(m_tail + DEPTH, std::memory_order_release);
+  ++m_tail;
+
+  // Writes made after this point are reported with a new event
+  if (event->type == EVENT_WRITE && event->node != 0)
+  {
+    FsIdentifier expected = event->node;
+    m_written.compare_exchange_strong(expected, 0, std::memory_order_acq_rel);
+  }
+
+  return true;
+}
+
+bool VfsWatcher::enqueue(const Event &event)
+{
+  size_t position = m_head.load(std::memory_order_relaxed);
+
+  while (true)
+  {
+    Cell * const cell = &m_cells[position & (DEPTH - 1)];
+    const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+    const auto difference = static_cast<ptrdiff_t>(sequence - position);
+
+    if (difference == 0)
+    {
+      // Cell is free, reserve it for this producer
+      if (m_head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+      {
+        cell->event = event;
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+      }
+    }
+    else if (difference < 0)
+    {
+      // Cell still holds an event of the previous lap
+      return false;
+    }
+    else
+      position = m_head.load(std::memory_order_relaxed);
+  }
+}
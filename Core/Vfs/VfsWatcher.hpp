@@ -0,0 +1,99 @@
+/*
+ * Core/Vfs/VfsWatcher.hpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#ifndef VFS_SHELL_CORE_VFS_VFSWATCHER_HPP_
+#define VFS_SHELL_CORE_VFS_VFSWATCHER_HPP_
+
+#include <xcore/fs/fs.h>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#ifndef CONFIG_VFS_WATCHER_DEPTH
+#  define CONFIG_VFS_WATCHER_DEPTH 16
+#endif
+
+class VfsNode;
+
+// Subscription to changes of a node and its direct descendants. Events are pushed by writers into
+// a bounded lock-free queue and popped by a single consumer, producers never block.
+class VfsWatcher
+{
+public:
+  enum Type: uint8_t
+  {
+    // Descendant node was created
+    EVENT_CREATE,
+    // Node or its descendant was removed
+    EVENT_REMOVE,
+    // Data of the node or its descendant was changed
+    EVENT_WRITE,
+    // Access or time of the node or its descendant was changed
+    EVENT_ATTRIBUTE,
+    // Queue was full, some events were dropped
+    EVENT_OVERFLOW
+  };
+
+  struct Event
+  {
+    // Identifier of the changed node, zero when the node is not reachable
+    FsIdentifier node;
+    Type type;
+  };
+
+  // Callback is invoked by writers after an event is queued, it should not block
+  using Callback = void (*)(void *);
+
+  static constexpr size_t DEPTH{CONFIG_VFS_WATCHER_DEPTH};
+
+  VfsWatcher(const VfsNode *, Callback, void *);
+  VfsWatcher(const VfsWatcher &) = delete;
+  VfsWatcher &operator=(const VfsWatcher &) = delete;
+
+  // Called by writers, events are dropped when the queue is full
+  void push(Type, FsIdentifier);
+  // Called by the consumer, returns false when the queue is empty
+  bool pop(Event *);
+
+  // Node is released, events of another node with the same address should be ignored
+  void detach()
+  {
+    m_node.store(nullptr, std::memory_order_relaxed);
+  }
+
+  const VfsNode *node() const
+  {
+    return m_node.load(std::memory_order_relaxed);
+  }
+
+private:
+  struct Cell
+  {
+    std::atomic<size_t> sequence;
+    Event event;
+  };
+
+  static_assert((DEPTH & (DEPTH - 1)) == 0, "Queue depth should be a power of two");
+
+  std::atomic<const VfsNode *> m_node;
+  const Callback m_callback;
+  void * const m_argument;
+
+  std::array<Cell, DEPTH> m_cells;
+  // Position of the next pushed event, shared by producers
+  std::atomic<size_t> m_head;
+  // Position of the next popped event, used by the consumer only
+  size_t m_tail;
+
+  // Identifier of a node with a queued write event, repeated writes of that node are coalesced
+  std::atomic<FsIdentifier> m_written;
+  std::atomic<bool> m_overflow;
+
+  bool enqueue(const Event &);
+};
+
+#endif // VFS_SHELL_CORE_VFS_VFSWATCHER_HPP_
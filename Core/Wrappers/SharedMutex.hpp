@@ -0,0 +1,86 @@
+/*
+ * Wrappers/SharedMutex.hpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#ifndef VFS_SHELL_WRAPPERS_SHAREDMUTEX_HPP_
+#define VFS_SHELL_WRAPPERS_SHAREDMUTEX_HPP_
+
+#include "Wrappers/Mutex.hpp"
+#include "Wrappers/Semaphore.hpp"
+#include <atomic>
+#include <cstdint>
+
+namespace Os
+{
+
+// Reader-writer lock, readers do not block each other and do not touch OS objects without writers
+class SharedMutex
+{
+public:
+  SharedMutex() :
+    m_drained{0},
+    m_state{0}
+  {
+  }
+
+  SharedMutex(const SharedMutex &) = delete;
+  SharedMutex &operator=(const SharedMutex &) = delete;
+
+  void lock()
+  {
+    // Gate stops other writers and new readers
+    m_gate.lock();
+
+    // Wait for the last active reader
+    if (m_state.fetch_add(WRITER_BIAS, std::memory_order_acquire) != 0)
+      m_drained.wait();
+  }
+
+  void unlock()
+  {
+    m_state.fetch_sub(WRITER_BIAS, std::memory_order_release);
+    m_gate.unlock();
+  }
+
+  void lockShared()
+  {
+    int32_t state = m_state.load(std::memory_order_relaxed);
+
+    while (true)
+    {
+      if (state >= 0)
+      {
+        if (m_state.compare_exchange_weak(state, state + 1, std::memory_order_acquire, std::memory_order_relaxed))
+          break;
+      }
+      else
+      {
+        // Writer is active or pending, sleep until the gate is opened
+        m_gate.lock();
+        m_gate.unlock();
+        state = m_state.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  void unlockShared()
+  {
+    // Last reader wakes up the pending writer
+    if (m_state.fetch_sub(1, std::memory_order_release) == WRITER_BIAS + 1)
+      m_drained.post();
+  }
+
+private:
+  static constexpr int32_t WRITER_BIAS{-(1 << 30)};
+
+  Mutex m_gate;
+  Semaphore m_drained;
+  // Number of active readers, negative when a writer holds the gate
+  std::atomic<int32_t> m_state;
+};
+
+} // namespace Os
+
+#endif // VFS_SHELL_WRAPPERS_SHAREDMUTEX_HPP_
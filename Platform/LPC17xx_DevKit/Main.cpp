@@ -15,6 +15,7 @@
 
 #include "Shell/Initializer.hpp"
 #include "Shell/Interfaces/InterfaceNode.hpp"
+#include "Shell/Scripts/AllocateNodeScript.hpp"
 #include "Shell/Scripts/ChangeDirectoryScript.hpp"
 #include "Shell/Scripts/ChecksumCrc32Script.hpp"
 #include "Shell/Scripts/CopyNodeScript.hpp"
@@ -25,16 +26,23 @@
 #include "Shell/Scripts/ExitScript.hpp"
 #include "Shell/Scripts/GetEnvScript.hpp"
 #include "Shell/Scripts/HelpScript.hpp"
+#include "Shell/Scripts/LinkNodeScript.hpp"
 #include "Shell/Scripts/ListEnvScript.hpp"
 #include "Shell/Scripts/ListNodesScript.hpp"
+#include "Shell/Scripts/LoadImageScript.hpp"
 #include "Shell/Scripts/MakeDirectoryScript.hpp"
 #include "Shell/Scripts/MountScript.hpp"
 #include "Shell/Scripts/PrintHexDataScript.hpp"
 #include "Shell/Scripts/PrintRawDataScript.hpp"
+#include "Shell/Scripts/QuotaScript.hpp"
 #include "Shell/Scripts/RemoveNodesScript.hpp"
+#include "Shell/Scripts/SaveImageScript.hpp"
 #include "Shell/Scripts/SetEnvScript.hpp"
 #include "Shell/Scripts/Shell.hpp"
+#include "Shell/Scripts/SyncScript.hpp"
+#include "Shell/Scripts/TailScript.hpp"
 #include "Shell/Scripts/TimeScript.hpp"
+#include "Shell/Scripts/TruncateNodeScript.hpp"
 #include "Shell/SerialTerminal.hpp"
 #include "Vfs/VfsHandle.hpp"
 
@@ -127,6 +135,7 @@ public:
       m_terminal << "System restarted" << Terminal::EOL;
     }
 
+    m_initializer.attach<AllocateNodeScript>();
     m_initializer.attach<ChangeDirectoryScript>();
     m_initializer.attach<ChecksumCrc32Script<BUFFER_SIZE>>();
     m_initializer.attach<CopyNodeScript<BUFFER_SIZE>>();
@@ -138,20 +147,27 @@ public:
     m_initializer.attach<ExitScript>();
     m_initializer.attach<GetEnvScript>();
     m_initializer.attach<HelpScript>();
+    m_initializer.attach<LinkNodeScript>();
     m_initializer.attach<ListEnvScript>();
     m_initializer.attach<ListNodesScript>();
+    m_initializer.attach<LoadImageScript>();
     m_initializer.attach<MakeDacScript>();
     m_initializer.attach<MakeDirectoryScript>();
     m_initializer.attach<MakePinScript>();
     m_initializer.attach<MountScript<CardBuilder>>();
     m_initializer.attach<PrintHexDataScript<BUFFER_SIZE>>();
     m_initializer.attach<PrintRawDataScript<BUFFER_SIZE>>();
+    m_initializer.attach<QuotaScript>();
     m_initializer.attach<RemoveNodesScript>();
+    m_initializer.attach<SaveImageScript<BUFFER_SIZE>>();
     m_initializer.attach<RtcUtilScript<RealTimeClock>>(&RealTimeClock::instance());
     m_initializer.attach<SetEnvScript>();
     m_initializer.attach<Shell>();
     m_initializer.attach<ShutdownScript>();
+    m_initializer.attach<SyncScript>();
+    m_initializer.attach<TailScript<BUFFER_SIZE>>();
     m_initializer.attach<TimeScript>();
+    m_initializer.attach<TruncateNodeScript>();
 
     return m_initializer.run() == E_OK ? EXIT_SUCCESS : EXIT_FAILURE;
   }
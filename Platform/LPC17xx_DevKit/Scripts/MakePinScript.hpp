@@ -98,7 +98,7 @@ private:
     fsJoinPaths(absolutePath, env()["PWD"], path);
 
     // Check node existence
-    FsNode * const existingNode = fsOpenNode(fs(), absolutePath);
+    FsNode * const existingNode = ShellHelpers::openNode(fs(), absolutePath);
     if (existingNode != nullptr)
     {
       fsNodeFree(existingNode);
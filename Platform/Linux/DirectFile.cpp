@@ -0,0 +1,263 @@
+/*
+ * DirectFile.cpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "DirectFile.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const InterfaceClass directFileTable = {
+    sizeof(struct DirectFile), // size
+    DirectFile::init,          // init
+    DirectFile::deinit,        // deinit
+
+    nullptr,                   // setCallback
+    DirectFile::getParam,      // getParam
+    DirectFile::setParam,      // setParam
+    DirectFile::read,          // read
+    DirectFile::write          // write
+};
+
+const InterfaceClass * const DirectFile = &directFileTable;
+
+DirectFile::DirectFile(size_t depth) :
+  m_file{-1},
+  m_buffer{nullptr},
+  m_requests{nullptr},
+  m_position{0},
+  m_size{0},
+  m_depth{depth},
+  m_buffered{false}
+{
+  // m_base should be left untouched
+}
+
+DirectFile::~DirectFile()
+{
+  if (m_file != -1)
+  {
+    // Metadata of the image is written back when the partition is released
+    fdatasync(m_file);
+    close(m_file);
+  }
+
+  free(m_requests);
+  free(m_buffer);
+}
+
+Result DirectFile::open(const char *path)
+{
+  m_file = ::open(path, O_RDWR | O_DIRECT);
+
+  if (m_file == -1 && errno == EINVAL)
+  {
+    // Some file systems, such as tmpfs, do not support direct I/O
+    m_file = ::open(path, O_RDWR);
+    m_buffered = true;
+  }
+
+  if (m_file == -1)
+    return E_ENTRY;
+
+  struct stat info;
+
+  if (fstat(m_file, &info) != 0)
+    return E_INTERFACE;
+
+  m_size = static_cast<uint64_t>(info.st_size);
+
+  if (!m_buffered && m_size % ALIGNMENT)
+  {
+    // Unaligned tail of the image can not be transferred directly
+    const int flags = fcntl(m_file, F_GETFL);
+
+    if (flags == -1 || fcntl(m_file, F_SETFL, flags & ~O_DIRECT) == -1)
+      return E_INTERFACE;
+
+    m_buffered = true;
+  }
+
+  m_buffer = static_cast<uint8_t *>(aligned_alloc(ALIGNMENT, m_depth * SEGMENT_SIZE));
+  m_requests = static_cast<struct aiocb *>(calloc(m_depth, sizeof(struct aiocb)));
+
+  return m_buffer != nullptr && m_requests != nullptr ? E_OK : E_MEMORY;
+}
+
+bool DirectFile::fill(uint64_t base, size_t offset)
+{
+  // Read a single block of the bounce buffer, the last block of the image may be shorter
+  const uint64_t position = base + offset;
+  const auto length = static_cast<size_t>(std::min<uint64_t>(ALIGNMENT, m_size - position));
+
+  return pread(m_file, m_buffer + offset, length, static_cast<off_t>(position)) == static_cast<ssize_t>(length);
+}
+
+bool DirectFile::submit(uint64_t position, size_t length, bool write)
+{
+  size_t count = 0;
+  bool completed = true;
+
+  // Segments are queued at once and processed concurrently
+  for (size_t offset = 0; offset < length; offset += SEGMENT_SIZE, ++count)
+  {
+    struct aiocb * const request = &m_requests[count];
+
+    memset(request, 0, sizeof(*request));
+    request->aio_fildes = m_file;
+    request->aio_buf = m_buffer + offset;
+    request->aio_nbytes = std::min(SEGMENT_SIZE, length - offset);
+    request->aio_offset = static_cast<off_t>(position + offset);
+    request->aio_sigevent.sigev_notify = SIGEV_NONE;
+
+    if ((write ? aio_write(request) : aio_read(request)) != 0)
+    {
+      // Segment is transferred synchronously when the request could not be queued
+      const ssize_t result = write ?
+          pwrite(m_file, m_buffer + offset, request->aio_nbytes, request->aio_offset) :
+          pread(m_file, m_buffer + offset, request->aio_nbytes, request->aio_offset);
+
+      if (result != static_cast<ssize_t>(request->aio_nbytes))
+        completed = false;
+
+      request->aio_fildes = -1;
+    }
+  }
+
+  // Every queued segment is collected before the bounce buffer is reused
+  for (size_t index = 0; index < count; ++index)
+  {
+    struct aiocb * const request = &m_requests[index];
+
+    if (request->aio_fildes == -1)
+      continue;
+
+    const struct aiocb * const list[] = {request};
+
+    while (aio_error(request) == EINPROGRESS)
+      aio_suspend(list, 1, nullptr);
+
+    if (aio_return(request) != static_cast<ssize_t>(request->aio_nbytes))
+      completed = false;
+  }
+
+  return completed;
+}
+
+size_t DirectFile::transfer(void *buffer, size_t length, bool write)
+{
+  if (m_position >= m_size)
+    return 0;
+
+  auto * const data = static_cast<uint8_t *>(buffer);
+  const size_t capacity = m_depth * SEGMENT_SIZE;
+  size_t done = 0;
+
+  length = static_cast<size_t>(std::min<uint64_t>(length, m_size - m_position));
+
+  while (done < length)
+  {
+    // Bounce buffer covers whole blocks around the requested range
+    const uint64_t start = m_position + done;
+    const uint64_t base = start - start % ALIGNMENT;
+    const auto offset = static_cast<size_t>(start - base);
+    const size_t chunk = std::min(length - done, capacity - offset);
+    const uint64_t last = start + chunk;
+    const uint64_t end = std::min(last + (ALIGNMENT - last % ALIGNMENT) % ALIGNMENT, m_size);
+    const auto span = static_cast<size_t>(end - base);
+
+    if (write)
+    {
+      // Partial blocks at the edges are completed with file data
+      const auto tail = static_cast<size_t>(last - last % ALIGNMENT - base);
+
+      if (offset && !fill(base, 0))
+        break;
+      if (last < end && !(offset && !tail) && !fill(base, tail))
+        break;
+
+      memcpy(m_buffer + offset, data + done, chunk);
+
+      if (!submit(base, span, true))
+        break;
+    }
+    else
+    {
+      if (!submit(base, span, false))
+        break;
+
+      memcpy(data + done, m_buffer + offset, chunk);
+    }
+
+    done += chunk;
+  }
+
+  m_position += done;
+  return done;
+}
+
+Result DirectFile::getParamImpl(int parameter, void *data)
+{
+  switch (static_cast<IfParameter>(parameter))
+  {
+    case IF_POSITION:
+      if (m_position > std::numeric_limits<uint32_t>::max())
+        return E_VALUE;
+
+      *static_cast<uint32_t *>(data) = static_cast<uint32_t>(m_position);
+      return E_OK;
+
+    case IF_POSITION_64:
+      *static_cast<uint64_t *>(data) = m_position;
+      return E_OK;
+
+    case IF_SIZE:
+      if (m_size > std::numeric_limits<uint32_t>::max())
+        return E_VALUE;
+
+      *static_cast<uint32_t *>(data) = static_cast<uint32_t>(m_size);
+      return E_OK;
+
+    case IF_SIZE_64:
+      *static_cast<uint64_t *>(data) = m_size;
+      return E_OK;
+
+    case IF_STATUS:
+      return E_OK;
+
+    default:
+      return E_INVALID;
+  }
+}
+
+Result DirectFile::setParamImpl(int parameter, const void *data)
+{
+  uint64_t position;
+
+  switch (static_cast<IfParameter>(parameter))
+  {
+    case IF_POSITION:
+      position = *static_cast<const uint32_t *>(data);
+      break;
+
+    case IF_POSITION_64:
+      position = *static_cast<const uint64_t *>(data);
+      break;
+
+    default:
+      return E_INVALID;
+  }
+
+  if (position >= m_size)
+    return E_ADDRESS;
+
+  m_position = position;
+  return E_OK;
+}
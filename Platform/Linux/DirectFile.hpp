@@ -0,0 +1,106 @@
+/*
+ * Platform/Linux/DirectFile.hpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#ifndef VFS_SHELL_PLATFORM_LINUX_DIRECTFILE_HPP_
+#define VFS_SHELL_PLATFORM_LINUX_DIRECTFILE_HPP_
+
+#include <xcore/interface.h>
+#include <aio.h>
+#include <cstdint>
+#include <new>
+
+extern const InterfaceClass * const DirectFile;
+
+// Partition image accessed with direct I/O, data is transferred through an aligned bounce buffer
+// in segments that are processed concurrently
+class DirectFile
+{
+public:
+  struct Config
+  {
+    /** Mandatory: path to the image file. */
+    const char *path;
+    /** Optional: number of segments in flight, default depth is used when zero. */
+    size_t depth;
+  };
+
+  // Offsets and lengths of direct transfers are multiples of the alignment
+  static constexpr size_t ALIGNMENT{4096};
+  static constexpr size_t SEGMENT_SIZE{65536};
+  static constexpr size_t DEFAULT_DEPTH{4};
+  static constexpr size_t MAX_DEPTH{64};
+
+  DirectFile(const DirectFile &) = delete;
+  DirectFile &operator=(const DirectFile &) = delete;
+
+  static Result init(void *object, const void *configBase)
+  {
+    const Config * const config = static_cast<const Config *>(configBase);
+
+    if (config->path == nullptr || config->depth > MAX_DEPTH)
+      return E_VALUE;
+
+    auto * const file = new (object) DirectFile{config->depth ? config->depth : DEFAULT_DEPTH};
+    const Result res = file->open(config->path);
+
+    if (res != E_OK)
+      file->~DirectFile();
+
+    return res;
+  }
+
+  static void deinit(void *object)
+  {
+    static_cast<DirectFile *>(object)->~DirectFile();
+  }
+
+  static Result getParam(void *object, int parameter, void *data)
+  {
+    return static_cast<DirectFile *>(object)->getParamImpl(parameter, data);
+  }
+
+  static Result setParam(void *object, int parameter, const void *data)
+  {
+    return static_cast<DirectFile *>(object)->setParamImpl(parameter, data);
+  }
+
+  static size_t read(void *object, void *buffer, size_t length)
+  {
+    return static_cast<DirectFile *>(object)->transfer(buffer, length, false);
+  }
+
+  static size_t write(void *object, const void *buffer, size_t length)
+  {
+    return static_cast<DirectFile *>(object)->transfer(const_cast<void *>(buffer), length, true);
+  }
+
+private:
+  Interface m_base;
+
+  int m_file;
+  // Bounce buffer of depth segments and control blocks of segments in flight
+  uint8_t *m_buffer;
+  struct aiocb *m_requests;
+  uint64_t m_position;
+  uint64_t m_size;
+  size_t m_depth;
+  // File system of the image rejected direct I/O, buffered I/O is used instead
+  bool m_buffered;
+
+  DirectFile(size_t);
+  ~DirectFile();
+
+  Result open(const char *);
+
+  bool fill(uint64_t, size_t);
+  bool submit(uint64_t, size_t, bool);
+  size_t transfer(void *, size_t, bool);
+
+  Result getParamImpl(int, void *);
+  Result setParamImpl(int, const void *);
+};
+
+#endif // VFS_SHELL_PLATFORM_LINUX_DIRECTFILE_HPP_
@@ -0,0 +1,50 @@
+/*
+ * ImageBuilder.cpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "ImageBuilder.hpp"
+#include "Vfs/VfsImage.hpp"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <new>
+
+VfsImage *ImageBuilder::build(const char *path)
+{
+  const int file = open(path, O_RDONLY);
+
+  if (file == -1)
+    return nullptr;
+
+  struct stat info;
+  void *memory = MAP_FAILED;
+  size_t length = 0;
+
+  if (fstat(file, &info) == 0 && info.st_size > 0)
+  {
+    length = static_cast<size_t>(info.st_size);
+
+    // Private writable mapping: pages with block headers are copied, data pages stay in the page cache
+    memory = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+  }
+
+  close(file);
+
+  if (memory == MAP_FAILED)
+    return nullptr;
+
+  VfsImage * const image = new (std::nothrow) VfsImage{memory, length, unmap};
+
+  if (image == nullptr)
+    munmap(memory, length);
+
+  return image;
+}
+
+void ImageBuilder::unmap(void *memory, size_t length)
+{
+  munmap(memory, length);
+}
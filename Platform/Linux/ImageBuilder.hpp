@@ -0,0 +1,28 @@
+/*
+ * Platform/Linux/ImageBuilder.hpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#ifndef VFS_SHELL_PLATFORM_LINUX_IMAGEBUILDER_HPP_
+#define VFS_SHELL_PLATFORM_LINUX_IMAGEBUILDER_HPP_
+
+#include <cstddef>
+
+class VfsImage;
+
+class ImageBuilder
+{
+public:
+  ImageBuilder() = delete;
+  ImageBuilder(const ImageBuilder &) = delete;
+  ImageBuilder &operator=(const ImageBuilder &) = delete;
+
+  // Map a host file, restored data nodes reference the mapping directly
+  static VfsImage *build(const char *);
+
+private:
+  static void unmap(void *, size_t);
+};
+
+#endif // VFS_SHELL_PLATFORM_LINUX_IMAGEBUILDER_HPP_
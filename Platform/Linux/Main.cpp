@@ -4,11 +4,14 @@
  * Project is distributed under the terms of the GNU General Public License v3.0
  */
 
+#include "DirectFile.hpp"
+#include "ImageBuilder.hpp"
 #include "MmfBuilder.hpp"
 #include "UnixTimeProvider.hpp"
 
 #include "Shell/Initializer.hpp"
 #include "Shell/Interfaces/InterfaceNode.hpp"
+#include "Shell/Scripts/AllocateNodeScript.hpp"
 #include "Shell/Scripts/ChangeDirectoryScript.hpp"
 #include "Shell/Scripts/ChangeModeScript.hpp"
 #include "Shell/Scripts/ChecksumCrc32Script.hpp"
@@ -19,42 +22,57 @@
 #include "Shell/Scripts/ExitScript.hpp"
 #include "Shell/Scripts/GetEnvScript.hpp"
 #include "Shell/Scripts/HelpScript.hpp"
+#include "Shell/Scripts/LinkNodeScript.hpp"
 #include "Shell/Scripts/ListEnvScript.hpp"
 #include "Shell/Scripts/ListNodesScript.hpp"
+#include "Shell/Scripts/LoadImageScript.hpp"
 #include "Shell/Scripts/MakeDirectoryScript.hpp"
 #include "Shell/Scripts/MountScript.hpp"
 #include "Shell/Scripts/PrintHexDataScript.hpp"
 #include "Shell/Scripts/PrintRawDataScript.hpp"
+#include "Shell/Scripts/QuotaScript.hpp"
 #include "Shell/Scripts/RemoveNodesScript.hpp"
+#include "Shell/Scripts/SaveImageScript.hpp"
 #include "Shell/Scripts/SetEnvScript.hpp"
 #include "Shell/Scripts/Shell.hpp"
+#include "Shell/Scripts/SyncScript.hpp"
+#include "Shell/Scripts/TailScript.hpp"
 #include "Shell/Scripts/TimeScript.hpp"
+#include "Shell/Scripts/TruncateNodeScript.hpp"
 #include "Shell/SerialTerminal.hpp"
 #include "Vfs/VfsHandle.hpp"
+#include "Vfs/VfsImage.hpp"
 
 #include <halm/platform/generic/console.h>
 #include <xcore/os/thread.h>
 
+#include <cctype>
 #include <iostream>
 #include <uv.h>
+#include <vector>
 
 class Application
 {
 public:
-  Application(Interface *serial, bool echoing = true, char **partitions = nullptr, size_t count = 0) :
+  Application(Interface *serial, bool echoing = true, char **partitions = nullptr, size_t count = 0,
+      const char *image = nullptr, bool direct = false, size_t depth = 0) :
     m_serial{serial, [](Interface *pointer){ deinit(pointer); raise(SIGUSR1); }},
     m_filesystem{static_cast<FsHandle *>(init(VfsHandleClass, nullptr)), [](FsHandle *pointer){ deinit(pointer); }},
     m_terminal{m_serial.get()},
     m_initializer{m_filesystem.get(), m_terminal, UnixTimeProvider::instance(), echoing},
     m_count{count},
-    m_partitions{partitions}
+    m_partitions{partitions},
+    m_image{image},
+    m_depth{depth},
+    m_direct{direct}
   {
     if (m_serial == nullptr || m_filesystem == nullptr)
       abort(); // TODO Rewrite
   }
 
-  Application(char **partitions = nullptr, size_t count = 0) :
-    Application{static_cast<Interface *>(init(Console, nullptr)), true, partitions, count}
+  Application(char **partitions = nullptr, size_t count = 0, const char *image = nullptr,
+      bool direct = false, size_t depth = 0) :
+    Application{static_cast<Interface *>(init(Console, nullptr)), true, partitions, count, image, direct, depth}
   {
   }
 
@@ -62,6 +80,7 @@ public:
   {
     bootstrap(m_partitions, m_count);
 
+    m_initializer.attach<AllocateNodeScript>();
     m_initializer.attach<ChangeDirectoryScript>();
     m_initializer.attach<ChangeModeScript>();
     m_initializer.attach<ChecksumCrc32Script<BUFFER_SIZE>>();
@@ -72,16 +91,23 @@ public:
     m_initializer.attach<ExitScript>();
     m_initializer.attach<GetEnvScript>();
     m_initializer.attach<HelpScript>();
+    m_initializer.attach<LinkNodeScript>();
     m_initializer.attach<ListEnvScript>();
     m_initializer.attach<ListNodesScript>();
+    m_initializer.attach<LoadImageScript>();
     m_initializer.attach<MakeDirectoryScript>();
     m_initializer.attach<MountScript<>>();
     m_initializer.attach<PrintHexDataScript<BUFFER_SIZE>>();
     m_initializer.attach<PrintRawDataScript<BUFFER_SIZE>>();
+    m_initializer.attach<QuotaScript>();
     m_initializer.attach<RemoveNodesScript>();
+    m_initializer.attach<SaveImageScript<BUFFER_SIZE>>();
     m_initializer.attach<SetEnvScript>();
     m_initializer.attach<Shell>();
+    m_initializer.attach<SyncScript>();
+    m_initializer.attach<TailScript<BUFFER_SIZE>>();
     m_initializer.attach<TimeScript>();
+    m_initializer.attach<TruncateNodeScript>();
 
     return m_initializer.run() == E_OK ? EXIT_SUCCESS : EXIT_FAILURE;
   }
@@ -96,6 +122,10 @@ private:
 
   size_t m_count;
   char **m_partitions;
+  const char *m_image;
+  // Partitions are accessed with direct I/O instead of memory mapping
+  size_t m_depth;
+  bool m_direct;
 
   void bootstrap(char **partitions = nullptr, size_t count = 0)
   {
@@ -108,17 +138,54 @@ private:
     node = new VfsDirectory{UnixTimeProvider::instance().getTime()};
     ShellHelpers::injectNode(m_filesystem.get(), node, "/dev");
 
-    for (size_t i = 0; i < std::max(count, static_cast<size_t>('z' - 'a')); ++i)
+    for (size_t i = 0; i < std::min(count, static_cast<size_t>('z' - 'a' + 1)); ++i)
     {
       const std::string path = std::string{"/dev/sd"} + static_cast<char>('a' + i);
-      Interface * const mmf = MmfBuilder::build(partitions[i]);
+      Interface * const partition = build(partitions[i]);
 
-      if (mmf != nullptr)
+      if (partition != nullptr)
       {
-        node = new InterfaceNode<>{mmf};
+        auto * const device = new InterfaceNode<>{partition};
+
+        // Small writes of file systems are merged into sector bursts
+        device->setWriteBehind(true);
+        node = device;
         ShellHelpers::injectNode(m_filesystem.get(), node, path.data());
       }
     }
+
+    if (m_image != nullptr)
+      restore(m_image);
+  }
+
+  Interface *build(const char *path)
+  {
+    if (!m_direct)
+      return MmfBuilder::build(path);
+
+    const DirectFile::Config config{path, m_depth};
+    return static_cast<Interface *>(init(DirectFile, &config));
+  }
+
+  void restore(const char *path)
+  {
+    // Nodes of the image are merged into the root directory, data stays in the mapped file
+    VfsImage * const image = ImageBuilder::build(path);
+
+    if (image == nullptr)
+    {
+      std::cerr << "Image " << path << " could not be mapped" << std::endl;
+      return;
+    }
+
+    FsNode * const root = ShellHelpers::openNode(m_filesystem.get(), "/");
+
+    if (root == nullptr || image->restore(root) != E_OK)
+      std::cerr << "Image " << path << " could not be restored" << std::endl;
+
+    if (root != nullptr)
+      fsNodeFree(root);
+    image->release();
   }
 };
 
@@ -136,6 +203,10 @@ static void userSignalCallback(uv_signal_t *, int)
 
 int main(int argc, char *argv[])
 {
+  std::vector<char *> partitions;
+  const char *image = nullptr;
+  size_t depth = 0;
+  bool direct = false;
   bool help = false;
 
   for (int i = 1; i < argc; ++i)
@@ -145,12 +216,51 @@ int main(int argc, char *argv[])
       help = true;
       continue;
     }
+
+    if (!strcmp(argv[i], "--direct") || !strcmp(argv[i], "-d"))
+    {
+      direct = true;
+      continue;
+    }
+
+    if ((!strcmp(argv[i], "--queue") || !strcmp(argv[i], "-q")) && i + 1 < argc)
+    {
+      const char * const value = argv[++i];
+      char *end;
+      const unsigned long number = strtoul(value, &end, 10);
+
+      if (!isdigit(static_cast<unsigned char>(*value)) || *end != '\0')
+      {
+        std::cerr << "Queue depth " << value << " is incorrect" << std::endl;
+        exit(EXIT_FAILURE);
+      }
+
+      // Bounce buffer of direct I/O grows with the depth
+      depth = static_cast<size_t>(std::min<unsigned long>(number, DirectFile::MAX_DEPTH));
+      continue;
+    }
+
+    if ((!strcmp(argv[i], "--image") || !strcmp(argv[i], "-i")) && i + 1 < argc)
+    {
+      image = argv[++i];
+      continue;
+    }
+
+    partitions.push_back(argv[i]);
   }
 
+  // List of partitions is terminated like the argument list
+  const size_t count = partitions.size();
+  partitions.push_back(nullptr);
+
   if (help)
   {
     std::cout << "Usage: shell [OPTION]... FILE" << std::endl;
-    std::cout << "  -h, --help  print help message" << std::endl;
+    std::cout << "  -d, --direct      access partitions with direct I/O instead of mapping" << std::endl;
+    std::cout << "  -h, --help        print help message" << std::endl;
+    std::cout << "  -i, --image IMAGE restore nodes from the image file" << std::endl;
+    std::cout << "  -q, --queue DEPTH number of direct I/O segments in flight, up to "
+        << DirectFile::MAX_DEPTH << std::endl;
     exit(EXIT_SUCCESS);
   }
   else
@@ -161,7 +271,7 @@ int main(int argc, char *argv[])
     uv_signal_init(loop, &listener);
     uv_signal_start(&listener, userSignalCallback, SIGUSR1);
 
-    Application * const application = new Application(argv + 1, static_cast<size_t>(argc - 1));
+    Application * const application = new Application(partitions.data(), count, image, direct, depth);
     Thread appThread;
     threadInit(&appThread, 4096, 0, applicationWrapper, application);
     threadStart(&appThread);
@@ -0,0 +1,189 @@
+/*
+ * Main.cpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "DirectFile.hpp"
+#include <halm/platform/generic/mmf.h>
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <vector>
+
+class BlockDeviceBenchmark: public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE(BlockDeviceBenchmark);
+  CPPUNIT_TEST(testDirectFileUnaligned);
+  CPPUNIT_TEST(testThroughput);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp();
+  void tearDown();
+
+  void testDirectFileUnaligned();
+  void testThroughput();
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  // Image is placed in the working directory, temporary file systems may reject direct I/O
+  static constexpr const char *IMAGE_PATH{"BlockDeviceBenchmark.img"};
+  static constexpr size_t IMAGE_SIZE{16 * 1024 * 1024};
+  static constexpr size_t RANDOM_BLOCK{4096};
+  static constexpr size_t RANDOM_COUNT{1024};
+  static constexpr size_t SEQUENTIAL_BLOCK{65536};
+
+  static void fillPattern(uint8_t *, size_t, uint32_t);
+  static void measure(const char *, Interface *);
+};
+
+void BlockDeviceBenchmark::setUp()
+{
+  FILE * const image = fopen(IMAGE_PATH, "wb");
+  CPPUNIT_ASSERT(image != nullptr);
+
+  const std::vector<uint8_t> zeros(SEQUENTIAL_BLOCK, 0);
+
+  for (size_t offset = 0; offset < IMAGE_SIZE; offset += zeros.size())
+    CPPUNIT_ASSERT(fwrite(zeros.data(), 1, zeros.size(), image) == zeros.size());
+
+  fclose(image);
+}
+
+void BlockDeviceBenchmark::tearDown()
+{
+  remove(IMAGE_PATH);
+}
+
+void BlockDeviceBenchmark::fillPattern(uint8_t *buffer, size_t length, uint32_t seed)
+{
+  for (size_t i = 0; i < length; ++i)
+    buffer[i] = static_cast<uint8_t>((seed + i) * 131 >> 3);
+}
+
+void BlockDeviceBenchmark::measure(const char *name, Interface *interface)
+{
+  std::vector<uint8_t> buffer(SEQUENTIAL_BLOCK);
+  std::vector<uint8_t> pattern(SEQUENTIAL_BLOCK);
+  std::mt19937 generator{42};
+  std::uniform_int_distribution<size_t> distribution{0, IMAGE_SIZE / RANDOM_BLOCK - 1};
+  std::vector<uint32_t> offsets(RANDOM_COUNT);
+
+  for (auto &offset : offsets)
+    offset = static_cast<uint32_t>(distribution(generator) * RANDOM_BLOCK);
+
+  // Random writes of file system sized blocks
+  const auto writeStart = Clock::now();
+
+  for (const auto offset : offsets)
+  {
+    fillPattern(pattern.data(), RANDOM_BLOCK, offset);
+    CPPUNIT_ASSERT(ifSetParam(interface, IF_POSITION, &offset) == E_OK);
+    CPPUNIT_ASSERT(ifWrite(interface, pattern.data(), RANDOM_BLOCK) == RANDOM_BLOCK);
+  }
+
+  const std::chrono::duration<double> writeTime = Clock::now() - writeStart;
+
+  // Sequential reads of the whole image
+  const uint32_t origin = 0;
+  const auto readStart = Clock::now();
+
+  CPPUNIT_ASSERT(ifSetParam(interface, IF_POSITION, &origin) == E_OK);
+
+  for (size_t offset = 0; offset < IMAGE_SIZE; offset += SEQUENTIAL_BLOCK)
+    CPPUNIT_ASSERT(ifRead(interface, buffer.data(), SEQUENTIAL_BLOCK) == SEQUENTIAL_BLOCK);
+
+  const std::chrono::duration<double> readTime = Clock::now() - readStart;
+
+  // Data written at random positions is verified after timing
+  for (const auto offset : offsets)
+  {
+    fillPattern(pattern.data(), RANDOM_BLOCK, offset);
+    CPPUNIT_ASSERT(ifSetParam(interface, IF_POSITION, &offset) == E_OK);
+    CPPUNIT_ASSERT(ifRead(interface, buffer.data(), RANDOM_BLOCK) == RANDOM_BLOCK);
+
+    // Later writes to the same block overwrite the pattern with the same values
+    CPPUNIT_ASSERT(std::equal(pattern.begin(), pattern.begin() + RANDOM_BLOCK, buffer.begin()));
+  }
+
+  const double megabytes = static_cast<double>(IMAGE_SIZE) / (1024 * 1024);
+  const double writeRate = static_cast<double>(RANDOM_COUNT) / writeTime.count();
+
+  std::cout << name << ": random writes " << writeRate << " IOPS, sequential reads "
+      << megabytes / readTime.count() << " MiB/s" << std::endl;
+}
+
+void BlockDeviceBenchmark::testDirectFileUnaligned()
+{
+  const DirectFile::Config config{IMAGE_PATH, 2};
+  Interface * const interface = static_cast<Interface *>(init(DirectFile, &config));
+  CPPUNIT_ASSERT(interface != nullptr);
+
+  // Transfer spans several segments and starts and ends inside blocks
+  const uint32_t position = 1000;
+  const size_t length = DirectFile::SEGMENT_SIZE * 3 + 5000;
+  std::vector<uint8_t> pattern(length);
+  std::vector<uint8_t> buffer(length + 2000);
+
+  fillPattern(pattern.data(), length, 7);
+  CPPUNIT_ASSERT(ifSetParam(interface, IF_POSITION, &position) == E_OK);
+  CPPUNIT_ASSERT(ifWrite(interface, pattern.data(), length) == length);
+
+  uint32_t current;
+  CPPUNIT_ASSERT(ifGetParam(interface, IF_POSITION, &current) == E_OK);
+  CPPUNIT_ASSERT(current == position + length);
+
+  // Surrounding data of partial blocks is preserved
+  const uint32_t before = position - 1000;
+  CPPUNIT_ASSERT(ifSetParam(interface, IF_POSITION, &before) == E_OK);
+  CPPUNIT_ASSERT(ifRead(interface, buffer.data(), buffer.size()) == buffer.size());
+
+  CPPUNIT_ASSERT(std::all_of(buffer.begin(), buffer.begin() + 1000, [](uint8_t value){ return value == 0; }));
+  CPPUNIT_ASSERT(std::equal(pattern.begin(), pattern.end(), buffer.begin() + 1000));
+  CPPUNIT_ASSERT(std::all_of(buffer.begin() + 1000 + length, buffer.end(), [](uint8_t value){ return value == 0; }));
+
+  // Transfers are truncated at the end of the image
+  const uint32_t tail = IMAGE_SIZE - 100;
+  CPPUNIT_ASSERT(ifSetParam(interface, IF_POSITION, &tail) == E_OK);
+  CPPUNIT_ASSERT(ifRead(interface, buffer.data(), buffer.size()) == 100);
+
+  const uint32_t outside = IMAGE_SIZE;
+  CPPUNIT_ASSERT(ifSetParam(interface, IF_POSITION, &outside) == E_ADDRESS);
+
+  deinit(interface);
+}
+
+void BlockDeviceBenchmark::testThroughput()
+{
+  const DirectFile::Config config{IMAGE_PATH, 0};
+  Interface * const direct = static_cast<Interface *>(init(DirectFile, &config));
+  CPPUNIT_ASSERT(direct != nullptr);
+  measure("DirectFile", direct);
+  deinit(direct);
+
+  Interface * const mapped = static_cast<Interface *>(init(MemoryMappedFile, IMAGE_PATH));
+  CPPUNIT_ASSERT(mapped != nullptr);
+  measure("MemoryMappedFile", mapped);
+  deinit(mapped);
+}
+
+CPPUNIT_TEST_SUITE_REGISTRATION(BlockDeviceBenchmark);
+
+int main(int, char *[])
+{
+  CPPUNIT_NS::Test * const suite = CPPUNIT_NS::TestFactoryRegistry::getRegistry().makeTest();
+
+  CppUnit::TextUi::TestRunner runner;
+  runner.addTest(suite);
+
+  const bool sucessful = runner.run();
+  return sucessful ? EXIT_SUCCESS : EXIT_FAILURE;
+}
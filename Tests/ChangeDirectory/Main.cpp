@@ -55,6 +55,7 @@ class ChangeDirectoryTest: public CPPUNIT_NS::TestFixture
   CPPUNIT_TEST(testErrorNoRelativePath);
   CPPUNIT_TEST(testHelpMessage);
   CPPUNIT_TEST(testRelativePath);
+  CPPUNIT_TEST(testRelativeToIdentifier);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -68,6 +69,7 @@ public:
   void testErrorNoRelativePath();
   void testHelpMessage();
   void testRelativePath();
+  void testRelativeToIdentifier();
 
 private:
   uv_loop_t *m_loop{nullptr};
@@ -195,6 +197,26 @@ void ChangeDirectoryTest::testRelativePath()
   CPPUNIT_ASSERT(result == true);
 }
 
+void ChangeDirectoryTest::testRelativeToIdentifier()
+{
+  // Identifier of the current directory is used for relative paths
+  m_application->sendShellCommand("cd /bin");
+  m_application->waitShellResponse();
+
+  m_application->sendShellCommand("ls -l cd");
+  const auto response = m_application->waitShellResponse();
+  const auto result = TestApplication::responseContainsText(response, "node has no descendants");
+  CPPUNIT_ASSERT(result == true);
+
+  m_application->sendShellCommand("cd ../dev");
+  m_application->waitShellResponse();
+
+  m_application->sendShellCommand("getenv PWD");
+  const auto path = m_application->waitShellResponse();
+  const auto pathFound = TestApplication::responseContainsText(path, "/dev");
+  CPPUNIT_ASSERT(pathFound == true);
+}
+
 CPPUNIT_TEST_SUITE_REGISTRATION(ChangeDirectoryTest);
 
 int main(int, char *[])
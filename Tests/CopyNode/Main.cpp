@@ -50,6 +50,7 @@ class CopyNodeTest: public CPPUNIT_NS::TestFixture
   CPPUNIT_TEST(testErrorNoDestinationArgument);
   CPPUNIT_TEST(testErrorNoDestinationNode);
   CPPUNIT_TEST(testErrorNoSourceNode);
+  CPPUNIT_TEST(testErrorSameNode);
   CPPUNIT_TEST(testHelpMessage);
   CPPUNIT_TEST(testPartialCopy);
   CPPUNIT_TEST(testSimpleCopy);
@@ -62,6 +63,7 @@ public:
   void testErrorNoDestinationArgument();
   void testErrorNoDestinationNode();
   void testErrorNoSourceNode();
+  void testErrorSameNode();
   void testHelpMessage();
   void testPartialCopy();
   void testSimpleCopy();
@@ -150,6 +152,25 @@ void CopyNodeTest::testErrorNoSourceNode()
   CPPUNIT_ASSERT(returnValueFound == true);
 }
 
+void CopyNodeTest::testErrorSameNode()
+{
+  m_application->sendShellCommand("cp /test.bin /test.bin");
+  const auto response = m_application->waitShellResponse();
+  const auto result = TestApplication::responseContainsText(response, "same node");
+  CPPUNIT_ASSERT(result == true);
+
+  m_application->sendShellCommand("getenv ?");
+  const auto returnValue = m_application->waitShellResponse();
+  const auto returnValueFound = TestApplication::responseContainsText(returnValue, std::to_string(E_VALUE));
+  CPPUNIT_ASSERT(returnValueFound == true);
+
+  // Data of the source node is kept
+  m_application->sendShellCommand("ls -l");
+  const auto listing = m_application->waitShellResponse();
+  const auto dataFound = TestApplication::responseContainsText(listing, "65536");
+  CPPUNIT_ASSERT(dataFound == true);
+}
+
 void CopyNodeTest::testHelpMessage()
 {
   m_application->sendShellCommand("cp --help");
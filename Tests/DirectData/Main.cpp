@@ -7,9 +7,12 @@
 #include "LimitedTestNode.hpp"
 #include "SyncedTestNode.hpp"
 #include "TestApplication.hpp"
+#include "VirtualMem.hpp"
+#include "Shell/Interfaces/InterfaceNode.hpp"
 #include "Shell/Scripts/DirectDataScript.hpp"
 #include "Shell/Scripts/GetEnvScript.hpp"
 #include "Shell/Scripts/ListNodesScript.hpp"
+#include "Shell/Scripts/QuotaScript.hpp"
 #include <cppunit/CompilerOutputter.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include <cppunit/extensions/TestFactoryRegistry.h>
@@ -42,6 +45,7 @@ public:
     m_initializer.attach<DirectDataScript<BUFFER_SIZE>>();
     m_initializer.attach<GetEnvScript>();
     m_initializer.attach<ListNodesScript>();
+    m_initializer.attach<QuotaScript>();
   }
 };
 
@@ -52,14 +56,17 @@ class DirectDataTest: public CPPUNIT_NS::TestFixture
   CPPUNIT_TEST(testCopyReadError);
   CPPUNIT_TEST(testErrorIncorrectArguments);
   CPPUNIT_TEST(testErrorIncorrectBlockSize);
+  CPPUNIT_TEST(testErrorIncorrectConversion);
   CPPUNIT_TEST(testErrorNoDestinationArgument);
   CPPUNIT_TEST(testErrorNoDestinationNode);
   CPPUNIT_TEST(testErrorNoSourceArgument);
   CPPUNIT_TEST(testErrorNoSourceNode);
   CPPUNIT_TEST(testHelpMessage);
+  CPPUNIT_TEST(testInterfaceNodeCopy);
   CPPUNIT_TEST(testMinimalNodeCopy);
   CPPUNIT_TEST(testPartialNodeCopy);
   CPPUNIT_TEST(testPositionalNodeCopy);
+  CPPUNIT_TEST(testSparseNodeCopy);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -70,16 +77,21 @@ public:
   void testCopyReadError();
   void testErrorIncorrectArguments();
   void testErrorIncorrectBlockSize();
+  void testErrorIncorrectConversion();
   void testErrorNoDestinationArgument();
   void testErrorNoDestinationNode();
   void testErrorNoSourceArgument();
   void testErrorNoSourceNode();
   void testHelpMessage();
+  void testInterfaceNodeCopy();
   void testMinimalNodeCopy();
   void testPartialNodeCopy();
   void testPositionalNodeCopy();
+  void testSparseNodeCopy();
 
 private:
+  static constexpr size_t PARTITION_SIZE{16384};
+
   uv_loop_t *m_loop{nullptr};
   Interrupt *m_listener{nullptr};
   Interface *m_appInterface{nullptr};
@@ -89,6 +101,7 @@ private:
   std::thread *m_appThread{nullptr};
   std::thread *m_loopThread{nullptr};
 
+  Interface *m_mem{nullptr};
   LimitedTestNode *m_nodePartialTest{nullptr};
   SyncedTestNode *m_nodeInterruptTest{nullptr};
   SyncedTestNode *m_nodeReadTest{nullptr};
@@ -96,10 +109,15 @@ private:
 
   Result onInterruptTestCallback();
   Result onReadFailureTestCallback();
+  size_t readNodeUsage(const char *);
 };
 
 void DirectDataTest::setUp()
 {
+  static const VirtualMem::Config virtualMemConfig = {
+      PARTITION_SIZE // size
+  };
+
   bool ok;
 
   m_loop = uv_default_loop();
@@ -112,6 +130,9 @@ void DirectDataTest::setUp()
   m_testInterface = TestApplication::makeUdpInterface("127.0.0.1", 8001, 8000);
   CPPUNIT_ASSERT(m_testInterface != nullptr);
 
+  m_mem = static_cast<Interface *>(init(VirtualMem, &virtualMemConfig));
+  CPPUNIT_ASSERT(m_mem != nullptr);
+
   m_application = new TestDirectDataApplication(m_appInterface, m_testInterface);
 
   m_nodeInterruptTest = new SyncedTestNode{[this](){ return onInterruptTestCallback(); }};
@@ -130,6 +151,7 @@ void DirectDataTest::setUp()
   m_application->injectNode(m_nodeReadTest, "/read_test.bin");
   m_application->makeDataNode("/empty.bin", 0, '\0');
   m_application->makeDataNode("/test.bin", 65536, 'A');
+  m_application->makeDataNode("/zero.bin", 65536, '\0');
 
   m_loopThread = new std::thread{TestApplication::runEventLoop, m_loop};
   m_appThread = new std::thread{TestApplication::runShell, m_application};
@@ -146,6 +168,8 @@ void DirectDataTest::tearDown()
 
   m_loopThread->join();
   delete m_loopThread;
+
+  deinit(m_mem);
 }
 
 void DirectDataTest::testCopyInterrupt()
@@ -210,6 +234,19 @@ void DirectDataTest::testErrorIncorrectBlockSize()
   CPPUNIT_ASSERT(returnValueFound == true);
 }
 
+void DirectDataTest::testErrorIncorrectConversion()
+{
+  m_application->sendShellCommand("dd --if /test.bin --of /test_2.bin --conv incorrect");
+  const auto response = m_application->waitShellResponse();
+  const auto result = TestApplication::responseContainsText(response, "invalid conversion");
+  CPPUNIT_ASSERT(result == true);
+
+  m_application->sendShellCommand("getenv ?");
+  const auto returnValue = m_application->waitShellResponse();
+  const auto returnValueFound = TestApplication::responseContainsText(returnValue, std::to_string(E_VALUE));
+  CPPUNIT_ASSERT(returnValueFound == true);
+}
+
 void DirectDataTest::testErrorNoDestinationArgument()
 {
   m_application->sendShellCommand("dd --if /test.bin");
@@ -269,6 +306,27 @@ void DirectDataTest::testHelpMessage()
   CPPUNIT_ASSERT(result == true);
 }
 
+void DirectDataTest::testInterfaceNodeCopy()
+{
+  VfsNode * const memNode = new InterfaceNode<>{m_mem};
+  CPPUNIT_ASSERT(memNode != nullptr);
+  m_application->injectNode(memNode, "/dev/mem");
+
+  // Blocks smaller than the buffer are read with several requests in flight
+  m_application->sendShellCommand("dd --if /dev/mem --of /mem_full.bin --bs 1024");
+  m_application->waitShellResponse();
+  m_application->sendShellCommand("dd --if /dev/mem --of /mem_part.bin --bs 512 --count 3 --skip 2");
+  m_application->waitShellResponse();
+
+  m_application->sendShellCommand("ls -l");
+  const auto response = m_application->waitShellResponse();
+
+  const auto result0 = TestApplication::responseContainsText(response, std::to_string(PARTITION_SIZE));
+  CPPUNIT_ASSERT(result0 == true);
+  const auto result1 = TestApplication::responseContainsText(response, "1536");
+  CPPUNIT_ASSERT(result1 == true);
+}
+
 void DirectDataTest::testMinimalNodeCopy()
 {
   m_application->sendShellCommand("dd --if /test.bin --of /dev/test_2.bin");
@@ -323,6 +381,65 @@ void DirectDataTest::testPositionalNodeCopy()
   CPPUNIT_ASSERT(resultB1 == true);
 }
 
+void DirectDataTest::testSparseNodeCopy()
+{
+  // Zero blocks are skipped, memory is not allocated for them
+
+  const size_t usageA0 = readNodeUsage("/dev");
+  CPPUNIT_ASSERT(usageA0 != SIZE_MAX);
+
+  m_application->sendShellCommand("dd --if /zero.bin --of /dev/test_2.bin --bs 1024 --conv sparse");
+  m_application->waitShellResponse();
+
+  m_application->sendShellCommand("ls -l /dev");
+  const auto responseA = m_application->waitShellResponse();
+
+  const auto resultA0 = TestApplication::responseContainsText(responseA, "test_2.bin");
+  CPPUNIT_ASSERT(resultA0 == true);
+  const auto resultA1 = TestApplication::responseContainsText(responseA, "65536");
+  CPPUNIT_ASSERT(resultA1 == true);
+
+  const size_t usageA1 = readNodeUsage("/dev");
+  CPPUNIT_ASSERT(usageA1 != SIZE_MAX);
+  CPPUNIT_ASSERT(usageA1 - usageA0 < 1024);
+
+  // Blocks before the seek position are not allocated
+
+  m_application->sendShellCommand("dd --if /test.bin --of /dev/test_3.bin --bs 1024 --count 1 --seek 1000");
+  m_application->waitShellResponse();
+
+  m_application->sendShellCommand("ls -l /dev");
+  const auto responseB = m_application->waitShellResponse();
+
+  const auto resultB0 = TestApplication::responseContainsText(responseB, "test_3.bin");
+  CPPUNIT_ASSERT(resultB0 == true);
+  const auto resultB1 = TestApplication::responseContainsText(responseB, "1025024");
+  CPPUNIT_ASSERT(resultB1 == true);
+
+  const size_t usageB = readNodeUsage("/dev");
+  CPPUNIT_ASSERT(usageB != SIZE_MAX);
+  CPPUNIT_ASSERT(usageB - usageA1 >= 1024 && usageB - usageA1 < 4096);
+}
+
+size_t DirectDataTest::readNodeUsage(const char *path)
+{
+  m_application->sendShellCommand((std::string{"quota "} + path).c_str());
+  const auto response = m_application->waitShellResponse();
+
+  // Usage is printed as "PATH: N bytes, M nodes"
+  const std::string prefix = std::string{path} + ": ";
+
+  for (const auto &line : response)
+  {
+    const size_t position = line.find(prefix);
+
+    if (position != std::string::npos)
+      return static_cast<size_t>(strtoul(line.c_str() + position + prefix.size(), nullptr, 10));
+  }
+
+  return SIZE_MAX;
+}
+
 Result DirectDataTest::onInterruptTestCallback()
 {
   if (++m_iteration == 4)
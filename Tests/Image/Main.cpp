@@ -0,0 +1,229 @@
+/*
+ * Main.cpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "TestApplication.hpp"
+#include "Shell/Scripts/EchoScript.hpp"
+#include "Shell/Scripts/GetEnvScript.hpp"
+#include "Shell/Scripts/ListNodesScript.hpp"
+#include "Shell/Scripts/LoadImageScript.hpp"
+#include "Shell/Scripts/MakeDirectoryScript.hpp"
+#include "Shell/Scripts/PrintRawDataScript.hpp"
+#include "Shell/Scripts/SaveImageScript.hpp"
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include <uv.h>
+#include <thread>
+
+static void onUvWalk(uv_handle_t *handle, void *)
+{
+  deinit(uv_handle_get_data(handle));
+}
+
+static void onSignalReceived(void *argument)
+{
+  uv_walk(static_cast<uv_loop_t *>(argument), onUvWalk, 0);
+}
+
+class TestImageApplication: public TestApplication
+{
+public:
+  TestImageApplication(Interface *client, Interface *host) :
+    TestApplication{client, host}
+  {
+  }
+
+  void bootstrap() override
+  {
+    TestApplication::bootstrap();
+
+    m_initializer.attach<EchoScript>();
+    m_initializer.attach<GetEnvScript>();
+    m_initializer.attach<ListNodesScript>();
+    m_initializer.attach<LoadImageScript>();
+    m_initializer.attach<MakeDirectoryScript>();
+    m_initializer.attach<PrintRawDataScript<BUFFER_SIZE>>();
+    m_initializer.attach<SaveImageScript<BUFFER_SIZE>>();
+  }
+
+private:
+  static constexpr size_t BUFFER_SIZE{1024};
+};
+
+class ImageTest: public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE(ImageTest);
+  CPPUNIT_TEST(testErrorIncorrectArguments);
+  CPPUNIT_TEST(testErrorIncorrectImage);
+  CPPUNIT_TEST(testErrorNoNode);
+  CPPUNIT_TEST(testHelpMessage);
+  CPPUNIT_TEST(testSaveAndLoad);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp();
+  void tearDown();
+
+  void testErrorIncorrectArguments();
+  void testErrorIncorrectImage();
+  void testErrorNoNode();
+  void testHelpMessage();
+  void testSaveAndLoad();
+
+private:
+  uv_loop_t *m_loop{nullptr};
+  Interrupt *m_listener{nullptr};
+  Interface *m_appInterface{nullptr};
+  Interface *m_testInterface{nullptr};
+  TestApplication *m_application{nullptr};
+
+  std::thread *m_appThread{nullptr};
+  std::thread *m_loopThread{nullptr};
+};
+
+void ImageTest::setUp()
+{
+  m_loop = uv_default_loop();
+  CPPUNIT_ASSERT(m_loop != nullptr);
+
+  m_listener = TestApplication::makeSignalListener(SIGUSR1, onSignalReceived, m_loop);
+  CPPUNIT_ASSERT(m_listener != nullptr);
+  m_appInterface = TestApplication::makeUdpInterface("127.0.0.1", 8000, 8001);
+  CPPUNIT_ASSERT(m_appInterface != nullptr);
+  m_testInterface = TestApplication::makeUdpInterface("127.0.0.1", 8001, 8000);
+  CPPUNIT_ASSERT(m_testInterface != nullptr);
+
+  m_application = new TestImageApplication(m_appInterface, m_testInterface);
+
+  m_loopThread = new std::thread{TestApplication::runEventLoop, m_loop};
+  m_appThread = new std::thread{TestApplication::runShell, m_application};
+
+  m_application->waitShellResponse();
+}
+
+void ImageTest::tearDown()
+{
+  m_application->sendShellCommand("exit");
+
+  m_appThread->join();
+  delete m_appThread;
+
+  m_loopThread->join();
+  delete m_loopThread;
+}
+
+void ImageTest::testErrorIncorrectArguments()
+{
+  m_application->sendShellCommand("save /");
+  const auto responseA = m_application->waitShellResponse();
+  const auto resultA = TestApplication::responseContainsText(responseA, "missing image operand");
+  CPPUNIT_ASSERT(resultA == true);
+
+  m_application->sendShellCommand("load /test.img");
+  const auto responseB = m_application->waitShellResponse();
+  const auto resultB = TestApplication::responseContainsText(responseB, "missing directory operand");
+  CPPUNIT_ASSERT(resultB == true);
+
+  m_application->sendShellCommand("getenv ?");
+  const auto returnValue = m_application->waitShellResponse();
+  const auto returnValueFound = TestApplication::responseContainsText(returnValue, std::to_string(E_VALUE));
+  CPPUNIT_ASSERT(returnValueFound == true);
+}
+
+void ImageTest::testErrorIncorrectImage()
+{
+  m_application->sendShellCommand("echo 0123456789012345678901234567890123456789 > /test.img");
+  m_application->waitShellResponse();
+
+  m_application->sendShellCommand("load /test.img /");
+  const auto response = m_application->waitShellResponse();
+  const auto result = TestApplication::responseContainsText(response, "restore failed");
+  CPPUNIT_ASSERT(result == true);
+
+  m_application->sendShellCommand("getenv ?");
+  const auto returnValue = m_application->waitShellResponse();
+  const auto returnValueFound = TestApplication::responseContainsText(returnValue, std::to_string(E_VALUE));
+  CPPUNIT_ASSERT(returnValueFound == true);
+}
+
+void ImageTest::testErrorNoNode()
+{
+  m_application->sendShellCommand("save /undefined /test.img");
+  const auto responseA = m_application->waitShellResponse();
+  const auto resultA = TestApplication::responseContainsText(responseA, "node not found");
+  CPPUNIT_ASSERT(resultA == true);
+
+  m_application->sendShellCommand("load /undefined /");
+  const auto responseB = m_application->waitShellResponse();
+  const auto resultB = TestApplication::responseContainsText(responseB, "node not found");
+  CPPUNIT_ASSERT(resultB == true);
+
+  m_application->sendShellCommand("getenv ?");
+  const auto returnValue = m_application->waitShellResponse();
+  const auto returnValueFound = TestApplication::responseContainsText(returnValue, std::to_string(E_ENTRY));
+  CPPUNIT_ASSERT(returnValueFound == true);
+}
+
+void ImageTest::testHelpMessage()
+{
+  m_application->sendShellCommand("save --help");
+  const auto responseA = m_application->waitShellResponse();
+  const auto resultA = TestApplication::responseContainsText(responseA, "Usage");
+  CPPUNIT_ASSERT(resultA == true);
+
+  m_application->sendShellCommand("load --help");
+  const auto responseB = m_application->waitShellResponse();
+  const auto resultB = TestApplication::responseContainsText(responseB, "Usage");
+  CPPUNIT_ASSERT(resultB == true);
+}
+
+void ImageTest::testSaveAndLoad()
+{
+  m_application->sendShellCommand("mkdir /src");
+  m_application->waitShellResponse();
+  m_application->sendShellCommand("mkdir /src/nested");
+  m_application->waitShellResponse();
+  m_application->sendShellCommand("echo 0123456789 > /src/nested/test.txt");
+  m_application->waitShellResponse();
+  m_application->sendShellCommand("mkdir /dst");
+  m_application->waitShellResponse();
+
+  m_application->sendShellCommand("save /src /test.img");
+  m_application->waitShellResponse();
+  m_application->sendShellCommand("load /test.img /dst");
+  m_application->waitShellResponse();
+
+  m_application->sendShellCommand("getenv ?");
+  const auto returnValue = m_application->waitShellResponse();
+  const auto returnValueFound = TestApplication::responseContainsText(returnValue, std::to_string(E_OK));
+  CPPUNIT_ASSERT(returnValueFound == true);
+
+  // Restored data is shared with the loaded image
+  m_application->sendShellCommand("cat /dst/nested/test.txt");
+  const auto response = m_application->waitShellResponse();
+  const auto result = TestApplication::responseContainsText(response, "0123456789");
+  CPPUNIT_ASSERT(result == true);
+
+  // Nodes with the same names are not replaced
+  m_application->sendShellCommand("load /test.img /dst");
+  const auto responseConflict = m_application->waitShellResponse();
+  const auto resultConflict = TestApplication::responseContainsText(responseConflict, "restore failed");
+  CPPUNIT_ASSERT(resultConflict == true);
+}
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ImageTest);
+
+int main(int, char *[])
+{
+  CPPUNIT_NS::Test * const suite = CPPUNIT_NS::TestFactoryRegistry::getRegistry().makeTest();
+
+  CppUnit::TextUi::TestRunner runner;
+  runner.addTest(suite);
+
+  const bool sucessful = runner.run();
+  return sucessful ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,375 @@
+/*
+ * Main.cpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "VirtualMem.hpp"
+#include "Shell/Interfaces/InterfaceCache.hpp"
+#include "Shell/Interfaces/InterfaceProxy.hpp"
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include <array>
+#include <cstring>
+
+class InterfaceCacheTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE(InterfaceCacheTest);
+  CPPUNIT_TEST(testEviction);
+  CPPUNIT_TEST(testIncorrectConfig);
+  CPPUNIT_TEST(testLongTransfers);
+  CPPUNIT_TEST(testParamForwarding);
+  CPPUNIT_TEST(testReadHits);
+  CPPUNIT_TEST(testRelease);
+  CPPUNIT_TEST(testUnalignedAccess);
+  CPPUNIT_TEST(testWriteBack);
+  CPPUNIT_TEST(testWriteThrough);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp();
+  void tearDown();
+
+  void testEviction();
+  void testIncorrectConfig();
+  void testLongTransfers();
+  void testParamForwarding();
+  void testReadHits();
+  void testRelease();
+  void testUnalignedAccess();
+  void testWriteBack();
+  void testWriteThrough();
+
+private:
+  static constexpr size_t SECTOR_SIZE{InterfaceCache::SECTOR_SIZE};
+  static constexpr size_t PARTITION_SIZE{64 * SECTOR_SIZE};
+
+  using Sector = std::array<uint8_t, SECTOR_SIZE>;
+
+  Interface *m_mem{nullptr};
+
+  Interface *makeCache(size_t, InterfaceCache::Policy);
+  uint8_t *sector(size_t);
+
+  static uint32_t counter(Interface *, CacheParameter);
+  static Sector pattern(uint8_t);
+  static size_t readSectors(Interface *, size_t, void *, size_t);
+  static size_t writeSectors(Interface *, size_t, const void *, size_t);
+};
+
+void InterfaceCacheTest::setUp()
+{
+  static const VirtualMem::Config virtualMemConfig = {
+      PARTITION_SIZE // size
+  };
+
+  m_mem = static_cast<Interface *>(init(VirtualMem, &virtualMemConfig));
+  CPPUNIT_ASSERT(m_mem != nullptr);
+
+  for (size_t index = 0; index < PARTITION_SIZE / SECTOR_SIZE; ++index)
+    memset(sector(index), static_cast<int>(index), SECTOR_SIZE);
+}
+
+void InterfaceCacheTest::tearDown()
+{
+  deinit(m_mem);
+}
+
+Interface *InterfaceCacheTest::makeCache(size_t sectors, InterfaceCache::Policy policy)
+{
+  // Cache releases the proxy, the memory is kept for checks
+  const InterfaceProxy::Config proxyConfig{m_mem};
+  Interface * const proxy = static_cast<Interface *>(init(InterfaceProxy, &proxyConfig));
+  CPPUNIT_ASSERT(proxy != nullptr);
+
+  const InterfaceCache::Config cacheConfig{proxy, sectors, policy};
+  Interface * const cache = static_cast<Interface *>(init(InterfaceCache, &cacheConfig));
+  CPPUNIT_ASSERT(cache != nullptr);
+
+  return cache;
+}
+
+uint8_t *InterfaceCacheTest::sector(size_t index)
+{
+  return reinterpret_cast<class VirtualMem *>(m_mem)->arena() + index * SECTOR_SIZE;
+}
+
+uint32_t InterfaceCacheTest::counter(Interface *interface, CacheParameter parameter)
+{
+  uint32_t value = 0;
+  const Result res = ifGetParam(interface, parameter, &value);
+  CPPUNIT_ASSERT(res == E_OK);
+
+  return value;
+}
+
+InterfaceCacheTest::Sector InterfaceCacheTest::pattern(uint8_t value)
+{
+  Sector buffer;
+  buffer.fill(value);
+  return buffer;
+}
+
+size_t InterfaceCacheTest::readSectors(Interface *interface, size_t index, void *buffer, size_t count)
+{
+  const uint64_t position = index * SECTOR_SIZE;
+  const Result res = ifSetParam(interface, IF_POSITION_64, &position);
+  CPPUNIT_ASSERT(res == E_OK);
+
+  return ifRead(interface, buffer, count * SECTOR_SIZE);
+}
+
+size_t InterfaceCacheTest::writeSectors(Interface *interface, size_t index, const void *buffer, size_t count)
+{
+  const uint64_t position = index * SECTOR_SIZE;
+  const Result res = ifSetParam(interface, IF_POSITION_64, &position);
+  CPPUNIT_ASSERT(res == E_OK);
+
+  return ifWrite(interface, buffer, count * SECTOR_SIZE);
+}
+
+void InterfaceCacheTest::testEviction()
+{
+  Interface * const cache = makeCache(2, InterfaceCache::Policy::WRITE_BACK);
+  size_t count;
+
+  for (size_t index = 0; index < 3; ++index)
+  {
+    const Sector buffer = pattern(static_cast<uint8_t>(0xA0 + index));
+
+    count = writeSectors(cache, index, buffer.data(), 1);
+    CPPUNIT_ASSERT(count == SECTOR_SIZE);
+  }
+
+  // Least recently used sector is written during eviction
+  CPPUNIT_ASSERT(memcmp(sector(0), pattern(0xA0).data(), SECTOR_SIZE) == 0);
+  CPPUNIT_ASSERT(memcmp(sector(1), pattern(0x01).data(), SECTOR_SIZE) == 0);
+  CPPUNIT_ASSERT(memcmp(sector(2), pattern(0x02).data(), SECTOR_SIZE) == 0);
+
+  // Recently read sector stays in the cache
+  Sector buffer;
+
+  count = readSectors(cache, 1, buffer.data(), 1);
+  CPPUNIT_ASSERT(count == SECTOR_SIZE);
+  count = readSectors(cache, 3, buffer.data(), 1);
+  CPPUNIT_ASSERT(count == SECTOR_SIZE);
+  CPPUNIT_ASSERT(memcmp(sector(2), pattern(0xA2).data(), SECTOR_SIZE) == 0);
+  CPPUNIT_ASSERT(memcmp(sector(1), pattern(0x01).data(), SECTOR_SIZE) == 0);
+
+  count = readSectors(cache, 1, buffer.data(), 1);
+  CPPUNIT_ASSERT(count == SECTOR_SIZE);
+  CPPUNIT_ASSERT(buffer == pattern(0xA1));
+  CPPUNIT_ASSERT(counter(cache, IF_CACHE_HITS) == 2);
+  CPPUNIT_ASSERT(counter(cache, IF_CACHE_MISSES) == 1);
+
+  deinit(cache);
+  CPPUNIT_ASSERT(memcmp(sector(1), pattern(0xA1).data(), SECTOR_SIZE) == 0);
+}
+
+void InterfaceCacheTest::testIncorrectConfig()
+{
+  const InterfaceCache::Config noPipeConfig{nullptr, 4, InterfaceCache::Policy::WRITE_THROUGH};
+  CPPUNIT_ASSERT(init(InterfaceCache, &noPipeConfig) == nullptr);
+
+  const InterfaceCache::Config emptyConfig{m_mem, 0, InterfaceCache::Policy::WRITE_THROUGH};
+  CPPUNIT_ASSERT(init(InterfaceCache, &emptyConfig) == nullptr);
+}
+
+void InterfaceCacheTest::testLongTransfers()
+{
+  Interface * const cache = makeCache(4, InterfaceCache::Policy::WRITE_BACK);
+  std::array<uint8_t, 4 * SECTOR_SIZE> buffer;
+  size_t count;
+
+  // Transfers longer than half of the cache are passed to the device
+  for (size_t iteration = 0; iteration < 2; ++iteration)
+  {
+    count = readSectors(cache, 8, buffer.data(), 4);
+    CPPUNIT_ASSERT(count == buffer.size());
+    CPPUNIT_ASSERT(memcmp(buffer.data(), sector(8), buffer.size()) == 0);
+  }
+  CPPUNIT_ASSERT(counter(cache, IF_CACHE_HITS) == 0);
+  CPPUNIT_ASSERT(counter(cache, IF_CACHE_MISSES) == 8);
+
+  buffer.fill(0xC0);
+  count = writeSectors(cache, 16, buffer.data(), 4);
+  CPPUNIT_ASSERT(count == buffer.size());
+  CPPUNIT_ASSERT(memcmp(buffer.data(), sector(16), buffer.size()) == 0);
+
+  // Short transfers are cached, missing sectors are read with a single request
+  count = readSectors(cache, 8, buffer.data(), 2);
+  CPPUNIT_ASSERT(count == 2 * SECTOR_SIZE);
+  count = readSectors(cache, 8, buffer.data(), 2);
+  CPPUNIT_ASSERT(count == 2 * SECTOR_SIZE);
+  CPPUNIT_ASSERT(memcmp(buffer.data(), sector(8), 2 * SECTOR_SIZE) == 0);
+  CPPUNIT_ASSERT(counter(cache, IF_CACHE_HITS) == 2);
+  CPPUNIT_ASSERT(counter(cache, IF_CACHE_MISSES) == 10);
+
+  deinit(cache);
+}
+
+void InterfaceCacheTest::testParamForwarding()
+{
+  Interface * const cache = makeCache(4, InterfaceCache::Policy::WRITE_THROUGH);
+  uint64_t value;
+  Result res;
+
+  res = ifGetParam(cache, IF_SIZE_64, &value);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(value == PARTITION_SIZE);
+
+  // Position is validated by the device
+  value = PARTITION_SIZE;
+  res = ifSetParam(cache, IF_POSITION_64, &value);
+  CPPUNIT_ASSERT(res != E_OK);
+
+  value = 3 * SECTOR_SIZE;
+  res = ifSetParam(cache, IF_POSITION_64, &value);
+  CPPUNIT_ASSERT(res == E_OK);
+
+  Sector buffer;
+  const size_t count = ifRead(cache, buffer.data(), buffer.size());
+  CPPUNIT_ASSERT(count == buffer.size());
+
+  res = ifGetParam(cache, IF_POSITION_64, &value);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(value == 4 * SECTOR_SIZE);
+
+  res = ifSetParam(cache, IF_CACHE_FLUSH, nullptr);
+  CPPUNIT_ASSERT(res == E_OK);
+
+  deinit(cache);
+}
+
+void InterfaceCacheTest::testReadHits()
+{
+  Interface * const cache = makeCache(4, InterfaceCache::Policy::WRITE_THROUGH);
+  Sector buffer;
+  size_t count;
+
+  for (size_t iteration = 0; iteration < 3; ++iteration)
+  {
+    count = readSectors(cache, 5, buffer.data(), 1);
+    CPPUNIT_ASSERT(count == SECTOR_SIZE);
+    CPPUNIT_ASSERT(buffer == pattern(0x05));
+  }
+
+  CPPUNIT_ASSERT(counter(cache, IF_CACHE_HITS) == 2);
+  CPPUNIT_ASSERT(counter(cache, IF_CACHE_MISSES) == 1);
+
+  deinit(cache);
+}
+
+void InterfaceCacheTest::testRelease()
+{
+  Interface * const cache = makeCache(4, InterfaceCache::Policy::WRITE_BACK);
+  const Sector buffer = pattern(0xE0);
+
+  const size_t count = writeSectors(cache, 7, buffer.data(), 1);
+  CPPUNIT_ASSERT(count == SECTOR_SIZE);
+  CPPUNIT_ASSERT(memcmp(sector(7), pattern(0x07).data(), SECTOR_SIZE) == 0);
+
+  // Modified sectors are written when the cache is released
+  deinit(cache);
+  CPPUNIT_ASSERT(memcmp(sector(7), buffer.data(), SECTOR_SIZE) == 0);
+}
+
+void InterfaceCacheTest::testUnalignedAccess()
+{
+  Interface * const cache = makeCache(4, InterfaceCache::Policy::WRITE_BACK);
+  const Sector data = pattern(0xD0);
+  size_t count;
+
+  count = writeSectors(cache, 2, data.data(), 1);
+  CPPUNIT_ASSERT(count == SECTOR_SIZE);
+
+  // Partial reads see modified sectors
+  std::array<uint8_t, 16> chunk;
+  uint64_t position = 2 * SECTOR_SIZE + 100;
+
+  CPPUNIT_ASSERT(ifSetParam(cache, IF_POSITION_64, &position) == E_OK);
+  count = ifRead(cache, chunk.data(), chunk.size());
+  CPPUNIT_ASSERT(count == chunk.size());
+  CPPUNIT_ASSERT(memcmp(chunk.data(), data.data(), chunk.size()) == 0);
+  CPPUNIT_ASSERT(memcmp(sector(2), data.data(), SECTOR_SIZE) == 0);
+
+  // Partial writes drop cached copies
+  chunk.fill(0x11);
+  CPPUNIT_ASSERT(ifSetParam(cache, IF_POSITION_64, &position) == E_OK);
+  count = ifWrite(cache, chunk.data(), chunk.size());
+  CPPUNIT_ASSERT(count == chunk.size());
+
+  Sector buffer;
+
+  count = readSectors(cache, 2, buffer.data(), 1);
+  CPPUNIT_ASSERT(count == SECTOR_SIZE);
+  CPPUNIT_ASSERT(buffer[99] == 0xD0);
+  CPPUNIT_ASSERT(buffer[100] == 0x11);
+  CPPUNIT_ASSERT(buffer[115] == 0x11);
+  CPPUNIT_ASSERT(buffer[116] == 0xD0);
+
+  deinit(cache);
+}
+
+void InterfaceCacheTest::testWriteBack()
+{
+  Interface * const cache = makeCache(4, InterfaceCache::Policy::WRITE_BACK);
+  const Sector data = pattern(0xB0);
+  Sector buffer;
+  size_t count;
+
+  count = writeSectors(cache, 3, data.data(), 1);
+  CPPUNIT_ASSERT(count == SECTOR_SIZE);
+  CPPUNIT_ASSERT(memcmp(sector(3), pattern(0x03).data(), SECTOR_SIZE) == 0);
+
+  count = readSectors(cache, 3, buffer.data(), 1);
+  CPPUNIT_ASSERT(count == SECTOR_SIZE);
+  CPPUNIT_ASSERT(buffer == data);
+  CPPUNIT_ASSERT(counter(cache, IF_CACHE_HITS) == 1);
+
+  const Result res = ifSetParam(cache, IF_CACHE_FLUSH, nullptr);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(memcmp(sector(3), data.data(), SECTOR_SIZE) == 0);
+
+  deinit(cache);
+}
+
+void InterfaceCacheTest::testWriteThrough()
+{
+  Interface * const cache = makeCache(4, InterfaceCache::Policy::WRITE_THROUGH);
+  Sector buffer;
+  size_t count;
+
+  count = readSectors(cache, 4, buffer.data(), 1);
+  CPPUNIT_ASSERT(count == SECTOR_SIZE);
+
+  // Device and the cached copy are updated
+  const Sector data = pattern(0xF0);
+
+  count = writeSectors(cache, 4, data.data(), 1);
+  CPPUNIT_ASSERT(count == SECTOR_SIZE);
+  CPPUNIT_ASSERT(memcmp(sector(4), data.data(), SECTOR_SIZE) == 0);
+
+  count = readSectors(cache, 4, buffer.data(), 1);
+  CPPUNIT_ASSERT(count == SECTOR_SIZE);
+  CPPUNIT_ASSERT(buffer == data);
+  CPPUNIT_ASSERT(counter(cache, IF_CACHE_HITS) == 1);
+  CPPUNIT_ASSERT(counter(cache, IF_CACHE_MISSES) == 1);
+
+  deinit(cache);
+}
+
+CPPUNIT_TEST_SUITE_REGISTRATION(InterfaceCacheTest);
+
+int main(int, char *[])
+{
+  CPPUNIT_NS::Test * const suite = CPPUNIT_NS::TestFactoryRegistry::getRegistry().makeTest();
+
+  CppUnit::TextUi::TestRunner runner;
+  runner.addTest(suite);
+
+  const bool sucessful = runner.run();
+  return sucessful ? EXIT_SUCCESS : EXIT_FAILURE;
+}
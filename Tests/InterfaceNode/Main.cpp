@@ -8,6 +8,7 @@
 #include "MockInterface.hpp"
 #include "MockSerial.hpp"
 #include "TestApplication.hpp"
+#include "VirtualMem.hpp"
 #include "Shell/Interfaces/InterfaceNode.hpp"
 #include "Shell/MockTimeProvider.hpp"
 #include "Shell/Scripts/EchoScript.hpp"
@@ -19,7 +20,9 @@
 #include <cppunit/extensions/TestFactoryRegistry.h>
 #include <cppunit/ui/text/TestRunner.h>
 #include <uv.h>
+#include <algorithm>
 #include <thread>
+#include <vector>
 
 static void onUvWalk(uv_handle_t *handle, void *)
 {
@@ -54,6 +57,7 @@ class InterfaceNodeTest : public CPPUNIT_NS::TestFixture
 {
   CPPUNIT_TEST_SUITE(InterfaceNodeTest);
   CPPUNIT_TEST(testAccess);
+  CPPUNIT_TEST(testAsyncRequests);
   CPPUNIT_TEST(testDisplayNode);
   CPPUNIT_TEST(testDisplayReadWrite);
   CPPUNIT_TEST(testEmptyNode);
@@ -63,8 +67,11 @@ class InterfaceNodeTest : public CPPUNIT_NS::TestFixture
   CPPUNIT_TEST(testMockDisplay);
   CPPUNIT_TEST(testMockInterface);
   CPPUNIT_TEST(testMockSerial);
+  CPPUNIT_TEST(testReadAhead);
+  CPPUNIT_TEST(testSeekElision);
   CPPUNIT_TEST(testSerialNode);
   CPPUNIT_TEST(testSubnode);
+  CPPUNIT_TEST(testWriteBehind);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -72,6 +79,7 @@ public:
   void tearDown();
 
   void testAccess();
+  void testAsyncRequests();
   void testDisplayNode();
   void testDisplayReadWrite();
   void testEmptyNode();
@@ -81,8 +89,11 @@ public:
   void testMockDisplay();
   void testMockInterface();
   void testMockSerial();
+  void testReadAhead();
+  void testSeekElision();
   void testSerialNode();
   void testSubnode();
+  void testWriteBehind();
 
 private:
   static constexpr size_t BUFFER_SIZE{1024};
@@ -194,6 +205,168 @@ void InterfaceNodeTest::testAccess()
   deinit(interface);
 }
 
+void InterfaceNodeTest::testAsyncRequests()
+{
+  static constexpr size_t CHUNK_SIZE{512};
+  static constexpr size_t PARTITION_SIZE{CHUNK_SIZE * 16};
+  static constexpr auto REQUEST_FIELD = static_cast<FsFieldType>(VfsNode::VFS_NODE_REQUEST);
+  static const VirtualMem::Config virtualMemConfig = {
+      PARTITION_SIZE // size
+  };
+
+  Interface * const mem = static_cast<Interface *>(init(VirtualMem, &virtualMemConfig));
+  CPPUNIT_ASSERT(mem != nullptr);
+  auto * const device = reinterpret_cast<class VirtualMem *>(mem);
+  uint8_t * const arena = device->arena();
+
+  for (size_t i = 0; i < PARTITION_SIZE; ++i)
+    arena[i] = static_cast<uint8_t>(i / CHUNK_SIZE);
+
+  VfsNode * const node = new InterfaceNode<>{mem};
+  CPPUNIT_ASSERT(node != nullptr);
+
+  std::array<std::array<uint8_t, CHUNK_SIZE>, InterfaceNode<>::REQUEST_QUEUE_LENGTH + 1> buffers;
+  std::array<VfsNode::Request, InterfaceNode<>::REQUEST_QUEUE_LENGTH + 1> requests;
+  VfsNode::Request *request;
+  size_t count;
+  Result res;
+
+  for (size_t i = 0; i < requests.size(); ++i)
+    requests[i] = VfsNode::Request{buffers[i].data(), CHUNK_SIZE, false, 0, E_OK, 0};
+
+  // Nothing is submitted
+  res = node->read(REQUEST_FIELD, 0, &request, sizeof(request), &count);
+  CPPUNIT_ASSERT(res == E_EMPTY);
+
+  // Interfaces without callbacks finish requests during submission, submission fails when the queue is full
+  for (size_t i = 0; i < requests.size(); ++i)
+  {
+    request = &requests[i];
+    res = node->write(REQUEST_FIELD, i * CHUNK_SIZE, &request, sizeof(request), &count);
+
+    if (i < InterfaceNode<>::REQUEST_QUEUE_LENGTH)
+    {
+      CPPUNIT_ASSERT(res == E_OK);
+      CPPUNIT_ASSERT(requests[i].status == E_OK);
+      CPPUNIT_ASSERT(requests[i].count == CHUNK_SIZE);
+    }
+    else
+      CPPUNIT_ASSERT(res == E_BUSY);
+  }
+
+  // Requests are returned in submission order
+  for (size_t i = 0; i < InterfaceNode<>::REQUEST_QUEUE_LENGTH; ++i)
+  {
+    res = node->read(REQUEST_FIELD, 0, &request, sizeof(request), &count);
+    CPPUNIT_ASSERT(res == E_OK);
+    CPPUNIT_ASSERT(request == &requests[i]);
+    CPPUNIT_ASSERT(request->position == i * CHUNK_SIZE);
+    CPPUNIT_ASSERT(memcmp(request->buffer, arena + i * CHUNK_SIZE, CHUNK_SIZE) == 0);
+  }
+
+  res = node->read(REQUEST_FIELD, 0, &request, sizeof(request), &count);
+  CPPUNIT_ASSERT(res == E_EMPTY);
+
+  // Requests of zero-copy interfaces are finished by the callback
+  device->allowZerocopy();
+
+  std::fill(buffers[0].begin(), buffers[0].end(), 0xA5);
+  requests[0].write = true;
+
+  for (size_t i = 0; i < 3; ++i)
+  {
+    request = &requests[i];
+    res = node->write(REQUEST_FIELD, (i + 8) * CHUNK_SIZE, &request, sizeof(request), &count);
+    CPPUNIT_ASSERT(res == E_OK);
+    CPPUNIT_ASSERT(requests[i].status == E_BUSY);
+  }
+
+  CPPUNIT_ASSERT(device->pending());
+  device->finish();
+  CPPUNIT_ASSERT(requests[0].status == E_OK);
+  CPPUNIT_ASSERT(requests[1].status == E_BUSY);
+  CPPUNIT_ASSERT(arena[8 * CHUNK_SIZE] == 0xA5);
+
+  res = node->read(REQUEST_FIELD, 0, &request, sizeof(request), &count);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(request == &requests[0]);
+
+  // Callback does not start queued requests, the next request is started when a finished one is taken
+  device->finish();
+  CPPUNIT_ASSERT(!device->pending());
+  CPPUNIT_ASSERT(requests[1].status == E_OK);
+  CPPUNIT_ASSERT(requests[1].count == CHUNK_SIZE);
+  CPPUNIT_ASSERT(buffers[1][0] == 9);
+  CPPUNIT_ASSERT(requests[2].status == E_BUSY);
+
+  res = node->read(REQUEST_FIELD, 0, &request, sizeof(request), &count);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(request == &requests[1]);
+  CPPUNIT_ASSERT(device->pending());
+
+  device->finish();
+  CPPUNIT_ASSERT(requests[2].status == E_OK);
+  CPPUNIT_ASSERT(buffers[2][0] == 10);
+
+  // Synchronous access waits for finished requests and returns the interface to blocking mode
+  std::array<uint8_t, CHUNK_SIZE> buffer;
+
+  res = node->read(FS_NODE_DATA, 8 * CHUNK_SIZE, buffer.data(), buffer.size(), &count);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(count == buffer.size());
+  CPPUNIT_ASSERT(buffer[0] == 0xA5);
+  CPPUNIT_ASSERT(!device->pending());
+
+  res = node->read(REQUEST_FIELD, 0, &request, sizeof(request), &count);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(request == &requests[2]);
+
+  // Requests beyond the end of the device fail
+  requests[0].write = false;
+  request = &requests[0];
+  res = node->write(REQUEST_FIELD, PARTITION_SIZE, &request, sizeof(request), &count);
+  CPPUNIT_ASSERT(res == E_OK);
+  res = node->read(REQUEST_FIELD, 0, &request, sizeof(request), &count);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(request->status != E_OK);
+
+  // Caller waiting for a request does not block submissions
+  request = &requests[0];
+  res = node->write(REQUEST_FIELD, 0, &request, sizeof(request), &count);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(device->pending());
+
+  VfsNode::Request *completed = nullptr;
+  std::thread waiter{[node, &completed](){
+    VfsNode::Request *finished;
+
+    if (node->read(REQUEST_FIELD, 0, &finished, sizeof(finished), nullptr) == E_OK)
+      completed = finished;
+  }};
+
+  std::this_thread::sleep_for(std::chrono::milliseconds{10});
+  request = &requests[1];
+  res = node->write(REQUEST_FIELD, CHUNK_SIZE, &request, sizeof(request), &count);
+  CPPUNIT_ASSERT(res == E_OK);
+
+  // Waiter starts the queued request before returning the finished one
+  device->finish();
+  waiter.join();
+  CPPUNIT_ASSERT(device->pending());
+  CPPUNIT_ASSERT(completed == &requests[0]);
+  CPPUNIT_ASSERT(requests[0].status == E_OK);
+  CPPUNIT_ASSERT(buffers[0][0] == 0);
+
+  device->finish();
+  res = node->read(REQUEST_FIELD, 0, &request, sizeof(request), &count);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(request == &requests[1]);
+  CPPUNIT_ASSERT(buffers[1][0] == 1);
+
+  delete node;
+  deinit(mem);
+}
+
 void InterfaceNodeTest::testDisplayNode()
 {
   const auto interface = static_cast<Interface *>(init(MockDisplay, nullptr));
@@ -571,6 +744,153 @@ void InterfaceNodeTest::testMockSerial()
   deinit(interface);
 }
 
+void InterfaceNodeTest::testReadAhead()
+{
+  static constexpr size_t CHUNK_SIZE{512};
+  static constexpr size_t PARTITION_SIZE{InterfaceNode<>::READ_AHEAD_LENGTH * 4};
+  static const VirtualMem::Config virtualMemConfig = {
+      PARTITION_SIZE // size
+  };
+
+  Interface * const mem = static_cast<Interface *>(init(VirtualMem, &virtualMemConfig));
+  CPPUNIT_ASSERT(mem != nullptr);
+  uint8_t * const arena = reinterpret_cast<class VirtualMem *>(mem)->arena();
+
+  for (size_t i = 0; i < PARTITION_SIZE; ++i)
+    arena[i] = static_cast<uint8_t>(i / CHUNK_SIZE);
+
+  VfsNode * const node = new InterfaceNode<>{mem};
+  CPPUNIT_ASSERT(node != nullptr);
+
+  std::array<uint8_t, CHUNK_SIZE> buffer;
+  size_t count;
+  Result res;
+
+  // Sequential reads return device data
+  for (size_t i = 0; i < 4; ++i)
+  {
+    res = node->read(FS_NODE_DATA, i * CHUNK_SIZE, buffer.data(), buffer.size(), &count);
+    CPPUNIT_ASSERT(res == E_OK);
+    CPPUNIT_ASSERT(count == buffer.size());
+    CPPUNIT_ASSERT(memcmp(buffer.data(), arena + i * CHUNK_SIZE, buffer.size()) == 0);
+  }
+
+  // Next chunk was read ahead, changes made behind the node are not visible
+  arena[4 * CHUNK_SIZE] = 0xFF;
+
+  res = node->read(FS_NODE_DATA, 4 * CHUNK_SIZE, buffer.data(), buffer.size(), &count);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(count == buffer.size());
+  CPPUNIT_ASSERT(buffer[0] == 4);
+
+  // Writes through the node drop data read ahead
+  const uint8_t pattern = 0xA5;
+
+  res = node->write(FS_NODE_DATA, 5 * CHUNK_SIZE, &pattern, sizeof(pattern), &count);
+  CPPUNIT_ASSERT(res == E_OK);
+
+  res = node->read(FS_NODE_DATA, 5 * CHUNK_SIZE, buffer.data(), buffer.size(), &count);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(buffer[0] == pattern);
+  CPPUNIT_ASSERT(buffer[1] == 5);
+
+  // Random reads bypass the buffer
+  arena[2 * CHUNK_SIZE] = 0xFF;
+
+  res = node->read(FS_NODE_DATA, 2 * CHUNK_SIZE, buffer.data(), buffer.size(), &count);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(buffer[0] == 0xFF);
+
+  delete node;
+  deinit(mem);
+}
+
+void InterfaceNodeTest::testSeekElision()
+{
+  static constexpr size_t CHUNK_SIZE{512};
+  static constexpr size_t PARTITION_SIZE{InterfaceNode<>::READ_AHEAD_LENGTH * 4};
+  static const VirtualMem::Config virtualMemConfig = {
+      PARTITION_SIZE // size
+  };
+
+  Interface * const mem = static_cast<Interface *>(init(VirtualMem, &virtualMemConfig));
+  CPPUNIT_ASSERT(mem != nullptr);
+  uint8_t * const arena = reinterpret_cast<class VirtualMem *>(mem)->arena();
+
+  for (size_t i = 0; i < PARTITION_SIZE; ++i)
+    arena[i] = static_cast<uint8_t>(i / CHUNK_SIZE);
+
+  auto * const node = new InterfaceNode<>{mem};
+  CPPUNIT_ASSERT(node != nullptr);
+
+  std::array<uint8_t, CHUNK_SIZE> buffer;
+  size_t count;
+  Result res;
+
+  // Sequential reads set the position once
+  for (size_t i = 0; i < InterfaceNode<>::READ_AHEAD_LENGTH * 2 / CHUNK_SIZE; ++i)
+  {
+    res = node->read(FS_NODE_DATA, i * CHUNK_SIZE, buffer.data(), buffer.size(), &count);
+    CPPUNIT_ASSERT(res == E_OK);
+    CPPUNIT_ASSERT(count == buffer.size());
+    CPPUNIT_ASSERT(memcmp(buffer.data(), arena + i * CHUNK_SIZE, buffer.size()) == 0);
+  }
+
+  CPPUNIT_ASSERT(node->seeks() == 1);
+
+  // Sequential writes set the position once
+  std::fill(buffer.begin(), buffer.end(), 0xA5);
+
+  for (size_t i = 0; i < 4; ++i)
+  {
+    res = node->write(FS_NODE_DATA, i * CHUNK_SIZE, buffer.data(), buffer.size(), &count);
+    CPPUNIT_ASSERT(res == E_OK);
+    CPPUNIT_ASSERT(count == buffer.size());
+  }
+
+  CPPUNIT_ASSERT(node->seeks() == 2);
+  CPPUNIT_ASSERT(arena[4 * CHUNK_SIZE - 1] == 0xA5);
+  CPPUNIT_ASSERT(arena[4 * CHUNK_SIZE] == 4);
+
+  // Read from the end of the previous write does not change the position
+  res = node->read(FS_NODE_DATA, 4 * CHUNK_SIZE, buffer.data(), buffer.size(), &count);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(buffer[0] == 4);
+  CPPUNIT_ASSERT(node->seeks() == 2);
+
+  // Random access sets the position
+  res = node->read(FS_NODE_DATA, 8 * CHUNK_SIZE, buffer.data(), buffer.size(), &count);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(buffer[0] == 8);
+  CPPUNIT_ASSERT(node->seeks() == 3);
+
+  // Position of a shared interface is checked before each transfer
+  Interface *interface;
+
+  res = node->read(static_cast<FsFieldType>(VfsNode::VFS_NODE_INTERFACE), 0,
+      &interface, sizeof(interface), &count);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(interface == mem);
+
+  const uint64_t origin = 0;
+
+  res = ifSetParam(interface, IF_POSITION_64, &origin);
+  CPPUNIT_ASSERT(res == E_OK);
+
+  res = node->read(FS_NODE_DATA, 9 * CHUNK_SIZE, buffer.data(), buffer.size(), &count);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(buffer[0] == 9);
+  CPPUNIT_ASSERT(node->seeks() == 4);
+
+  res = node->read(FS_NODE_DATA, 10 * CHUNK_SIZE, buffer.data(), buffer.size(), &count);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(buffer[0] == 10);
+  CPPUNIT_ASSERT(node->seeks() == 4);
+
+  delete node;
+  deinit(mem);
+}
+
 void InterfaceNodeTest::testSerialNode()
 {
   static const std::array<const char *, 4> SUBNODE_NAMES = {{
@@ -754,6 +1074,145 @@ void InterfaceNodeTest::testSubnode()
   deinit(interface);
 }
 
+void InterfaceNodeTest::testWriteBehind()
+{
+  static constexpr size_t SECTOR_SIZE{InterfaceNode<>::SECTOR_SIZE};
+  static constexpr size_t PARTITION_SIZE{InterfaceNode<>::WRITE_BEHIND_LENGTH * 4};
+  static const VirtualMem::Config virtualMemConfig = {
+      PARTITION_SIZE // size
+  };
+
+  Interface * const mem = static_cast<Interface *>(init(VirtualMem, &virtualMemConfig));
+  CPPUNIT_ASSERT(mem != nullptr);
+  uint8_t * const arena = reinterpret_cast<class VirtualMem *>(mem)->arena();
+
+  for (size_t i = 0; i < PARTITION_SIZE; ++i)
+    arena[i] = static_cast<uint8_t>(i / SECTOR_SIZE);
+
+  auto * const node = new InterfaceNode<>{mem};
+  CPPUNIT_ASSERT(node != nullptr);
+  node->setWriteBehind(true);
+
+  std::array<uint8_t, SECTOR_SIZE> buffer;
+  size_t count;
+  Result res;
+
+  // Adjacent small writes are kept in the buffer
+  const size_t origin = SECTOR_SIZE + SECTOR_SIZE / 2;
+
+  for (size_t i = 0; i < 8; ++i)
+  {
+    const uint8_t pattern[] = {0xA5, 0xA5, 0xA5, 0xA5};
+
+    res = node->write(FS_NODE_DATA, origin + i * sizeof(pattern), pattern, sizeof(pattern), &count);
+    CPPUNIT_ASSERT(res == E_OK);
+    CPPUNIT_ASSERT(count == sizeof(pattern));
+  }
+
+  CPPUNIT_ASSERT(node->writeStats().dirty == 32);
+  CPPUNIT_ASSERT(node->writeStats().flushes == 0);
+  CPPUNIT_ASSERT(arena[origin] == 1);
+
+  // Reads return buffered data
+  res = node->read(FS_NODE_DATA, SECTOR_SIZE, buffer.data(), buffer.size(), &count);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(count == buffer.size());
+  CPPUNIT_ASSERT(buffer[SECTOR_SIZE / 2 - 1] == 1);
+  CPPUNIT_ASSERT(buffer[SECTOR_SIZE / 2] == 0xA5);
+  CPPUNIT_ASSERT(buffer[SECTOR_SIZE / 2 + 31] == 0xA5);
+  CPPUNIT_ASSERT(buffer[SECTOR_SIZE / 2 + 32] == 1);
+
+  // Overlapping write replaces buffered data
+  const uint8_t overlap = 0x5A;
+
+  res = node->write(FS_NODE_DATA, origin + 4, &overlap, sizeof(overlap), &count);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(node->writeStats().dirty == 32);
+
+  // Changes made behind the node are kept in the rest of the sector
+  arena[SECTOR_SIZE] = 0xFF;
+
+  res = node->sync();
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(node->writeStats().dirty == 0);
+  CPPUNIT_ASSERT(node->writeStats().flushes == 1);
+  CPPUNIT_ASSERT(arena[SECTOR_SIZE] == 0xFF);
+  CPPUNIT_ASSERT(arena[origin - 1] == 1);
+  CPPUNIT_ASSERT(arena[origin] == 0xA5);
+  CPPUNIT_ASSERT(arena[origin + 4] == overlap);
+  CPPUNIT_ASSERT(arena[origin + 32] == 1);
+  CPPUNIT_ASSERT(arena[2 * SECTOR_SIZE] == 2);
+
+  // Distant write flushes the buffer
+  res = node->write(FS_NODE_DATA, 0, &overlap, sizeof(overlap), &count);
+  CPPUNIT_ASSERT(res == E_OK);
+  res = node->write(FS_NODE_DATA, PARTITION_SIZE - 1, &overlap, sizeof(overlap), &count);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(arena[0] == overlap);
+  CPPUNIT_ASSERT(arena[PARTITION_SIZE - 1] != overlap);
+  CPPUNIT_ASSERT(node->writeStats().flushes == 2);
+
+  // Sequential writes are written in full buffer bursts
+  const size_t flushes = node->writeStats().flushes;
+
+  for (size_t i = 0; i < InterfaceNode<>::WRITE_BEHIND_LENGTH * 2 / SECTOR_SIZE; ++i)
+  {
+    std::fill(buffer.begin(), buffer.end(), 0xC3);
+    res = node->write(FS_NODE_DATA, i * SECTOR_SIZE, buffer.data(), buffer.size() / 2, &count);
+    CPPUNIT_ASSERT(res == E_OK);
+    res = node->write(FS_NODE_DATA, i * SECTOR_SIZE + SECTOR_SIZE / 2, buffer.data(), buffer.size() / 2, &count);
+    CPPUNIT_ASSERT(res == E_OK);
+  }
+
+  CPPUNIT_ASSERT(node->writeStats().flushes == flushes + 3);
+  CPPUNIT_ASSERT(node->writeStats().dirty == 0);
+  CPPUNIT_ASSERT(arena[InterfaceNode<>::WRITE_BEHIND_LENGTH * 2 - 1] == 0xC3);
+  CPPUNIT_ASSERT(arena[PARTITION_SIZE - 1] == overlap);
+
+  // Large writes go to the device directly after buffered data
+  std::vector<uint8_t> large(InterfaceNode<>::WRITE_BEHIND_LENGTH, 0x3C);
+
+  res = node->write(FS_NODE_DATA, PARTITION_SIZE - 2, &overlap, sizeof(overlap), &count);
+  CPPUNIT_ASSERT(res == E_OK);
+  res = node->write(FS_NODE_DATA, PARTITION_SIZE - large.size(), large.data(), large.size(), &count);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(count == large.size());
+  CPPUNIT_ASSERT(arena[PARTITION_SIZE - 2] == 0x3C);
+  CPPUNIT_ASSERT(node->writeStats().dirty == 0);
+
+  // Buffered data is written when the node is released
+  res = node->write(FS_NODE_DATA, 3, &overlap, sizeof(overlap), &count);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(arena[3] != overlap);
+
+  delete node;
+  CPPUNIT_ASSERT(arena[3] == overlap);
+
+  // Buffered data is written when the interface is exported, later writes are not buffered
+  auto * const exported = new InterfaceNode<>{mem};
+  CPPUNIT_ASSERT(exported != nullptr);
+  exported->setWriteBehind(true);
+
+  res = exported->write(FS_NODE_DATA, 5, &overlap, sizeof(overlap), &count);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(arena[5] != overlap);
+
+  Interface *base;
+
+  res = exported->read(static_cast<FsFieldType>(VfsNode::VFS_NODE_INTERFACE), 0, &base, sizeof(base), nullptr);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(arena[5] == overlap);
+
+  exported->setWriteBehind(true);
+  res = exported->write(FS_NODE_DATA, 7, &overlap, sizeof(overlap), &count);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(arena[7] == overlap);
+  CPPUNIT_ASSERT(exported->writeStats().dirty == 0);
+
+  delete exported;
+  deinit(mem);
+}
+
 CPPUNIT_TEST_SUITE_REGISTRATION(InterfaceNodeTest);
 
 int main(int, char *[])
@@ -0,0 +1,207 @@
+/*
+ * Main.cpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "TestApplication.hpp"
+#include "Shell/ShellHelpers.hpp"
+#include "Shell/Scripts/EchoScript.hpp"
+#include "Shell/Scripts/GetEnvScript.hpp"
+#include "Shell/Scripts/LinkNodeScript.hpp"
+#include "Shell/Scripts/RemoveNodesScript.hpp"
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include <uv.h>
+#include <string>
+#include <thread>
+
+static void onUvWalk(uv_handle_t *handle, void *)
+{
+  deinit(uv_handle_get_data(handle));
+}
+
+static void onSignalReceived(void *argument)
+{
+  uv_walk(static_cast<uv_loop_t *>(argument), onUvWalk, 0);
+}
+
+class TestLinkNodeApplication: public TestApplication
+{
+public:
+  TestLinkNodeApplication(Interface *client, Interface *host) :
+    TestApplication{client, host}
+  {
+  }
+
+  std::string readData(const char *path)
+  {
+    FsNode * const node = ShellHelpers::openNode(m_filesystem.get(), path);
+    CPPUNIT_ASSERT(node != nullptr);
+
+    char buffer[BUFFER_SIZE];
+    size_t count;
+    const Result res = fsNodeRead(node, FS_NODE_DATA, 0, buffer, sizeof(buffer), &count);
+    CPPUNIT_ASSERT(res == E_OK);
+
+    fsNodeFree(node);
+    return std::string{buffer, count};
+  }
+
+  void bootstrap() override
+  {
+    TestApplication::bootstrap();
+
+    m_initializer.attach<EchoScript>();
+    m_initializer.attach<GetEnvScript>();
+    m_initializer.attach<LinkNodeScript>();
+    m_initializer.attach<RemoveNodesScript>();
+  }
+};
+
+class LinkNodeTest: public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE(LinkNodeTest);
+  CPPUNIT_TEST(testErrorDirectory);
+  CPPUNIT_TEST(testErrorExists);
+  CPPUNIT_TEST(testErrorNoNode);
+  CPPUNIT_TEST(testHelpMessage);
+  CPPUNIT_TEST(testLink);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp();
+  void tearDown();
+
+  void testErrorDirectory();
+  void testErrorExists();
+  void testErrorNoNode();
+  void testHelpMessage();
+  void testLink();
+
+private:
+  uv_loop_t *m_loop{nullptr};
+  Interrupt *m_listener{nullptr};
+  Interface *m_appInterface{nullptr};
+  Interface *m_testInterface{nullptr};
+  TestLinkNodeApplication *m_application{nullptr};
+
+  std::thread *m_appThread{nullptr};
+  std::thread *m_loopThread{nullptr};
+};
+
+void LinkNodeTest::setUp()
+{
+  m_loop = uv_default_loop();
+  CPPUNIT_ASSERT(m_loop != nullptr);
+
+  m_listener = TestApplication::makeSignalListener(SIGUSR1, onSignalReceived, m_loop);
+  CPPUNIT_ASSERT(m_listener != nullptr);
+  m_appInterface = TestApplication::makeUdpInterface("127.0.0.1", 8000, 8001);
+  CPPUNIT_ASSERT(m_appInterface != nullptr);
+  m_testInterface = TestApplication::makeUdpInterface("127.0.0.1", 8001, 8000);
+  CPPUNIT_ASSERT(m_testInterface != nullptr);
+
+  m_application = new TestLinkNodeApplication(m_appInterface, m_testInterface);
+  m_application->makeDataNode("/file.txt", "text");
+
+  m_loopThread = new std::thread{TestApplication::runEventLoop, m_loop};
+  m_appThread = new std::thread{TestApplication::runShell, m_application};
+
+  m_application->waitShellResponse();
+}
+
+void LinkNodeTest::tearDown()
+{
+  m_application->sendShellCommand("exit");
+
+  m_appThread->join();
+  delete m_appThread;
+
+  m_loopThread->join();
+  delete m_loopThread;
+}
+
+void LinkNodeTest::testErrorDirectory()
+{
+  m_application->sendShellCommand("ln /dev /devices");
+  const auto response = m_application->waitShellResponse();
+  const auto result = TestApplication::responseContainsText(response, "hard link not allowed for directory");
+  CPPUNIT_ASSERT(result == true);
+
+  m_application->sendShellCommand("getenv ?");
+  const auto returnValue = m_application->waitShellResponse();
+  const auto returnValueFound = TestApplication::responseContainsText(returnValue, std::to_string(E_VALUE));
+  CPPUNIT_ASSERT(returnValueFound == true);
+}
+
+void LinkNodeTest::testErrorExists()
+{
+  m_application->sendShellCommand("ln /file.txt /file.txt");
+  const auto response = m_application->waitShellResponse();
+  const auto result = TestApplication::responseContainsText(response, "node already exists");
+  CPPUNIT_ASSERT(result == true);
+
+  m_application->sendShellCommand("getenv ?");
+  const auto returnValue = m_application->waitShellResponse();
+  const auto returnValueFound = TestApplication::responseContainsText(returnValue, std::to_string(E_EXIST));
+  CPPUNIT_ASSERT(returnValueFound == true);
+}
+
+void LinkNodeTest::testErrorNoNode()
+{
+  m_application->sendShellCommand("ln /undefined /alias.txt");
+  const auto response = m_application->waitShellResponse();
+  const auto result = TestApplication::responseContainsText(response, "node not found");
+  CPPUNIT_ASSERT(result == true);
+
+  m_application->sendShellCommand("getenv ?");
+  const auto returnValue = m_application->waitShellResponse();
+  const auto returnValueFound = TestApplication::responseContainsText(returnValue, std::to_string(E_ENTRY));
+  CPPUNIT_ASSERT(returnValueFound == true);
+}
+
+void LinkNodeTest::testHelpMessage()
+{
+  m_application->sendShellCommand("ln --help");
+  const auto response = m_application->waitShellResponse();
+
+  const auto result = TestApplication::responseContainsText(response, "Usage");
+  CPPUNIT_ASSERT(result == true);
+}
+
+void LinkNodeTest::testLink()
+{
+  m_application->sendShellCommand("ln /file.txt /alias.txt");
+  m_application->waitShellResponse();
+
+  // Data written through the link is visible through the original name
+  m_application->sendShellCommand("echo linked > /alias.txt");
+  m_application->waitShellResponse();
+  CPPUNIT_ASSERT(m_application->readData("/file.txt").find("linked") == 0);
+
+  // Data stays available through the link after removal of the original name
+  m_application->sendShellCommand("rm /file.txt");
+  m_application->waitShellResponse();
+  CPPUNIT_ASSERT(m_application->readData("/alias.txt").find("linked") == 0);
+
+  m_application->sendShellCommand("getenv ?");
+  const auto returnValue = m_application->waitShellResponse();
+  const auto returnValueFound = TestApplication::responseContainsText(returnValue, std::to_string(E_OK));
+  CPPUNIT_ASSERT(returnValueFound == true);
+}
+
+CPPUNIT_TEST_SUITE_REGISTRATION(LinkNodeTest);
+
+int main(int, char *[])
+{
+  CPPUNIT_NS::Test * const suite = CPPUNIT_NS::TestFactoryRegistry::getRegistry().makeTest();
+
+  CppUnit::TextUi::TestRunner runner;
+  runner.addTest(suite);
+
+  const bool sucessful = runner.run();
+  return sucessful ? EXIT_SUCCESS : EXIT_FAILURE;
+}
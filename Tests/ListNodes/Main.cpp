@@ -12,6 +12,7 @@
 #include <cppunit/extensions/TestFactoryRegistry.h>
 #include <cppunit/ui/text/TestRunner.h>
 #include <uv.h>
+#include <string>
 #include <thread>
 
 static void onUvWalk(uv_handle_t *handle, void *)
@@ -50,6 +51,7 @@ class ListNodesTest: public CPPUNIT_NS::TestFixture
   CPPUNIT_TEST(testHelpMessage);
   CPPUNIT_TEST(testHumanReadableSize);
   CPPUNIT_TEST(testListMultipleNodes);
+  CPPUNIT_TEST(testListManyNodes);
   CPPUNIT_TEST(testNodeSize);
   CPPUNIT_TEST_SUITE_END();
 
@@ -63,6 +65,7 @@ public:
   void testHelpMessage();
   void testHumanReadableSize();
   void testListMultipleNodes();
+  void testListManyNodes();
   void testNodeSize();
 
 private:
@@ -92,6 +95,10 @@ void ListNodesTest::setUp()
 
   m_application->makeDataNode("/test.bin", 1572864, 'A');
 
+  // Root directory does not fit into a single batch of node attributes
+  for (size_t i = 0; i < 40; ++i)
+    m_application->makeDataNode(("/node_" + std::to_string(i)).c_str(), i, 'B');
+
   m_loopThread = new std::thread{TestApplication::runEventLoop, m_loop};
   m_appThread = new std::thread{TestApplication::runShell, m_application};
 
@@ -177,6 +184,23 @@ void ListNodesTest::testListMultipleNodes()
   CPPUNIT_ASSERT(result2 == true);
 }
 
+void ListNodesTest::testListManyNodes()
+{
+  m_application->sendShellCommand("ls -l /");
+  const auto response = m_application->waitShellResponse();
+
+  for (size_t i = 0; i < 40; ++i)
+  {
+    const auto result = TestApplication::responseContainsText(response, "node_" + std::to_string(i));
+    CPPUNIT_ASSERT(result == true);
+  }
+
+  m_application->sendShellCommand("getenv ?");
+  const auto returnValue = m_application->waitShellResponse();
+  const auto returnValueFound = TestApplication::responseContainsText(returnValue, std::to_string(E_OK));
+  CPPUNIT_ASSERT(returnValueFound == true);
+}
+
 void ListNodesTest::testNodeSize()
 {
   m_application->sendShellCommand("ls -l");
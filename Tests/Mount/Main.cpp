@@ -12,12 +12,15 @@
 #include "Shell/Scripts/ListNodesScript.hpp"
 #include "Shell/Scripts/MountScript.hpp"
 #include "Shell/Scripts/RemoveNodesScript.hpp"
+#include "Shell/Scripts/SyncScript.hpp"
 #include <yaf/utils.h>
 #include <cppunit/CompilerOutputter.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include <cppunit/extensions/TestFactoryRegistry.h>
 #include <cppunit/ui/text/TestRunner.h>
 #include <uv.h>
+#include <algorithm>
+#include <cstring>
 #include <thread>
 
 static void onUvWalk(uv_handle_t *handle, void *)
@@ -47,12 +50,15 @@ public:
     m_initializer.attach<ListNodesScript>();
     m_initializer.attach<MountScript<>>();
     m_initializer.attach<RemoveNodesScript>();
+    m_initializer.attach<SyncScript>();
   }
 };
 
 class MountTest : public CPPUNIT_NS::TestFixture
 {
   CPPUNIT_TEST_SUITE(MountTest);
+  CPPUNIT_TEST(testBind);
+  CPPUNIT_TEST(testErrorBindData);
   CPPUNIT_TEST(testErrorIncorrectArguments);
   CPPUNIT_TEST(testErrorNoDestination);
   CPPUNIT_TEST(testErrorNoInterface);
@@ -62,12 +68,15 @@ class MountTest : public CPPUNIT_NS::TestFixture
   CPPUNIT_TEST(testMount);
   CPPUNIT_TEST(testNodes);
   CPPUNIT_TEST(testVirtualMem);
+  CPPUNIT_TEST(testWriteBack);
   CPPUNIT_TEST_SUITE_END();
 
 public:
   void setUp();
   void tearDown();
 
+  void testBind();
+  void testErrorBindData();
   void testErrorIncorrectArguments();
   void testErrorNoDestination();
   void testErrorNoInterface();
@@ -77,6 +86,7 @@ public:
   void testMount();
   void testNodes();
   void testVirtualMem();
+  void testWriteBack();
 
 private:
   static constexpr size_t PARTITION_SIZE{1024 * 1024};
@@ -131,6 +141,76 @@ void MountTest::tearDown()
   deinit(m_mem);
 }
 
+void MountTest::testBind()
+{
+  static const Fat32FsConfig makeFsConfig = {
+      1024,  // cluster
+      0,     // reserved
+      2,     // tables
+      "TEST" // label
+  };
+
+  std::vector<std::string> response;
+  Result res;
+  bool ok;
+
+  res = fat32MakeFs(m_mem, &makeFsConfig, nullptr, 0);
+  CPPUNIT_ASSERT(res == E_OK);
+
+  VfsNode * const virtualMemNode = new InterfaceNode<>{m_mem};
+  CPPUNIT_ASSERT(virtualMemNode != nullptr);
+  m_application->injectNode(virtualMemNode, "/dev/mem");
+
+  m_application->sendShellCommand("mount /dev/mem /mnt");
+  m_application->waitShellResponse();
+  m_application->sendShellCommand("mount --bind /mnt /view");
+  m_application->waitShellResponse();
+
+  // Nodes created through the bound directory belong to the mounted file system
+  m_application->sendShellCommand("echo test > /view/TEST.TXT");
+  m_application->waitShellResponse();
+
+  m_application->sendShellCommand("ls /mnt");
+  response = m_application->waitShellResponse();
+  ok = TestApplication::responseContainsText(response, "TEST.TXT");
+  CPPUNIT_ASSERT(ok == true);
+
+  m_application->sendShellCommand("rm /view/TEST.TXT");
+  m_application->waitShellResponse();
+
+  m_application->sendShellCommand("ls /mnt");
+  response = m_application->waitShellResponse();
+  ok = TestApplication::responseContainsText(response, "node has no descendants");
+  CPPUNIT_ASSERT(ok == true);
+
+  // Removal of the bound directory keeps the mountpoint
+  m_application->sendShellCommand("rm -r /view");
+  m_application->waitShellResponse();
+
+  m_application->sendShellCommand("ls /");
+  response = m_application->waitShellResponse();
+  ok = TestApplication::responseContainsText(response, "view");
+  CPPUNIT_ASSERT(ok == false);
+  ok = TestApplication::responseContainsText(response, "mnt");
+  CPPUNIT_ASSERT(ok == true);
+}
+
+void MountTest::testErrorBindData()
+{
+  m_application->sendShellCommand("echo test > /file");
+  m_application->waitShellResponse();
+
+  m_application->sendShellCommand("mount --bind /file /view");
+  const auto response = m_application->waitShellResponse();
+  const auto result = TestApplication::responseContainsText(response, "not a directory");
+  CPPUNIT_ASSERT(result == true);
+
+  m_application->sendShellCommand("getenv ?");
+  const auto returnValue = m_application->waitShellResponse();
+  const auto returnValueFound = TestApplication::responseContainsText(returnValue, std::to_string(E_VALUE));
+  CPPUNIT_ASSERT(returnValueFound == true);
+}
+
 void MountTest::testErrorIncorrectArguments()
 {
   m_application->sendShellCommand("mount");
@@ -324,6 +404,63 @@ void MountTest::testVirtualMem()
   deinit(proxy);
 }
 
+void MountTest::testWriteBack()
+{
+  static const Fat32FsConfig makeFsConfig = {
+      1024,  // cluster
+      0,     // reserved
+      2,     // tables
+      "TEST" // label
+  };
+  static const char text[] = "cached";
+
+  std::vector<std::string> response;
+  Result res;
+  bool ok;
+
+  res = fat32MakeFs(m_mem, &makeFsConfig, nullptr, 0);
+  CPPUNIT_ASSERT(res == E_OK);
+
+  VfsNode * const virtualMemNode = new InterfaceNode<>{m_mem};
+  CPPUNIT_ASSERT(virtualMemNode != nullptr);
+  m_application->injectNode(virtualMemNode, "/dev/mem");
+
+  // Malformed cache sizes are rejected before the device is opened
+  m_application->sendShellCommand("mount --cache 32k /dev/mem /mnt");
+  response = m_application->waitShellResponse();
+  ok = TestApplication::responseContainsText(response, "invalid cache size");
+  CPPUNIT_ASSERT(ok == true);
+
+  m_application->sendShellCommand("mount --cache -1 /dev/mem /mnt");
+  response = m_application->waitShellResponse();
+  ok = TestApplication::responseContainsText(response, "invalid cache size");
+  CPPUNIT_ASSERT(ok == true);
+
+  m_application->sendShellCommand("mount --cache 32 --write-back /dev/mem /mnt");
+  m_application->waitShellResponse();
+
+  m_application->sendShellCommand("echo cached > /mnt/TEST.TXT");
+  m_application->waitShellResponse();
+
+  m_application->sendShellCommand("ls /mnt");
+  response = m_application->waitShellResponse();
+  ok = TestApplication::responseContainsText(response, "TEST.TXT");
+  CPPUNIT_ASSERT(ok == true);
+
+  // Modified sectors reach the device after synchronization
+  m_application->sendShellCommand("sync");
+  m_application->waitShellResponse();
+
+  m_application->sendShellCommand("getenv ?");
+  response = m_application->waitShellResponse();
+  ok = TestApplication::responseContainsText(response, std::to_string(E_OK));
+  CPPUNIT_ASSERT(ok == true);
+
+  const uint8_t * const arena = reinterpret_cast<class VirtualMem *>(m_mem)->arena();
+  const uint8_t * const position = std::search(arena, arena + PARTITION_SIZE, text, text + strlen(text));
+  CPPUNIT_ASSERT(position != arena + PARTITION_SIZE);
+}
+
 CPPUNIT_TEST_SUITE_REGISTRATION(MountTest);
 
 int main(int, char *[])
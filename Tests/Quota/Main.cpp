@@ -0,0 +1,210 @@
+/*
+ * Main.cpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "TestApplication.hpp"
+#include "Shell/Scripts/EchoScript.hpp"
+#include "Shell/Scripts/GetEnvScript.hpp"
+#include "Shell/Scripts/ListNodesScript.hpp"
+#include "Shell/Scripts/MakeDirectoryScript.hpp"
+#include "Shell/Scripts/PrintRawDataScript.hpp"
+#include "Shell/Scripts/QuotaScript.hpp"
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include <uv.h>
+#include <thread>
+
+static void onUvWalk(uv_handle_t *handle, void *)
+{
+  deinit(uv_handle_get_data(handle));
+}
+
+static void onSignalReceived(void *argument)
+{
+  uv_walk(static_cast<uv_loop_t *>(argument), onUvWalk, 0);
+}
+
+class TestQuotaApplication: public TestApplication
+{
+public:
+  TestQuotaApplication(Interface *client, Interface *host) :
+    TestApplication{client, host}
+  {
+  }
+
+  void bootstrap() override
+  {
+    TestApplication::bootstrap();
+
+    m_initializer.attach<EchoScript>();
+    m_initializer.attach<GetEnvScript>();
+    m_initializer.attach<ListNodesScript>();
+    m_initializer.attach<MakeDirectoryScript>();
+    m_initializer.attach<PrintRawDataScript<BUFFER_SIZE>>();
+    m_initializer.attach<QuotaScript>();
+  }
+
+private:
+  static constexpr size_t BUFFER_SIZE{1024};
+};
+
+class QuotaTest: public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE(QuotaTest);
+  CPPUNIT_TEST(testErrorIncorrectArguments);
+  CPPUNIT_TEST(testErrorNoNode);
+  CPPUNIT_TEST(testHelpMessage);
+  CPPUNIT_TEST(testNodeLimit);
+  CPPUNIT_TEST(testSizeLimit);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp();
+  void tearDown();
+
+  void testErrorIncorrectArguments();
+  void testErrorNoNode();
+  void testHelpMessage();
+  void testNodeLimit();
+  void testSizeLimit();
+
+private:
+  uv_loop_t *m_loop{nullptr};
+  Interrupt *m_listener{nullptr};
+  Interface *m_appInterface{nullptr};
+  Interface *m_testInterface{nullptr};
+  TestApplication *m_application{nullptr};
+
+  std::thread *m_appThread{nullptr};
+  std::thread *m_loopThread{nullptr};
+};
+
+void QuotaTest::setUp()
+{
+  m_loop = uv_default_loop();
+  CPPUNIT_ASSERT(m_loop != nullptr);
+
+  m_listener = TestApplication::makeSignalListener(SIGUSR1, onSignalReceived, m_loop);
+  CPPUNIT_ASSERT(m_listener != nullptr);
+  m_appInterface = TestApplication::makeUdpInterface("127.0.0.1", 8000, 8001);
+  CPPUNIT_ASSERT(m_appInterface != nullptr);
+  m_testInterface = TestApplication::makeUdpInterface("127.0.0.1", 8001, 8000);
+  CPPUNIT_ASSERT(m_testInterface != nullptr);
+
+  m_application = new TestQuotaApplication(m_appInterface, m_testInterface);
+
+  m_loopThread = new std::thread{TestApplication::runEventLoop, m_loop};
+  m_appThread = new std::thread{TestApplication::runShell, m_application};
+
+  m_application->waitShellResponse();
+}
+
+void QuotaTest::tearDown()
+{
+  m_application->sendShellCommand("exit");
+
+  m_appThread->join();
+  delete m_appThread;
+
+  m_loopThread->join();
+  delete m_loopThread;
+}
+
+void QuotaTest::testErrorIncorrectArguments()
+{
+  m_application->sendShellCommand("quota");
+  m_application->waitShellResponse();
+
+  m_application->sendShellCommand("getenv ?");
+  const auto returnValue = m_application->waitShellResponse();
+  const auto returnValueFound = TestApplication::responseContainsText(returnValue, std::to_string(E_VALUE));
+  CPPUNIT_ASSERT(returnValueFound == true);
+}
+
+void QuotaTest::testErrorNoNode()
+{
+  m_application->sendShellCommand("quota /undefined");
+  const auto response = m_application->waitShellResponse();
+  const auto result = TestApplication::responseContainsText(response, "node not found");
+  CPPUNIT_ASSERT(result == true);
+
+  m_application->sendShellCommand("getenv ?");
+  const auto returnValue = m_application->waitShellResponse();
+  const auto returnValueFound = TestApplication::responseContainsText(returnValue, std::to_string(E_ENTRY));
+  CPPUNIT_ASSERT(returnValueFound == true);
+}
+
+void QuotaTest::testHelpMessage()
+{
+  m_application->sendShellCommand("quota --help");
+  const auto response = m_application->waitShellResponse();
+
+  const auto result = TestApplication::responseContainsText(response, "Usage");
+  CPPUNIT_ASSERT(result == true);
+}
+
+void QuotaTest::testNodeLimit()
+{
+  m_application->sendShellCommand("mkdir /test");
+  m_application->waitShellResponse();
+  m_application->sendShellCommand("quota --nodes 2 /test");
+  m_application->waitShellResponse();
+
+  m_application->sendShellCommand("mkdir /test/a");
+  m_application->waitShellResponse();
+  m_application->sendShellCommand("mkdir /test/b");
+  m_application->waitShellResponse();
+
+  m_application->sendShellCommand("getenv ?");
+  const auto returnValue = m_application->waitShellResponse();
+  const auto returnValueFound = TestApplication::responseContainsText(returnValue, std::to_string(E_OK));
+  CPPUNIT_ASSERT(returnValueFound == false);
+
+  m_application->sendShellCommand("quota /test");
+  const auto response = m_application->waitShellResponse();
+  const auto result = TestApplication::responseContainsText(response, "2 nodes of 2");
+  CPPUNIT_ASSERT(result == true);
+}
+
+void QuotaTest::testSizeLimit()
+{
+  m_application->sendShellCommand("mkdir /test");
+  m_application->waitShellResponse();
+  m_application->sendShellCommand("quota --size 64 /test");
+  m_application->waitShellResponse();
+
+  m_application->sendShellCommand("echo 0123456789 > /test/a.txt");
+  m_application->waitShellResponse();
+
+  m_application->sendShellCommand("quota /test");
+  const auto responseA = m_application->waitShellResponse();
+  const auto resultA = TestApplication::responseContainsText(responseA, "of 64");
+  CPPUNIT_ASSERT(resultA == true);
+
+  // Output over the limit is rejected
+  m_application->sendShellCommand("echo 0123456789012345678901234567890123456789012345678901234567890123456789"
+      " > /test/b.txt");
+  m_application->waitShellResponse();
+
+  m_application->sendShellCommand("cat /test/b.txt");
+  const auto responseB = m_application->waitShellResponse();
+  const auto resultB = TestApplication::responseContainsText(responseB, "0123456789012345678901234567890123456789");
+  CPPUNIT_ASSERT(resultB == false);
+}
+
+CPPUNIT_TEST_SUITE_REGISTRATION(QuotaTest);
+
+int main(int, char *[])
+{
+  CPPUNIT_NS::Test * const suite = CPPUNIT_NS::TestFactoryRegistry::getRegistry().makeTest();
+
+  CppUnit::TextUi::TestRunner runner;
+  runner.addTest(suite);
+
+  const bool sucessful = runner.run();
+  return sucessful ? EXIT_SUCCESS : EXIT_FAILURE;
+}
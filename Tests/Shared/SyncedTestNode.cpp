@@ -18,6 +18,12 @@ void SyncedTestNode::post()
   m_sem.post();
 }
 
+Result SyncedTestNode::map(FsLength, Mapping *)
+{
+  // Data reads are intercepted, mapping would bypass the callback
+  return E_INVALID;
+}
+
 Result SyncedTestNode::read(FsFieldType type, FsLength position, void *buffer, size_t length, size_t *read)
 {
   Result res = E_OK;
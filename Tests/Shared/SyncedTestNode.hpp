@@ -17,6 +17,7 @@ public:
   SyncedTestNode(std::function<Result ()> = nullptr);
   void post();
 
+  virtual Result map(FsLength, Mapping *) override;
   virtual Result read(FsFieldType, FsLength, void *, size_t, size_t *) override;
 
 private:
@@ -13,7 +13,7 @@ static const InterfaceClass virtualMemTable = {
     VirtualMem::init,          // init
     VirtualMem::deinit,        // deinit
 
-    nullptr,                   // setCallback
+    VirtualMem::setCallback,   // setCallback
     VirtualMem::getParam,      // getParam
     VirtualMem::setParam,      // setParam
     VirtualMem::read,          // read
@@ -38,6 +38,15 @@ VirtualMem::~VirtualMem()
 {
 }
 
+void VirtualMem::finish()
+{
+  CPPUNIT_ASSERT(m_pending);
+  m_pending = false;
+
+  if (m_callback != nullptr)
+    m_callback(m_callbackArgument);
+}
+
 Result VirtualMem::getParamImpl(int parameter, void *data)
 {
   switch (static_cast<IfParameter>(parameter))
@@ -51,7 +60,7 @@ Result VirtualMem::getParamImpl(int parameter, void *data)
       return E_OK;
 
     case IF_STATUS:
-      return E_OK;
+      return m_pending ? E_BUSY : E_OK;
 
     default:
       return E_INVALID;
@@ -81,6 +90,17 @@ Result VirtualMem::setParamImpl(int parameter, const void *data)
     case IF_RELEASE:
       return E_OK;
 
+    case IF_BLOCKING:
+      m_zerocopy = false;
+      return E_OK;
+
+    case IF_ZEROCOPY:
+      if (!m_zerocopyAllowed)
+        return E_INVALID;
+
+      m_zerocopy = true;
+      return E_OK;
+
     default:
       return E_INVALID;
   }
@@ -88,16 +108,22 @@ Result VirtualMem::setParamImpl(int parameter, const void *data)
 
 size_t VirtualMem::readImpl(void *buffer, size_t length)
 {
+  CPPUNIT_ASSERT(!m_pending);
+
   memcpy(buffer, m_data.get() + m_position, length);
   m_position += length;
+  m_pending = m_zerocopy;
 
   return length;
 }
 
 size_t VirtualMem::writeImpl(const void *buffer, size_t length)
 {
+  CPPUNIT_ASSERT(!m_pending);
+
   memcpy(m_data.get() + m_position, buffer, length);
   m_position += length;
+  m_pending = m_zerocopy;
 
   return length;
 }
@@ -39,6 +39,12 @@ public:
     static_cast<VirtualMem *>(object)->~VirtualMem();
   }
 
+  static void setCallback(void *object, void (*callback)(void *), void *argument)
+  {
+    static_cast<VirtualMem *>(object)->m_callback = callback;
+    static_cast<VirtualMem *>(object)->m_callbackArgument = argument;
+  }
+
   static Result getParam(void *object, int parameter, void *data)
   {
     return static_cast<VirtualMem *>(object)->getParamImpl(parameter, data);
@@ -64,6 +70,20 @@ public:
     return m_data.get();
   }
 
+  // Zero-copy mode is rejected by default, transfers are finished by the test
+  void allowZerocopy()
+  {
+    m_zerocopyAllowed = true;
+  }
+
+  // Finish a transfer started in zero-copy mode
+  void finish();
+
+  bool pending() const
+  {
+    return m_pending;
+  }
+
 private:
   Interface m_base;
 
@@ -71,6 +91,13 @@ private:
   size_t m_position{0};
   size_t m_size;
 
+  // In zero-copy mode data is copied immediately, completion is reported by finish()
+  void (*m_callback)(void *){nullptr};
+  void *m_callbackArgument{nullptr};
+  bool m_pending{false};
+  bool m_zerocopy{false};
+  bool m_zerocopyAllowed{false};
+
   VirtualMem(size_t);
   ~VirtualMem();
 
@@ -0,0 +1,199 @@
+/*
+ * Main.cpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "TestApplication.hpp"
+#include "Shell/ShellHelpers.hpp"
+#include "Shell/Scripts/GetEnvScript.hpp"
+#include "Shell/Scripts/TailScript.hpp"
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include <uv.h>
+#include <cstring>
+#include <thread>
+
+static void onUvWalk(uv_handle_t *handle, void *)
+{
+  deinit(uv_handle_get_data(handle));
+}
+
+static void onSignalReceived(void *argument)
+{
+  uv_walk(static_cast<uv_loop_t *>(argument), onUvWalk, 0);
+}
+
+class TestTailApplication: public TestApplication
+{
+public:
+  TestTailApplication(Interface *client, Interface *host) :
+    TestApplication{client, host}
+  {
+  }
+
+  void appendData(const char *path, const char *text)
+  {
+    FsNode * const node = ShellHelpers::openNode(m_filesystem.get(), path);
+    CPPUNIT_ASSERT(node != nullptr);
+
+    FsLength length;
+    Result res;
+
+    res = fsNodeLength(node, FS_NODE_DATA, &length);
+    CPPUNIT_ASSERT(res == E_OK);
+    res = fsNodeWrite(node, FS_NODE_DATA, length, text, strlen(text), nullptr);
+    CPPUNIT_ASSERT(res == E_OK);
+
+    fsNodeFree(node);
+  }
+
+  void bootstrap() override
+  {
+    TestApplication::bootstrap();
+
+    m_initializer.attach<GetEnvScript>();
+    m_initializer.attach<TailScript<BUFFER_SIZE>>();
+  }
+};
+
+class TailTest: public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE(TailTest);
+  CPPUNIT_TEST(testErrorNoNode);
+  CPPUNIT_TEST(testFollow);
+  CPPUNIT_TEST(testHelpMessage);
+  CPPUNIT_TEST(testLastLines);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp();
+  void tearDown();
+
+  void testErrorNoNode();
+  void testFollow();
+  void testHelpMessage();
+  void testLastLines();
+
+private:
+  uv_loop_t *m_loop{nullptr};
+  Interrupt *m_listener{nullptr};
+  Interface *m_appInterface{nullptr};
+  Interface *m_testInterface{nullptr};
+  TestTailApplication *m_application{nullptr};
+
+  std::thread *m_appThread{nullptr};
+  std::thread *m_loopThread{nullptr};
+};
+
+void TailTest::setUp()
+{
+  m_loop = uv_default_loop();
+  CPPUNIT_ASSERT(m_loop != nullptr);
+
+  m_listener = TestApplication::makeSignalListener(SIGUSR1, onSignalReceived, m_loop);
+  CPPUNIT_ASSERT(m_listener != nullptr);
+  m_appInterface = TestApplication::makeUdpInterface("127.0.0.1", 8000, 8001);
+  CPPUNIT_ASSERT(m_appInterface != nullptr);
+  m_testInterface = TestApplication::makeUdpInterface("127.0.0.1", 8001, 8000);
+  CPPUNIT_ASSERT(m_testInterface != nullptr);
+
+  m_application = new TestTailApplication(m_appInterface, m_testInterface);
+
+  std::string text;
+
+  for (size_t i = 1; i <= 12; ++i)
+    text += "row " + std::to_string(i) + "\n";
+
+  m_application->makeDataNode("/log.txt", text.c_str());
+
+  m_loopThread = new std::thread{TestApplication::runEventLoop, m_loop};
+  m_appThread = new std::thread{TestApplication::runShell, m_application};
+
+  m_application->waitShellResponse();
+}
+
+void TailTest::tearDown()
+{
+  m_application->sendShellCommand("exit");
+
+  m_appThread->join();
+  delete m_appThread;
+
+  m_loopThread->join();
+  delete m_loopThread;
+}
+
+void TailTest::testErrorNoNode()
+{
+  m_application->sendShellCommand("tail /undefined");
+  const auto response = m_application->waitShellResponse();
+  const auto result = TestApplication::responseContainsText(response, "node not found");
+  CPPUNIT_ASSERT(result == true);
+
+  m_application->sendShellCommand("getenv ?");
+  const auto returnValue = m_application->waitShellResponse();
+  const auto returnValueFound = TestApplication::responseContainsText(returnValue, std::to_string(E_ENTRY));
+  CPPUNIT_ASSERT(returnValueFound == true);
+}
+
+void TailTest::testFollow()
+{
+  m_application->sendShellCommand("tail -n 1 -f /log.txt");
+  const auto response0 = m_application->waitShellResponse();
+  CPPUNIT_ASSERT(TestApplication::responseContainsText(response0, "row 12") == true);
+  CPPUNIT_ASSERT(TestApplication::responseContainsText(response0, "row 11") == false);
+
+  // Appended data is printed as soon as it is written
+  m_application->appendData("/log.txt", "row 13\n");
+  const auto response1 = m_application->waitShellResponse();
+  CPPUNIT_ASSERT(TestApplication::responseContainsText(response1, "row 13") == true);
+  CPPUNIT_ASSERT(TestApplication::responseContainsText(response1, "row 12") == false);
+
+  // Command is stopped by the end of text symbol
+  m_application->sendShellBuffer("\x03", 1);
+  m_application->waitShellResponse();
+
+  m_application->sendShellCommand("getenv ?");
+  const auto returnValue = m_application->waitShellResponse();
+  const auto returnValueFound = TestApplication::responseContainsText(returnValue, std::to_string(E_OK));
+  CPPUNIT_ASSERT(returnValueFound == true);
+}
+
+void TailTest::testHelpMessage()
+{
+  m_application->sendShellCommand("tail --help");
+  const auto response = m_application->waitShellResponse();
+
+  const auto result = TestApplication::responseContainsText(response, "Usage");
+  CPPUNIT_ASSERT(result == true);
+}
+
+void TailTest::testLastLines()
+{
+  m_application->sendShellCommand("tail /log.txt");
+  const auto response0 = m_application->waitShellResponse();
+  CPPUNIT_ASSERT(TestApplication::responseContainsText(response0, "row 3") == true);
+  CPPUNIT_ASSERT(TestApplication::responseContainsText(response0, "row 12") == true);
+  CPPUNIT_ASSERT(TestApplication::responseContainsText(response0, "row 2") == false);
+
+  m_application->sendShellCommand("tail -n 2 /log.txt");
+  const auto response1 = m_application->waitShellResponse();
+  CPPUNIT_ASSERT(TestApplication::responseContainsText(response1, "row 11") == true);
+  CPPUNIT_ASSERT(TestApplication::responseContainsText(response1, "row 10") == false);
+}
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TailTest);
+
+int main(int, char *[])
+{
+  CPPUNIT_NS::Test * const suite = CPPUNIT_NS::TestFactoryRegistry::getRegistry().makeTest();
+
+  CppUnit::TextUi::TestRunner runner;
+  runner.addTest(suite);
+
+  const bool sucessful = runner.run();
+  return sucessful ? EXIT_SUCCESS : EXIT_FAILURE;
+}
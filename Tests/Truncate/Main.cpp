@@ -0,0 +1,242 @@
+/*
+ * Main.cpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "TestApplication.hpp"
+#include "Shell/Scripts/AllocateNodeScript.hpp"
+#include "Shell/Scripts/EchoScript.hpp"
+#include "Shell/Scripts/GetEnvScript.hpp"
+#include "Shell/Scripts/ListNodesScript.hpp"
+#include "Shell/Scripts/PrintRawDataScript.hpp"
+#include "Shell/Scripts/TruncateNodeScript.hpp"
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include <uv.h>
+#include <thread>
+
+static void onUvWalk(uv_handle_t *handle, void *)
+{
+  deinit(uv_handle_get_data(handle));
+}
+
+static void onSignalReceived(void *argument)
+{
+  uv_walk(static_cast<uv_loop_t *>(argument), onUvWalk, 0);
+}
+
+class TestTruncateApplication: public TestApplication
+{
+public:
+  TestTruncateApplication(Interface *client, Interface *host) :
+    TestApplication{client, host}
+  {
+  }
+
+  void bootstrap() override
+  {
+    TestApplication::bootstrap();
+
+    m_initializer.attach<AllocateNodeScript>();
+    m_initializer.attach<EchoScript>();
+    m_initializer.attach<GetEnvScript>();
+    m_initializer.attach<ListNodesScript>();
+    m_initializer.attach<PrintRawDataScript<BUFFER_SIZE>>();
+    m_initializer.attach<TruncateNodeScript>();
+  }
+
+private:
+  static constexpr size_t BUFFER_SIZE{1024};
+};
+
+class TruncateTest: public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE(TruncateTest);
+  CPPUNIT_TEST(testAllocation);
+  CPPUNIT_TEST(testErrorIncorrectArguments);
+  CPPUNIT_TEST(testErrorNoNode);
+  CPPUNIT_TEST(testHelpMessage);
+  CPPUNIT_TEST(testOverwriteTruncation);
+  CPPUNIT_TEST(testTruncation);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp();
+  void tearDown();
+
+  void testAllocation();
+  void testErrorIncorrectArguments();
+  void testErrorNoNode();
+  void testHelpMessage();
+  void testOverwriteTruncation();
+  void testTruncation();
+
+private:
+  uv_loop_t *m_loop{nullptr};
+  Interrupt *m_listener{nullptr};
+  Interface *m_appInterface{nullptr};
+  Interface *m_testInterface{nullptr};
+  TestApplication *m_application{nullptr};
+
+  std::thread *m_appThread{nullptr};
+  std::thread *m_loopThread{nullptr};
+};
+
+void TruncateTest::setUp()
+{
+  m_loop = uv_default_loop();
+  CPPUNIT_ASSERT(m_loop != nullptr);
+
+  m_listener = TestApplication::makeSignalListener(SIGUSR1, onSignalReceived, m_loop);
+  CPPUNIT_ASSERT(m_listener != nullptr);
+  m_appInterface = TestApplication::makeUdpInterface("127.0.0.1", 8000, 8001);
+  CPPUNIT_ASSERT(m_appInterface != nullptr);
+  m_testInterface = TestApplication::makeUdpInterface("127.0.0.1", 8001, 8000);
+  CPPUNIT_ASSERT(m_testInterface != nullptr);
+
+  m_application = new TestTruncateApplication(m_appInterface, m_testInterface);
+
+  m_loopThread = new std::thread{TestApplication::runEventLoop, m_loop};
+  m_appThread = new std::thread{TestApplication::runShell, m_application};
+
+  m_application->waitShellResponse();
+}
+
+void TruncateTest::tearDown()
+{
+  m_application->sendShellCommand("exit");
+
+  m_appThread->join();
+  delete m_appThread;
+
+  m_loopThread->join();
+  delete m_loopThread;
+}
+
+void TruncateTest::testAllocation()
+{
+  m_application->sendShellCommand("echo 0123456789 > /test.txt");
+  m_application->waitShellResponse();
+
+  m_application->sendShellCommand("fallocate -l 65536 /test.txt");
+  m_application->waitShellResponse();
+
+  m_application->sendShellCommand("getenv ?");
+  const auto returnValue = m_application->waitShellResponse();
+  const auto returnValueFound = TestApplication::responseContainsText(returnValue, std::to_string(E_OK));
+  CPPUNIT_ASSERT(returnValueFound == true);
+
+  // Length of the node is not changed, echo appends a line terminator
+  m_application->sendShellCommand("ls -l /");
+  const auto response = m_application->waitShellResponse();
+  const auto result = TestApplication::responseContainsText(response, " 12 ");
+  CPPUNIT_ASSERT(result == true);
+}
+
+void TruncateTest::testErrorIncorrectArguments()
+{
+  m_application->sendShellCommand("truncate /test.txt");
+  const auto response = m_application->waitShellResponse();
+  const auto result = TestApplication::responseContainsText(response, "missing size operand");
+  CPPUNIT_ASSERT(result == true);
+
+  m_application->sendShellCommand("getenv ?");
+  const auto returnValue = m_application->waitShellResponse();
+  const auto returnValueFound = TestApplication::responseContainsText(returnValue, std::to_string(E_VALUE));
+  CPPUNIT_ASSERT(returnValueFound == true);
+
+  static const char * const INVALID_COMMANDS[] = {
+      "truncate -s 4k /test.txt",
+      "truncate -s -4 /test.txt",
+      "fallocate -l abc /test.txt",
+      "fallocate -l \"\" /test.txt"
+  };
+
+  for (const auto command : INVALID_COMMANDS)
+  {
+    m_application->sendShellCommand(command);
+    const auto invalidResponse = m_application->waitShellResponse();
+    const auto invalidResult = TestApplication::responseContainsText(invalidResponse, "operand");
+    CPPUNIT_ASSERT(invalidResult == true);
+
+    m_application->sendShellCommand("getenv ?");
+    const auto invalidValue = m_application->waitShellResponse();
+    const auto invalidValueFound = TestApplication::responseContainsText(invalidValue, std::to_string(E_VALUE));
+    CPPUNIT_ASSERT(invalidValueFound == true);
+  }
+}
+
+void TruncateTest::testErrorNoNode()
+{
+  m_application->sendShellCommand("truncate -s 0 /undefined");
+  const auto response = m_application->waitShellResponse();
+  const auto result = TestApplication::responseContainsText(response, "node not found");
+  CPPUNIT_ASSERT(result == true);
+
+  m_application->sendShellCommand("getenv ?");
+  const auto returnValue = m_application->waitShellResponse();
+  const auto returnValueFound = TestApplication::responseContainsText(returnValue, std::to_string(E_ENTRY));
+  CPPUNIT_ASSERT(returnValueFound == true);
+}
+
+void TruncateTest::testHelpMessage()
+{
+  m_application->sendShellCommand("truncate --help");
+  const auto responseA = m_application->waitShellResponse();
+  const auto resultA = TestApplication::responseContainsText(responseA, "Usage");
+  CPPUNIT_ASSERT(resultA == true);
+
+  m_application->sendShellCommand("fallocate --help");
+  const auto responseB = m_application->waitShellResponse();
+  const auto resultB = TestApplication::responseContainsText(responseB, "Usage");
+  CPPUNIT_ASSERT(resultB == true);
+}
+
+void TruncateTest::testOverwriteTruncation()
+{
+  m_application->sendShellCommand("echo 0123456789 > /test.txt");
+  m_application->waitShellResponse();
+
+  // Shorter output replaces all data of the node
+  m_application->sendShellCommand("echo abc > /test.txt");
+  m_application->waitShellResponse();
+
+  m_application->sendShellCommand("cat /test.txt");
+  const auto response = m_application->waitShellResponse();
+  const auto resultA = TestApplication::responseContainsText(response, "abc");
+  CPPUNIT_ASSERT(resultA == true);
+  const auto resultB = TestApplication::responseContainsText(response, "456789");
+  CPPUNIT_ASSERT(resultB == false);
+}
+
+void TruncateTest::testTruncation()
+{
+  m_application->sendShellCommand("echo 0123456789 > /test.txt");
+  m_application->waitShellResponse();
+
+  m_application->sendShellCommand("truncate -s 4 /test.txt");
+  m_application->waitShellResponse();
+
+  m_application->sendShellCommand("cat /test.txt");
+  const auto response = m_application->waitShellResponse();
+  const auto resultA = TestApplication::responseContainsText(response, "0123");
+  CPPUNIT_ASSERT(resultA == true);
+  const auto resultB = TestApplication::responseContainsText(response, "456789");
+  CPPUNIT_ASSERT(resultB == false);
+}
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TruncateTest);
+
+int main(int, char *[])
+{
+  CPPUNIT_NS::Test * const suite = CPPUNIT_NS::TestFactoryRegistry::getRegistry().makeTest();
+
+  CppUnit::TextUi::TestRunner runner;
+  runner.addTest(suite);
+
+  const bool sucessful = runner.run();
+  return sucessful ? EXIT_SUCCESS : EXIT_FAILURE;
+}
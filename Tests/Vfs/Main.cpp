@@ -8,12 +8,28 @@
 #include "Vfs/VfsDataNode.hpp"
 #include "Vfs/VfsDirectory.hpp"
 #include "Vfs/VfsHandle.hpp"
+#include "Vfs/VfsImage.hpp"
 #include "Vfs/VfsMountpoint.hpp"
+#include "Vfs/VfsSlab.hpp"
 #include <cppunit/CompilerOutputter.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include <cppunit/extensions/TestFactoryRegistry.h>
 #include <cppunit/ui/text/TestRunner.h>
+#include <algorithm>
 #include <cstring>
+#include <string>
+#include <vector>
+
+class NamedTestNode: public VfsNode
+{
+public:
+  NamedTestNode(const char *name = nullptr) :
+    VfsNode{0, FS_ACCESS_READ}
+  {
+    if (name != nullptr)
+      setStaticName(name);
+  }
+};
 
 class VfsTest: public CPPUNIT_NS::TestFixture
 {
@@ -24,10 +40,29 @@ class VfsTest: public CPPUNIT_NS::TestFixture
   CPPUNIT_TEST(testDataNodeRead);
   CPPUNIT_TEST(testDataNodeReserve);
   CPPUNIT_TEST(testDataNodeWrite);
+  CPPUNIT_TEST(testDataNodeExtents);
+  CPPUNIT_TEST(testDataNodeSparse);
+  CPPUNIT_TEST(testDataNodeClone);
+  CPPUNIT_TEST(testDataNodeMapping);
+  CPPUNIT_TEST(testDataNodeTruncate);
+  CPPUNIT_TEST(testDirectoryIteration);
+  CPPUNIT_TEST(testDirectoryListing);
+  CPPUNIT_TEST(testDirectoryRemovalReclamation);
+  CPPUNIT_TEST(testDirectoryLookup);
+  CPPUNIT_TEST(testDirectoryQuota);
   CPPUNIT_TEST(testHandle);
+  CPPUNIT_TEST(testImage);
+  CPPUNIT_TEST(testInodeTable);
+  CPPUNIT_TEST(testLink);
+  CPPUNIT_TEST(testMountpoint);
   CPPUNIT_TEST(testNodeCreationFailures);
   CPPUNIT_TEST(testNodeDeletionFailures);
   CPPUNIT_TEST(testNodeInjection);
+  CPPUNIT_TEST(testNodeLayout);
+  CPPUNIT_TEST(testPathCache);
+  CPPUNIT_TEST(testProxyPool);
+  CPPUNIT_TEST(testSlabCaches);
+  CPPUNIT_TEST(testWatcher);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -40,10 +75,29 @@ public:
   void testDataNodeRead();
   void testDataNodeReserve();
   void testDataNodeWrite();
+  void testDataNodeExtents();
+  void testDataNodeSparse();
+  void testDataNodeClone();
+  void testDataNodeMapping();
+  void testDataNodeTruncate();
+  void testDirectoryIteration();
+  void testDirectoryListing();
+  void testDirectoryRemovalReclamation();
+  void testDirectoryLookup();
+  void testDirectoryQuota();
   void testHandle();
+  void testImage();
+  void testInodeTable();
+  void testLink();
+  void testMountpoint();
   void testNodeCreationFailures();
   void testNodeDeletionFailures();
   void testNodeInjection();
+  void testNodeLayout();
+  void testPathCache();
+  void testProxyPool();
+  void testSlabCaches();
+  void testWatcher();
 
 private:
   static constexpr size_t BUFFER_SIZE{1024};
@@ -352,136 +406,1928 @@ void VfsTest::testDataNodeWrite()
   delete node;
 }
 
-void VfsTest::testHandle()
+void VfsTest::testDataNodeExtents()
 {
-  const Result res = fsHandleSync(handle);
+  static constexpr size_t DATA_LENGTH{VfsDataNode::EXTENT_THRESHOLD + VfsDataNode::EXTENT_SIZE / 2};
+
+  VfsDataNode * const node = new VfsDataNode{};
+  CPPUNIT_ASSERT(node != nullptr);
+
+  std::vector<uint8_t> pattern(DATA_LENGTH);
+  std::vector<uint8_t> buffer(DATA_LENGTH);
+  size_t length;
+  Result res;
+
+  for (size_t i = 0; i < pattern.size(); ++i)
+    pattern[i] = static_cast<uint8_t>(i * 7 + i / 256);
+
+  // Small file is stored in a contiguous buffer
+  res = node->write(FS_NODE_DATA, 0, pattern.data(), 16, &length);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(length == 16);
+  CPPUNIT_ASSERT(node->extents() == false);
+
+  // Append data in pieces not aligned to extent boundaries, extents are used beyond the threshold
+  for (size_t position = 16; position < DATA_LENGTH;)
+  {
+    const size_t chunk = std::min(DATA_LENGTH - position, VfsDataNode::EXTENT_SIZE / 3 + 1);
+
+    res = node->write(FS_NODE_DATA, position, pattern.data() + position, chunk, &length);
+    CPPUNIT_ASSERT(res == E_OK);
+    CPPUNIT_ASSERT(length == chunk);
+    position += chunk;
+
+    CPPUNIT_ASSERT(node->extents() == (position > VfsDataNode::EXTENT_THRESHOLD));
+  }
+
+  FsLength dataLength;
+  res = node->length(FS_NODE_DATA, &dataLength);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(dataLength == DATA_LENGTH);
+
+  res = node->read(FS_NODE_DATA, 0, buffer.data(), buffer.size(), &length);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(length == DATA_LENGTH);
+  CPPUNIT_ASSERT(buffer == pattern);
+
+  // Read across an extent boundary
+  const size_t offset = VfsDataNode::EXTENT_SIZE - 3;
+  res = node->read(FS_NODE_DATA, offset, buffer.data(), 6, &length);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(length == 6);
+  CPPUNIT_ASSERT(memcmp(buffer.data(), pattern.data() + offset, 6) == 0);
+
+  // Conversion between storage modes keeps the data
+  CPPUNIT_ASSERT(node->setStorage(VfsDataNode::STORAGE_CONTIGUOUS) == true);
+  CPPUNIT_ASSERT(node->extents() == false);
+  std::fill(buffer.begin(), buffer.end(), 0);
+  res = node->read(FS_NODE_DATA, 0, buffer.data(), buffer.size(), &length);
   CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(buffer == pattern);
+
+  CPPUNIT_ASSERT(node->setStorage(VfsDataNode::STORAGE_EXTENTS) == true);
+  CPPUNIT_ASSERT(node->extents() == true);
+  std::fill(buffer.begin(), buffer.end(), 0);
+  res = node->read(FS_NODE_DATA, 0, buffer.data(), buffer.size(), &length);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(buffer == pattern);
+
+  // Reservation with a pattern in extent mode
+  CPPUNIT_ASSERT(node->reserve(DATA_LENGTH, 'A') == true);
+  res = node->read(FS_NODE_DATA, DATA_LENGTH - 1, buffer.data(), 1, &length);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(length == 1);
+  CPPUNIT_ASSERT(buffer[0] == 'A');
+
+  delete node;
 }
 
-void VfsTest::testNodeCreationFailures()
+void VfsTest::testDataNodeSparse()
 {
-  const FsAccess access = FS_ACCESS_READ | FS_ACCESS_WRITE;
-  const time64_t timestamp = 0;
+  static constexpr size_t HOLE_LENGTH{VfsDataNode::EXTENT_SIZE * 64};
+  static const char PATTERN[] = "pattern";
+
+  std::vector<uint8_t> buffer(VfsDataNode::EXTENT_SIZE * 2);
+  FsLength dataLength;
+  size_t length;
   Result res;
 
-  auto dir = new VfsDirectory{};
-  CPPUNIT_ASSERT(dir != nullptr);
-  auto node = new VfsDataNode{};
+  // Write far past the end of a small node
+  VfsDataNode * const node = new VfsDataNode{};
   CPPUNIT_ASSERT(node != nullptr);
 
-  // Try to create node with incorrect access size
+  res = node->write(FS_NODE_DATA, 0, PATTERN, sizeof(PATTERN), &length);
+  CPPUNIT_ASSERT(res == E_OK);
+  res = node->write(FS_NODE_DATA, HOLE_LENGTH, PATTERN, sizeof(PATTERN), &length);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(length == sizeof(PATTERN));
 
-  const std::array<FsFieldDescriptor, 1> accessSizeTest = {{
-      {
-          &access,
-          0,
-          FS_NODE_ACCESS
-      }
-  }};
-  res = dir->create(accessSizeTest.data(), accessSizeTest.size());
-  CPPUNIT_ASSERT(res == E_VALUE);
+  res = node->length(FS_NODE_DATA, &dataLength);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(dataLength == HOLE_LENGTH + sizeof(PATTERN));
+  CPPUNIT_ASSERT(node->allocated() == VfsDataNode::EXTENT_SIZE * 2);
 
-  // Try to create node with incorrect timestamp size
+  // Holes are read as zeros
+  res = node->read(FS_NODE_DATA, HOLE_LENGTH / 2, buffer.data(), buffer.size(), &length);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(length == buffer.size());
+  CPPUNIT_ASSERT(std::count(buffer.begin(), buffer.end(), 0) == static_cast<ptrdiff_t>(buffer.size()));
 
-  const std::array<FsFieldDescriptor, 1> timeSizeTest = {{
-      {
-          &timestamp,
-          0,
-          FS_NODE_TIME
-      }
-  }};
-  res = dir->create(timeSizeTest.data(), timeSizeTest.size());
-  CPPUNIT_ASSERT(res == E_VALUE);
+  res = node->read(FS_NODE_DATA, HOLE_LENGTH - 1, buffer.data(), buffer.size(), &length);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(length == sizeof(PATTERN) + 1);
+  CPPUNIT_ASSERT(buffer[0] == 0);
+  CPPUNIT_ASSERT(memcmp(buffer.data() + 1, PATTERN, sizeof(PATTERN)) == 0);
 
-  // Try to create node with incorrect name length
+  // Zeros written into a hole do not allocate memory
+  std::fill(buffer.begin(), buffer.end(), 0);
+  res = node->write(FS_NODE_DATA, VfsDataNode::EXTENT_SIZE * 4, buffer.data(), buffer.size(), &length);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(node->allocated() == VfsDataNode::EXTENT_SIZE * 2);
 
-  const std::array<FsFieldDescriptor, 1> nameSizeTest = {{
-      {
-          "",
-          0,
-          FS_NODE_NAME
-      }
+  // Preallocation reserves the extent table only, holes are not filled
+  res = node->preallocate(HOLE_LENGTH * 4);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(node->allocated() == VfsDataNode::EXTENT_SIZE * 2);
+
+  // Long holes take no extents, a clone shares all data until it is modified
+  static constexpr size_t LONG_LENGTH{VfsDataNode::EXTENT_SIZE * 65536};
+
+  res = node->truncate(LONG_LENGTH);
+  CPPUNIT_ASSERT(res == E_OK);
+  res = node->write(FS_NODE_DATA, LONG_LENGTH - sizeof(PATTERN), PATTERN, sizeof(PATTERN), &length);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(node->allocated() == VfsDataNode::EXTENT_SIZE * 3);
+
+  VfsDataNode * const copy = new VfsDataNode{};
+  CPPUNIT_ASSERT(copy != nullptr);
+  copy->clone(*node);
+
+  res = copy->write(FS_NODE_DATA, LONG_LENGTH / 2, PATTERN, sizeof(PATTERN), &length);
+  CPPUNIT_ASSERT(res == E_OK);
+  res = node->truncate(HOLE_LENGTH + sizeof(PATTERN));
+  CPPUNIT_ASSERT(res == E_OK);
+
+  res = node->read(FS_NODE_DATA, 0, buffer.data(), sizeof(PATTERN), &length);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(memcmp(buffer.data(), PATTERN, sizeof(PATTERN)) == 0);
+  res = copy->read(FS_NODE_DATA, LONG_LENGTH - sizeof(PATTERN), buffer.data(), sizeof(PATTERN), &length);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(memcmp(buffer.data(), PATTERN, sizeof(PATTERN)) == 0);
+  res = copy->read(FS_NODE_DATA, LONG_LENGTH / 2, buffer.data(), sizeof(PATTERN), &length);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(memcmp(buffer.data(), PATTERN, sizeof(PATTERN)) == 0);
+  CPPUNIT_ASSERT(copy->allocated() == VfsDataNode::EXTENT_SIZE * 4);
+  CPPUNIT_ASSERT(node->allocated() == VfsDataNode::EXTENT_SIZE * 2);
+
+  delete copy;
+
+  // Zero-filled reservation consists of holes
+  CPPUNIT_ASSERT(node->reserve(HOLE_LENGTH, '\0') == true);
+  CPPUNIT_ASSERT(node->allocated() == 0);
+  res = node->length(FS_NODE_DATA, &dataLength);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(dataLength == HOLE_LENGTH);
+
+  // Gaps in contiguous mode are filled with zeros
+  CPPUNIT_ASSERT(node->setStorage(VfsDataNode::STORAGE_CONTIGUOUS) == true);
+  CPPUNIT_ASSERT(node->reserve(PATTERN) == true);
+  res = node->write(FS_NODE_DATA, sizeof(PATTERN) + 4, PATTERN, sizeof(PATTERN), &length);
+  CPPUNIT_ASSERT(res == E_OK);
+  res = node->read(FS_NODE_DATA, sizeof(PATTERN) - 1, buffer.data(), 6, &length);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(length == 6);
+  CPPUNIT_ASSERT(std::count(buffer.begin(), buffer.begin() + 5, 0) == 5);
+  CPPUNIT_ASSERT(buffer[5] == PATTERN[0]);
+
+  delete node;
+}
+
+void VfsTest::testDataNodeClone()
+{
+  static constexpr size_t DATA_LENGTH{(VfsDataNode::EXTENT_THRESHOLD / VfsDataNode::EXTENT_SIZE + 1)
+      * VfsDataNode::EXTENT_SIZE};
+  static const char PATTERN[] = "pattern";
+
+  std::vector<uint8_t> buffer(DATA_LENGTH);
+  size_t length;
+  Result res;
+
+  // Clone of a small node shares the contiguous buffer
+  VfsDataNode * const small = new VfsDataNode{};
+  CPPUNIT_ASSERT(small != nullptr);
+  CPPUNIT_ASSERT(small->reserve(PATTERN) == true);
+
+  VfsDataNode * const smallCopy = new VfsDataNode{};
+  CPPUNIT_ASSERT(smallCopy != nullptr);
+  smallCopy->clone(*small);
+
+  res = smallCopy->write(FS_NODE_DATA, 0, "P", 1, &length);
+  CPPUNIT_ASSERT(res == E_OK);
+  res = small->read(FS_NODE_DATA, 0, buffer.data(), buffer.size(), &length);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(length == sizeof(PATTERN) - 1);
+  CPPUNIT_ASSERT(buffer[0] == 'p');
+  res = smallCopy->read(FS_NODE_DATA, 0, buffer.data(), buffer.size(), &length);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(length == sizeof(PATTERN) - 1);
+  CPPUNIT_ASSERT(buffer[0] == 'P');
+  CPPUNIT_ASSERT(memcmp(buffer.data() + 1, PATTERN + 1, sizeof(PATTERN) - 2) == 0);
+
+  delete small;
+  delete smallCopy;
+
+  // Clone keeps the storage mode of the source
+  VfsDataNode * const contiguous = new VfsDataNode{};
+  CPPUNIT_ASSERT(contiguous != nullptr);
+  CPPUNIT_ASSERT(contiguous->setStorage(VfsDataNode::STORAGE_CONTIGUOUS) == true);
+  CPPUNIT_ASSERT(contiguous->reserve(DATA_LENGTH, 'c') == true);
+
+  VfsDataNode * const contiguousCopy = new VfsDataNode{};
+  CPPUNIT_ASSERT(contiguousCopy != nullptr);
+  contiguousCopy->clone(*contiguous);
+
+  res = contiguousCopy->write(FS_NODE_DATA, DATA_LENGTH, PATTERN, sizeof(PATTERN), &length);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(contiguousCopy->extents() == false);
+
+  delete contiguous;
+  delete contiguousCopy;
+
+  // Clone of a large node shares extents
+  FsNode * const root = static_cast<FsNode *>(fsHandleRoot(handle));
+  CPPUNIT_ASSERT(root != nullptr);
+
+  const std::array<FsFieldDescriptor, 2> sourceDesc = {{
+      {"source", sizeof("source"), FS_NODE_NAME},
+      {nullptr, 0, FS_NODE_DATA}
   }};
-  res = dir->create(nameSizeTest.data(), nameSizeTest.size());
-  CPPUNIT_ASSERT(res == E_VALUE);
+  res = fsNodeCreate(root, sourceDesc.data(), sourceDesc.size());
+  CPPUNIT_ASSERT(res == E_OK);
 
-  // Try to create node with incorrect node object size
+  FsNode * const source = ShellHelpers::openNode(handle, "/source");
+  CPPUNIT_ASSERT(source != nullptr);
 
-  const std::array<FsFieldDescriptor, 1> objectSizeTest = {{
-      {
-          &node,
-          0,
-          static_cast<FsFieldType>(VfsNode::VFS_NODE_OBJECT)
-      }
+  std::fill(buffer.begin(), buffer.end(), 'A');
+  res = fsNodeWrite(source, FS_NODE_DATA, 0, buffer.data(), buffer.size(), &length);
+  CPPUNIT_ASSERT(res == E_OK);
+
+  const auto extentsBefore = VfsSlab::extentCache().stats().used;
+
+  VfsNode * const origin = VfsNodeProxy::cast(source)->get();
+  const std::array<FsFieldDescriptor, 2> cloneDesc = {{
+      {"clone", sizeof("clone"), FS_NODE_NAME},
+      {&origin, sizeof(origin), static_cast<FsFieldType>(VfsNode::VFS_NODE_CLONE)}
   }};
-  res = dir->create(objectSizeTest.data(), objectSizeTest.size());
-  CPPUNIT_ASSERT(res == E_VALUE);
+  res = fsNodeCreate(root, cloneDesc.data(), cloneDesc.size());
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(VfsSlab::extentCache().stats().used == extentsBefore);
 
-  // Mixed list of descriptors
+  FsNode * const copy = ShellHelpers::openNode(handle, "/clone");
+  CPPUNIT_ASSERT(copy != nullptr);
 
-  const std::array<FsFieldDescriptor, 2> mixedListTest = {{
-      {
-          "test",
-          strlen("test") + 1,
-          FS_NODE_NAME
-      }, {
-          &node,
-          sizeof(node),
-          static_cast<FsFieldType>(VfsNode::VFS_NODE_OBJECT)
-      }
+  FsLength dataLength;
+  res = fsNodeLength(copy, FS_NODE_DATA, &dataLength);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(dataLength == DATA_LENGTH);
+
+  // Modification of the clone copies only the affected extent
+  res = fsNodeWrite(copy, FS_NODE_DATA, VfsDataNode::EXTENT_SIZE + 1, PATTERN, sizeof(PATTERN), &length);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(VfsSlab::extentCache().stats().used == extentsBefore + 1);
+
+  res = fsNodeRead(source, FS_NODE_DATA, 0, buffer.data(), buffer.size(), &length);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(std::count(buffer.begin(), buffer.end(), 'A') == static_cast<ptrdiff_t>(DATA_LENGTH));
+
+  res = fsNodeRead(copy, FS_NODE_DATA, VfsDataNode::EXTENT_SIZE, buffer.data(), sizeof(PATTERN) + 1, &length);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(buffer[0] == 'A');
+  CPPUNIT_ASSERT(memcmp(buffer.data() + 1, PATTERN, sizeof(PATTERN)) == 0);
+
+  // Shared extents stay valid after removal of the source
+  res = fsNodeRemove(root, source);
+  CPPUNIT_ASSERT(res == E_OK);
+  fsNodeFree(source);
+
+  res = fsNodeRead(copy, FS_NODE_DATA, 0, buffer.data(), buffer.size(), &length);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(length == DATA_LENGTH);
+  CPPUNIT_ASSERT(buffer[DATA_LENGTH - 1] == 'A');
+
+  // Directories can not be cloned
+  VfsNode * const directory = VfsNodeProxy::cast(root)->get();
+  const std::array<FsFieldDescriptor, 2> directoryDesc = {{
+      {"directory", sizeof("directory"), FS_NODE_NAME},
+      {&directory, sizeof(directory), static_cast<FsFieldType>(VfsNode::VFS_NODE_CLONE)}
   }};
-  res = dir->create(mixedListTest.data(), mixedListTest.size());
+  res = fsNodeCreate(root, directoryDesc.data(), directoryDesc.size());
   CPPUNIT_ASSERT(res == E_INVALID);
 
-  // Try to create node without name
+  res = fsNodeRemove(root, copy);
+  CPPUNIT_ASSERT(res == E_OK);
+  fsNodeFree(copy);
+  fsNodeFree(root);
 
-  const std::array<FsFieldDescriptor, 1> unnamedNodeTest = {{
-      {
-          &access,
-          sizeof(access),
-          FS_NODE_ACCESS
-      }
+  CPPUNIT_ASSERT(VfsSlab::extentCache().stats().used == extentsBefore - DATA_LENGTH / VfsDataNode::EXTENT_SIZE);
+}
+
+void VfsTest::testDataNodeMapping()
+{
+  static constexpr size_t EXTENT_SIZE{VfsDataNode::EXTENT_SIZE};
+  static constexpr size_t OFFSET{(VfsDataNode::EXTENT_THRESHOLD / EXTENT_SIZE + 1) * EXTENT_SIZE};
+  static const char PATTERN[] = "pattern";
+  static constexpr auto MAP_FIELD = static_cast<FsFieldType>(VfsNode::VFS_NODE_MAP);
+
+  FsNode * const root = static_cast<FsNode *>(fsHandleRoot(handle));
+  CPPUNIT_ASSERT(root != nullptr);
+
+  const std::array<FsFieldDescriptor, 2> desc = {{
+      {"node", sizeof("node"), FS_NODE_NAME},
+      {PATTERN, sizeof(PATTERN) - 1, FS_NODE_DATA}
   }};
-  res = dir->create(unnamedNodeTest.data(), unnamedNodeTest.size());
+  Result res = fsNodeCreate(root, desc.data(), desc.size());
+  CPPUNIT_ASSERT(res == E_OK);
+
+  FsNode * const node = ShellHelpers::openNode(handle, "/node");
+  CPPUNIT_ASSERT(node != nullptr);
+
+  VfsNode::Mapping mapping{nullptr, sizeof(PATTERN), nullptr, nullptr};
+  size_t length;
+
+  // Data of the contiguous buffer is mapped in place
+  res = fsNodeRead(node, MAP_FIELD, 1, &mapping, sizeof(mapping), &length);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(length == sizeof(mapping));
+  CPPUNIT_ASSERT(mapping.length == sizeof(PATTERN) - 2);
+  CPPUNIT_ASSERT(memcmp(mapping.data, PATTERN + 1, mapping.length) == 0);
+
+  // Mapped data is not changed by writes to the node
+  res = fsNodeWrite(node, FS_NODE_DATA, 0, "PATTERN", strlen("PATTERN"), nullptr);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(memcmp(mapping.data, PATTERN + 1, mapping.length) == 0);
+  mapping.unmap(mapping.token);
+
+  // Mapping at the end of data is empty
+  mapping.length = sizeof(PATTERN);
+  res = fsNodeRead(node, MAP_FIELD, sizeof(PATTERN) - 1, &mapping, sizeof(mapping), nullptr);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(mapping.length == 0);
+  mapping.unmap(mapping.token);
+
+  res = fsNodeRead(node, MAP_FIELD, sizeof(PATTERN), &mapping, sizeof(mapping), nullptr);
+  CPPUNIT_ASSERT(res == E_VALUE);
+  res = fsNodeRead(node, MAP_FIELD, 0, &mapping, sizeof(mapping) - 1, nullptr);
   CPPUNIT_ASSERT(res == E_VALUE);
 
-  delete node;
-  delete dir;
+  // Extents are mapped one at a time, mapped ranges are clamped to extent boundaries
+  const std::vector<uint8_t> buffer(EXTENT_SIZE, 'A');
+  res = fsNodeWrite(node, FS_NODE_DATA, OFFSET, buffer.data(), buffer.size(), nullptr);
+  CPPUNIT_ASSERT(res == E_OK);
+
+  mapping.length = EXTENT_SIZE * 2;
+  res = fsNodeRead(node, MAP_FIELD, OFFSET, &mapping, sizeof(mapping), nullptr);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(mapping.length == EXTENT_SIZE);
+  CPPUNIT_ASSERT(memcmp(mapping.data, buffer.data(), buffer.size()) == 0);
+
+  // Holes are mapped as zeros
+  const std::vector<uint8_t> zeros(EXTENT_SIZE, 0);
+  VfsNode::Mapping hole{nullptr, EXTENT_SIZE * 2, nullptr, nullptr};
+  res = fsNodeRead(node, MAP_FIELD, EXTENT_SIZE + 1, &hole, sizeof(hole), nullptr);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(hole.length == EXTENT_SIZE - 1);
+  CPPUNIT_ASSERT(memcmp(hole.data, zeros.data(), hole.length) == 0);
+  hole.unmap(hole.token);
+
+  hole.length = 2;
+  res = fsNodeRead(node, MAP_FIELD, OFFSET - 1, &hole, sizeof(hole), nullptr);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(hole.length == 1);
+  CPPUNIT_ASSERT(*static_cast<const uint8_t *>(hole.data) == 0);
+  hole.unmap(hole.token);
+
+  // Removal of the node keeps mapped data
+  res = fsNodeRemove(root, node);
+  CPPUNIT_ASSERT(res == E_OK);
+  fsNodeFree(node);
+  fsNodeFree(root);
+
+  CPPUNIT_ASSERT(memcmp(mapping.data, buffer.data(), buffer.size()) == 0);
+  mapping.unmap(mapping.token);
 }
 
-void VfsTest::testNodeDeletionFailures()
+void VfsTest::testDataNodeTruncate()
 {
-  auto dir = new VfsDirectory{};
-  CPPUNIT_ASSERT(dir != nullptr);
+  static constexpr size_t EXTENT_SIZE{VfsDataNode::EXTENT_SIZE};
+  static constexpr auto CAPACITY_FIELD = static_cast<FsFieldType>(VfsNode::VFS_NODE_CAPACITY);
+  static constexpr auto LENGTH_FIELD = static_cast<FsFieldType>(VfsNode::VFS_NODE_LENGTH);
+
+  FsNode * const root = static_cast<FsNode *>(fsHandleRoot(handle));
+  CPPUNIT_ASSERT(root != nullptr);
+
+  // Capacity hint reserves storage of an empty node
+  const FsLength hint = EXTENT_SIZE / 2;
+  const std::array<FsFieldDescriptor, 2> desc = {{
+      {"node", sizeof("node"), FS_NODE_NAME},
+      {&hint, sizeof(hint), CAPACITY_FIELD}
+  }};
+  Result res = fsNodeCreate(root, desc.data(), desc.size());
+  CPPUNIT_ASSERT(res == E_OK);
 
-  auto proxy = static_cast<FsNode *>(fsHandleRoot(handle));
-  const auto res = dir->remove(proxy);
-  CPPUNIT_ASSERT(res == E_ENTRY);
-  fsNodeFree(proxy);
+  FsNode * const node = ShellHelpers::openNode(handle, "/node");
+  CPPUNIT_ASSERT(node != nullptr);
 
-  delete dir;
+  FsLength capacity;
+  FsLength dataLength;
+
+  res = fsNodeRead(node, CAPACITY_FIELD, 0, &capacity, sizeof(capacity), nullptr);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(capacity >= hint);
+  res = fsNodeLength(node, FS_NODE_DATA, &dataLength);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(dataLength == 0);
+
+  // Extension fills the node with zeros
+  std::vector<uint8_t> buffer(EXTENT_SIZE * 4, 'A');
+  FsLength length = buffer.size();
+  size_t count;
+
+  res = fsNodeWrite(node, LENGTH_FIELD, 0, &length, sizeof(length), nullptr);
+  CPPUNIT_ASSERT(res == E_OK);
+  res = fsNodeRead(node, FS_NODE_DATA, 0, buffer.data(), buffer.size(), &count);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(count == buffer.size());
+  CPPUNIT_ASSERT(std::count(buffer.begin(), buffer.end(), 0) == static_cast<ptrdiff_t>(buffer.size()));
+
+  // Data removed by shrinking is read as zeros after extension
+  std::fill(buffer.begin(), buffer.end(), 'A');
+  res = fsNodeWrite(node, FS_NODE_DATA, 0, buffer.data(), buffer.size(), nullptr);
+  CPPUNIT_ASSERT(res == E_OK);
+
+  length = EXTENT_SIZE + 1;
+  res = fsNodeWrite(node, LENGTH_FIELD, 0, &length, sizeof(length), nullptr);
+  CPPUNIT_ASSERT(res == E_OK);
+  res = fsNodeLength(node, FS_NODE_DATA, &dataLength);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(dataLength == length);
+
+  length = buffer.size();
+  res = fsNodeWrite(node, LENGTH_FIELD, 0, &length, sizeof(length), nullptr);
+  CPPUNIT_ASSERT(res == E_OK);
+  res = fsNodeRead(node, FS_NODE_DATA, 0, buffer.data(), buffer.size(), &count);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(count == buffer.size());
+  CPPUNIT_ASSERT(std::count(buffer.begin(), buffer.begin() + EXTENT_SIZE + 1, 'A') == EXTENT_SIZE + 1);
+  CPPUNIT_ASSERT(std::count(buffer.begin() + EXTENT_SIZE + 1, buffer.end(), 0)
+      == static_cast<ptrdiff_t>(buffer.size() - EXTENT_SIZE - 1));
+
+  // Preallocation reserves storage of small nodes without changing the length
+  capacity = VfsDataNode::EXTENT_THRESHOLD;
+  res = fsNodeWrite(node, CAPACITY_FIELD, 0, &capacity, sizeof(capacity), nullptr);
+  CPPUNIT_ASSERT(res == E_OK);
+  res = fsNodeRead(node, CAPACITY_FIELD, 0, &capacity, sizeof(capacity), nullptr);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(capacity >= VfsDataNode::EXTENT_THRESHOLD);
+  res = fsNodeLength(node, FS_NODE_DATA, &dataLength);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(dataLength == buffer.size());
+
+  // Truncation to zero releases data
+  length = 0;
+  res = fsNodeWrite(node, LENGTH_FIELD, 0, &length, sizeof(length), nullptr);
+  CPPUNIT_ASSERT(res == E_OK);
+  res = fsNodeRead(node, CAPACITY_FIELD, 0, &capacity, sizeof(capacity), nullptr);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(capacity == 0);
+
+  // Incorrect arguments
+  res = fsNodeWrite(node, LENGTH_FIELD, 1, &length, sizeof(length), nullptr);
+  CPPUNIT_ASSERT(res == E_VALUE);
+  res = fsNodeWrite(node, LENGTH_FIELD, 0, &length, sizeof(length) - 1, nullptr);
+  CPPUNIT_ASSERT(res == E_VALUE);
+
+  fsNodeFree(node);
+  fsNodeFree(root);
 }
 
-void VfsTest::testNodeInjection()
+void VfsTest::testDirectoryIteration()
 {
+  static const char * const NAMES[] = {"a", "b", "c", "d"};
+
+  for (const auto name : NAMES)
+  {
+    const Result res = ShellHelpers::injectNode(handle, new VfsDataNode{}, (std::string{"/"} + name).c_str());
+    CPPUNIT_ASSERT(res == E_OK);
+  }
+
+  FsNode * const root = static_cast<FsNode *>(fsHandleRoot(handle));
+  CPPUNIT_ASSERT(root != nullptr);
+  FsNode * const child = static_cast<FsNode *>(fsNodeHead(root));
+  CPPUNIT_ASSERT(child != nullptr);
+
+  char name[BUFFER_SIZE];
   Result res;
 
-  auto node = new VfsDataNode{};
+  // Remove the next node while the iterator is active
+  FsNode * const node = ShellHelpers::openNode(handle, "/b");
   CPPUNIT_ASSERT(node != nullptr);
+  res = fsNodeRemove(root, node);
+  CPPUNIT_ASSERT(res == E_OK);
+  fsNodeFree(node);
 
-  // Test null pointer injection
-  res = ShellHelpers::injectNode(handle, nullptr, "/test");
-  CPPUNIT_ASSERT(res == E_VALUE);
+  res = fsNodeRead(child, FS_NODE_NAME, 0, name, sizeof(name), nullptr);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(strcmp(name, "a") == 0);
 
-  // Test incorrect node name
-  res = ShellHelpers::injectNode(handle, node, "/");
-  CPPUNIT_ASSERT(res == E_VALUE);
+  res = fsNodeNext(child);
+  CPPUNIT_ASSERT(res == E_OK);
+  res = fsNodeRead(child, FS_NODE_NAME, 0, name, sizeof(name), nullptr);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(strcmp(name, "c") == 0);
 
-  // Test incorrect parent name
-  res = ShellHelpers::injectNode(handle, node, "/undefined/test");
+  res = fsNodeNext(child);
+  CPPUNIT_ASSERT(res == E_OK);
+  res = fsNodeRead(child, FS_NODE_NAME, 0, name, sizeof(name), nullptr);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(strcmp(name, "d") == 0);
+
+  res = fsNodeNext(child);
   CPPUNIT_ASSERT(res == E_ENTRY);
 
-  delete node;
+  fsNodeFree(child);
+  fsNodeFree(root);
+}
+
+void VfsTest::testDirectoryRemovalReclamation()
+{
+  static const char * const NAMES[] = {"a", "b", "c"};
+
+  for (const auto name : NAMES)
+  {
+    const Result res = ShellHelpers::injectNode(handle, new VfsDataNode{}, (std::string{"/"} + name).c_str());
+    CPPUNIT_ASSERT(res == E_OK);
+  }
+
+  const auto initialData = VfsSlab::dataCache().stats();
+
+  FsNode * const root = static_cast<FsNode *>(fsHandleRoot(handle));
+  CPPUNIT_ASSERT(root != nullptr);
+  FsNode * const child = static_cast<FsNode *>(fsNodeHead(root));
+  CPPUNIT_ASSERT(child != nullptr);
+
+  char name[BUFFER_SIZE];
+  Result res;
+
+  res = fsNodeNext(child);
+  CPPUNIT_ASSERT(res == E_OK);
+
+  // Remove the current node of the iterator
+  FsNode * const node = ShellHelpers::openNode(handle, "/b");
+  CPPUNIT_ASSERT(node != nullptr);
+  res = fsNodeRemove(root, node);
+  CPPUNIT_ASSERT(res == E_OK);
+  fsNodeFree(node);
+
+  // Removed node is still readable by the iterator
+  CPPUNIT_ASSERT(VfsSlab::dataCache().stats().used == initialData.used);
+  res = fsNodeRead(child, FS_NODE_NAME, 0, name, sizeof(name), nullptr);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(strcmp(name, "b") == 0);
+  CPPUNIT_ASSERT(ShellHelpers::openNode(handle, "/b") == nullptr);
+
+  // Iteration continues with the next node, removed node is released
+  res = fsNodeNext(child);
+  CPPUNIT_ASSERT(res == E_OK);
+  res = fsNodeRead(child, FS_NODE_NAME, 0, name, sizeof(name), nullptr);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(strcmp(name, "c") == 0);
+  CPPUNIT_ASSERT(VfsSlab::dataCache().stats().used == initialData.used - 1);
+
+  // Open proxies do not delay release of other removed nodes
+  FsNode * const other = ShellHelpers::openNode(handle, "/a");
+  CPPUNIT_ASSERT(other != nullptr);
+  res = fsNodeRemove(root, other);
+  CPPUNIT_ASSERT(res == E_OK);
+  fsNodeFree(other);
+
+  CPPUNIT_ASSERT(VfsSlab::dataCache().stats().used == initialData.used - 2);
+  CPPUNIT_ASSERT(VfsHandle::cast(handle)->epoch().pending() == 0);
+
+  fsNodeFree(child);
+  fsNodeFree(root);
+}
+
+void VfsTest::testDirectoryListing()
+{
+  static constexpr auto ENTRIES_FIELD = static_cast<FsFieldType>(VfsNode::VFS_NODE_ENTRIES);
+  static constexpr size_t NODE_COUNT{20};
+  // Buffer fits a few records with short names
+  static constexpr size_t BATCH_LENGTH{(sizeof(VfsNode::Record) + 16) * 3};
+
+  Result res;
+
+  res = ShellHelpers::injectNode(handle, new VfsDirectory{}, "/listing");
+  CPPUNIT_ASSERT(res == E_OK);
+
+  for (size_t i = 0; i < NODE_COUNT; ++i)
+  {
+    const std::string path = "/listing/node_" + std::to_string(i);
+    VfsDataNode * const node = new VfsDataNode{};
+
+    CPPUNIT_ASSERT(node != nullptr);
+    CPPUNIT_ASSERT(node->reserve(i, 'A') == true);
+
+    res = ShellHelpers::injectNode(handle, node, path.c_str());
+    CPPUNIT_ASSERT(res == E_OK);
+  }
+
+  res = ShellHelpers::injectNode(handle, new VfsDirectory{}, "/listing/nested");
+  CPPUNIT_ASSERT(res == E_OK);
+  res = ShellHelpers::injectNode(handle, new VfsDirectory{}, "/listing/nested/child");
+  CPPUNIT_ASSERT(res == E_OK);
+
+  FsNode * const listing = ShellHelpers::openNode(handle, "/listing");
+  CPPUNIT_ASSERT(listing != nullptr);
+
+  alignas(VfsNode::Record) uint8_t buffer[BATCH_LENGTH];
+  std::vector<std::string> names;
+  FsLength position = 0;
+  size_t batches = 0;
+  const size_t inodes = VfsHandle::cast(handle)->inodes();
+
+  while (true)
+  {
+    size_t count;
+
+    res = fsNodeRead(listing, ENTRIES_FIELD, position, buffer, sizeof(buffer), &count);
+    CPPUNIT_ASSERT(res == E_OK);
+    if (!count)
+      break;
+
+    for (size_t offset = 0; offset < count; ++position)
+    {
+      VfsNode::Record record;
+      memcpy(&record, buffer + offset, sizeof(record));
+
+      const std::string name{reinterpret_cast<const char *>(buffer + offset + sizeof(record))};
+
+      CPPUNIT_ASSERT(record.size % alignof(VfsNode::Record) == 0);
+      CPPUNIT_ASSERT(record.access == (FS_ACCESS_READ | FS_ACCESS_WRITE));
+
+      if (name == "nested")
+      {
+        CPPUNIT_ASSERT(record.directory == true);
+      }
+      else
+      {
+        CPPUNIT_ASSERT(record.directory == false);
+        CPPUNIT_ASSERT(record.length == std::stoul(name.substr(strlen("node_"))));
+      }
+
+      // Identifiers are the same as identifiers of opened nodes
+      const std::string path = "/listing/" + name;
+      FsNode * const node = ShellHelpers::openNode(handle, path.c_str());
+      CPPUNIT_ASSERT(node != nullptr);
+
+      FsIdentifier id = 0;
+      fsNodeRead(node, FS_NODE_ID, 0, &id, sizeof(id), nullptr);
+      CPPUNIT_ASSERT(record.id == id);
+      fsNodeFree(node);
+
+      names.push_back(name);
+      offset += record.size;
+    }
+
+    // Listed node is removed, listing continues from the cursor without skipping nodes
+    if (!batches++)
+    {
+      FsNode * const node = ShellHelpers::openNode(handle, "/listing/node_0");
+      CPPUNIT_ASSERT(node != nullptr);
+      res = fsNodeRemove(listing, node);
+      CPPUNIT_ASSERT(res == E_OK);
+      fsNodeFree(node);
+    }
+  }
+
+  CPPUNIT_ASSERT(batches > 1);
+  CPPUNIT_ASSERT(names.size() == NODE_COUNT + 1);
+  CPPUNIT_ASSERT(names.front() == "node_0");
+  CPPUNIT_ASSERT(names.back() == "nested");
+
+  // Identifiers of listed nodes are not added to the inode table
+  CPPUNIT_ASSERT(VfsHandle::cast(handle)->inodes() == inodes);
+
+  // Position without a matching cursor skips records from the beginning
+  size_t count;
+  VfsNode::Record record;
+
+  res = fsNodeRead(listing, ENTRIES_FIELD, 4, buffer, sizeof(buffer), &count);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(count > 0);
+  memcpy(&record, buffer, sizeof(record));
+  CPPUNIT_ASSERT(strcmp(reinterpret_cast<const char *>(buffer + sizeof(record)), "node_5") == 0);
+
+  // Buffer should fit at least one record
+  res = fsNodeRead(listing, ENTRIES_FIELD, 0, buffer, sizeof(VfsNode::Record), &count);
+  CPPUNIT_ASSERT(res == E_VALUE);
+
+  fsNodeFree(listing);
+
+  // Empty directory has no records, data nodes do not support listing
+  FsNode * const nested = ShellHelpers::openNode(handle, "/listing/nested/child");
+  CPPUNIT_ASSERT(nested != nullptr);
+  res = fsNodeRead(nested, ENTRIES_FIELD, 0, buffer, sizeof(buffer), &count);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(count == 0);
+  fsNodeFree(nested);
+
+  FsNode * const node = ShellHelpers::openNode(handle, "/listing/node_1");
+  CPPUNIT_ASSERT(node != nullptr);
+  res = fsNodeRead(node, ENTRIES_FIELD, 0, buffer, sizeof(buffer), &count);
+  CPPUNIT_ASSERT(res == E_INVALID);
+  fsNodeFree(node);
+}
+
+void VfsTest::testDirectoryLookup()
+{
+  auto dir = new VfsDirectory{};
+  CPPUNIT_ASSERT(dir != nullptr);
+  auto node = new VfsDataNode{};
+  CPPUNIT_ASSERT(node != nullptr);
+
+  Result res;
+
+  res = ShellHelpers::injectNode(handle, dir, "/dir");
+  CPPUNIT_ASSERT(res == E_OK);
+  res = ShellHelpers::injectNode(handle, node, "/dir/node");
+  CPPUNIT_ASSERT(res == E_OK);
+
+  VfsNode *found = nullptr;
+
+  res = dir->lookup("node", &found);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(found == node);
+
+  res = dir->lookup("nod", &found);
+  CPPUNIT_ASSERT(res == E_ENTRY);
+
+  // Index should follow the name of the node
+  const auto ok = node->rename("renamed");
+  CPPUNIT_ASSERT(ok == true);
+
+  res = dir->lookup("node", &found);
+  CPPUNIT_ASSERT(res == E_ENTRY);
+  res = dir->lookup("renamed", &found);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(found == node);
+
+  // Path resolution
+  FsNode *proxy;
+
+  proxy = ShellHelpers::openNode(handle, "/dir/renamed");
+  CPPUNIT_ASSERT(proxy != nullptr);
+  CPPUNIT_ASSERT(reinterpret_cast<VfsNodeProxy *>(proxy)->get() == node);
+  fsNodeFree(proxy);
+
+  proxy = ShellHelpers::openNode(handle, "//dir/./renamed/");
+  CPPUNIT_ASSERT(proxy != nullptr);
+  CPPUNIT_ASSERT(reinterpret_cast<VfsNodeProxy *>(proxy)->get() == node);
+  fsNodeFree(proxy);
+
+  proxy = ShellHelpers::openBaseNode(handle, "/dir/renamed");
+  CPPUNIT_ASSERT(proxy != nullptr);
+  CPPUNIT_ASSERT(reinterpret_cast<VfsNodeProxy *>(proxy)->get() == dir);
+  fsNodeFree(proxy);
+
+  proxy = ShellHelpers::openNode(handle, "/dir/node");
+  CPPUNIT_ASSERT(proxy == nullptr);
+  proxy = ShellHelpers::openNode(handle, "/dir/renamed/child");
+  CPPUNIT_ASSERT(proxy == nullptr);
+  proxy = ShellHelpers::openBaseNode(handle, "/");
+  CPPUNIT_ASSERT(proxy == nullptr);
+}
+
+void VfsTest::testDirectoryQuota()
+{
+  static constexpr size_t EXTENT_SIZE{VfsDataNode::EXTENT_SIZE};
+  static constexpr auto LIMIT_FIELD = static_cast<FsFieldType>(VfsNode::VFS_NODE_LIMIT);
+  static constexpr auto USAGE_FIELD = static_cast<FsFieldType>(VfsNode::VFS_NODE_USAGE);
+
+  Result res;
+
+  res = ShellHelpers::injectNode(handle, new VfsDirectory{}, "/limited");
+  CPPUNIT_ASSERT(res == E_OK);
+  res = ShellHelpers::injectNode(handle, new VfsDirectory{}, "/limited/nested");
+  CPPUNIT_ASSERT(res == E_OK);
+
+  FsNode * const root = static_cast<FsNode *>(fsHandleRoot(handle));
+  CPPUNIT_ASSERT(root != nullptr);
+  FsNode * const limited = ShellHelpers::openNode(handle, "/limited");
+  CPPUNIT_ASSERT(limited != nullptr);
+  FsNode * const nested = ShellHelpers::openNode(handle, "/limited/nested");
+  CPPUNIT_ASSERT(nested != nullptr);
+
+  VfsNode::Usage initial;
+  VfsNode::Usage usage;
+
+  res = fsNodeRead(root, USAGE_FIELD, 0, &initial, sizeof(initial), nullptr);
+  CPPUNIT_ASSERT(res == E_OK);
+
+  // Data written into a nested directory is charged to all ancestors
+  const std::array<FsFieldDescriptor, 2> desc = {{
+      {"node", sizeof("node"), FS_NODE_NAME},
+      {"", 0, FS_NODE_DATA}
+  }};
+  res = fsNodeCreate(nested, desc.data(), desc.size());
+  CPPUNIT_ASSERT(res == E_OK);
+
+  FsNode * const node = ShellHelpers::openNode(handle, "/limited/nested/node");
+  CPPUNIT_ASSERT(node != nullptr);
+
+  const std::vector<uint8_t> buffer(EXTENT_SIZE * 3, 'A');
+  res = fsNodeWrite(node, FS_NODE_DATA, 0, buffer.data(), buffer.size(), nullptr);
+  CPPUNIT_ASSERT(res == E_OK);
+
+  // Extent table is charged together with the extents
+  VfsNode::Usage charged;
+
+  res = fsNodeRead(limited, USAGE_FIELD, 0, &charged, sizeof(charged), nullptr);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(charged.bytes > EXTENT_SIZE * 3);
+  CPPUNIT_ASSERT(charged.nodes == 3);
+
+  res = fsNodeRead(root, USAGE_FIELD, 0, &usage, sizeof(usage), nullptr);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(usage.bytes == initial.bytes + charged.bytes);
+
+  const VfsNode::Usage limit{charged.bytes + EXTENT_SIZE, 3};
+  res = fsNodeWrite(limited, LIMIT_FIELD, 0, &limit, sizeof(limit), nullptr);
+  CPPUNIT_ASSERT(res == E_OK);
+
+  // Writes and creation over the limits fail without changes
+  res = fsNodeWrite(node, FS_NODE_DATA, buffer.size(), buffer.data(), buffer.size(), nullptr);
+  CPPUNIT_ASSERT(res == E_FULL);
+  res = fsNodeCreate(limited, desc.data(), desc.size());
+  CPPUNIT_ASSERT(res == E_FULL);
+
+  FsLength length;
+  res = fsNodeLength(node, FS_NODE_DATA, &length);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(length == buffer.size());
+
+  res = fsNodeRead(limited, USAGE_FIELD, 0, &usage, sizeof(usage), nullptr);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(usage.bytes == charged.bytes);
+  CPPUNIT_ASSERT(usage.nodes == 3);
+
+  // Extents shared with a clone are copied on overwrite, copies are checked against the limit
+  VfsNode * const origin = VfsNodeProxy::cast(node)->get();
+  const std::array<FsFieldDescriptor, 2> cloneDesc = {{
+      {"clone", sizeof("clone"), FS_NODE_NAME},
+      {&origin, sizeof(origin), static_cast<FsFieldType>(VfsNode::VFS_NODE_CLONE)}
+  }};
+  res = fsNodeCreate(root, cloneDesc.data(), cloneDesc.size());
+  CPPUNIT_ASSERT(res == E_OK);
+
+  res = fsNodeWrite(node, FS_NODE_DATA, 0, buffer.data(), EXTENT_SIZE * 2, nullptr);
+  CPPUNIT_ASSERT(res == E_FULL);
+
+  FsNode * const copy = ShellHelpers::openNode(handle, "/clone");
+  CPPUNIT_ASSERT(copy != nullptr);
+  res = fsNodeRemove(root, copy);
+  CPPUNIT_ASSERT(res == E_OK);
+  fsNodeFree(copy);
+
+  res = fsNodeWrite(node, FS_NODE_DATA, 0, buffer.data(), EXTENT_SIZE * 2, nullptr);
+  CPPUNIT_ASSERT(res == E_OK);
+
+  // Removal returns resources at once, an open node is no longer charged
+  res = fsNodeRemove(nested, node);
+  CPPUNIT_ASSERT(res == E_OK);
+  res = fsNodeWrite(node, FS_NODE_DATA, buffer.size(), buffer.data(), buffer.size(), nullptr);
+  CPPUNIT_ASSERT(res == E_OK);
+  fsNodeFree(node);
+
+  res = fsNodeRead(limited, USAGE_FIELD, 0, &usage, sizeof(usage), nullptr);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(usage.bytes == 0);
+  CPPUNIT_ASSERT(usage.nodes == 2);
+
+  res = fsNodeRemove(root, limited);
+  CPPUNIT_ASSERT(res == E_OK);
+  fsNodeFree(nested);
+  fsNodeFree(limited);
+
+  res = fsNodeRead(root, USAGE_FIELD, 0, &usage, sizeof(usage), nullptr);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(usage.bytes == initial.bytes);
+  CPPUNIT_ASSERT(usage.nodes == initial.nodes - 2);
+
+  fsNodeFree(root);
+}
+
+void VfsTest::testHandle()
+{
+  const Result res = fsHandleSync(handle);
+  CPPUNIT_ASSERT(res == E_OK);
+}
+
+void VfsTest::testImage()
+{
+  static constexpr auto MAP_FIELD = static_cast<FsFieldType>(VfsNode::VFS_NODE_MAP);
+  static size_t released = 0;
+
+  const auto readNode = [this](const char *path){
+    std::string buffer(BUFFER_SIZE * 4, '\0');
+    size_t count = 0;
+    FsNode * const node = ShellHelpers::openNode(handle, path);
+
+    if (node != nullptr)
+    {
+      fsNodeRead(node, FS_NODE_DATA, 0, &buffer[0], buffer.size(), &count);
+      fsNodeFree(node);
+    }
+
+    buffer.resize(count);
+    return buffer;
+  };
+
+  const std::string pattern(BUFFER_SIZE * 3, 'x');
+  VfsDataNode * const large = new VfsDataNode{};
+  CPPUNIT_ASSERT(large->reserve(pattern.data(), pattern.size()) == true);
+  VfsDataNode * const small = new VfsDataNode{};
+  CPPUNIT_ASSERT(small->reserve("alpha") == true);
+  Result res;
+
+  res = ShellHelpers::injectNode(handle, new VfsDirectory{}, "/src");
+  CPPUNIT_ASSERT(res == E_OK);
+  res = ShellHelpers::injectNode(handle, small, "/src/small");
+  CPPUNIT_ASSERT(res == E_OK);
+  res = ShellHelpers::injectNode(handle, new VfsDataNode{}, "/src/empty");
+  CPPUNIT_ASSERT(res == E_OK);
+  res = ShellHelpers::injectNode(handle, new VfsDirectory{}, "/src/nested");
+  CPPUNIT_ASSERT(res == E_OK);
+  res = ShellHelpers::injectNode(handle, large, "/src/nested/large");
+  CPPUNIT_ASSERT(res == E_OK);
+  res = ShellHelpers::injectNode(handle, new VfsDirectory{0, FS_ACCESS_READ}, "/src/locked");
+  CPPUNIT_ASSERT(res == E_OK);
+  res = ShellHelpers::injectNode(handle, new VfsDataNode{}, "/src/image");
+  CPPUNIT_ASSERT(res == E_OK);
+  res = ShellHelpers::injectNode(handle, new VfsDirectory{}, "/dst");
+  CPPUNIT_ASSERT(res == E_OK);
+
+  // Image placed into the saved directory is not included into itself
+  FsNode * const source = ShellHelpers::openNode(handle, "/src");
+  CPPUNIT_ASSERT(source != nullptr);
+  FsNode * const sink = ShellHelpers::openNode(handle, "/src/image");
+  CPPUNIT_ASSERT(sink != nullptr);
+
+  uint8_t buffer[64];
+  res = VfsImage::save(source, sink, buffer, sizeof(buffer));
+  CPPUNIT_ASSERT(res == E_OK);
+  fsNodeFree(source);
+
+  // Image is copied into memory with a release callback
+  FsLength imageLength;
+  res = fsNodeLength(sink, FS_NODE_DATA, &imageLength);
+  CPPUNIT_ASSERT(res == E_OK);
+
+  const auto memory = static_cast<uint8_t *>(malloc(static_cast<size_t>(imageLength)));
+  CPPUNIT_ASSERT(memory != nullptr);
+  res = fsNodeRead(sink, FS_NODE_DATA, 0, memory, static_cast<size_t>(imageLength), nullptr);
+  CPPUNIT_ASSERT(res == E_OK);
+  fsNodeFree(sink);
+
+  VfsImage * const image = new VfsImage{memory, static_cast<size_t>(imageLength),
+      [](void *data, size_t){ free(data); ++released; }};
+  CPPUNIT_ASSERT(image != nullptr);
+
+  // Data nodes are unable to attach restored nodes, the image stays usable
+  FsNode * const file = ShellHelpers::openNode(handle, "/src/small");
+  CPPUNIT_ASSERT(file != nullptr);
+  res = image->restore(file);
+  CPPUNIT_ASSERT(res == E_INVALID);
+  fsNodeFree(file);
+
+  FsNode * const destination = ShellHelpers::openNode(handle, "/dst");
+  CPPUNIT_ASSERT(destination != nullptr);
+  res = image->restore(destination);
+  CPPUNIT_ASSERT(res == E_OK);
+
+  // Block headers are already constructed, the image is restored only once
+  res = image->restore(destination);
+  CPPUNIT_ASSERT(res == E_BUSY);
+  fsNodeFree(destination);
+
+  CPPUNIT_ASSERT(readNode("/dst/small") == "alpha");
+  CPPUNIT_ASSERT(readNode("/dst/nested/large") == pattern);
+  CPPUNIT_ASSERT(readNode("/dst/empty").empty());
+  CPPUNIT_ASSERT(ShellHelpers::openNode(handle, "/dst/image") == nullptr);
+
+  // Access of restored directories is preserved
+  FsNode * const locked = ShellHelpers::openNode(handle, "/dst/locked");
+  CPPUNIT_ASSERT(locked != nullptr);
+  FsAccess access;
+  res = fsNodeRead(locked, FS_NODE_ACCESS, 0, &access, sizeof(access), nullptr);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(access == FS_ACCESS_READ);
+  fsNodeFree(locked);
+
+  // Data of restored nodes references the image memory
+  FsNode * const restored = ShellHelpers::openNode(handle, "/dst/nested/large");
+  CPPUNIT_ASSERT(restored != nullptr);
+  VfsNode::Mapping mapping{nullptr, pattern.size(), nullptr, nullptr};
+  res = fsNodeRead(restored, MAP_FIELD, 0, &mapping, sizeof(mapping), nullptr);
+  CPPUNIT_ASSERT(res == E_OK);
+  const auto mapped = static_cast<const uint8_t *>(mapping.data);
+  CPPUNIT_ASSERT(mapped >= memory && mapped + mapping.length <= memory + imageLength);
+  mapping.unmap(mapping.token);
+
+  // Data is copied before the first modification
+  res = fsNodeWrite(restored, FS_NODE_DATA, 0, "y", 1, nullptr);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(mapped[0] == 'x');
+  fsNodeFree(restored);
+
+  // Memory is released after the image and all nodes using it are gone
+  image->release();
+  CPPUNIT_ASSERT(released == 0);
+
+  FsNode * const root = ShellHelpers::openNode(handle, "/");
+  CPPUNIT_ASSERT(root != nullptr);
+  FsNode * const removed = ShellHelpers::openNode(handle, "/dst");
+  CPPUNIT_ASSERT(removed != nullptr);
+  res = fsNodeRemove(root, removed);
+  CPPUNIT_ASSERT(res == E_OK);
+  fsNodeFree(removed);
+  fsNodeFree(root);
+
+  CPPUNIT_ASSERT(VfsHandle::cast(handle)->epoch().pending() == 0);
+  CPPUNIT_ASSERT(released == 1);
+
+  // Incorrect images are rejected
+  uint8_t corrupted[64] = {0};
+  VfsImage * const invalid = new VfsImage{corrupted, sizeof(corrupted), [](void *, size_t){ ++released; }};
+  FsNode * const target = ShellHelpers::openNode(handle, "/src");
+  CPPUNIT_ASSERT(target != nullptr);
+  res = invalid->restore(target);
+  CPPUNIT_ASSERT(res == E_VALUE);
+  fsNodeFree(target);
+  invalid->release();
+  CPPUNIT_ASSERT(released == 2);
+}
+
+void VfsTest::testInodeTable()
+{
+  static const auto readIdentifier = [](FsNode *node){
+    FsIdentifier id = 0;
+    fsNodeRead(node, FS_NODE_ID, 0, &id, sizeof(id), nullptr);
+    return id;
+  };
+
+  VfsHandle * const vfs = VfsHandle::cast(handle);
+  Result res;
+
+  res = ShellHelpers::injectNode(handle, new VfsDirectory{}, "/inodes");
+  CPPUNIT_ASSERT(res == E_OK);
+  res = ShellHelpers::injectNode(handle, new VfsDataNode{}, "/inodes/data");
+  CPPUNIT_ASSERT(res == E_OK);
+  res = ShellHelpers::injectNode(handle, new VfsDirectory{}, "/inodes/nested");
+  CPPUNIT_ASSERT(res == E_OK);
+  res = ShellHelpers::injectNode(handle, new VfsDataNode{}, "/inodes/nested/child");
+  CPPUNIT_ASSERT(res == E_OK);
+
+  FsNode * const directory = ShellHelpers::openNode(handle, "/inodes");
+  CPPUNIT_ASSERT(directory != nullptr);
+  FsNode * const data = ShellHelpers::openNode(handle, "/inodes/data");
+  CPPUNIT_ASSERT(data != nullptr);
+  FsNode * const child = ShellHelpers::openNode(handle, "/inodes/nested/child");
+  CPPUNIT_ASSERT(child != nullptr);
+
+  // Identifiers are unique and stable, reading them does not grow the table
+  const size_t initial = vfs->inodes();
+  const FsIdentifier directoryId = readIdentifier(directory);
+  const FsIdentifier dataId = readIdentifier(data);
+  const FsIdentifier childId = readIdentifier(child);
+
+  CPPUNIT_ASSERT(directoryId != 0 && dataId != 0 && childId != 0);
+  CPPUNIT_ASSERT(directoryId != dataId && dataId != childId && childId != directoryId);
+  CPPUNIT_ASSERT(vfs->inodes() == initial);
+  CPPUNIT_ASSERT(readIdentifier(data) == dataId);
+
+  CPPUNIT_ASSERT(VfsNodeProxy::cast(data)->get()->rename("renamed") == true);
+  CPPUNIT_ASSERT(readIdentifier(data) == dataId);
+
+  // Nodes are opened by identifiers and by paths relative to them
+  FsNode *node;
+
+  node = VfsHandle::openNodeAt(handle, dataId, nullptr);
+  CPPUNIT_ASSERT(node != nullptr);
+  CPPUNIT_ASSERT(VfsNodeProxy::cast(node)->get() == VfsNodeProxy::cast(data)->get());
+  fsNodeFree(node);
+
+  // Nodes opened by identifiers are remembered
+  CPPUNIT_ASSERT(vfs->inodes() == initial + 1);
+  node = VfsHandle::openNodeAt(handle, dataId, nullptr);
+  CPPUNIT_ASSERT(node != nullptr);
+  fsNodeFree(node);
+  CPPUNIT_ASSERT(vfs->inodes() == initial + 1);
+
+  node = VfsHandle::openNodeAt(handle, directoryId, "nested/child");
+  CPPUNIT_ASSERT(node != nullptr);
+  CPPUNIT_ASSERT(VfsNodeProxy::cast(node)->get() == VfsNodeProxy::cast(child)->get());
+  fsNodeFree(node);
+
+  node = VfsHandle::openNodeAt(handle, directoryId, "renamed");
+  CPPUNIT_ASSERT(node != nullptr);
+  fsNodeFree(node);
+
+  CPPUNIT_ASSERT(VfsHandle::openNodeAt(handle, directoryId, "data") == nullptr);
+  CPPUNIT_ASSERT(VfsHandle::openNodeAt(handle, directoryId, "nested/../renamed") == nullptr);
+  CPPUNIT_ASSERT(VfsHandle::openNodeAt(handle, 0, nullptr) == nullptr);
+
+  node = VfsHandle::openNodeAt(handle, childId, nullptr);
+  CPPUNIT_ASSERT(node != nullptr);
+  fsNodeFree(node);
+  CPPUNIT_ASSERT(vfs->inodes() == initial + 3);
+
+  // Removed subtree can not be opened while its nodes are still in use
+  FsNode * const nested = ShellHelpers::openNode(handle, "/inodes/nested");
+  CPPUNIT_ASSERT(nested != nullptr);
+  res = fsNodeRemove(directory, nested);
+  CPPUNIT_ASSERT(res == E_OK);
+  fsNodeFree(nested);
+
+  // Identifiers are derived from entries, nodes of a released directory are no longer identified
+  CPPUNIT_ASSERT(VfsHandle::openNodeAt(handle, childId, nullptr) == nullptr);
+  CPPUNIT_ASSERT(readIdentifier(child) == 0);
+
+  // Identifiers are released together with nodes
+  fsNodeFree(child);
+  fsNodeFree(data);
+  fsNodeFree(directory);
+
+  CPPUNIT_ASSERT(vfs->epoch().pending() == 0);
+  CPPUNIT_ASSERT(vfs->inodes() == initial + 2);
+
+  // Identifiers of removed nodes are not reused
+  res = ShellHelpers::injectNode(handle, new VfsDataNode{}, "/inodes/nested");
+  CPPUNIT_ASSERT(res == E_OK);
+  node = ShellHelpers::openNode(handle, "/inodes/nested");
+  CPPUNIT_ASSERT(node != nullptr);
+  CPPUNIT_ASSERT(readIdentifier(node) > childId);
+  fsNodeFree(node);
+}
+
+void VfsTest::testLink()
+{
+  static constexpr auto LINK_FIELD = static_cast<FsFieldType>(VfsNode::VFS_NODE_LINK);
+  static const auto makeLink = [](FsNode *directory, const char *name, FsNode *target){
+    VfsNode * const node = VfsNodeProxy::cast(target)->get();
+    const std::array<FsFieldDescriptor, 2> desc = {{
+        {name, strlen(name) + 1, FS_NODE_NAME},
+        {&node, sizeof(node), LINK_FIELD}
+    }};
+
+    return fsNodeCreate(directory, desc.data(), desc.size());
+  };
+  static const auto readName = [](FsNode *node){
+    char name[BUFFER_SIZE] = {0};
+    fsNodeRead(node, FS_NODE_NAME, 0, name, sizeof(name), nullptr);
+    return std::string{name};
+  };
+
+  static const char DATA[] = "data";
+  static const char UPDATED[] = "DATA";
+
+  const auto initialData = VfsSlab::dataCache().stats();
+  char buffer[BUFFER_SIZE];
+  size_t count;
+  Result res;
+
+  res = ShellHelpers::injectNode(handle, new VfsDirectory{}, "/home");
+  CPPUNIT_ASSERT(res == E_OK);
+  res = ShellHelpers::injectNode(handle, new VfsDirectory{}, "/home/nested");
+  CPPUNIT_ASSERT(res == E_OK);
+  res = ShellHelpers::injectNode(handle, new VfsDirectory{}, "/work");
+  CPPUNIT_ASSERT(res == E_OK);
+
+  VfsDataNode * const dataNode = new VfsDataNode{};
+  CPPUNIT_ASSERT(dataNode != nullptr);
+  CPPUNIT_ASSERT(dataNode->reserve(DATA) == true);
+  res = ShellHelpers::injectNode(handle, dataNode, "/home/file");
+  CPPUNIT_ASSERT(res == E_OK);
+
+  FsNode * const home = ShellHelpers::openNode(handle, "/home");
+  CPPUNIT_ASSERT(home != nullptr);
+  FsNode * const work = ShellHelpers::openNode(handle, "/work");
+  CPPUNIT_ASSERT(work != nullptr);
+  FsNode * const file = ShellHelpers::openNode(handle, "/home/file");
+  CPPUNIT_ASSERT(file != nullptr);
+
+  // Hard link shares data with the target and keeps its own name
+  res = makeLink(work, "alias", file);
+  CPPUNIT_ASSERT(res == E_OK);
+  FsNode * const alias = ShellHelpers::openNode(handle, "/work/alias");
+  CPPUNIT_ASSERT(alias != nullptr);
+  CPPUNIT_ASSERT(readName(alias) == "alias");
+  CPPUNIT_ASSERT(readName(file) == "file");
+
+  res = fsNodeWrite(alias, FS_NODE_DATA, 0, UPDATED, sizeof(UPDATED) - 1, &count);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(count == sizeof(UPDATED) - 1);
+  res = fsNodeRead(file, FS_NODE_DATA, 0, buffer, sizeof(buffer), &count);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(count == sizeof(UPDATED) - 1 && memcmp(buffer, UPDATED, count) == 0);
+
+  // Link to a link references the final target
+  res = makeLink(work, "second", alias);
+  CPPUNIT_ASSERT(res == E_OK);
+  FsNode * const second = ShellHelpers::openNode(handle, "/work/second");
+  CPPUNIT_ASSERT(second != nullptr);
+
+  VfsNode *target = nullptr;
+
+  res = fsNodeRead(second, LINK_FIELD, 0, &target, sizeof(target), nullptr);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(target == dataNode);
+  res = fsNodeRead(file, LINK_FIELD, 0, &target, sizeof(target), nullptr);
+  CPPUNIT_ASSERT(res == E_INVALID);
+
+  // Bound directory forwards creation, iteration and removal to the target
+  res = makeLink(work, "bound", home);
+  CPPUNIT_ASSERT(res == E_OK);
+  FsNode * const bound = ShellHelpers::openNode(handle, "/work/bound");
+  CPPUNIT_ASSERT(bound != nullptr);
+
+  const std::array<FsFieldDescriptor, 2> desc = {{
+      {"created", sizeof("created"), FS_NODE_NAME},
+      {nullptr, 0, FS_NODE_DATA}
+  }};
+
+  res = fsNodeCreate(bound, desc.data(), desc.size());
+  CPPUNIT_ASSERT(res == E_OK);
+  FsNode * const created = ShellHelpers::openNode(handle, "/home/created");
+  CPPUNIT_ASSERT(created != nullptr);
+  fsNodeFree(created);
+
+  FsNode * const child = ShellHelpers::openNode(handle, "/work/bound/created");
+  CPPUNIT_ASSERT(child != nullptr);
+  CPPUNIT_ASSERT(readName(child) == "created");
+  res = fsNodeRemove(bound, child);
+  CPPUNIT_ASSERT(res == E_OK);
+  fsNodeFree(child);
+  CPPUNIT_ASSERT(ShellHelpers::openNode(handle, "/home/created") == nullptr);
+
+  // Directory can not be bound into its own subtree
+  FsNode * const nested = ShellHelpers::openNode(handle, "/home/nested");
+  CPPUNIT_ASSERT(nested != nullptr);
+  res = makeLink(nested, "loop", home);
+  CPPUNIT_ASSERT(res == E_INVALID);
+  res = makeLink(home, "loop", home);
+  CPPUNIT_ASSERT(res == E_INVALID);
+  res = makeLink(nested, "loop", bound);
+  CPPUNIT_ASSERT(res == E_INVALID);
+
+  // Cycles through links of other directories are detected as well
+  res = makeLink(nested, "loop", work);
+  CPPUNIT_ASSERT(res == E_INVALID);
+  fsNodeFree(nested);
+
+  // Lookups are forwarded to the target of the bound directory
+  FsNode * const reached = ShellHelpers::openNode(handle, "/work/bound/nested");
+  CPPUNIT_ASSERT(reached != nullptr);
+  CPPUNIT_ASSERT(readName(reached) == "nested");
+  fsNodeFree(reached);
+
+  // Target survives removal of its original entry
+  res = fsNodeRemove(home, file);
+  CPPUNIT_ASSERT(res == E_OK);
+  fsNodeFree(file);
+  CPPUNIT_ASSERT(ShellHelpers::openNode(handle, "/home/file") == nullptr);
+
+  res = fsNodeRead(alias, FS_NODE_DATA, 0, buffer, sizeof(buffer), &count);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(count == sizeof(UPDATED) - 1 && memcmp(buffer, UPDATED, count) == 0);
+  res = fsNodeWrite(second, FS_NODE_DATA, 0, DATA, sizeof(DATA) - 1, &count);
+  CPPUNIT_ASSERT(res == E_OK);
+  res = fsNodeRead(alias, FS_NODE_DATA, 0, buffer, sizeof(buffer), &count);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(count == sizeof(DATA) - 1 && memcmp(buffer, DATA, count) == 0);
+
+  // Target is released with the last link
+  res = fsNodeRemove(work, alias);
+  CPPUNIT_ASSERT(res == E_OK);
+  fsNodeFree(alias);
+  res = fsNodeRemove(work, bound);
+  CPPUNIT_ASSERT(res == E_OK);
+  fsNodeFree(bound);
+  CPPUNIT_ASSERT(ShellHelpers::openNode(handle, "/work/bound/nested") == nullptr);
+
+  res = fsNodeRemove(work, second);
+  CPPUNIT_ASSERT(res == E_OK);
+  fsNodeFree(second);
+  fsNodeFree(work);
+  fsNodeFree(home);
+
+  CPPUNIT_ASSERT(VfsSlab::dataCache().stats().used == initialData.used);
+  CPPUNIT_ASSERT(VfsHandle::cast(handle)->epoch().pending() == 0);
+}
+
+void VfsTest::testMountpoint()
+{
+  static const auto readData = [](FsHandle *fs, const char *path){
+    FsNode * const node = ShellHelpers::openNode(fs, path);
+    char buffer[BUFFER_SIZE];
+    size_t count = 0;
+
+    if (node == nullptr)
+      return std::string{};
+
+    if (fsNodeRead(node, FS_NODE_DATA, 0, buffer, sizeof(buffer), &count) != E_OK)
+      count = 0;
+
+    fsNodeFree(node);
+    return std::string{buffer, count};
+  };
+  static const auto makeData = [](FsHandle *fs, const char *path, const char *text){
+    VfsDataNode * const node = new VfsDataNode{};
+    CPPUNIT_ASSERT(node != nullptr);
+    CPPUNIT_ASSERT(node->reserve(text) == true);
+
+    const Result res = ShellHelpers::injectNode(fs, node, path);
+    CPPUNIT_ASSERT(res == E_OK);
+  };
+
+  // Another in-memory handle plays the role of the mounted file system
+  FsHandle * const target = static_cast<FsHandle *>(init(VfsHandleClass, nullptr));
+  CPPUNIT_ASSERT(target != nullptr);
+
+  Result res;
+
+  res = ShellHelpers::injectNode(target, new VfsDirectory{}, "/a");
+  CPPUNIT_ASSERT(res == E_OK);
+  res = ShellHelpers::injectNode(target, new VfsDirectory{}, "/a/b");
+  CPPUNIT_ASSERT(res == E_OK);
+  makeData(target, "/a/b/first", "first");
+
+  VfsMountpoint * const mountpoint = new VfsMountpoint{target, nullptr};
+  CPPUNIT_ASSERT(mountpoint != nullptr);
+  res = ShellHelpers::injectNode(handle, mountpoint, "/mnt");
+  CPPUNIT_ASSERT(res == E_OK);
+
+  // Mounted file system is synchronized with the handle
+  res = fsHandleSync(handle);
+  CPPUNIT_ASSERT(res == E_OK);
+
+  // Repeated lookups use the cached parent directory
+  for (size_t i = 0; i < 2; ++i)
+  {
+    CPPUNIT_ASSERT(readData(handle, "/mnt/a/b/first") == "first");
+    CPPUNIT_ASSERT(readData(handle, "/mnt/./a//b/first") == "first");
+  }
+  CPPUNIT_ASSERT(ShellHelpers::openNode(handle, "/mnt/a/b/undefined") == nullptr);
+  CPPUNIT_ASSERT(ShellHelpers::openNode(handle, "/mnt/a/undefined/first") == nullptr);
+
+  // Descendants of the mountpoint are iterated as before
+  FsNode * const mnt = ShellHelpers::openNode(handle, "/mnt");
+  CPPUNIT_ASSERT(mnt != nullptr);
+  FsNode * const head = static_cast<FsNode *>(fsNodeHead(mnt));
+  CPPUNIT_ASSERT(head != nullptr);
+
+  char name[BUFFER_SIZE];
+
+  res = fsNodeRead(head, FS_NODE_NAME, 0, name, sizeof(name), nullptr);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(strcmp(name, "a") == 0);
+  CPPUNIT_ASSERT(fsNodeNext(head) != E_OK);
+  fsNodeFree(head);
+  fsNodeFree(mnt);
+
+  // Removal of a cached directory releases the cache
+  FsNode * const a = ShellHelpers::openNode(handle, "/mnt/a");
+  CPPUNIT_ASSERT(a != nullptr);
+  FsNode * const b = ShellHelpers::openNode(handle, "/mnt/a/b");
+  CPPUNIT_ASSERT(b != nullptr);
+  FsNode * const first = ShellHelpers::openNode(handle, "/mnt/a/b/first");
+  CPPUNIT_ASSERT(first != nullptr);
+
+  res = fsNodeRemove(b, first);
+  CPPUNIT_ASSERT(res == E_OK);
+  fsNodeFree(first);
+  res = fsNodeRemove(a, b);
+  CPPUNIT_ASSERT(res == E_OK);
+  fsNodeFree(b);
+  CPPUNIT_ASSERT(ShellHelpers::openNode(handle, "/mnt/a/b/first") == nullptr);
+
+  // Directory with the same path is opened again
+  const std::array<FsFieldDescriptor, 1> desc = {{
+      {"b", sizeof("b"), FS_NODE_NAME}
+  }};
+
+  res = fsNodeCreate(a, desc.data(), desc.size());
+  CPPUNIT_ASSERT(res == E_OK);
+  fsNodeFree(a);
+
+  makeData(target, "/a/b/second", "second");
+  CPPUNIT_ASSERT(readData(handle, "/mnt/a/b/second") == "second");
+
+  // Bound mountpoint resolves paths of the mounted file system
+  FsNode * const source = ShellHelpers::openNode(handle, "/mnt");
+  CPPUNIT_ASSERT(source != nullptr);
+  FsNode * const root = static_cast<FsNode *>(fsHandleRoot(handle));
+  CPPUNIT_ASSERT(root != nullptr);
+
+  VfsNode * const node = VfsNodeProxy::cast(source)->get();
+  const std::array<FsFieldDescriptor, 2> linkDesc = {{
+      {"view", sizeof("view"), FS_NODE_NAME},
+      {&node, sizeof(node), static_cast<FsFieldType>(VfsNode::VFS_NODE_LINK)}
+  }};
+
+  res = fsNodeCreate(root, linkDesc.data(), linkDesc.size());
+  CPPUNIT_ASSERT(res == E_OK);
+  fsNodeFree(root);
+  fsNodeFree(source);
+
+  CPPUNIT_ASSERT(readData(handle, "/view/a/b/second") == "second");
+}
+
+void VfsTest::testNodeCreationFailures()
+{
+  const FsAccess access = FS_ACCESS_READ | FS_ACCESS_WRITE;
+  const time64_t timestamp = 0;
+  Result res;
+
+  auto dir = new VfsDirectory{};
+  CPPUNIT_ASSERT(dir != nullptr);
+  auto node = new VfsDataNode{};
+  CPPUNIT_ASSERT(node != nullptr);
+
+  // Try to create node with incorrect access size
+
+  const std::array<FsFieldDescriptor, 1> accessSizeTest = {{
+      {
+          &access,
+          0,
+          FS_NODE_ACCESS
+      }
+  }};
+  res = dir->create(accessSizeTest.data(), accessSizeTest.size());
+  CPPUNIT_ASSERT(res == E_VALUE);
+
+  // Try to create node with incorrect timestamp size
+
+  const std::array<FsFieldDescriptor, 1> timeSizeTest = {{
+      {
+          &timestamp,
+          0,
+          FS_NODE_TIME
+      }
+  }};
+  res = dir->create(timeSizeTest.data(), timeSizeTest.size());
+  CPPUNIT_ASSERT(res == E_VALUE);
+
+  // Try to create node with incorrect name length
+
+  const std::array<FsFieldDescriptor, 1> nameSizeTest = {{
+      {
+          "",
+          0,
+          FS_NODE_NAME
+      }
+  }};
+  res = dir->create(nameSizeTest.data(), nameSizeTest.size());
+  CPPUNIT_ASSERT(res == E_VALUE);
+
+  // Try to create node with incorrect node object size
+
+  const std::array<FsFieldDescriptor, 1> objectSizeTest = {{
+      {
+          &node,
+          0,
+          static_cast<FsFieldType>(VfsNode::VFS_NODE_OBJECT)
+      }
+  }};
+  res = dir->create(objectSizeTest.data(), objectSizeTest.size());
+  CPPUNIT_ASSERT(res == E_VALUE);
+
+  // Mixed list of descriptors
+
+  const std::array<FsFieldDescriptor, 2> mixedListTest = {{
+      {
+          "test",
+          strlen("test") + 1,
+          FS_NODE_NAME
+      }, {
+          &node,
+          sizeof(node),
+          static_cast<FsFieldType>(VfsNode::VFS_NODE_OBJECT)
+      }
+  }};
+  res = dir->create(mixedListTest.data(), mixedListTest.size());
+  CPPUNIT_ASSERT(res == E_INVALID);
+
+  // Try to create node without name
+
+  const std::array<FsFieldDescriptor, 1> unnamedNodeTest = {{
+      {
+          &access,
+          sizeof(access),
+          FS_NODE_ACCESS
+      }
+  }};
+  res = dir->create(unnamedNodeTest.data(), unnamedNodeTest.size());
+  CPPUNIT_ASSERT(res == E_VALUE);
+
+  delete node;
+  delete dir;
+}
+
+void VfsTest::testNodeDeletionFailures()
+{
+  auto dir = new VfsDirectory{};
+  CPPUNIT_ASSERT(dir != nullptr);
+
+  auto proxy = static_cast<FsNode *>(fsHandleRoot(handle));
+  const auto res = dir->remove(proxy);
+  CPPUNIT_ASSERT(res == E_ENTRY);
+  fsNodeFree(proxy);
+
+  delete dir;
+}
+
+void VfsTest::testNodeInjection()
+{
+  Result res;
+
+  auto node = new VfsDataNode{};
+  CPPUNIT_ASSERT(node != nullptr);
+
+  // Test null pointer injection
+  res = ShellHelpers::injectNode(handle, nullptr, "/test");
+  CPPUNIT_ASSERT(res == E_VALUE);
+
+  // Test incorrect node name
+  res = ShellHelpers::injectNode(handle, node, "/");
+  CPPUNIT_ASSERT(res == E_VALUE);
+
+  // Test incorrect parent name
+  res = ShellHelpers::injectNode(handle, node, "/undefined/test");
+  CPPUNIT_ASSERT(res == E_ENTRY);
+
+  delete node;
+}
+
+void VfsTest::testNodeLayout()
+{
+  static const char STATIC_NAME[] = "static_name_of_the_node";
+
+  // Size budgets are defined for 64-bit hosts
+  if (sizeof(void *) == 8)
+  {
+    CPPUNIT_ASSERT(sizeof(VfsNode) <= 56);
+    CPPUNIT_ASSERT(sizeof(VfsDataNode) <= 88);
+    CPPUNIT_ASSERT(sizeof(VfsDirectory) <= 152);
+  }
+
+  const auto initialNames = VfsSlab::nameCache().stats();
+  auto node = new NamedTestNode{};
+  CPPUNIT_ASSERT(node != nullptr);
+
+  // Short names are stored inside the node
+  auto ok = node->rename("short");
+  CPPUNIT_ASSERT(ok == true);
+  CPPUNIT_ASSERT(strcmp(node->name(), "short") == 0);
+  CPPUNIT_ASSERT(VfsSlab::nameCache().stats().used == initialNames.used);
+
+  ok = node->rename("name_of_medium_length");
+  CPPUNIT_ASSERT(ok == true);
+  CPPUNIT_ASSERT(strcmp(node->name(), "name_of_medium_length") == 0);
+  CPPUNIT_ASSERT(VfsSlab::nameCache().stats().used == initialNames.used + 1);
+
+  // Moved node takes the name buffer
+  NamedTestNode moved{std::move(*node)};
+  CPPUNIT_ASSERT(strcmp(moved.name(), "name_of_medium_length") == 0);
+  CPPUNIT_ASSERT(node->name() == nullptr);
+  delete node;
+  CPPUNIT_ASSERT(VfsSlab::nameCache().stats().used == initialNames.used + 1);
+
+  ok = moved.rename(nullptr);
+  CPPUNIT_ASSERT(ok == true);
+  CPPUNIT_ASSERT(moved.name() == nullptr);
+  CPPUNIT_ASSERT(VfsSlab::nameCache().stats().used == initialNames.used);
+
+  // Static names are referenced without copying
+  NamedTestNode named{STATIC_NAME};
+  CPPUNIT_ASSERT(named.name() == STATIC_NAME);
+  CPPUNIT_ASSERT(VfsSlab::nameCache().stats().used == initialNames.used);
+}
+
+void VfsTest::testPathCache()
+{
+  VfsHandle * const vfs = VfsHandle::cast(handle);
+  CPPUNIT_ASSERT(vfs != nullptr);
+
+  auto dir = new VfsDirectory{};
+  CPPUNIT_ASSERT(dir != nullptr);
+  auto node = new VfsDataNode{};
+  CPPUNIT_ASSERT(node != nullptr);
+
+  Result res;
+
+  res = ShellHelpers::injectNode(handle, dir, "/dir");
+  CPPUNIT_ASSERT(res == E_OK);
+  res = ShellHelpers::injectNode(handle, node, "/dir/node");
+  CPPUNIT_ASSERT(res == E_OK);
+
+  const auto initial = vfs->cacheStats();
+  FsNode *proxy;
+
+  // First access fills the cache, second one should skip the walk
+  for (size_t i = 0; i < 2; ++i)
+  {
+    proxy = ShellHelpers::openNode(handle, "/dir/node");
+    CPPUNIT_ASSERT(proxy != nullptr);
+    CPPUNIT_ASSERT(reinterpret_cast<VfsNodeProxy *>(proxy)->get() == node);
+    fsNodeFree(proxy);
+  }
+
+  auto stats = vfs->cacheStats();
+  CPPUNIT_ASSERT(stats.hits == initial.hits + 1);
+  CPPUNIT_ASSERT(stats.misses == initial.misses + 1);
+
+  // Directory entry is already cached during node injection
+  proxy = ShellHelpers::openBaseNode(handle, "/dir/node");
+  CPPUNIT_ASSERT(proxy != nullptr);
+  CPPUNIT_ASSERT(reinterpret_cast<VfsNodeProxy *>(proxy)->get() == dir);
+  fsNodeFree(proxy);
+  proxy = ShellHelpers::openBaseNode(handle, "/dir/other");
+  CPPUNIT_ASSERT(proxy != nullptr);
+  fsNodeFree(proxy);
+
+  stats = vfs->cacheStats();
+  CPPUNIT_ASSERT(stats.hits == initial.hits + 3);
+  CPPUNIT_ASSERT(stats.misses == initial.misses + 1);
+
+  // Equivalent spellings of the path share the cached entry
+  static const char * const spellings[] = {"/dir//node", "/dir/./node", "//dir/node/"};
+
+  for (const auto spelling : spellings)
+  {
+    proxy = ShellHelpers::openNode(handle, spelling);
+    CPPUNIT_ASSERT(proxy != nullptr);
+    CPPUNIT_ASSERT(reinterpret_cast<VfsNodeProxy *>(proxy)->get() == node);
+    fsNodeFree(proxy);
+  }
+
+  stats = vfs->cacheStats();
+  CPPUNIT_ASSERT(stats.hits == initial.hits + 6);
+  CPPUNIT_ASSERT(stats.misses == initial.misses + 1);
+  CPPUNIT_ASSERT(stats.entries <= initial.entries + 1);
+
+  // Renaming of a parent directory invalidates entries of descendants
+  const auto ok = dir->rename("renamed");
+  CPPUNIT_ASSERT(ok == true);
+
+  proxy = ShellHelpers::openNode(handle, "/dir/node");
+  CPPUNIT_ASSERT(proxy == nullptr);
+  proxy = ShellHelpers::openNode(handle, "/renamed/node");
+  CPPUNIT_ASSERT(proxy != nullptr);
+  fsNodeFree(proxy);
+
+  // Removal invalidates the entry of the removed node
+  proxy = ShellHelpers::openNode(handle, "/renamed/node");
+  CPPUNIT_ASSERT(proxy != nullptr);
+  FsNode * const parent = ShellHelpers::openBaseNode(handle, "/renamed/node");
+  CPPUNIT_ASSERT(parent != nullptr);
+  res = fsNodeRemove(parent, proxy);
+  CPPUNIT_ASSERT(res == E_OK);
+  fsNodeFree(parent);
+  fsNodeFree(proxy);
+
+  proxy = ShellHelpers::openNode(handle, "/renamed/node");
+  CPPUNIT_ASSERT(proxy == nullptr);
+
+  stats = vfs->cacheStats();
+  CPPUNIT_ASSERT(stats.entries <= VfsPathCache::CAPACITY * VfsHandle::LOCK_SHARDS);
+}
+
+void VfsTest::testProxyPool()
+{
+  std::vector<FsNode *> proxies;
+
+  // Allocate more proxies than the pool can hold, last ones are allocated from the heap
+  for (size_t i = 0; i < VfsProxyPool::CAPACITY + 2; ++i)
+  {
+    FsNode * const proxy = static_cast<FsNode *>(fsHandleRoot(handle));
+    CPPUNIT_ASSERT(proxy != nullptr);
+    CPPUNIT_ASSERT(std::find(proxies.begin(), proxies.end(), proxy) == proxies.end());
+
+    proxies.push_back(proxy);
+  }
+
+  FsNode * const child = static_cast<FsNode *>(fsNodeHead(proxies.back()));
+  CPPUNIT_ASSERT(child == nullptr);
+
+  for (auto proxy : proxies)
+    fsNodeFree(proxy);
+
+  // Released slot should be reused
+  FsNode * const first = static_cast<FsNode *>(fsHandleRoot(handle));
+  CPPUNIT_ASSERT(first != nullptr);
+  fsNodeFree(first);
+
+  FsNode * const second = static_cast<FsNode *>(fsHandleRoot(handle));
+  CPPUNIT_ASSERT(second == first);
+  fsNodeFree(second);
+}
+
+void VfsTest::testSlabCaches()
+{
+  static constexpr size_t NODE_COUNT{40};
+
+  const auto initialData = VfsSlab::dataCache().stats();
+  const auto initialNames = VfsSlab::nameCache().stats();
+
+  FsNode * const root = static_cast<FsNode *>(fsHandleRoot(handle));
+  CPPUNIT_ASSERT(root != nullptr);
+
+  // Names are long enough to be allocated from the name cache
+  for (size_t i = 0; i < NODE_COUNT; ++i)
+  {
+    const std::string name = "long_node_name_" + std::to_string(i);
+    const std::array<FsFieldDescriptor, 2> desc = {{
+        {name.c_str(), name.size() + 1, FS_NODE_NAME},
+        {nullptr, 0, FS_NODE_DATA}
+    }};
+
+    const auto res = fsNodeCreate(root, desc.data(), desc.size());
+    CPPUNIT_ASSERT(res == E_OK);
+  }
+
+  auto data = VfsSlab::dataCache().stats();
+  auto names = VfsSlab::nameCache().stats();
+
+  CPPUNIT_ASSERT(data.objectSize >= sizeof(VfsDataNode));
+  CPPUNIT_ASSERT(data.used == initialData.used + NODE_COUNT);
+  CPPUNIT_ASSERT(data.used <= data.capacity);
+  CPPUNIT_ASSERT(data.slabs > initialData.slabs);
+  CPPUNIT_ASSERT(names.used == initialNames.used + NODE_COUNT);
+  // Chunks of the name cache have no headers
+  CPPUNIT_ASSERT(names.chunkSize <= VfsSlab::NAME_LENGTH);
+
+  // Node with a long name should take the name from the heap
+  auto node = new VfsDataNode{};
+  CPPUNIT_ASSERT(node != nullptr);
+  const std::string longName(VfsSlab::NAME_LENGTH, 'x');
+  const auto ok = node->rename(longName.c_str());
+  CPPUNIT_ASSERT(ok == true);
+  CPPUNIT_ASSERT(VfsSlab::nameCache().stats().used == names.used);
+  delete node;
+
+  for (size_t i = 0; i < NODE_COUNT; ++i)
+  {
+    const std::string path = "/long_node_name_" + std::to_string(i);
+    FsNode * const child = ShellHelpers::openNode(handle, path.c_str());
+    CPPUNIT_ASSERT(child != nullptr);
+
+    const auto res = fsNodeRemove(root, child);
+    CPPUNIT_ASSERT(res == E_OK);
+    fsNodeFree(child);
+  }
+
+  fsNodeFree(root);
+
+  // Empty slabs are released except for one spare slab per cache
+  data = VfsSlab::dataCache().stats();
+  names = VfsSlab::nameCache().stats();
+
+  CPPUNIT_ASSERT(data.used == initialData.used);
+  CPPUNIT_ASSERT(data.slabs <= initialData.slabs + 1);
+  CPPUNIT_ASSERT(names.used == initialNames.used);
+  CPPUNIT_ASSERT(names.slabs <= initialNames.slabs + 1);
+}
+
+void VfsTest::testWatcher()
+{
+  static const auto readIdentifier = [](FsNode *node){
+    FsIdentifier id = 0;
+    fsNodeRead(node, FS_NODE_ID, 0, &id, sizeof(id), nullptr);
+    return id;
+  };
+  static const auto onNodeChanged = [](void *argument){
+    ++*static_cast<size_t *>(argument);
+  };
+
+  VfsHandle * const vfs = VfsHandle::cast(handle);
+  const uint8_t value = 0;
+  VfsWatcher::Event event;
+  Result res;
+
+  res = ShellHelpers::injectNode(handle, new VfsDirectory{}, "/watched");
+  CPPUNIT_ASSERT(res == E_OK);
+  res = ShellHelpers::injectNode(handle, new VfsDataNode{}, "/watched/data");
+  CPPUNIT_ASSERT(res == E_OK);
+  res = ShellHelpers::injectNode(handle, new VfsDirectory{}, "/watched/nested");
+  CPPUNIT_ASSERT(res == E_OK);
+  res = ShellHelpers::injectNode(handle, new VfsDataNode{}, "/watched/nested/data");
+  CPPUNIT_ASSERT(res == E_OK);
+
+  FsNode * const directory = ShellHelpers::openNode(handle, "/watched");
+  CPPUNIT_ASSERT(directory != nullptr);
+  FsNode * const data = ShellHelpers::openNode(handle, "/watched/data");
+  CPPUNIT_ASSERT(data != nullptr);
+  FsNode * const nested = ShellHelpers::openNode(handle, "/watched/nested/data");
+  CPPUNIT_ASSERT(nested != nullptr);
+
+  size_t calls = 0;
+  VfsWatcher watcher{VfsNodeProxy::cast(directory)->get(), onNodeChanged, &calls};
+
+  vfs->watch(&watcher);
+
+  // Creation of a descendant is reported with its identifier
+  const std::array<FsFieldDescriptor, 2> desc = {{
+      {"created", sizeof("created"), FS_NODE_NAME},
+      {nullptr, 0, FS_NODE_DATA}
+  }};
+
+  res = fsNodeCreate(directory, desc.data(), desc.size());
+  CPPUNIT_ASSERT(res == E_OK);
+  FsNode * const created = ShellHelpers::openNode(handle, "/watched/created");
+  CPPUNIT_ASSERT(created != nullptr);
+
+  CPPUNIT_ASSERT(calls == 1);
+  CPPUNIT_ASSERT(watcher.pop(&event) == true);
+  CPPUNIT_ASSERT(event.type == VfsWatcher::EVENT_CREATE);
+  CPPUNIT_ASSERT(event.node == readIdentifier(created));
+  CPPUNIT_ASSERT(watcher.pop(&event) == false);
+
+  // Repeated writes are coalesced until the event is popped
+  for (size_t i = 0; i < 4; ++i)
+  {
+    res = fsNodeWrite(data, FS_NODE_DATA, i, &value, sizeof(value), nullptr);
+    CPPUNIT_ASSERT(res == E_OK);
+  }
+
+  CPPUNIT_ASSERT(watcher.pop(&event) == true);
+  CPPUNIT_ASSERT(event.type == VfsWatcher::EVENT_WRITE);
+  CPPUNIT_ASSERT(event.node == readIdentifier(data));
+  CPPUNIT_ASSERT(watcher.pop(&event) == false);
+
+  res = fsNodeWrite(data, FS_NODE_DATA, 0, &value, sizeof(value), nullptr);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(watcher.pop(&event) == true);
+  CPPUNIT_ASSERT(event.type == VfsWatcher::EVENT_WRITE);
+
+  // Attributes of the watched node are reported as well
+  const FsAccess access = FS_ACCESS_READ | FS_ACCESS_WRITE;
+
+  res = fsNodeWrite(directory, FS_NODE_ACCESS, 0, &access, sizeof(access), nullptr);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(watcher.pop(&event) == true);
+  CPPUNIT_ASSERT(event.type == VfsWatcher::EVENT_ATTRIBUTE);
+  CPPUNIT_ASSERT(event.node == readIdentifier(directory));
+
+  // Changes deeper in the tree are not reported
+  res = fsNodeWrite(nested, FS_NODE_DATA, 0, &value, sizeof(value), nullptr);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(watcher.pop(&event) == false);
+
+  // Removed node is still identified by the event
+  const FsIdentifier createdId = readIdentifier(created);
+
+  res = fsNodeRemove(directory, created);
+  CPPUNIT_ASSERT(res == E_OK);
+  fsNodeFree(created);
+
+  CPPUNIT_ASSERT(watcher.pop(&event) == true);
+  CPPUNIT_ASSERT(event.type == VfsWatcher::EVENT_REMOVE);
+  CPPUNIT_ASSERT(event.node == createdId);
+
+  // Events over the queue depth are dropped and reported once
+  for (size_t i = 0; i < VfsWatcher::DEPTH + 4; ++i)
+  {
+    res = fsNodeWrite(data, FS_NODE_ACCESS, 0, &access, sizeof(access), nullptr);
+    CPPUNIT_ASSERT(res == E_OK);
+  }
+
+  for (size_t i = 0; i < VfsWatcher::DEPTH; ++i)
+  {
+    CPPUNIT_ASSERT(watcher.pop(&event) == true);
+    CPPUNIT_ASSERT(event.type == VfsWatcher::EVENT_ATTRIBUTE);
+  }
+
+  CPPUNIT_ASSERT(watcher.pop(&event) == true);
+  CPPUNIT_ASSERT(event.type == VfsWatcher::EVENT_OVERFLOW);
+  CPPUNIT_ASSERT(watcher.pop(&event) == false);
+
+  vfs->unwatch(&watcher);
+  // Replaced lists of watchers are released after the grace period
+  CPPUNIT_ASSERT(vfs->epoch().pending() == 0);
+
+  res = fsNodeWrite(data, FS_NODE_DATA, 0, &value, sizeof(value), nullptr);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(watcher.pop(&event) == false);
+
+  // Watcher of a released node is detached
+  VfsWatcher removed{VfsNodeProxy::cast(data)->get(), nullptr, nullptr};
+
+  vfs->watch(&removed);
+  res = fsNodeRemove(directory, data);
+  CPPUNIT_ASSERT(res == E_OK);
+  CPPUNIT_ASSERT(removed.pop(&event) == true);
+  CPPUNIT_ASSERT(event.type == VfsWatcher::EVENT_REMOVE);
+  CPPUNIT_ASSERT(removed.node() != nullptr);
+
+  // Node is released when the proxies that may reach it are gone
+  fsNodeFree(data);
+  fsNodeFree(nested);
+  fsNodeFree(directory);
+
+  CPPUNIT_ASSERT(vfs->epoch().pending() == 0);
+  CPPUNIT_ASSERT(removed.node() == nullptr);
+  vfs->unwatch(&removed);
 }
 
 CPPUNIT_TEST_SUITE_REGISTRATION(VfsTest);
@@ -0,0 +1,563 @@
+/*
+ * Main.cpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "Shell/ShellHelpers.hpp"
+#include "Vfs/VfsDataNode.hpp"
+#include "Vfs/VfsDirectory.hpp"
+#include "Vfs/VfsHandle.hpp"
+#include "Vfs/VfsWatcher.hpp"
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+class VfsConcurrencyTest: public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE(VfsConcurrencyTest);
+  CPPUNIT_TEST(testCacheWithRenames);
+  CPPUNIT_TEST(testCrossLinks);
+  CPPUNIT_TEST(testLinksWithReaders);
+  CPPUNIT_TEST(testReadersWithWriter);
+  CPPUNIT_TEST(testTraversalWithWriter);
+  CPPUNIT_TEST(testWatcherWithWriters);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp();
+  void tearDown();
+
+  void testCacheWithRenames();
+  void testCrossLinks();
+  void testLinksWithReaders();
+  void testReadersWithWriter();
+  void testTraversalWithWriter();
+  void testWatcherWithWriters();
+
+private:
+  static constexpr size_t FILE_COUNT{16};
+  static constexpr size_t FILE_LENGTH{65536};
+  static constexpr size_t ITERATIONS{2000};
+  static constexpr size_t MAX_THREADS{4};
+
+  FsHandle *handle{nullptr};
+
+  void populate();
+  size_t readFiles(size_t, size_t);
+  bool traverseDirectory(size_t);
+  bool writeFiles(size_t, const std::atomic<bool> *);
+};
+
+void VfsConcurrencyTest::setUp()
+{
+  handle = static_cast<FsHandle *>(init(VfsHandleClass, nullptr));
+  CPPUNIT_ASSERT(handle != nullptr);
+
+  populate();
+}
+
+void VfsConcurrencyTest::tearDown()
+{
+  deinit(handle);
+}
+
+void VfsConcurrencyTest::populate()
+{
+  Result res;
+
+  res = ShellHelpers::injectNode(handle, new VfsDirectory{}, "/data");
+  CPPUNIT_ASSERT(res == E_OK);
+  res = ShellHelpers::injectNode(handle, new VfsDirectory{}, "/scratch");
+  CPPUNIT_ASSERT(res == E_OK);
+
+  for (size_t i = 0; i < FILE_COUNT; ++i)
+  {
+    const std::string path = "/data/" + std::to_string(i);
+    VfsDataNode * const node = new VfsDataNode{};
+
+    CPPUNIT_ASSERT(node != nullptr);
+    CPPUNIT_ASSERT(node->reserve(FILE_LENGTH, static_cast<char>('a' + i)) == true);
+
+    res = ShellHelpers::injectNode(handle, node, path.c_str());
+    CPPUNIT_ASSERT(res == E_OK);
+  }
+}
+
+size_t VfsConcurrencyTest::readFiles(size_t index, size_t iterations)
+{
+  std::vector<uint8_t> buffer(FILE_LENGTH);
+  size_t total = 0;
+
+  for (size_t iteration = 0; iteration < iterations; ++iteration)
+  {
+    const size_t number = (index + iteration) % FILE_COUNT;
+    const std::string path = "/data/" + std::to_string(number);
+
+    FsNode * const node = ShellHelpers::openNode(handle, path.c_str());
+    if (node == nullptr)
+      return 0;
+
+    size_t count;
+    const Result res = fsNodeRead(node, FS_NODE_DATA, 0, buffer.data(), buffer.size(), &count);
+    fsNodeFree(node);
+
+    if (res != E_OK || count != FILE_LENGTH)
+      return 0;
+
+    // Data of each file is filled with a single value
+    const auto value = static_cast<uint8_t>('a' + number);
+    if (buffer[0] != value || memcmp(buffer.data(), buffer.data() + 1, buffer.size() - 1))
+      return 0;
+
+    total += count;
+  }
+
+  return total;
+}
+
+bool VfsConcurrencyTest::traverseDirectory(size_t iterations)
+{
+  for (size_t iteration = 0; iteration < iterations; ++iteration)
+  {
+    FsNode * const scratch = ShellHelpers::openNode(handle, "/scratch");
+    if (scratch == nullptr)
+      return false;
+
+    FsNode * const child = static_cast<FsNode *>(fsNodeHead(scratch));
+    fsNodeFree(scratch);
+
+    if (child == nullptr)
+      continue;
+
+    bool ok = true;
+
+    do
+    {
+      // Names of nodes created by the writer consist of a single digit
+      char name[8];
+
+      if (fsNodeRead(child, FS_NODE_NAME, 0, name, sizeof(name), nullptr) != E_OK || strlen(name) != 1)
+        ok = false;
+    }
+    while (ok && fsNodeNext(child) == E_OK);
+
+    fsNodeFree(child);
+
+    if (!ok)
+      return false;
+  }
+
+  return true;
+}
+
+bool VfsConcurrencyTest::writeFiles(size_t iterations, const std::atomic<bool> *stop)
+{
+  static const char PATTERN[] = "pattern";
+
+  FsNode * const scratch = ShellHelpers::openNode(handle, "/scratch");
+  if (scratch == nullptr)
+    return false;
+
+  bool ok = true;
+
+  for (size_t iteration = 0; ok && (iteration < iterations || !stop->load()); ++iteration)
+  {
+    const std::string name = std::to_string(iteration % 8);
+    const std::string path = "/scratch/" + name;
+    const std::array<FsFieldDescriptor, 2> desc = {{
+        {name.c_str(), name.size() + 1, FS_NODE_NAME},
+        {PATTERN, sizeof(PATTERN), FS_NODE_DATA}
+    }};
+
+    if (fsNodeCreate(scratch, desc.data(), desc.size()) != E_OK)
+    {
+      ok = false;
+      break;
+    }
+
+    FsNode * const node = ShellHelpers::openNode(handle, path.c_str());
+
+    if (node != nullptr)
+    {
+      // Append data and remove the node
+      ok = fsNodeWrite(node, FS_NODE_DATA, sizeof(PATTERN), PATTERN, sizeof(PATTERN), nullptr) == E_OK
+          && fsNodeRemove(scratch, node) == E_OK;
+      fsNodeFree(node);
+    }
+    else
+      ok = false;
+  }
+
+  fsNodeFree(scratch);
+  return ok;
+}
+
+void VfsConcurrencyTest::testCacheWithRenames()
+{
+  FsNode * const scratch = ShellHelpers::openNode(handle, "/scratch");
+  CPPUNIT_ASSERT(scratch != nullptr);
+
+  VfsHandle * const vfs = VfsHandle::cast(handle);
+  VfsNode * const directory = VfsNodeProxy::cast(scratch)->get();
+  const auto initial = vfs->cacheStats();
+
+  std::atomic<bool> stop{false};
+  std::vector<std::thread> readers;
+  std::array<bool, MAX_THREADS> results{};
+  bool renamed = true;
+
+  // Renames invalidate every shard of the path cache while readers fill it
+  std::thread writer{[directory, &stop, &renamed](){
+    for (size_t iteration = 0; renamed && !stop.load(); ++iteration)
+      renamed = directory->rename(iteration & 1 ? "scratch" : "other");
+
+    renamed = renamed && directory->rename("scratch");
+  }};
+
+  for (size_t i = 0; i < MAX_THREADS; ++i)
+  {
+    readers.emplace_back([this, i, directory, &results](){
+      bool ok = true;
+
+      for (size_t iteration = 0; ok && iteration < ITERATIONS / 10; ++iteration)
+      {
+        // Cached entries never point to another node
+        for (const char *path : {"/scratch", "/other"})
+        {
+          FsNode * const node = ShellHelpers::openNode(handle, path);
+
+          if (node != nullptr)
+          {
+            ok = ok && VfsNodeProxy::cast(node)->get() == directory;
+            fsNodeFree(node);
+          }
+        }
+
+        ok = ok && readFiles(i + iteration, 1) == FILE_LENGTH;
+      }
+
+      results[i] = ok;
+    });
+  }
+
+  for (auto &reader : readers)
+    reader.join();
+
+  stop = true;
+  writer.join();
+  fsNodeFree(scratch);
+
+  CPPUNIT_ASSERT(renamed == true);
+  for (const auto result : results)
+    CPPUNIT_ASSERT(result == true);
+
+  // Every lookup is counted once by a shard of the cache
+  const auto stats = vfs->cacheStats();
+  const size_t lookups = (stats.hits - initial.hits) + (stats.misses - initial.misses);
+
+  CPPUNIT_ASSERT(lookups == MAX_THREADS * ITERATIONS / 10 * 3);
+  CPPUNIT_ASSERT(stats.entries <= VfsPathCache::CAPACITY * VfsHandle::LOCK_SHARDS);
+}
+
+void VfsConcurrencyTest::testCrossLinks()
+{
+  Result res;
+
+  res = ShellHelpers::injectNode(handle, new VfsDirectory{}, "/scratch/a");
+  CPPUNIT_ASSERT(res == E_OK);
+  res = ShellHelpers::injectNode(handle, new VfsDirectory{}, "/scratch/b");
+  CPPUNIT_ASSERT(res == E_OK);
+
+  FsNode * const first = ShellHelpers::openNode(handle, "/scratch/a");
+  CPPUNIT_ASSERT(first != nullptr);
+  FsNode * const second = ShellHelpers::openNode(handle, "/scratch/b");
+  CPPUNIT_ASSERT(second != nullptr);
+
+  VfsNode * const firstNode = VfsNodeProxy::cast(first)->get();
+  VfsNode * const secondNode = VfsNodeProxy::cast(second)->get();
+  const std::array<FsFieldDescriptor, 2> firstDesc = {{
+      {"link", sizeof("link"), FS_NODE_NAME},
+      {&secondNode, sizeof(secondNode), static_cast<FsFieldType>(VfsNode::VFS_NODE_LINK)}
+  }};
+  const std::array<FsFieldDescriptor, 2> secondDesc = {{
+      {"link", sizeof("link"), FS_NODE_NAME},
+      {&firstNode, sizeof(firstNode), static_cast<FsFieldType>(VfsNode::VFS_NODE_LINK)}
+  }};
+
+  const auto unlink = [this](FsNode *directory, const char *path){
+    FsNode * const link = ShellHelpers::openNode(handle, path);
+
+    if (link != nullptr)
+    {
+      fsNodeRemove(directory, link);
+      fsNodeFree(link);
+    }
+  };
+
+  // Links in opposite directions are created concurrently, only one of them is inserted
+  for (size_t iteration = 0; iteration < ITERATIONS / 10; ++iteration)
+  {
+    Result firstRes = E_OK;
+    Result secondRes = E_OK;
+
+    std::thread writer{[first, &firstDesc, &firstRes](){
+      firstRes = fsNodeCreate(first, firstDesc.data(), firstDesc.size());
+    }};
+    secondRes = fsNodeCreate(second, secondDesc.data(), secondDesc.size());
+    writer.join();
+
+    CPPUNIT_ASSERT(firstRes == E_OK || firstRes == E_INVALID);
+    CPPUNIT_ASSERT(secondRes == E_OK || secondRes == E_INVALID);
+    CPPUNIT_ASSERT((firstRes == E_OK) != (secondRes == E_OK));
+
+    unlink(first, "/scratch/a/link");
+    unlink(second, "/scratch/b/link");
+  }
+
+  fsNodeFree(second);
+  fsNodeFree(first);
+}
+
+void VfsConcurrencyTest::testLinksWithReaders()
+{
+  FsNode * const scratch = ShellHelpers::openNode(handle, "/scratch");
+  CPPUNIT_ASSERT(scratch != nullptr);
+  FsNode * const target = ShellHelpers::openNode(handle, "/data/0");
+  CPPUNIT_ASSERT(target != nullptr);
+
+  VfsNode * const node = VfsNodeProxy::cast(target)->get();
+  const std::array<FsFieldDescriptor, 2> desc = {{
+      {"link", sizeof("link"), FS_NODE_NAME},
+      {&node, sizeof(node), static_cast<FsFieldType>(VfsNode::VFS_NODE_LINK)}
+  }};
+
+  std::atomic<bool> stop{false};
+  std::vector<std::thread> readers;
+  std::array<bool, MAX_THREADS> results{};
+  bool linked = true;
+
+  // Writer creates and removes the link while readers open the target through it
+  std::thread writer{[this, scratch, &desc, &stop, &linked](){
+    while (linked && !stop.load())
+    {
+      linked = fsNodeCreate(scratch, desc.data(), desc.size()) == E_OK;
+
+      FsNode * const link = ShellHelpers::openNode(handle, "/scratch/link");
+
+      if (link != nullptr)
+      {
+        linked = linked && fsNodeRemove(scratch, link) == E_OK;
+        fsNodeFree(link);
+      }
+      else
+        linked = false;
+    }
+  }};
+
+  for (size_t i = 0; i < MAX_THREADS; ++i)
+  {
+    readers.emplace_back([this, i, &results](){
+      std::vector<uint8_t> buffer(FILE_LENGTH);
+      bool ok = true;
+
+      for (size_t iteration = 0; ok && iteration < ITERATIONS / 10; ++iteration)
+      {
+        FsNode * const link = ShellHelpers::openNode(handle, "/scratch/link");
+
+        if (link != nullptr)
+        {
+          size_t count;
+
+          // Data of the target stays readable after removal of the link
+          ok = fsNodeRead(link, FS_NODE_DATA, 0, buffer.data(), buffer.size(), &count) == E_OK
+              && count == FILE_LENGTH && buffer[0] == 'a' && buffer[FILE_LENGTH - 1] == 'a';
+          fsNodeFree(link);
+        }
+      }
+
+      results[i] = ok;
+    });
+  }
+
+  for (auto &reader : readers)
+    reader.join();
+
+  stop = true;
+  writer.join();
+
+  fsNodeFree(target);
+  fsNodeFree(scratch);
+
+  CPPUNIT_ASSERT(linked == true);
+  for (const auto result : results)
+    CPPUNIT_ASSERT(result == true);
+
+  // Links are released, the target is still in place
+  CPPUNIT_ASSERT(VfsHandle::cast(handle)->epoch().pending() == 0);
+  CPPUNIT_ASSERT(readFiles(0, FILE_COUNT) == FILE_COUNT * FILE_LENGTH);
+}
+
+void VfsConcurrencyTest::testReadersWithWriter()
+{
+  std::atomic<bool> stop{false};
+  std::vector<std::thread> readers;
+  std::vector<size_t> results(MAX_THREADS);
+  bool written = false;
+
+  // Writer modifies another directory until all readers are finished
+  std::thread writer{[this, &stop, &written](){ written = writeFiles(ITERATIONS / 10, &stop); }};
+
+  for (size_t i = 0; i < MAX_THREADS; ++i)
+    readers.emplace_back([this, i, &results](){ results[i] = readFiles(i, ITERATIONS / 10); });
+  for (auto &reader : readers)
+    reader.join();
+
+  stop = true;
+  writer.join();
+
+  CPPUNIT_ASSERT(written == true);
+  for (const auto result : results)
+    CPPUNIT_ASSERT(result == ITERATIONS / 10 * FILE_LENGTH);
+
+  // Listing of the directory changed by the writer
+  FsNode * const scratch = ShellHelpers::openNode(handle, "/scratch");
+  CPPUNIT_ASSERT(scratch != nullptr);
+  CPPUNIT_ASSERT(fsNodeHead(scratch) == nullptr);
+  fsNodeFree(scratch);
+}
+
+void VfsConcurrencyTest::testTraversalWithWriter()
+{
+  std::atomic<bool> stop{false};
+  std::vector<std::thread> readers;
+  std::array<bool, MAX_THREADS> results{};
+  bool written = false;
+
+  // Writer creates and removes nodes of the directory traversed by readers
+  std::thread writer{[this, &stop, &written](){ written = writeFiles(ITERATIONS / 10, &stop); }};
+
+  for (size_t i = 0; i < MAX_THREADS; ++i)
+    readers.emplace_back([this, i, &results](){ results[i] = traverseDirectory(ITERATIONS); });
+  for (auto &reader : readers)
+    reader.join();
+
+  stop = true;
+  writer.join();
+
+  CPPUNIT_ASSERT(written == true);
+  for (const auto result : results)
+    CPPUNIT_ASSERT(result == true);
+
+  // All removed nodes are released when readers are gone
+  CPPUNIT_ASSERT(VfsHandle::cast(handle)->epoch().pending() == 0);
+}
+
+void VfsConcurrencyTest::testWatcherWithWriters()
+{
+  VfsHandle * const vfs = VfsHandle::cast(handle);
+  FsNode * const directory = ShellHelpers::openNode(handle, "/data");
+  CPPUNIT_ASSERT(directory != nullptr);
+
+  std::atomic<size_t> finished{0};
+  std::vector<std::thread> writers;
+  std::array<bool, MAX_THREADS> results{};
+  VfsWatcher watcher{VfsNodeProxy::cast(directory)->get(), nullptr, nullptr};
+
+  vfs->watch(&watcher);
+
+  // Each writer rewrites the first byte of its own file
+  for (size_t i = 0; i < MAX_THREADS; ++i)
+  {
+    writers.emplace_back([this, i, &finished, &results](){
+      const std::string path = "/data/" + std::to_string(i);
+      const auto value = static_cast<uint8_t>('a' + i);
+      bool ok = true;
+
+      for (size_t iteration = 0; ok && iteration < ITERATIONS; ++iteration)
+      {
+        FsNode * const node = ShellHelpers::openNode(handle, path.c_str());
+
+        ok = node != nullptr && fsNodeWrite(node, FS_NODE_DATA, 0, &value, sizeof(value), nullptr) == E_OK;
+        if (node != nullptr)
+          fsNodeFree(node);
+      }
+
+      results[i] = ok;
+      ++finished;
+    });
+  }
+
+  // Another subscriber is attached and detached while writers dispatch events
+  std::thread subscriber{[vfs, &directory, &finished](){
+    while (finished.load() != MAX_THREADS)
+    {
+      VfsWatcher transient{VfsNodeProxy::cast(directory)->get(), nullptr, nullptr};
+
+      vfs->watch(&transient);
+      std::this_thread::yield();
+      vfs->unwatch(&transient);
+    }
+  }};
+
+  std::set<FsIdentifier> written;
+  size_t events = 0;
+  bool overflow = false;
+  bool valid = true;
+
+  // Queue is drained once more after all writers are finished
+  for (bool last = false; !last;)
+  {
+    VfsWatcher::Event event;
+
+    last = finished.load() == MAX_THREADS;
+
+    while (watcher.pop(&event))
+    {
+      ++events;
+
+      if (event.type == VfsWatcher::EVENT_WRITE && event.node != 0)
+        written.insert(event.node);
+      else if (event.type == VfsWatcher::EVENT_OVERFLOW)
+        overflow = true;
+      else
+        valid = false;
+    }
+  }
+
+  for (auto &writer : writers)
+    writer.join();
+  subscriber.join();
+  vfs->unwatch(&watcher);
+  fsNodeFree(directory);
+
+  for (const auto result : results)
+    CPPUNIT_ASSERT(result == true);
+
+  // Repeated writes are coalesced, every file is reported unless events were dropped
+  CPPUNIT_ASSERT(valid == true);
+  CPPUNIT_ASSERT(events > 0 && events <= MAX_THREADS * ITERATIONS + 1);
+  CPPUNIT_ASSERT(overflow || written.size() == MAX_THREADS);
+}
+
+CPPUNIT_TEST_SUITE_REGISTRATION(VfsConcurrencyTest);
+
+int main(int, char *[])
+{
+  CPPUNIT_NS::Test * const suite = CPPUNIT_NS::TestFactoryRegistry::getRegistry().makeTest();
+
+  CppUnit::TextUi::TestRunner runner;
+  runner.addTest(suite);
+
+  const bool sucessful = runner.run();
+  return sucessful ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,152 @@
+/*
+ * Main.cpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "Shell/ShellHelpers.hpp"
+#include "Vfs/VfsDataNode.hpp"
+#include "Vfs/VfsDirectory.hpp"
+#include "Vfs/VfsHandle.hpp"
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+class VfsConcurrencyBenchmark: public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE(VfsConcurrencyBenchmark);
+  CPPUNIT_TEST(testReadScaling);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp();
+  void tearDown();
+
+  void testReadScaling();
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  static constexpr size_t FILE_COUNT{16};
+  static constexpr size_t FILE_LENGTH{65536};
+  static constexpr size_t ITERATIONS{2000};
+  static constexpr size_t MAX_THREADS{4};
+  // Minimal speedup of parallel readers, serialized readers stay below it
+  static constexpr double SCALING_LIMIT{1.2};
+
+  FsHandle *handle{nullptr};
+
+  double measure(size_t);
+  size_t readFiles(size_t, size_t);
+};
+
+void VfsConcurrencyBenchmark::setUp()
+{
+  handle = static_cast<FsHandle *>(init(VfsHandleClass, nullptr));
+  CPPUNIT_ASSERT(handle != nullptr);
+
+  Result res;
+
+  res = ShellHelpers::injectNode(handle, new VfsDirectory{}, "/data");
+  CPPUNIT_ASSERT(res == E_OK);
+
+  for (size_t i = 0; i < FILE_COUNT; ++i)
+  {
+    const std::string path = "/data/" + std::to_string(i);
+    VfsDataNode * const node = new VfsDataNode{};
+
+    CPPUNIT_ASSERT(node != nullptr);
+    CPPUNIT_ASSERT(node->reserve(FILE_LENGTH, static_cast<char>('a' + i)) == true);
+
+    res = ShellHelpers::injectNode(handle, node, path.c_str());
+    CPPUNIT_ASSERT(res == E_OK);
+  }
+}
+
+void VfsConcurrencyBenchmark::tearDown()
+{
+  deinit(handle);
+}
+
+size_t VfsConcurrencyBenchmark::readFiles(size_t index, size_t iterations)
+{
+  std::vector<uint8_t> buffer(FILE_LENGTH);
+  size_t total = 0;
+
+  for (size_t iteration = 0; iteration < iterations; ++iteration)
+  {
+    const size_t number = (index + iteration) % FILE_COUNT;
+    const std::string path = "/data/" + std::to_string(number);
+
+    FsNode * const node = ShellHelpers::openNode(handle, path.c_str());
+    if (node == nullptr)
+      return 0;
+
+    size_t count;
+    const Result res = fsNodeRead(node, FS_NODE_DATA, 0, buffer.data(), buffer.size(), &count);
+    fsNodeFree(node);
+
+    if (res != E_OK || count != FILE_LENGTH)
+      return 0;
+
+    total += count;
+  }
+
+  return total;
+}
+
+double VfsConcurrencyBenchmark::measure(size_t threadCount)
+{
+  std::vector<std::thread> threads;
+  std::vector<size_t> results(threadCount);
+
+  const auto start = Clock::now();
+
+  for (size_t i = 0; i < threadCount; ++i)
+    threads.emplace_back([this, i, &results](){ results[i] = readFiles(i, ITERATIONS); });
+  for (auto &thread : threads)
+    thread.join();
+
+  const std::chrono::duration<double> time = Clock::now() - start;
+
+  for (const auto result : results)
+    CPPUNIT_ASSERT(result == ITERATIONS * FILE_LENGTH);
+
+  const double throughput = static_cast<double>(threadCount * ITERATIONS * FILE_LENGTH) / time.count();
+
+  std::cout << threadCount << " readers: " << throughput / (1024.0 * 1024.0) << " MiB/s" << std::endl;
+  return throughput;
+}
+
+void VfsConcurrencyBenchmark::testReadScaling()
+{
+  const size_t cores = std::min<size_t>(std::thread::hardware_concurrency(), MAX_THREADS);
+
+  const double single = measure(1);
+  const double parallel = measure(std::max<size_t>(cores, 2));
+
+  // Scaling can be measured only on multi-core machines
+  if (cores >= 2)
+    CPPUNIT_ASSERT(parallel >= single * SCALING_LIMIT);
+}
+
+CPPUNIT_TEST_SUITE_REGISTRATION(VfsConcurrencyBenchmark);
+
+int main(int, char *[])
+{
+  CPPUNIT_NS::Test * const suite = CPPUNIT_NS::TestFactoryRegistry::getRegistry().makeTest();
+
+  CppUnit::TextUi::TestRunner runner;
+  runner.addTest(suite);
+
+  const bool sucessful = runner.run();
+  return sucessful ? EXIT_SUCCESS : EXIT_FAILURE;
+}
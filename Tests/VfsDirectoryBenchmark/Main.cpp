@@ -0,0 +1,169 @@
+/*
+ * Main.cpp
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "Shell/ShellHelpers.hpp"
+#include "Vfs/VfsDirectory.hpp"
+#include "Vfs/VfsHandle.hpp"
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+class VfsDirectoryBenchmark: public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE(VfsDirectoryBenchmark);
+  CPPUNIT_TEST(testScaling);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp();
+  void tearDown();
+
+  void testScaling();
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Timings
+  {
+    double list;
+    double lookup;
+  };
+
+  static constexpr size_t SMALL_COUNT{1000};
+  static constexpr size_t LARGE_COUNT{100000};
+  // Allowed per-node slowdown, quadratic algorithms exceed it by an order of magnitude
+  static constexpr double SCALING_LIMIT{8.0};
+
+  FsHandle *handle{nullptr};
+
+  Timings measure(size_t);
+  void populate(const char *, size_t);
+};
+
+void VfsDirectoryBenchmark::setUp()
+{
+  handle = static_cast<FsHandle *>(init(VfsHandleClass, nullptr));
+  CPPUNIT_ASSERT(handle != nullptr);
+}
+
+void VfsDirectoryBenchmark::tearDown()
+{
+  deinit(handle);
+}
+
+void VfsDirectoryBenchmark::populate(const char *path, size_t count)
+{
+  Result res;
+
+  res = ShellHelpers::injectNode(handle, new VfsDirectory{}, path);
+  CPPUNIT_ASSERT(res == E_OK);
+
+  FsNode * const dir = ShellHelpers::openNode(handle, path);
+  CPPUNIT_ASSERT(dir != nullptr);
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    const std::string name = std::to_string(i);
+    const std::array<FsFieldDescriptor, 2> desc = {{
+        {
+            name.c_str(),
+            name.size() + 1,
+            FS_NODE_NAME
+        }, {
+            nullptr,
+            0,
+            FS_NODE_DATA
+        }
+    }};
+
+    res = fsNodeCreate(dir, desc.data(), desc.size());
+    CPPUNIT_ASSERT(res == E_OK);
+  }
+
+  fsNodeFree(dir);
+}
+
+VfsDirectoryBenchmark::Timings VfsDirectoryBenchmark::measure(size_t count)
+{
+  const std::string path = std::string{"/dir"} + std::to_string(count);
+  populate(path.c_str(), count);
+
+  // Full listing of the directory
+  const auto listStart = Clock::now();
+
+  FsNode * const dir = ShellHelpers::openNode(handle, path.c_str());
+  CPPUNIT_ASSERT(dir != nullptr);
+  FsNode * const child = static_cast<FsNode *>(fsNodeHead(dir));
+  CPPUNIT_ASSERT(child != nullptr);
+  fsNodeFree(dir);
+
+  size_t visited = 0;
+
+  do
+  {
+    char name[32];
+    const Result res = fsNodeRead(child, FS_NODE_NAME, 0, name, sizeof(name), nullptr);
+    CPPUNIT_ASSERT(res == E_OK);
+
+    ++visited;
+  }
+  while (fsNodeNext(child) == E_OK);
+
+  fsNodeFree(child);
+  CPPUNIT_ASSERT(visited == count);
+
+  const std::chrono::duration<double> listTime = Clock::now() - listStart;
+
+  // Path resolution of every node
+  const auto lookupStart = Clock::now();
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    const std::string nodePath = path + "/" + std::to_string(i);
+    FsNode * const node = ShellHelpers::openNode(handle, nodePath.c_str());
+    CPPUNIT_ASSERT(node != nullptr);
+    fsNodeFree(node);
+  }
+
+  const std::chrono::duration<double> lookupTime = Clock::now() - lookupStart;
+
+  std::cout << count << " nodes: listing " << listTime.count() << " s, lookup " << lookupTime.count() << " s"
+      << std::endl;
+
+  return Timings{listTime.count() / count, lookupTime.count() / count};
+}
+
+void VfsDirectoryBenchmark::testScaling()
+{
+  const auto small = measure(SMALL_COUNT);
+  const auto large = measure(LARGE_COUNT);
+
+  // Timer resolution limits the precision for small directories
+  const double floor = 1e-7;
+
+  CPPUNIT_ASSERT(large.list <= std::max(small.list, floor) * SCALING_LIMIT);
+  CPPUNIT_ASSERT(large.lookup <= std::max(small.lookup, floor) * SCALING_LIMIT);
+}
+
+CPPUNIT_TEST_SUITE_REGISTRATION(VfsDirectoryBenchmark);
+
+int main(int, char *[])
+{
+  CPPUNIT_NS::Test * const suite = CPPUNIT_NS::TestFactoryRegistry::getRegistry().makeTest();
+
+  CppUnit::TextUi::TestRunner runner;
+  runner.addTest(suite);
+
+  const bool sucessful = runner.run();
+  return sucessful ? EXIT_SUCCESS : EXIT_FAILURE;
+}
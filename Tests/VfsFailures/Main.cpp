@@ -8,10 +8,12 @@
 #include "Vfs/VfsDataNode.hpp"
 #include "Vfs/VfsDirectory.hpp"
 #include "Vfs/VfsHandle.hpp"
+#include "Vfs/VfsSlab.hpp"
 #include <cppunit/CompilerOutputter.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include <cppunit/extensions/TestFactoryRegistry.h>
 #include <cppunit/ui/text/TestRunner.h>
+#include <string>
 
 extern "C" void *__libc_malloc(size_t);
 
@@ -45,12 +47,21 @@ public:
 
 private:
   static constexpr size_t BUFFER_SIZE{1024};
+  // Name is too long for the name cache, therefore it is allocated from the heap
+  static constexpr const char *LONG_NAME{"name_exceeding_the_length_of_the_name_cache"};
 
   FsHandle *handle{nullptr};
 };
 
 void VfsTest::setUp()
 {
+  // Slab caches allocate their locks on first use, create them before failure injection
+  VfsSlab::directoryCache();
+  VfsSlab::dataCache();
+  VfsSlab::entryCache();
+  VfsSlab::extentCache();
+  VfsSlab::nameCache();
+
   handle = static_cast<FsHandle *>(init(VfsHandleClass, nullptr));
   CPPUNIT_ASSERT(handle != nullptr);
 }
@@ -69,7 +80,7 @@ void VfsTest::testDataNodeFailures()
   bool ok;
 
   mallocHookFails = 1;
-  ok = node->rename("test");
+  ok = node->rename(LONG_NAME);
   CPPUNIT_ASSERT(ok == false);
 
   mallocHookFails = 1;
@@ -96,12 +107,15 @@ void VfsTest::testNodeCreationFailures()
   auto node = new VfsDataNode{};
   CPPUNIT_ASSERT(node != nullptr);
 
+  // Release the node to keep a free chunk in the node cache
+  delete node;
+
   // Try to create node, simulate renaming failure
 
   const std::array<FsFieldDescriptor, 2> memoryFailureTest = {{
       {
-          "test",
-          strlen("test") + 1,
+          LONG_NAME,
+          strlen(LONG_NAME) + 1,
           FS_NODE_NAME
       }, {
           nullptr,
@@ -110,11 +124,10 @@ void VfsTest::testNodeCreationFailures()
       }
   }};
 
-  mallocHookFails = 2;
+  mallocHookFails = 1;
   const auto res = dir->create(memoryFailureTest.data(), memoryFailureTest.size());
   CPPUNIT_ASSERT(res == E_MEMORY);
 
-  delete node;
   delete dir;
 }
 
@@ -123,9 +136,11 @@ void VfsTest::testNodeInjection()
   auto node = new VfsDataNode{};
   CPPUNIT_ASSERT(node != nullptr);
 
+  const std::string path = std::string{"/"} + LONG_NAME;
+
   // Test rename failure
   mallocHookFails = 1;
-  const auto res = ShellHelpers::injectNode(handle, node, "/test");
+  const auto res = ShellHelpers::injectNode(handle, node, path.c_str());
   CPPUNIT_ASSERT(res == E_MEMORY);
 
   delete node;